@@ -0,0 +1,130 @@
+// src/bin_protocol.c
+
+#include "bin_protocol.h"
+#include <string.h>
+
+// 빅 엔디언 정수 쓰기
+static void put_be(unsigned char *out, uint64_t value, int bytes)
+{
+    for (int i = bytes - 1; i >= 0; i--)
+    {
+        out[i] = (unsigned char)value;
+        value >>= 8;
+    }
+}
+
+// 빅 엔디언 정수 읽기
+static uint64_t get_be(const unsigned char *in, int bytes)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++)
+    {
+        value = (value << 8) | in[i];
+    }
+    return value;
+}
+
+// 필드 헤더(태그 + 길이)와 값을 out 끝에 추가
+static bool put_field(ReplyBuffer *out, uint8_t tag, const void *value, size_t len)
+{
+    if (!reply_reserve(out, BIN_FIELD_HEADER_SIZE + len))
+        return false;
+    unsigned char *p = (unsigned char *)out->data + out->len;
+    p[0] = tag;
+    put_be(p + 1, len, 4);
+    if (len > 0)
+        memcpy(p + BIN_FIELD_HEADER_SIZE, value, len);
+    out->len += BIN_FIELD_HEADER_SIZE + len;
+    out->data[out->len] = '\0';
+    return true;
+}
+
+// 1바이트 추가 (명령 코드/상태 코드)
+bool bin_put_u8(ReplyBuffer *out, uint8_t value)
+{
+    return reply_append(out, (const char *)&value, 1);
+}
+
+// 4바이트 정수 필드 추가
+bool bin_put_u32_field(ReplyBuffer *out, uint8_t tag, uint32_t value)
+{
+    unsigned char raw[4];
+    put_be(raw, value, 4);
+    return put_field(out, tag, raw, sizeof(raw));
+}
+
+// 8바이트 시각 필드 추가
+bool bin_put_i64_field(ReplyBuffer *out, uint8_t tag, int64_t value)
+{
+    unsigned char raw[8];
+    put_be(raw, (uint64_t)value, 8);
+    return put_field(out, tag, raw, sizeof(raw));
+}
+
+// 문자열 필드 추가
+bool bin_put_str_field(ReplyBuffer *out, uint8_t tag, const char *value)
+{
+    return put_field(out, tag, value, strlen(value));
+}
+
+// 하위 필드를 담는 필드 시작 (길이는 bin_end_field에서 채움)
+size_t bin_begin_field(ReplyBuffer *out, uint8_t tag)
+{
+    size_t start = out->len;
+    put_field(out, tag, NULL, 0);
+    return start;
+}
+
+// 하위 필드를 담는 필드 끝: 시작 이후 추가된 길이를 헤더에 기록
+void bin_end_field(ReplyBuffer *out, size_t start)
+{
+    if (!out->data || out->len < start + BIN_FIELD_HEADER_SIZE)
+        return;
+    put_be((unsigned char *)out->data + start + 1, out->len - start - BIN_FIELD_HEADER_SIZE, 4);
+}
+
+// 커서 초기화
+void bin_reader_init(BinReader *reader, const void *data, size_t len)
+{
+    reader->data = (const unsigned char *)data;
+    reader->len = len;
+    reader->off = 0;
+}
+
+// 다음 필드 읽기
+bool bin_next_field(BinReader *reader, BinField *field)
+{
+    if (reader->len - reader->off < BIN_FIELD_HEADER_SIZE)
+        return false;
+    const unsigned char *p = reader->data + reader->off;
+    field->tag = p[0];
+    field->len = (uint32_t)get_be(p + 1, 4);
+    // 값이 데이터 범위를 벗어나면 형식 오류
+    if (field->len > reader->len - reader->off - BIN_FIELD_HEADER_SIZE)
+        return false;
+    field->value = p + BIN_FIELD_HEADER_SIZE;
+    reader->off += BIN_FIELD_HEADER_SIZE + field->len;
+    return true;
+}
+
+// 4바이트 정수 값
+uint32_t bin_field_u32(const BinField *field)
+{
+    return field->len == 4 ? (uint32_t)get_be(field->value, 4) : 0;
+}
+
+// 8바이트 시각 값
+int64_t bin_field_i64(const BinField *field)
+{
+    return field->len == 8 ? (int64_t)get_be(field->value, 8) : 0;
+}
+
+// 문자열 값을 null 문자로 끝나는 문자열로 복사
+bool bin_field_str(const BinField *field, char *dest, size_t dest_size)
+{
+    if (field->len >= dest_size)
+        return false;
+    memcpy(dest, field->value, field->len);
+    dest[field->len] = '\0';
+    return true;
+}
@@ -0,0 +1,91 @@
+// src/bin_protocol.h
+
+#ifndef BIN_PROTOCOL_H
+#define BIN_PROTOCOL_H
+
+#include "reply_buffer.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 바이너리(TLV) 프로토콜
+//
+// 연결 직후 첫 요청으로 "HELLO:BIN1"을 보내 "OK:BIN1" 응답을 받은 연결에서만 사용할 수 있다.
+// 텍스트 명령은 항상 영문 대문자로 시작하므로, 첫 바이트가 0x20 미만이면 바이너리 요청으로 구분한다.
+// (바이너리 모드 연결에서도 텍스트 요청은 그대로 사용할 수 있다.)
+//
+//   요청 : 명령 코드(1바이트) + 필드...
+//   응답 : 상태 코드(1바이트) + 필드...
+//   필드 : 태그(1바이트) + 값 길이(빅 엔디언 4바이트) + 값
+//
+// 숫자는 고정 길이 빅 엔디언(ID는 4바이트, 시각은 1970-01-01 기준 초 단위 8바이트)이고,
+// 문자열은 null 문자 없이 길이만큼 담는다. 목록 응답은 메모마다 BIN_TAG_MEMO 필드 하나이며,
+// 그 값이 다시 필드들(ID, 생성/수정 시각, 제목 ...)로 이루어진다.
+
+#define BIN_PROTOCOL_NAME "BIN1"  // HELLO로 협상하는 프로토콜 이름
+#define BIN_OPCODE_LIMIT 0x20     // 이 값보다 작은 첫 바이트는 바이너리 요청
+#define BIN_FIELD_HEADER_SIZE 5   // 태그 + 길이
+
+// 명령 코드
+// (user_id 자리에는 BIN_TAG_USER_ID 대신 BIN_TAG_SESSION을 보내도 됨, 둘 중 하나만 한 번 보내야 하며 아니면 실패 응답)
+#define BIN_OP_MEMO_LIST 0x01          // 사용자 전체 메모 목록 (user_id)
+#define BIN_OP_MEMO_LIST_BY_MONTH 0x02 // 월별 메모 목록 (user_id, year, month)
+#define BIN_OP_MEMO_SEARCH 0x03        // 메모 검색 (user_id, field, keyword)
+#define BIN_OP_MEMO_VIEW 0x04          // 메모 상세 조회 (user_id, memo_id)
+
+// 상태 코드
+#define BIN_STATUS_OK 0x00        // 성공
+#define BIN_STATUS_FAIL 0x01      // 실패 (BIN_TAG_MESSAGE에 사유)
+#define BIN_STATUS_THROTTLED 0x02 // 요청 빈도 제한으로 처리하지 않음 (BIN_TAG_MESSAGE에 안내)
+#define BIN_STATUS_BUSY 0x03      // 서버 과부하로 처리하지 않음 (BIN_TAG_MESSAGE에 안내)
+#define BIN_STATUS_EXPIRED 0x04   // 요청 기한이 지나 처리하지 않거나 중단함 (BIN_TAG_MESSAGE에 안내)
+
+// 필드 태그
+#define BIN_TAG_USER_ID 0x01    // 문자열
+#define BIN_TAG_MEMO_ID 0x02    // 4바이트 정수
+#define BIN_TAG_YEAR 0x03       // 4바이트 정수
+#define BIN_TAG_MONTH 0x04      // 4바이트 정수
+#define BIN_TAG_FIELD 0x05      // 문자열 (검색 대상: title, content, all)
+#define BIN_TAG_KEYWORD 0x06    // 문자열
+#define BIN_TAG_SESSION 0x07    // 8바이트 세션 토큰 값 (session.h, 사용자 ID 대신 사용)
+#define BIN_TAG_MEMO 0x10       // 메모 레코드 (하위 필드 묶음)
+#define BIN_TAG_TITLE 0x11      // 문자열
+#define BIN_TAG_CONTENT 0x12    // 문자열
+#define BIN_TAG_CREATED_AT 0x13 // 8바이트 시각
+#define BIN_TAG_UPDATED_AT 0x14 // 8바이트 시각
+#define BIN_TAG_MESSAGE 0x20    // 문자열 (실패 사유 등)
+
+// 읽어 들인 필드 하나
+typedef struct
+{
+    uint8_t tag;                // 태그
+    uint32_t len;               // 값 길이
+    const unsigned char *value; // 값 (원본 버퍼 안을 가리킴)
+} BinField;
+
+// 필드를 차례로 읽는 커서
+typedef struct
+{
+    const unsigned char *data; // 데이터 시작
+    size_t len;                // 데이터 길이
+    size_t off;                // 현재 위치
+} BinReader;
+
+// 쓰기: out 끝에 추가 (메모리 부족 시 false)
+bool bin_put_u8(ReplyBuffer *out, uint8_t value);
+bool bin_put_u32_field(ReplyBuffer *out, uint8_t tag, uint32_t value);
+bool bin_put_i64_field(ReplyBuffer *out, uint8_t tag, int64_t value);
+bool bin_put_str_field(ReplyBuffer *out, uint8_t tag, const char *value);
+
+// 하위 필드를 담는 필드 시작/끝 (begin이 돌려준 위치를 end에 넘김)
+size_t bin_begin_field(ReplyBuffer *out, uint8_t tag);
+void bin_end_field(ReplyBuffer *out, size_t start);
+
+// 읽기
+void bin_reader_init(BinReader *reader, const void *data, size_t len);
+bool bin_next_field(BinReader *reader, BinField *field); // 다음 필드 (끝이거나 형식 오류면 false)
+uint32_t bin_field_u32(const BinField *field);           // 4바이트 정수 값 (길이가 다르면 0)
+int64_t bin_field_i64(const BinField *field);            // 8바이트 시각 값 (길이가 다르면 0)
+bool bin_field_str(const BinField *field, char *dest, size_t dest_size); // 문자열 복사 (길면 false)
+
+#endif
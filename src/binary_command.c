@@ -0,0 +1,158 @@
+// src/binary_command.c
+
+#include "binary_command.h"
+#include "bin_protocol.h"
+#include "memo.h"
+#include "session.h"
+#include <stdio.h>
+#include <string.h>
+
+// 요청 필드를 해석한 결과
+typedef struct
+{
+    char user_id[MAX_USER_ID_LEN];     // 사용자 ID
+    uint64_t session;                  // 세션 토큰 값 (0이면 없음)
+    int memo_id;                       // 메모 ID
+    int year;                          // 연도
+    int month;                         // 월
+    char field[16];                    // 검색 대상
+    const char *keyword;               // 검색어 (요청 안을 가리킴, null 문자로 끝나지 않음)
+    size_t keyword_len;                // 검색어 길이
+} BinRequest;
+
+// 실패 응답 생성
+static void reply_fail(ReplyBuffer *reply, const char *message)
+{
+    reply_clear(reply);
+    bin_put_u8(reply, BIN_STATUS_FAIL);
+    bin_put_str_field(reply, BIN_TAG_MESSAGE, message);
+}
+
+// 메모 하나를 목록 레코드로 추가 (ID, 생성/수정 시각, 제목)
+static void put_summary_record(const Memo *memo, void *ctx)
+{
+    ReplyBuffer *reply = (ReplyBuffer *)ctx;
+    size_t start = bin_begin_field(reply, BIN_TAG_MEMO);
+    bin_put_u32_field(reply, BIN_TAG_MEMO_ID, (uint32_t)memo->id);
+    bin_put_i64_field(reply, BIN_TAG_CREATED_AT, memo->created_ts);
+    bin_put_i64_field(reply, BIN_TAG_UPDATED_AT, memo->updated_ts);
+    bin_put_str_field(reply, BIN_TAG_TITLE, memo->title);
+    bin_end_field(reply, start);
+}
+
+// 요청 필드 해석 (알 수 없는 태그는 무시)
+// 사용자 ID와 세션 토큰은 둘 중 하나만 한 번 보내야 한다. 디스패처는 처음 나온 사용자 필드로 파티션과
+// 빈도 제한 대상을 정하므로, 여러 개를 받아 주면 핸들러가 다른 사용자의 파티션을 건드릴 수 있다.
+static bool parse_request(const unsigned char *fields, size_t len, BinRequest *req)
+{
+    memset(req, 0, sizeof(*req));
+    BinReader reader;
+    BinField field;
+    bin_reader_init(&reader, fields, len);
+    bool has_user = false; // 사용자 ID나 세션 토큰을 받았는지 여부
+    while (bin_next_field(&reader, &field))
+    {
+        bool ok = true;
+        switch (field.tag)
+        {
+        case BIN_TAG_USER_ID:
+            ok = !has_user && bin_field_str(&field, req->user_id, sizeof(req->user_id));
+            has_user = true;
+            break;
+        case BIN_TAG_SESSION:
+            ok = !has_user;
+            has_user = true;
+            req->session = (uint64_t)bin_field_i64(&field);
+            break;
+        case BIN_TAG_MEMO_ID:
+            req->memo_id = (int)bin_field_u32(&field);
+            break;
+        case BIN_TAG_YEAR:
+            req->year = (int)bin_field_u32(&field);
+            break;
+        case BIN_TAG_MONTH:
+            req->month = (int)bin_field_u32(&field);
+            break;
+        case BIN_TAG_FIELD:
+            ok = bin_field_str(&field, req->field, sizeof(req->field));
+            break;
+        case BIN_TAG_KEYWORD:
+            req->keyword = (const char *)field.value;
+            req->keyword_len = field.len;
+            break;
+        }
+        if (!ok)
+            return false;
+    }
+    // 남은 바이트가 있으면 형식 오류
+    return reader.off == reader.len && (req->user_id[0] != '\0' || req->session != 0);
+}
+
+// 바이너리 요청 처리
+void handle_binary_command(const unsigned char *request, size_t len, ReplyBuffer *reply)
+{
+    BinRequest req;
+    if (len == 0 || !parse_request(request + 1, len - 1, &req))
+    {
+        reply_fail(reply, "잘못된 요청입니다.");
+        return;
+    }
+    // 세션 토큰이면 로그인한 사용자 ID로 변환
+    if (req.session != 0)
+    {
+        const char *user_id = session_resolve_value(req.session);
+        if (!user_id)
+        {
+            reply_fail(reply, "세션이 만료되었습니다. 다시 로그인하세요.");
+            return;
+        }
+        snprintf(req.user_id, sizeof(req.user_id), "%s", user_id);
+    }
+
+    // 성공 응답은 상태 코드 뒤에 메모 레코드를 이어 붙임
+    reply_clear(reply);
+    bin_put_u8(reply, BIN_STATUS_OK);
+    switch (request[0])
+    {
+    // 사용자 전체 메모 목록
+    case BIN_OP_MEMO_LIST:
+        memo_visit_user(req.user_id, put_summary_record, reply);
+        break;
+    // 월별 메모 목록
+    case BIN_OP_MEMO_LIST_BY_MONTH:
+        memo_visit_month(req.user_id, req.year, req.month, put_summary_record, reply);
+        break;
+    // 메모 검색
+    case BIN_OP_MEMO_SEARCH:
+        if (req.keyword_len == 0 || req.field[0] == '\0')
+        {
+            reply_fail(reply, "검색 필드와 검색어가 필요합니다.");
+            return;
+        }
+        memo_visit_search(req.user_id, req.field, req.keyword, req.keyword_len, put_summary_record, reply);
+        break;
+    // 메모 상세 조회 (레코드 하나에 내용까지 포함)
+    case BIN_OP_MEMO_VIEW:
+    {
+        const Memo *memo = memo_get_by_id_internal(req.memo_id, req.user_id);
+        if (!memo)
+        {
+            char message[64];
+            snprintf(message, sizeof(message), "메모 ID %d를 찾을 수 없습니다.", req.memo_id);
+            reply_fail(reply, message);
+            return;
+        }
+        size_t start = bin_begin_field(reply, BIN_TAG_MEMO);
+        bin_put_u32_field(reply, BIN_TAG_MEMO_ID, (uint32_t)memo->id);
+        bin_put_i64_field(reply, BIN_TAG_CREATED_AT, memo->created_ts);
+        bin_put_i64_field(reply, BIN_TAG_UPDATED_AT, memo->updated_ts);
+        bin_put_str_field(reply, BIN_TAG_TITLE, memo->title);
+        bin_put_str_field(reply, BIN_TAG_CONTENT, memo->content);
+        bin_end_field(reply, start);
+        break;
+    }
+    default:
+        reply_fail(reply, "알 수 없는 바이너리 명령입니다.");
+        return;
+    }
+}
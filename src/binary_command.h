@@ -0,0 +1,14 @@
+// src/binary_command.h
+
+#ifndef BINARY_COMMAND_H
+#define BINARY_COMMAND_H
+
+#include "reply_buffer.h"
+#include <stddef.h>
+
+// 바이너리 프로토콜(bin_protocol.h) 메모 조회 명령을 처리하고 바이너리 응답을 생성
+// - request: 명령 코드로 시작하는 요청 (null 문자를 포함할 수 있으므로 길이를 함께 받음)
+// - reply: 상태 코드와 필드들로 이루어진 응답을 저장할 버퍼
+void handle_binary_command(const unsigned char *request, size_t len, ReplyBuffer *reply);
+
+#endif
@@ -0,0 +1,127 @@
+// src/client_net.c
+
+#include "client_net.h"
+#include "frame.h"
+#include "bin_protocol.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 응답 수신 버퍼 (communicate_with_server는 한 번에 요청 하나만 보내므로 연결 전체에서 재사용)
+static ReplyBuffer g_reply_buf;
+// 통신 실패 시 돌려줄 응답 (호출자가 수정할 수 있도록 배열로 둠)
+static char g_fail_reply[] = "FAIL:서버와 통신할 수 없습니다.";
+// 바이너리 프로토콜 협상 결과
+static bool g_binary = false;
+// 로그인으로 받은 세션 토큰 ("@" + 16진수 16자리, 없으면 빈 문자열)
+static char g_session[32] = "";
+
+// 연결 직후 프로토콜 협상
+void client_hello(SOCKET sock)
+{
+    char *reply;
+    // 연결 확인 프레임(PING)도 받겠다고 알림 (frame_recv가 건너뛰므로 따로 처리할 것은 없음)
+    // 응답은 "OK:BIN1" 또는 "OK:BIN1,PING" 형식
+    g_binary = communicate_with_server(sock, "HELLO:" BIN_PROTOCOL_NAME ",TEXT,PING", &reply) &&
+               strncmp(reply, "OK:" BIN_PROTOCOL_NAME, strlen("OK:" BIN_PROTOCOL_NAME)) == 0 &&
+               (reply[strlen("OK:" BIN_PROTOCOL_NAME)] == '\0' || reply[strlen("OK:" BIN_PROTOCOL_NAME)] == ',');
+}
+
+// 바이너리 프로토콜 사용 가능 여부
+bool client_binary_enabled(void)
+{
+    return g_binary;
+}
+
+// 로그인 성공 응답에서 세션 토큰을 떼어 저장
+void client_set_session(char *login_reply)
+{
+    g_session[0] = '\0';
+    char *token = strrchr(login_reply, ':');
+    if (token == NULL || token[1] != '@' || strlen(token + 1) >= sizeof(g_session))
+        return;
+    strcpy(g_session, token + 1);
+    *token = '\0'; // 메시지만 남김
+}
+
+// 로그아웃
+void client_end_session(SOCKET sock)
+{
+    if (g_session[0] == '\0')
+        return;
+    char request[64], *reply;
+    snprintf(request, sizeof(request), "LOGOUT:%s", g_session);
+    communicate_with_server(sock, request, &reply);
+    g_session[0] = '\0';
+}
+
+// 요청의 사용자 ID 자리에 넣을 값
+const char *client_user_key(const char *user_id)
+{
+    return g_session[0] != '\0' ? g_session : user_id;
+}
+
+// 바이너리 요청에 사용자 필드 추가
+bool client_put_user_field(ReplyBuffer *request, const char *user_id)
+{
+    if (g_session[0] == '\0')
+        return bin_put_str_field(request, BIN_TAG_USER_ID, user_id);
+    // 토큰 문자열("@" 뒤의 16진수)을 8바이트 값으로 전송
+    return bin_put_i64_field(request, BIN_TAG_SESSION, (int64_t)strtoull(g_session + 1, NULL, 16));
+}
+
+// 서버에 요청을 보내고 응답을 받는 헬퍼 함수
+bool communicate_with_server(SOCKET sock, const char *request, char **reply)
+{
+    *reply = g_fail_reply;
+    // 요청 전송
+    if (!client_send_burst(sock, &request, NULL, 1))
+    {
+        printf("[클라이언트] 서버에 요청 전송 실패\n");
+        return false;
+    }
+    // 응답 수신
+    if (!client_recv_reply(sock, &g_reply_buf))
+    {
+        printf("[클라이언트] 서버로부터 응답 수신 실패\n");
+        return false;
+    }
+    *reply = g_reply_buf.data;
+    return true;
+}
+
+// 여러 요청을 응답을 기다리지 않고 연달아 전송
+bool client_send_burst(SOCKET sock, const char *const *requests, const size_t *lengths, int count)
+{
+    // 모든 프레임을 한 버퍼에 모아 send 한 번으로 전송
+    ReplyBuffer out;
+    reply_init(&out);
+    bool ok = true;
+    for (int i = 0; i < count && ok; i++)
+    {
+        size_t len = lengths ? lengths[i] : strlen(requests[i]);
+        ok = reply_reserve(&out, FRAME_HEADER_SIZE + len);
+        if (ok)
+        {
+            frame_encode_header((unsigned char *)out.data + out.len, 0, (uint32_t)len);
+            memcpy(out.data + out.len + FRAME_HEADER_SIZE, requests[i], len);
+            out.len += FRAME_HEADER_SIZE + len;
+        }
+    }
+    // 모두 보낼 때까지 반복 전송
+    size_t off = 0;
+    while (ok && off < out.len)
+    {
+        int sent = send(sock, out.data + off, (int)(out.len - off), 0);
+        ok = sent > 0;
+        off += ok ? (size_t)sent : 0;
+    }
+    reply_free(&out);
+    return ok;
+}
+
+// 파이프라인으로 보낸 요청의 응답 하나를 수신
+bool client_recv_reply(SOCKET sock, ReplyBuffer *reply)
+{
+    return frame_recv(sock, reply);
+}
@@ -0,0 +1,46 @@
+// src/client_net.h
+
+#ifndef CLIENT_NET_H
+#define CLIENT_NET_H
+
+#include <winsock2.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "reply_buffer.h"
+
+// 연결 직후 프로토콜 협상 (바이너리 프로토콜을 제시하고 서버가 받아들이면 사용)
+// 협상에 실패해도(이전 서버 등) 텍스트 프로토콜로 계속 통신할 수 있다.
+void client_hello(SOCKET sock);
+
+// 이 연결에서 바이너리 프로토콜(bin_protocol.h)을 사용할 수 있는지 여부
+bool client_binary_enabled(void);
+
+// 로그인 성공 응답("OK:로그인 성공:@토큰")에서 세션 토큰을 떼어 저장
+// 응답 문자열에서는 토큰 부분을 잘라 내므로 그대로 메시지로 출력할 수 있다.
+// 토큰을 주지 않는 이전 서버라면 이후 요청에도 사용자 ID를 그대로 사용한다.
+void client_set_session(char *login_reply);
+
+// 로그아웃: 서버에 세션 종료(LOGOUT)를 알리고 저장한 토큰을 지움
+void client_end_session(SOCKET sock);
+
+// 요청의 사용자 ID 자리에 넣을 값 (세션 토큰이 있으면 토큰, 없으면 user_id)
+const char *client_user_key(const char *user_id);
+
+// 바이너리 요청에 사용자 필드 추가 (세션 토큰이 있으면 BIN_TAG_SESSION, 없으면 BIN_TAG_USER_ID)
+bool client_put_user_field(ReplyBuffer *request, const char *user_id);
+
+// 서버에 요청을 보내고 응답을 받는 헬퍼 함수
+// 요청/응답 모두 길이 헤더가 붙은 프레임으로 주고받으므로 응답 크기에 제한이 없다.
+// reply에는 응답 문자열 주소가 저장되며, 다음 호출 전까지만 유효하다 (수정은 가능).
+// 통신에 실패하면 false를 반환하고 reply는 "FAIL:" 메시지를 가리킨다.
+bool communicate_with_server(SOCKET sock, const char *request, char **reply);
+
+// 여러 요청을 응답을 기다리지 않고 연달아 전송 (파이프라인)
+// 서버는 받은 순서대로 처리하므로, 응답은 client_recv_reply로 같은 순서대로 count번 받아야 한다.
+// lengths가 NULL이면 요청을 문자열로 보고 strlen으로 길이를 구한다 (바이너리 요청은 길이 필요).
+bool client_send_burst(SOCKET sock, const char *const *requests, const size_t *lengths, int count);
+
+// 파이프라인으로 보낸 요청의 응답 하나를 reply에 수신
+bool client_recv_reply(SOCKET sock, ReplyBuffer *reply);
+
+#endif
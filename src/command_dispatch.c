@@ -0,0 +1,371 @@
+// src/command_dispatch.c
+
+#include "command_dispatch.h"
+#include "memo_command.h"
+#include "user_command.h"
+#include "binary_command.h"
+#include "bin_protocol.h"
+#include "platform.h"
+#include "store_partition.h"
+#include "session.h"
+#include "logger.h"
+#include "rate_limit.h"
+#include "load_shed.h"
+#include "deadline.h"
+#include "epoch.h"
+#include <stdio.h>
+#include <string.h>
+
+#define LOG_REQUEST_PREVIEW 160 // 로그에 남길 요청 문자열의 최대 길이
+
+// 샤드 모드가 아니면 요청 사용자의 파티션을 잠그거나 에포크 구간에 들어가서 핸들러를 실행 (store_partition.h, epoch.h)
+// 샤드 모드에서는 사용자의 파티션을 맡은 샤드만 핸들러를 실행하므로 잠그지 않음
+static bool g_sharded = false;
+
+// 핸들러가 저장소에 접근하는 방식
+typedef enum
+{
+    STORE_ACCESS_SNAPSHOT, // 사용자의 메모 판만 읽음 (목록/월별/검색/전체 내보내기): 잠그지 않고 에포크 구간 안에서
+    STORE_ACCESS_READ,     // 메모 ID 색인을 읽음 (상세 조회/한 개 내보내기): 파티션 읽기 잠금
+    STORE_ACCESS_WRITE     // 저장소를 바꿈: 파티션 쓰기 잠금
+} StoreAccess;
+
+// 저장소 접근 시작 (샤드 모드가 아닐 때)
+static void store_access_begin(int partition, StoreAccess access)
+{
+    if (access == STORE_ACCESS_SNAPSHOT)
+        epoch_enter();
+    else
+        store_lock_partition(partition, access == STORE_ACCESS_WRITE);
+}
+
+// 저장소 접근 끝
+static void store_access_end(int partition, StoreAccess access)
+{
+    if (access == STORE_ACCESS_SNAPSHOT)
+        epoch_exit();
+    else
+        store_unlock_partition(partition, access == STORE_ACCESS_WRITE);
+}
+
+// 샤드 모드 설정
+void dispatch_set_sharded(bool sharded)
+{
+    g_sharded = sharded;
+}
+
+// 텍스트 요청에서 사용자 ID 항목("명령어:사용자ID:..."의 두 번째 항목)의 위치
+// (핸들러의 strtok처럼 연속된 구분자는 건너뜀, 항목이 없으면 false)
+static bool find_user_field(const char *request, size_t len, size_t *start, size_t *end)
+{
+    size_t i = 0;
+    while (i < len && request[i] != '\0' && request[i] != ':')
+        i++;
+    while (i < len && request[i] == ':')
+        i++;
+    *start = i;
+    while (i < len && request[i] != '\0' && request[i] != ':')
+        i++;
+    *end = i;
+    return i > *start;
+}
+
+// 요청이 다루는 사용자의 저장소 파티션
+int dispatch_partition(const char *request, size_t len, bool binary)
+{
+    // 바이너리 요청: 사용자 ID 필드 (사용자 필드가 둘 이상인 요청은 핸들러가 저장소를 건드리기 전에 거절함)
+    if (binary)
+    {
+        BinReader reader;
+        BinField field;
+        bin_reader_init(&reader, request + 1, len - 1);
+        while (bin_next_field(&reader, &field))
+        {
+            if (field.tag == BIN_TAG_USER_ID)
+                return store_partition_of_n((const char *)field.value, field.len);
+            // 세션 토큰에는 파티션 번호가 들어 있음
+            if (field.tag == BIN_TAG_SESSION)
+                return session_partition_of_value((uint64_t)bin_field_i64(&field));
+        }
+        return -1;
+    }
+    // 텍스트 요청: 두 번째 항목
+    size_t start, end;
+    if (!find_user_field(request, len, &start, &end))
+        return -1;
+    // 세션 토큰이면 해시 없이 토큰에 든 파티션 번호 사용
+    if (request[start] == SESSION_TOKEN_PREFIX)
+        return session_partition_of_n(request + start, end - start);
+    return store_partition_of_n(request + start, end - start);
+}
+
+// 텍스트 명령어 이름 비교 (이름 뒤가 ':'이거나 요청의 끝이어야 같은 명령, 요청은 null 문자로 끝나지 않아도 됨)
+static bool command_is(const char *request, size_t len, const char *name)
+{
+    size_t name_len = strlen(name);
+    return len >= name_len && memcmp(request, name, name_len) == 0 &&
+           (len == name_len || request[name_len] == ':' || request[name_len] == '\0');
+}
+
+// 텍스트 명령어의 빈도 제한 종류
+static RateClass text_rate_class(const char *request, size_t len)
+{
+    // 일괄 작업 예산은 일괄 작업 대기열로 가는 명령(dispatch_is_bulk)과 같게 둠 (메모 하나 내보내기는 조회)
+    if (command_is(request, len, "MEMO_SEARCH") || command_is(request, len, "DOWNLOAD_ALL") ||
+        command_is(request, len, "DELETE_USER"))
+        return RATE_CLASS_BULK;
+    if (command_is(request, len, "MEMO_LIST") || command_is(request, len, "MEMO_LIST_BY_MONTH") ||
+        command_is(request, len, "MEMO_VIEW") || command_is(request, len, "DOWNLOAD_SINGLE"))
+        return RATE_CLASS_READ;
+    // 변경 명령과 알 수 없는 명령 (알 수 없는 명령도 계속 보내면 막히도록)
+    return RATE_CLASS_WRITE;
+}
+
+// 텍스트 명령어의 부하 조절 종류 (과부하 시 버리는 순서)
+static ShedClass text_shed_class(const char *request, size_t len)
+{
+    if (command_is(request, len, "DOWNLOAD_ALL") || command_is(request, len, "DOWNLOAD_SINGLE"))
+        return SHED_CLASS_EXPORT;
+    if (command_is(request, len, "MEMO_SEARCH"))
+        return SHED_CLASS_SEARCH;
+    if (command_is(request, len, "MEMO_LIST") || command_is(request, len, "MEMO_LIST_BY_MONTH") ||
+        command_is(request, len, "MEMO_VIEW"))
+        return SHED_CLASS_INTERACTIVE;
+    return SHED_CLASS_KEEP;
+}
+
+// 텍스트 명령어의 저장소 접근 방식
+static StoreAccess text_store_access(const char *request, size_t len)
+{
+    if (command_is(request, len, "MEMO_LIST") || command_is(request, len, "MEMO_LIST_BY_MONTH") ||
+        command_is(request, len, "MEMO_SEARCH") || command_is(request, len, "DOWNLOAD_ALL"))
+        return STORE_ACCESS_SNAPSHOT;
+    if (command_is(request, len, "MEMO_VIEW") || command_is(request, len, "DOWNLOAD_SINGLE"))
+        return STORE_ACCESS_READ;
+    return STORE_ACCESS_WRITE;
+}
+
+// 느린 일괄 작업 요청인지 판별
+bool dispatch_is_bulk(const char *request, size_t len, bool binary)
+{
+    if (binary)
+        return len > 0 && (unsigned char)request[0] == BIN_OP_MEMO_SEARCH;
+    return command_is(request, len, "DOWNLOAD_ALL") || command_is(request, len, "MEMO_SEARCH") ||
+           command_is(request, len, "DELETE_USER");
+}
+
+// 요청 빈도 제한 확인 (저장소를 잠그거나 에포크 구간에 들어간 상태, 또는 파티션을 맡은 샤드에서 호출)
+// 세션 토큰은 로그인한 사용자 ID로 바꿔서, 같은 사용자가 세션을 여러 개 만들어도 예산을 함께 쓰게 한다.
+// 반환값: 예산을 넘었으면 true
+static bool throttled(RateLimit *limit, const char *request, size_t len, bool binary)
+{
+    const char *user_id = NULL;
+    size_t user_len = 0;
+    RateClass rate_class;
+    if (binary)
+    {
+        rate_class = (unsigned char)request[0] == BIN_OP_MEMO_SEARCH ? RATE_CLASS_BULK : RATE_CLASS_READ;
+        BinReader reader;
+        BinField field;
+        bin_reader_init(&reader, request + 1, len - 1);
+        while (bin_next_field(&reader, &field))
+        {
+            if (field.tag == BIN_TAG_USER_ID)
+            {
+                user_id = (const char *)field.value;
+                user_len = field.len;
+                break;
+            }
+            if (field.tag == BIN_TAG_SESSION)
+            {
+                // 끝난 세션이면 연결 버킷만 확인 (핸들러가 실패 응답을 보냄)
+                user_id = session_resolve_value((uint64_t)bin_field_i64(&field));
+                user_len = user_id ? strlen(user_id) : 0;
+                break;
+            }
+        }
+    }
+    else
+    {
+        rate_class = text_rate_class(request, len);
+        size_t start, end;
+        if (find_user_field(request, len, &start, &end))
+        {
+            if (request[start] == SESSION_TOKEN_PREFIX)
+            {
+                char token[SESSION_TOKEN_LEN + 1];
+                if (end - start == SESSION_TOKEN_LEN)
+                {
+                    memcpy(token, request + start, SESSION_TOKEN_LEN);
+                    token[SESSION_TOKEN_LEN] = '\0';
+                    user_id = session_resolve(token);
+                    user_len = user_id ? strlen(user_id) : 0;
+                }
+            }
+            else
+            {
+                user_id = request + start;
+                user_len = end - start;
+            }
+        }
+    }
+    return !rate_limit_acquire(limit, user_id, user_len, rate_class);
+}
+
+// 클라이언트 요청 하나를 처리하여 응답 생성
+bool dispatch_command(const char *request, ReplyBuffer *reply, RateLimit *limit, unsigned long long deadline_ms)
+{
+    // "EXIT" 명령어 처리
+    if (strcmp(request, "EXIT") == 0)
+    {
+        // 클라이언트에게 정상적으로 응답을 보내고 연결 종료
+        reply_set(reply, "OK:서버와 연결을 종료합니다.");
+        return false;
+    }
+
+    // 프로토콜 협상은 연결의 첫 요청으로만 가능 (dispatch_hello)
+    if (strncmp(request, "HELLO:", 6) == 0)
+    {
+        reply_set(reply, "FAIL:HELLO는 연결 직후 첫 요청으로만 보낼 수 있습니다.");
+        return true;
+    }
+
+    // 대기 시간이 목표를 넘어 이 종류의 요청을 버리는 중이면 저장소를 잠그지 않고 바로 과부하 응답
+    size_t len = strlen(request);
+    ShedClass shed_class = text_shed_class(request, len);
+    if (load_shed_enabled() && !load_shed_admit(shed_class))
+    {
+        reply_set(reply, "%s", REPLY_BUSY);
+        return true;
+    }
+
+    int partition = g_sharded ? -1 : dispatch_partition(request, len, false);
+    StoreAccess access = text_store_access(request, len);
+    if (!g_sharded)
+        store_access_begin(partition, access);
+    // 대기열이나 잠금을 기다리는 동안 기한이 지났으면 핸들러를 실행하지 않음
+    if (!deadline_begin(deadline_ms, shed_class))
+    {
+        reply_set(reply, "%s", REPLY_EXPIRED);
+    }
+    else
+    {
+        // 예산을 넘은 요청은 핸들러를 실행하지 않고 제한 응답
+        if (rate_limit_enabled() && throttled(limit, request, len, false))
+        {
+            reply_set(reply, "%s", REPLY_THROTTLED);
+        }
+        // 명령어에 따라 핸들러 분기
+        else if (strncmp(request, "MEMO_", 5) == 0 ||
+            strncmp(request, "DOWNLOAD_ALL", 12) == 0 ||
+            strncmp(request, "DOWNLOAD_SINGLE", 15) == 0)
+        {
+            // 메모 명령어 처리
+            handle_memo_command(request, reply);
+        }
+        else
+        {
+            // 사용자 명령어 처리
+            handle_user_command(request, reply);
+        }
+        // 처리 도중 기한이 지나 멈췄으면 만들다 만 응답 대신 기한 초과 응답
+        if (deadline_end())
+            reply_set(reply, "%s", REPLY_EXPIRED);
+    }
+    if (!g_sharded)
+        store_access_end(partition, access);
+    return true;
+}
+
+// 연결의 첫 요청이 프로토콜 협상(HELLO)이면 처리
+bool dispatch_hello(const char *request, ReplyBuffer *reply, bool *binary, bool *keepalive)
+{
+    if (strncmp(request, "HELLO:", 6) != 0)
+        return false;
+    // 클라이언트가 제시한 목록(쉼표 구분)에 바이너리 프로토콜/연결 확인 프레임이 있으면 사용
+    const char *offered = request + 6;
+    size_t name_len = strlen(BIN_PROTOCOL_NAME);
+    *binary = false;
+    if (keepalive)
+        *keepalive = false;
+    while (*offered)
+    {
+        size_t len = strcspn(offered, ",");
+        if (len == name_len && strncmp(offered, BIN_PROTOCOL_NAME, name_len) == 0)
+            *binary = true;
+        else if (keepalive && len == 4 && strncmp(offered, "PING", 4) == 0)
+            *keepalive = true;
+        offered += len;
+        if (*offered == ',')
+            offered++;
+    }
+    reply_set(reply, "OK:%s%s", *binary ? BIN_PROTOCOL_NAME : "TEXT", keepalive && *keepalive ? ",PING" : "");
+    return true;
+}
+
+// 바이너리 요청인지 판별 (텍스트 명령은 항상 영문 대문자로 시작)
+bool is_binary_request(const char *request, size_t len)
+{
+    return len > 0 && (unsigned char)request[0] < BIN_OPCODE_LIMIT;
+}
+
+// 바이너리 요청 하나를 처리하여 응답 생성
+void dispatch_binary_command(const char *request, size_t len, ReplyBuffer *reply, RateLimit *limit,
+                             unsigned long long deadline_ms)
+{
+    // 바이너리 명령은 모두 조회/검색
+    ShedClass shed_class = (unsigned char)request[0] == BIN_OP_MEMO_SEARCH ? SHED_CLASS_SEARCH : SHED_CLASS_INTERACTIVE;
+    if (load_shed_enabled() && !load_shed_admit(shed_class))
+    {
+        reply_clear(reply);
+        bin_put_u8(reply, BIN_STATUS_BUSY);
+        bin_put_str_field(reply, BIN_TAG_MESSAGE, REPLY_BUSY + 5);
+        return;
+    }
+    // 모두 조회라 상세 조회만 읽기 잠금, 나머지는 잠그지 않음
+    int partition = g_sharded ? -1 : dispatch_partition(request, len, true);
+    StoreAccess access = (unsigned char)request[0] == BIN_OP_MEMO_VIEW ? STORE_ACCESS_READ : STORE_ACCESS_SNAPSHOT;
+    if (!g_sharded)
+        store_access_begin(partition, access);
+    // 텍스트 요청과 같은 순서: 기한 확인 -> 빈도 제한 -> 핸들러 -> 중단 여부 확인
+    bool expired = !deadline_begin(deadline_ms, shed_class);
+    if (!expired)
+    {
+        if (rate_limit_enabled() && throttled(limit, request, len, true))
+        {
+            reply_clear(reply);
+            bin_put_u8(reply, BIN_STATUS_THROTTLED);
+            bin_put_str_field(reply, BIN_TAG_MESSAGE, THROTTLED_MESSAGE);
+        }
+        else
+        {
+            handle_binary_command((const unsigned char *)request, len, reply);
+        }
+        expired = deadline_end();
+    }
+    if (expired)
+    {
+        reply_clear(reply);
+        bin_put_u8(reply, BIN_STATUS_EXPIRED);
+        bin_put_str_field(reply, BIN_TAG_MESSAGE, EXPIRED_MESSAGE);
+    }
+    if (!g_sharded)
+        store_access_end(partition, access);
+}
+
+// 받은 요청을 로그에 남김
+void dispatch_log_request(const char *peer, long long peer_id, const char *request, size_t len, bool binary)
+{
+    // 기록하지 않는 수준이면 가리는 작업도 하지 않음
+    if (!logger_enabled(LOG_LEVEL_INFO))
+        return;
+    if (binary)
+    {
+        logger_write(LOG_LEVEL_INFO, "[서버] %s %lld 수신: (바이너리 명령 0x%02X, %zu바이트)", peer, peer_id,
+                     (unsigned char)request[0], len);
+        return;
+    }
+    char text[LOG_REQUEST_PREVIEW];
+    logger_redact_request(request, len, text, sizeof(text));
+    logger_write(LOG_LEVEL_INFO, "[서버] %s %lld 수신: %s", peer, peer_id, text);
+}
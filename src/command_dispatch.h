@@ -0,0 +1,73 @@
+// src/command_dispatch.h
+
+#ifndef COMMAND_DISPATCH_H
+#define COMMAND_DISPATCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "reply_buffer.h"
+#include "rate_limit.h"
+
+// 워커 대기열이 가득 찼거나 대기 시간 기반 부하 조절이 요청을 버릴 때 보내는 응답
+// 클라이언트는 "OK"가 아닌 응답의 5번째 바이트부터 메시지로 출력하므로 "FAIL:"과 같은 길이의 코드를 사용
+#define REPLY_BUSY "BUSY:서버 요청이 많아 지금은 처리할 수 없습니다. 잠시 후 다시 시도하세요."
+
+// 사용자나 연결이 요청 빈도 예산(rate_limit.h)을 넘었을 때 보내는 응답 (서버 전체 과부하인 BUSY와 구분)
+// 바이너리 요청에는 BIN_STATUS_THROTTLED 상태 코드와 함께 같은 메시지를 보낸다.
+#define THROTTLED_MESSAGE "요청이 너무 잦습니다. 잠시 후 다시 시도하세요."
+#define REPLY_THROTTLED "SLOW:" THROTTLED_MESSAGE
+
+// 요청의 기한(deadline.h)이 지나 처리하지 않았거나 중간에 멈췄을 때 보내는 응답
+// 바이너리 요청에는 BIN_STATUS_EXPIRED 상태 코드와 함께 같은 메시지를 보낸다.
+#define EXPIRED_MESSAGE "요청 기한이 지나 처리를 중단했습니다."
+#define REPLY_EXPIRED "LATE:" EXPIRED_MESSAGE
+
+// 클라이언트 요청 하나를 명령어 종류에 따라 메모/사용자 핸들러로 분기하고 응답을 생성
+// - request: 클라이언트가 보낸 요청 문자열 (예: "MEMO_VIEW:user_id:3")
+// - reply: 서버가 클라이언트에게 보낼 응답을 저장할 버퍼 (필요한 만큼 늘어남)
+// - limit: 요청을 보낸 연결의 빈도 제한 버킷 (NULL이면 사용자 예산만 확인)
+// - deadline_ms: 요청의 기한 (ps_now_ms 기준, 0이면 없음, 프레임의 제한 시간으로 받은 쪽이 계산)
+// 예산을 넘은 요청은 처리하지 않고 REPLY_THROTTLED로 응답하고,
+// 대기 시간 기반 부하 조절(load_shed.h)이 버리는 종류의 요청은 REPLY_BUSY로,
+// 기한이 지난 요청(시작 전이든 처리 중이든)은 REPLY_EXPIRED로 응답한다.
+// 반환값: 연결을 유지하면 true, 클라이언트가 EXIT로 종료를 요청했으면 false
+// 여러 워커 스레드에서 동시에 호출해도 안전하다.
+bool dispatch_command(const char *request, ReplyBuffer *reply, RateLimit *limit, unsigned long long deadline_ms);
+
+// 연결의 첫 요청이 프로토콜 협상 요청("HELLO:BIN1,TEXT,PING" 형식)이면 응답을 만들고 true 반환
+// binary에는 이 연결에서 바이너리 프로토콜(bin_protocol.h)을 쓸 수 있는지가 저장된다.
+// keepalive가 NULL이 아니면(서버가 연결 확인 프레임을 보내는 경우) 클라이언트가 "PING"을 제시했는지가 저장되고,
+// 제시했으면 응답 끝에 ",PING"을 붙인다 (예: "OK:BIN1,PING").
+// 첫 요청이 HELLO가 아니면 아무것도 하지 않고 false를 반환한다.
+bool dispatch_hello(const char *request, ReplyBuffer *reply, bool *binary, bool *keepalive);
+
+// 바이너리 모드 연결에서 받은 요청이 바이너리 요청인지 판별
+bool is_binary_request(const char *request, size_t len);
+
+// 바이너리 요청 하나를 처리하여 바이너리 응답 생성 (여러 워커 스레드에서 동시에 호출해도 안전)
+// limit, deadline_ms는 dispatch_command와 같다.
+void dispatch_binary_command(const char *request, size_t len, ReplyBuffer *reply, RateLimit *limit,
+                             unsigned long long deadline_ms);
+
+// 샤드 모드 설정 (Linux, --shards)
+// 켜면 저장소 파티션을 잠그지 않고 핸들러를 실행한다. 대신 호출하는 쪽이 같은 저장소 파티션의 요청을
+// 항상 같은 스레드(그 파티션을 맡은 샤드)에서만 처리해야 한다.
+void dispatch_set_sharded(bool sharded);
+
+// 받은 요청 하나를 로그에 남김 (비동기 로거, logger.h)
+// - peer/peer_id: 보낸 쪽 표시 (예: "클라이언트", 7)
+// 텍스트 요청은 비밀번호/세션 토큰/메모 내용을 가려서 남기고, 바이너리 요청은 명령 코드와 크기만 남긴다.
+void dispatch_log_request(const char *peer, long long peer_id, const char *request, size_t len, bool binary);
+
+// 느린 일괄 작업(DOWNLOAD_ALL, MEMO_SEARCH, DELETE_USER) 요청인지 판별 (null 문자로 끝나지 않아도 됨)
+// 워커 풀/샤드는 이런 요청을 낮은 우선순위로 동시 실행 수를 제한해서 처리하고, 조회 같은 대화형 요청이 뒤에서 기다리지 않게 한다.
+// (검색은 계정의 메모 수를 잠금 없이 알 수 없으므로 크기와 상관없이 모두 일괄 작업으로 본다.)
+bool dispatch_is_bulk(const char *request, size_t len, bool binary);
+
+// 요청이 다루는 사용자의 저장소 파티션 번호 (store_partition.h)
+// 사용자 ID 대신 세션 토큰(session.h)이 오면 토큰에 든 파티션 번호를 사용한다.
+// - request/len: 요청 (null 문자로 끝나지 않아도 됨), binary: 바이너리 요청 여부
+// 반환값: 사용자 ID가 없는 요청(EXIT 등)이면 -1 (어느 샤드에서 처리해도 됨)
+int dispatch_partition(const char *request, size_t len, bool binary);
+
+#endif
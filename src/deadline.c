@@ -0,0 +1,113 @@
+// src/deadline.c
+
+#include "deadline.h"
+#include "platform.h"
+
+#define DEADLINE_KINDS (SHED_CLASS_EXPORT + 1) // 평균을 재는 명령 종류 수
+#define AVERAGE_SHIFT 3                        // 평균에 새 값을 반영하는 비율 (1/8)
+
+// 현재 스레드가 처리 중인 요청
+static _Thread_local unsigned long long t_deadline_ms = 0; // 기한 (0이면 없음)
+static _Thread_local bool t_expired = false;               // 확인 지점에서 기한이 지났다고 판단했는지 여부
+static _Thread_local bool t_measuring = false;             // CPU 시간을 재는 중인지 여부
+static _Thread_local unsigned long long t_cpu_start = 0;   // 처리 시작 시 스레드 CPU 시간
+static _Thread_local ShedClass t_kind = SHED_CLASS_KEEP;   // 명령 종류
+
+// 기한이 붙은 요청을 받은 적이 있는지 여부 (그 전에는 CPU 시간을 재지 않음)
+static bool g_seen = false;
+// 끝까지 처리한 요청의 종류별 평균 CPU 시간 (마이크로초, 여러 스레드가 갱신하므로 근사값)
+static unsigned long long g_average_us[DEADLINE_KINDS];
+
+// 통계 (모두 원자적으로 접근)
+static unsigned long long g_skipped = 0;
+static unsigned long long g_abandoned = 0;
+static unsigned long long g_saved_us = 0;
+static unsigned long long g_wasted_us = 0;
+
+// 현재 스레드에서 요청 하나의 처리를 시작
+bool deadline_begin(unsigned long long deadline_ms, ShedClass kind)
+{
+    if (deadline_ms != 0)
+    {
+        if (!__atomic_load_n(&g_seen, __ATOMIC_RELAXED))
+            __atomic_store_n(&g_seen, true, __ATOMIC_RELAXED);
+        // 대기열이나 잠금을 기다리는 동안 이미 지났으면 평균 전체를 아낀 것으로 셈
+        if (ps_now_ms() >= deadline_ms)
+        {
+            __atomic_fetch_add(&g_skipped, 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&g_saved_us, __atomic_load_n(&g_average_us[kind], __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+            return false;
+        }
+    }
+    t_deadline_ms = deadline_ms;
+    t_expired = false;
+    t_kind = kind;
+    t_measuring = __atomic_load_n(&g_seen, __ATOMIC_RELAXED);
+    if (t_measuring)
+        t_cpu_start = ps_thread_cpu_us();
+    return true;
+}
+
+// 현재 스레드가 처리 중인 요청의 기한이 지났는지 확인
+bool deadline_expired(void)
+{
+    if (t_deadline_ms == 0)
+        return false;
+    if (!t_expired && ps_now_ms() >= t_deadline_ms)
+        t_expired = true;
+    return t_expired;
+}
+
+// 현재 스레드의 요청 처리를 마침
+bool deadline_end(void)
+{
+    bool abandoned = t_expired;
+    if (t_measuring)
+    {
+        unsigned long long spent = ps_thread_cpu_us() - t_cpu_start;
+        unsigned long long average = __atomic_load_n(&g_average_us[t_kind], __ATOMIC_RELAXED);
+        if (abandoned)
+        {
+            // 평균보다 오래 쓰고 멈췄으면 아낀 것은 없다고 봄
+            __atomic_fetch_add(&g_wasted_us, spent, __ATOMIC_RELAXED);
+            if (average > spent)
+                __atomic_fetch_add(&g_saved_us, average - spent, __ATOMIC_RELAXED);
+        }
+        else
+        {
+            // 중단한 요청은 평균에 넣지 않음 (넣으면 평균이 점점 작아짐)
+            unsigned long long next = average == 0 ? spent : average - (average >> AVERAGE_SHIFT) + (spent >> AVERAGE_SHIFT);
+            __atomic_store_n(&g_average_us[t_kind], next, __ATOMIC_RELAXED);
+        }
+    }
+    if (abandoned)
+        __atomic_fetch_add(&g_abandoned, 1, __ATOMIC_RELAXED);
+    t_deadline_ms = 0;
+    t_expired = false;
+    t_measuring = false;
+    return abandoned;
+}
+
+// 시작 전에 기한이 지나 처리하지 않은 요청 수
+unsigned long long deadline_skipped(void)
+{
+    return __atomic_load_n(&g_skipped, __ATOMIC_RELAXED);
+}
+
+// 처리 도중 기한이 지나 중단한 요청 수
+unsigned long long deadline_abandoned(void)
+{
+    return __atomic_load_n(&g_abandoned, __ATOMIC_RELAXED);
+}
+
+// 아낀 것으로 추정한 CPU 시간
+unsigned long long deadline_saved_us(void)
+{
+    return __atomic_load_n(&g_saved_us, __ATOMIC_RELAXED);
+}
+
+// 중단한 요청이 멈추기 전까지 쓴 CPU 시간
+unsigned long long deadline_wasted_us(void)
+{
+    return __atomic_load_n(&g_wasted_us, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,44 @@
+// src/deadline.h
+
+#ifndef DEADLINE_H
+#define DEADLINE_H
+
+#include <stdbool.h>
+#include "load_shed.h"
+
+// 요청 기한 (deadline)과 기한이 지난 작업의 중단
+//
+// 클라이언트는 프레임에 제한 시간(FRAME_FLAG_DEADLINE, frame.h)을 붙여 그 시간이 지나면 응답을 기다리지 않는다고 알린다.
+// 프레임을 받은 쪽(이벤트 루프, 연결 스레드, 공유 메모리 채널)이 받은 시각 + 제한 시간을 기한으로 기록해 디스패처에 넘기고,
+// 디스패처는 핸들러를 실행하기 전에 deadline_begin으로 기한을 현재 스레드에 걸어 둔다.
+//  - 대기열이나 저장소 잠금을 기다리는 동안 이미 기한이 지났으면 핸들러를 아예 실행하지 않는다.
+//  - 검색/내보내기처럼 메모를 하나씩 도는 반복문은 메모 사이에서 deadline_expired()를 확인하고, 지났으면 남은 메모를 건너뛴다.
+//  - 중간에 멈춘 요청의 응답은 디스패처가 만든 응답 대신 기한 초과 응답(REPLY_EXPIRED)으로 바꾼다.
+// 기한은 스레드별 변수에 두므로 핸들러와 반복문의 인자를 바꾸지 않아도 된다. (한 스레드는 한 번에 요청 하나만 처리)
+//
+// 아낀 CPU 시간은 추정값이다. 기한이 붙은 요청을 한 번이라도 받은 뒤로는 요청마다 스레드 CPU 시간을 재서
+// 끝까지 처리한 요청의 종류별(ShedClass) 평균을 두고, 시작 전에 버린 요청은 평균 전체,
+// 중간에 멈춘 요청은 (평균 - 멈추기 전까지 쓴 시간)을 아낀 것으로 센다.
+
+// 현재 스레드에서 요청 하나의 처리를 시작
+// - deadline_ms: 기한 (ps_now_ms 기준, 0이면 기한 없음)
+// - kind: 명령 종류 (평균 CPU 시간을 따로 재는 단위)
+// 반환값: 처리해도 되면 true, 이미 기한이 지났으면 false (핸들러를 실행하지 말고 바로 기한 초과 응답)
+// false를 반환했으면 deadline_end를 호출하지 않는다.
+bool deadline_begin(unsigned long long deadline_ms, ShedClass kind);
+
+// 현재 스레드가 처리 중인 요청의 기한이 지났는지 확인 (반복문의 확인 지점에서 호출)
+// 기한이 없으면 시계를 읽지 않고 바로 false를 반환하며, 한 번 지났다고 판단하면 그 요청이 끝날 때까지 계속 true다.
+bool deadline_expired(void);
+
+// 현재 스레드의 요청 처리를 마침
+// 반환값: 처리 도중 기한이 지나 작업을 중단했으면 true (호출자가 응답을 기한 초과 응답으로 바꿔야 함)
+bool deadline_end(void);
+
+// 통계 (서버 종료 시 로그용)
+unsigned long long deadline_skipped(void);   // 시작 전에 기한이 지나 처리하지 않은 요청 수
+unsigned long long deadline_abandoned(void); // 처리 도중 기한이 지나 중단한 요청 수
+unsigned long long deadline_saved_us(void);  // 아낀 것으로 추정한 CPU 시간 (마이크로초)
+unsigned long long deadline_wasted_us(void); // 중단한 요청이 멈추기 전까지 쓴 CPU 시간 (마이크로초)
+
+#endif
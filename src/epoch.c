@@ -0,0 +1,129 @@
+// src/epoch.c
+
+#include "epoch.h"
+#include "platform.h"
+#include <stdlib.h>
+
+#define EPOCH_STRIPES 64     // 읽기 카운터 칸 수 (스레드마다 하나를 골라 씀)
+#define CACHE_LINE_SIZE 64   // 칸 하나의 크기
+
+// 읽기 카운터 칸 하나 (에포크 홀짝별 읽는 중인 스레드 수, 다른 칸과 캐시 줄을 나누지 않음)
+typedef struct
+{
+    uint64_t readers[2];
+    char pad[CACHE_LINE_SIZE - 2 * sizeof(uint64_t)];
+} EpochStripe;
+
+static EpochStripe g_stripes[EPOCH_STRIPES]; // 읽기 카운터 (원자적으로 접근)
+static uint64_t g_epoch = 2;                 // 전역 에포크 (원자적으로 접근, 쓰는 쪽은 g_retire_lock을 잡고 증가)
+static int g_next_stripe = 0;                // 다음 스레드에 줄 칸 번호 (원자적으로 증가)
+
+static ps_mutex_t g_retire_lock = PS_MUTEX_INITIALIZER; // 대기 목록과 에포크 증가 보호
+static EpochRetired *g_retired = NULL;                  // 해제 대기 목록 (최근 항목부터, 에포크는 뒤로 갈수록 작거나 같음)
+
+// 현재 스레드의 읽기 상태
+static _Thread_local int t_stripe = -1; // 쓰는 칸 (처음 구간에 들어갈 때 정함)
+static _Thread_local int t_depth = 0;   // 겹친 구간 수
+static _Thread_local int t_parity = 0;  // 구간에 들어갈 때 늘린 카운터의 홀짝
+
+// 읽기 구간 시작
+void epoch_enter(void)
+{
+    if (t_depth++ > 0)
+        return;
+    if (t_stripe < 0)
+        t_stripe = (int)((unsigned)__atomic_fetch_add(&g_next_stripe, 1, __ATOMIC_RELAXED) % EPOCH_STRIPES);
+    t_parity = (int)(__atomic_load_n(&g_epoch, __ATOMIC_RELAXED) & 1);
+    __atomic_fetch_add(&g_stripes[t_stripe].readers[t_parity], 1, __ATOMIC_RELAXED);
+    // 카운터를 늘린 것이 쓰는 쪽에 보이기 전에 공유 포인터를 읽지 않도록 (epoch_retire의 울타리와 짝)
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+// 읽기 구간 끝
+void epoch_exit(void)
+{
+    if (--t_depth > 0)
+        return;
+    __atomic_fetch_sub(&g_stripes[t_stripe].readers[t_parity], 1, __ATOMIC_RELEASE);
+}
+
+// 홀짝이 parity인 에포크에 들어간 읽기가 모두 끝났는지 확인
+static bool readers_gone(int parity)
+{
+    for (int i = 0; i < EPOCH_STRIPES; i++)
+    {
+        if (__atomic_load_n(&g_stripes[i].readers[parity], __ATOMIC_ACQUIRE) != 0)
+            return false;
+    }
+    return true;
+}
+
+// 넘길 수 있는 만큼 에포크를 넘김 (g_retire_lock을 잡고 호출, 최대 두 번)
+// 에포크 e에서 e + 1로 넘기려면 e - 1에 들어간 읽기(e + 1과 홀짝이 같음)가 모두 끝나야 한다.
+// 그러면 에포크 t에 넘겨받은 항목은 에포크가 t + 2가 된 뒤로 어느 읽기도 가리키지 않는다.
+static uint64_t advance_epoch(void)
+{
+    uint64_t epoch = __atomic_load_n(&g_epoch, __ATOMIC_RELAXED);
+    for (int step = 0; step < 2 && readers_gone((int)((epoch + 1) & 1)); step++)
+    {
+        epoch++;
+        __atomic_store_n(&g_epoch, epoch, __ATOMIC_SEQ_CST);
+    }
+    return epoch;
+}
+
+// 대기 목록에서 에포크가 limit 이하인 항목들을 떼어 냄 (g_retire_lock을 잡고 호출)
+static EpochRetired *take_expired(uint64_t limit)
+{
+    EpochRetired **link = &g_retired;
+    while (*link && (*link)->epoch > limit)
+    {
+        link = &(*link)->next;
+    }
+    EpochRetired *expired = *link;
+    *link = NULL;
+    return expired;
+}
+
+// 떼어 낸 항목들 해제 (잠금 밖에서, release가 다시 epoch_retire를 불러도 됨)
+static void release_all(EpochRetired *item)
+{
+    while (item)
+    {
+        EpochRetired *next = item->next;
+        item->release(item);
+        item = next;
+    }
+}
+
+// 해제를 미룸
+void epoch_retire(EpochRetired *item, void (*release)(EpochRetired *item))
+{
+    // 포인터를 바꿔 끼운 것이 읽는 쪽에 보인 뒤에 카운터를 확인하도록 (epoch_enter의 울타리와 짝)
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    item->release = release;
+    ps_mutex_lock(&g_retire_lock);
+    item->epoch = __atomic_load_n(&g_epoch, __ATOMIC_RELAXED);
+    item->next = g_retired;
+    g_retired = item;
+    uint64_t epoch = advance_epoch();
+    EpochRetired *expired = take_expired(epoch - 2);
+    ps_mutex_unlock(&g_retire_lock);
+    release_all(expired);
+}
+
+// malloc 블록을 그대로 해제
+void epoch_free(EpochRetired *item)
+{
+    free(item);
+}
+
+// 남은 대기 항목을 모두 해제
+void epoch_drain(void)
+{
+    ps_mutex_lock(&g_retire_lock);
+    EpochRetired *all = g_retired;
+    g_retired = NULL;
+    ps_mutex_unlock(&g_retire_lock);
+    release_all(all);
+}
@@ -0,0 +1,42 @@
+// src/epoch.h
+
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <stdint.h>
+
+// 에포크 기반 메모리 회수 (잠그지 않고 읽는 자료구조용)
+//
+// 읽는 쪽은 epoch_enter/epoch_exit 사이에서 공유 포인터를 원자적으로 읽어 그 대상을 잠금 없이 사용한다.
+// 쓰는 쪽은 새 판을 만들어 포인터를 바꿔 끼운 뒤, 이전 판을 바로 해제하지 않고 epoch_retire로 넘긴다.
+// 넘겨받은 항목은 그 시점에 읽고 있던 스레드가 모두 구간을 벗어난 뒤(에포크가 두 번 넘어간 뒤)에 해제한다.
+//  - 읽는 쪽은 전역 에포크의 홀짝에 해당하는 카운터를 늘리고 줄이기만 한다. (기다리거나 잠그지 않음)
+//    카운터는 캐시 줄 단위로 나눈 여러 칸에 흩어 두어 스레드끼리 같은 줄을 두고 다투지 않게 한다.
+//  - 에포크는 지난 홀짝의 읽기가 모두 끝났을 때만 넘어간다. 쓰는 쪽도 기다리지 않고, 넘길 수 있을 때만 넘긴다.
+//    (해제가 밀린 항목은 다음 epoch_retire에서 다시 확인)
+// 해제 대기 목록은 항목에 넣어 둔 EpochRetired로 잇기 때문에 epoch_retire는 메모리를 할당하지 않는다.
+
+// 해제 대기 항목 (해제할 구조체 안에 넣어 둠)
+typedef struct EpochRetired
+{
+    struct EpochRetired *next;                   // 대기 목록의 다음 항목
+    void (*release)(struct EpochRetired *item); // 해제 함수
+    uint64_t epoch;                              // 넘겨받은 시점의 에포크
+} EpochRetired;
+
+// 읽기 구간 시작/끝 (같은 스레드에서 겹쳐 호출해도 됨)
+// 구간 안에서 읽은 공유 포인터는 구간이 끝날 때까지 해제되지 않는다.
+void epoch_enter(void);
+void epoch_exit(void);
+
+// 더 이상 공유 포인터로 닿을 수 없게 된 항목의 해제를 미룸 (쓰는 쪽, 포인터를 바꿔 끼운 뒤 호출)
+// 지금 읽고 있는 스레드가 모두 구간을 벗어나면 release(item)을 호출한다. (호출하는 스레드는 정해져 있지 않음)
+void epoch_retire(EpochRetired *item, void (*release)(EpochRetired *item));
+
+// EpochRetired를 첫 멤버로 둔 malloc 블록을 그대로 해제하는 release 함수
+void epoch_free(EpochRetired *item);
+
+// 남은 대기 항목을 모두 해제 (종료 시, 읽는 스레드가 없을 때만 호출)
+void epoch_drain(void);
+
+#endif
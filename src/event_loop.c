@@ -0,0 +1,1890 @@
+// src/event_loop.c
+
+#define _GNU_SOURCE // pthread_setaffinity_np (샤드 스레드 CPU 고정)
+
+#include "event_loop.h"
+#include "command_dispatch.h"
+#include "worker_pool.h"
+#include "server_config.h"
+#include "frame.h"
+#include "uring.h"
+#include "mpsc_queue.h"
+#include "timer_wheel.h"
+#include "load_shed.h"
+#include "store_partition.h"
+#include "platform.h"
+#include "logger.h"
+#include "output_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <limits.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/resource.h>
+
+#define READ_BUF_SIZE 65536                       // 한 번에 읽을 최대 바이트 수
+#define LEGACY_BUF_SIZE 2048                      // 길이 헤더 없는 이전 클라이언트의 요청 최대 크기
+#define MAX_EVENTS 256                            // epoll_wait 한 번에 처리할 최대 이벤트 수
+#define PIPELINE_MAX_BATCH 32                     // 워커에게 한 번에 넘기는 최대 요청 수
+#define INPUT_HIGH_WATER (FRAME_MAX_REQUEST * 2)  // 처리 중일 때 미리 받아 둘 최대 바이트 수
+#define MAX_TAGGED_INFLIGHT 64                    // 연결당 동시에 처리할 수 있는 요청 ID 지정 요청 수
+#define URING_ENTRIES 4096                        // io_uring 제출 큐 크기
+#define URING_BUF_GROUP 0                         // io_uring 수신 버퍼 그룹 ID
+#define URING_BUF_COUNT 1024                      // io_uring 수신 버퍼 수 (2의 거듭제곱)
+#define URING_BUF_SIZE 16384                      // io_uring 수신 버퍼 하나의 크기
+#define URING_SEND_IOV 16                         // io_uring 전송 요청 하나에 담는 최대 청크 수
+#define FLUSH_IOV 64                              // epoll 방식에서 송신 대기열을 sendmsg 한 번에 보내는 최대 청크 수
+#define IDLE_TICK_MS 100                          // 유휴 시간 타이머 휠의 틱 길이 (종료/확인 시각의 오차)
+#define SHED_BUSY_WAIT_US 100                     // 대기가 이보다 짧게 끝나면 잠들지 않고 바로 돌아온 것으로 봄 (부하 조절)
+
+// io_uring 요청 종류 (user_data 하위 2비트, 상위 비트는 연결 구조체 주소)
+#define URING_OP_MASK 3ULL
+#define URING_OP_WAKEUP 0ULL // 워커 완료 알림 eventfd 읽기 (서버 소켓 주소가 붙으면 연결 수락 취소)
+#define URING_OP_ACCEPT 1ULL // 연결 수락 (multishot: 한 번 제출로 계속 수락)
+#define URING_OP_RECV 2ULL   // 수신 (커널이 버퍼 링에서 버퍼를 골라 채움)
+#define URING_OP_SEND 3ULL   // 전송
+
+// 연결의 통신 방식 (첫 바이트로 판별)
+typedef enum
+{
+    WIRE_UNKNOWN, // 아직 첫 요청을 받지 않음
+    WIRE_LEGACY,  // 길이 헤더 없이 recv 한 번을 요청 하나로 취급하는 이전 방식
+    WIRE_FRAMED   // 길이 헤더가 붙은 프레임 방식 (frame.h)
+} WireMode;
+
+struct Shard;
+
+// 클라이언트 연결 상태
+// 유휴 연결은 이 구조체 하나만 차지하고, 덜 받은 요청이나 보내지 못한 응답이 있을 때만 버퍼를 할당한다.
+// 보내지 못한 응답은 공유 풀의 청크로 된 송신 대기열(output_pool.h)에 두며, 대기열이 기준 이상 쌓이면 새 요청을 읽지 않는다.
+typedef struct Connection
+{
+    struct Shard *shard;   // 연결을 맡은 샤드 (연결의 모든 입출력은 이 샤드의 스레드에서만 처리)
+    int fd;                // 클라이언트 소켓 (닫힌 뒤에는 -1)
+    WireMode mode;         // 통신 방식
+    uint32_t events;       // 현재 epoll에 등록된 관심 이벤트
+    ReplyBuffer in;        // 아직 처리하지 않은 수신 데이터 (프레임 방식)
+    OutputQueue out;       // 아직 전송하지 못한 응답 (io_uring 방식은 커널에 맡긴 부분 포함)
+    bool close_after_send; // 송신 대기열을 다 보낸 뒤 연결 종료 여부 (EXIT)
+    bool busy;             // 워커가 이 연결의 순서 있는(ID 없는) 요청 묶음을 처리 중인지 여부
+    int tagged_inflight;   // 워커가 처리 중인 요청 ID 지정 요청 수
+    bool greeted;          // 첫 요청(HELLO 협상 기회)을 이미 받았는지 여부
+    bool binary;           // HELLO로 바이너리 프로토콜을 협상했는지 여부
+    // io_uring 방식 전용
+    bool sending;          // 커널에 송신 대기열 앞부분의 전송을 맡겼는지 여부 (완료될 때까지 그 청크들을 유지, 새 응답은 뒤에 붙임)
+    struct msghdr send_msg; // 커널에 맡긴 전송 요청 (완료될 때까지 유지)
+    struct iovec send_iov[URING_SEND_IOV]; // 커널에 맡긴 청크들
+    bool recv_armed;       // 커널에 수신 요청이 걸려 있는지 여부
+    int linger_fd;         // 연결 종료 후 커널 요청이 모두 끝나면 닫을 소켓 (없으면 -1)
+    // 유휴 시간 관리 (--idle-timeout, --keepalive)
+    TimerNode idle_timer;    // 다음 유휴 시간 확인 타이머 (샤드의 타이머 휠에 등록)
+    uint64_t last_active_ms; // 마지막으로 데이터를 받은 시각
+    uint64_t last_ping_ms;   // 마지막으로 연결 확인 프레임을 보낸 시각
+    bool keepalive;          // HELLO로 연결 확인 프레임(PING)을 협상했는지 여부
+    RateLimit limit;         // 연결의 요청 빈도 제한 버킷 (요청을 처리하는 워커/샤드가 원자적으로 갱신)
+    struct Connection *prev; // 샤드의 열린 연결 목록 (연결 정리 시 순회)
+    struct Connection *next;
+} Connection;
+
+// 묶음 안의 요청 하나
+typedef struct
+{
+    char *request;      // 요청 문자열 (작업의 input 버퍼 안을 가리킴)
+    size_t request_len; // 요청 길이 (바이너리 요청은 null 문자를 포함할 수 있음)
+    unsigned long long deadline_ms; // 기한 (프레임을 받은 시각 + 제한 시간, 0이면 없음)
+    ReplyBuffer reply;  // 워커가 채우는 응답
+} PipelinedRequest;
+
+// 워커에게 넘기는 요청 묶음
+// 클라이언트가 응답을 기다리지 않고 연달아 보낸(파이프라인) 요청들을 한 번에 넘기고,
+// 워커는 순서대로 처리하며, 응답은 writev 한 번으로 모아서 보낸다.
+// 요청 ID가 붙은 요청은 하나씩 별도 작업으로 넘겨 다른 요청과 상관없이 완료되는 대로 응답한다.
+// 샤드 모드에서는 워커 대신 사용자의 파티션을 맡은 샤드가 처리하며, 한 묶음에는 같은 파티션의 요청만 담는다.
+typedef struct RequestJob
+{
+    WorkerTask task;         // 워커 풀 작업 (반드시 첫 멤버)
+    MpscNode link;           // 샤드 간 큐(다른 샤드의 처리 대기 / 요청을 보낸 샤드의 완료) 연결 노드
+    Connection *conn;        // 요청을 보낸 연결 (요청을 보낸 샤드만 접근)
+    RateLimit *limit;        // 요청을 보낸 연결의 빈도 제한 버킷 (처리하는 스레드가 사용, 작업이 끝날 때까지 연결이 유지됨)
+    struct Shard *origin;    // 요청을 보낸 연결의 샤드 (처리 후 여기로 돌려보냄)
+    int partition;           // 요청들이 다루는 사용자의 저장소 파티션 (사용자 없는 요청뿐이면 -1)
+    char *input;             // 요청 문자열들이 들어 있는 버퍼
+    int count;               // 묶음에 담긴 요청 수
+    int processed;           // 실제로 처리한 요청 수 (EXIT 뒤의 요청은 처리하지 않음)
+    bool keep_open;          // EXIT가 없었으면 true
+    bool tagged;             // 요청 ID 지정 요청인지 여부 (이 경우 count는 1)
+    bool binary;             // 바이너리 프로토콜을 협상한 연결의 요청인지 여부
+    bool bulk;               // 일괄 작업(DOWNLOAD_ALL 등) 요청인지 여부 (이 경우 count는 1, 낮은 우선순위로 처리)
+    uint32_t request_id;     // 요청 ID
+    unsigned long long queued_us; // 요청들이 도착했다고 보는 시각 (부하 조절의 체류 시간 기준)
+    struct RequestJob *next; // 샤드 안의 완료 대기 목록 연결 포인터
+    PipelinedRequest items[]; // 요청 목록
+} RequestJob;
+
+// 이벤트 루프 하나와 그 루프가 맡은 연결들
+// 기본 모드는 샤드 하나(메인 스레드)가 모든 연결을 받고 명령어 처리는 워커 풀에 맡긴다.
+// 샤드 모드(--shards N)는 코어마다 샤드 하나가 자기 리스너(SO_REUSEPORT)로 연결을 받고,
+// 사용자 ID의 파티션 i에 해당하는 요청은 샤드 i가 직접 처리한다. (다른 샤드의 요청은 inbox로 넘김)
+typedef struct Shard
+{
+    int index;               // 샤드 번호 (= 맡은 저장소 파티션 번호)
+    ps_thread_t thread;      // 샤드 스레드 (샤드 0은 메인 스레드에서 실행)
+    int listen_fd;           // 서버 소켓
+    int epoll_fd;            // epoll 인스턴스 (epoll 방식)
+    Connection listener;     // 서버 소켓 식별용 (epoll data.ptr / io_uring user_data 비교)
+    Connection local_listener; // 로컬(AF_UNIX) 서버 소켓 식별용 (샤드 0만 사용, fd가 -1이면 없음)
+    Connection wakeup;       // 완료 알림 eventfd 식별용
+    int connection_count;    // 현재 연결 수
+    Connection *connections; // 열린 연결 목록 헤드
+    bool draining;           // 연결 정리 중 (새 연결 수락을 멈춤)
+    bool drained;            // 이 샤드의 연결을 모두 닫음
+    bool use_uring;          // io_uring 방식 사용 여부 (false면 epoll)
+    Uring ring;              // io_uring 인스턴스
+    uint64_t wakeup_value;   // io_uring으로 읽은 eventfd 값
+    bool failed;             // 초기화 실패 여부
+
+    MpscQueue done;          // 처리가 끝난 작업 (워커 또는 다른 샤드 → 이 샤드)
+    MpscQueue inbox;         // 이 샤드의 파티션에 속한 다른 샤드의 작업 (샤드 모드)
+    RequestJob *ready_head;  // 이 샤드가 바로 처리하고 응답을 기다리는 작업 목록 헤드 (샤드 모드)
+    RequestJob *ready_tail;  // 이 샤드가 바로 처리하고 응답을 기다리는 작업 목록 꼬리
+    RequestJob *bulk_head;   // 이 샤드의 파티션에 속한 처리 대기 일괄 작업 목록 헤드 (샤드 모드, 한 바퀴에 bulk_limit개씩 처리)
+    RequestJob *bulk_tail;   // 처리 대기 일괄 작업 목록 꼬리
+    uint64_t wake_mask;      // 다음 대기 전에 깨울 샤드 (비트 i = 샤드 i)
+    TimerWheel timers;       // 연결들의 유휴 시간 타이머 (이 샤드의 스레드만 사용)
+    uint64_t now_ms;         // 마지막 대기에서 깨어난 시각 (타이머를 쓸 때만 갱신)
+    // 부하 조절(--shed-target)을 쓸 때만 갱신하는 시각 (마이크로초)
+    unsigned long long wait_start_us; // 마지막 대기를 시작한 시각
+    unsigned long long wake_us;       // 마지막 대기에서 깨어난 시각
+    unsigned long long arrival_us;    // 이번 바퀴에 받은 데이터가 도착했다고 보는 시각 (요청 묶음의 체류 시간 기준)
+
+    unsigned long long io_syscalls;   // 호출한 입출력 시스템 콜 수 (io_uring 방식은 io_uring_enter 제외)
+    unsigned long long request_total; // 처리를 맡긴 요청 수
+    unsigned long long forwarded;     // 다른 샤드로 넘긴 요청 묶음 수
+    char read_buf[READ_BUF_SIZE];     // 이 샤드의 모든 연결이 공유하는 수신 버퍼
+} Shard;
+
+// 전역 변수
+static volatile sig_atomic_t g_stop_requested = 0; // 종료 요청 플래그
+static Shard *g_shards = NULL;                     // 샤드 배열
+static volatile int g_shard_total = 0;             // 샤드 수 (시그널 핸들러가 읽음)
+static bool g_sharded = false;                     // 샤드 모드 여부 (false면 샤드 하나 + 워커 풀)
+static bool g_idle_timers = false;                 // 유휴 시간 종료 또는 연결 확인을 사용하는지 여부
+static int g_drain_requested = 0;                  // 연결 정리 요청 플래그 (원자적으로 접근)
+static unsigned long long g_drain_deadline_ms = 0; // 연결 정리 제한 시각 (g_drain_requested보다 먼저 씀)
+static int g_drained_shards = 0;                   // 연결 정리를 마친 샤드 수 (원자적으로 접근)
+static ps_mutex_t g_shards_lock = PS_MUTEX_INITIALIZER; // event_loop_drain이 샤드를 깨우는 동안 샤드 배열을 해제하지 않도록 보호
+static int g_listen_fds[MAX_STORE_PARTITIONS];     // 넘겨받은(실행 전) 또는 남겨 둔(실행 후) 샤드 리스너
+static int g_listen_count = 0;                     // g_listen_fds의 리스너 수
+
+static void process_input(Connection *conn);
+static void uring_arm_recv(Connection *conn);
+static bool uring_start_send(Connection *conn);
+
+// 소켓을 논블로킹 모드로 설정
+static bool set_nonblocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags < 0)
+        return false;
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// 열 수 있는 파일 디스크립터 수를 하드 리밋까지 올림 (수만 개의 동시 연결 대비)
+static void raise_fd_limit(void)
+{
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max)
+    {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+}
+
+// 연결 상태에 맞게 epoll 관심 이벤트 갱신 (바뀐 경우에만 시스템 콜 호출)
+//  - 보낼 응답이 밀려 있으면 EPOLLOUT을 기다림 (응답은 송신 대기열 순서대로 나가므로 요청/응답 순서는 유지됨)
+//  - 송신 대기열이 기준 이상이거나 풀이 거의 찼으면 더 읽지 않음 (클라이언트가 응답을 읽을 때까지 새 요청을 받지 않음)
+//  - 이전 방식 연결은 처리 중에 더 읽지 않음 (요청 경계를 알 수 없음)
+//  - 프레임 방식 연결은 처리 중에도 INPUT_HIGH_WATER까지 다음 요청을 미리 받아 둠
+//  - io_uring 방식은 수신을 원할 때 수신 요청만 걸어 둠 (전송은 send_iov에서 바로 커널에 맡김)
+static void refresh_interest(Connection *conn)
+{
+    uint32_t events = EPOLLIN;
+    if (output_pool_should_pause(&conn->out) || conn->close_after_send)
+        events = 0;
+    else if (conn->busy && conn->mode != WIRE_FRAMED)
+        events = 0;
+    else if (conn->in.len >= INPUT_HIGH_WATER)
+        events = 0;
+    if (conn->shard->use_uring)
+    {
+        if (events == EPOLLIN && !conn->recv_armed)
+            uring_arm_recv(conn);
+        return;
+    }
+    if (conn->out.bytes > 0)
+        events |= EPOLLOUT;
+    if (events == conn->events)
+        return;
+    struct epoll_event ev = {0};
+    ev.events = events;
+    ev.data.ptr = conn;
+    conn->shard->io_syscalls++;
+    epoll_ctl(conn->shard->epoll_fd, EPOLL_CTL_MOD, conn->fd, &ev);
+    conn->events = events;
+}
+
+// 요청 count개를 담을 작업 생성
+static RequestJob *alloc_job(Connection *conn, int count)
+{
+    RequestJob *job = (RequestJob *)malloc(sizeof(RequestJob) + count * sizeof(PipelinedRequest));
+    if (!job)
+        return NULL;
+    job->conn = conn;
+    job->origin = conn->shard;
+    job->limit = &conn->limit;
+    job->partition = -1;
+    job->input = NULL;
+    job->count = count;
+    job->processed = 0;
+    job->keep_open = true;
+    job->tagged = false;
+    job->binary = conn->binary;
+    job->bulk = false;
+    job->request_id = 0;
+    job->queued_us = conn->shard->arrival_us;
+    for (int i = 0; i < count; i++)
+    {
+        job->items[i].request = NULL;
+        job->items[i].request_len = 0;
+        job->items[i].deadline_ms = 0;
+        reply_init(&job->items[i].reply);
+        // 응답은 sendmsg로 조각째 보내므로 큰 외부 바이트(내보내기의 메모 내용 등)는 복사하지 않음
+        job->items[i].reply.gather = true;
+    }
+    return job;
+}
+
+// 작업 메모리 해제
+static void free_job(RequestJob *job)
+{
+    for (int i = 0; i < job->count; i++)
+    {
+        reply_free(&job->items[i].reply);
+    }
+    free(job->input);
+    free(job);
+}
+
+// 샤드 간 큐 노드 → 작업
+static RequestJob *job_of(MpscNode *node)
+{
+    return (RequestJob *)((char *)node - offsetof(RequestJob, link));
+}
+
+// 연결 구조체 해제
+// 워커나 커널(io_uring)이 아직 사용 중이면 아무것도 하지 않고, 마지막 사용이 끝나는 시점에 다시 호출된다.
+static void release_connection(Connection *conn)
+{
+    if (conn->busy || conn->tagged_inflight > 0 || conn->recv_armed || conn->sending)
+        return;
+    if (conn->linger_fd >= 0)
+        close(conn->linger_fd);
+    free(conn);
+}
+
+// 연결 종료 및 자원 해제
+// 워커가 아직 요청을 처리 중이면 소켓만 닫고, 구조체는 마지막 작업이 완료되는 시점에 해제한다.
+static void close_connection(Connection *conn)
+{
+    Shard *shard = conn->shard;
+    logger_write(LOG_LEVEL_INFO, "[서버] 클라이언트 %d 연결 해제됨", conn->fd);
+    if (shard->use_uring)
+    {
+        // 커널에 걸린 수신/전송 요청이 바로 끝나도록 shutdown만 하고, 소켓은 요청이 모두 완료된 뒤 닫음
+        // (바로 닫으면 같은 번호가 새 연결에 재사용되어 남은 요청의 대상이 바뀔 수 있음)
+        shutdown(conn->fd, SHUT_RDWR);
+        conn->linger_fd = conn->fd;
+    }
+    else
+    {
+        // epoll에서 제거 후 소켓 닫기
+        shard->io_syscalls++;
+        epoll_ctl(shard->epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+        close(conn->fd);
+    }
+    conn->fd = -1;
+    // 열린 연결 목록에서 제거
+    if (conn->prev)
+        conn->prev->next = conn->next;
+    else
+        shard->connections = conn->next;
+    if (conn->next)
+        conn->next->prev = conn->prev;
+    timer_wheel_cancel(&shard->timers, &conn->idle_timer);
+    // 커널이 전송 중인 청크를 읽고 있으면 전송이 끝난 뒤에 돌려줌 (uring_sent)
+    if (!conn->sending)
+        output_queue_free(&conn->out);
+    reply_free(&conn->in);
+    shard->connection_count--;
+    release_connection(conn);
+}
+
+// 연결 정리 중 닫아도 되는 연결인지 확인 (처리 중인 요청, 보내지 못한 응답, 받아 두거나 도착한 데이터가 모두 없음)
+static bool connection_idle(Connection *conn)
+{
+    if (conn->busy || conn->tagged_inflight > 0 || conn->out.bytes > 0 || conn->in.len > 0)
+        return false;
+    // 도착했지만 아직 읽지 않은 요청이 있으면 처리하고 응답한 뒤에 닫음 (상대가 이미 끊었으면 0)
+    char byte;
+    return recv(conn->fd, &byte, 1, MSG_PEEK | MSG_DONTWAIT) <= 0;
+}
+
+// 송신 대기열의 응답을 가능한 만큼 전송 (epoll 방식)
+// 반환값: 연결이 유효하면 true, 전송 오류로 연결을 닫아야 하면 false
+static bool flush_pending(Connection *conn)
+{
+    while (conn->out.bytes > 0)
+    {
+        struct iovec iov[FLUSH_IOV];
+        struct msghdr msg = {0};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = output_queue_peek(&conn->out, iov, FLUSH_IOV);
+        conn->shard->io_syscalls++;
+        ssize_t sent = sendmsg(conn->fd, &msg, MSG_NOSIGNAL);
+        if (sent < 0)
+        {
+            // 소켓 송신 버퍼가 가득 찬 경우 다음 EPOLLOUT까지 대기
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return true;
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        // 다 보낸 청크는 풀에 돌려줌
+        output_queue_consume(&conn->out, (size_t)sent);
+    }
+    return true;
+}
+
+// 조각들 중 앞의 skip 바이트를 제외한 나머지를 송신 대기열 끝에 복사
+// 풀의 상한(--output-cap)에 걸리면 응답을 너무 느리게 읽는 연결로 보고 false를 반환한다. (호출자가 연결을 닫음)
+static bool append_pending(Connection *conn, const struct iovec *iov, int iov_count, size_t skip)
+{
+    if (output_queue_append(&conn->out, iov, iov_count, skip))
+        return true;
+    logger_write(LOG_LEVEL_WARN, "[서버] 클라이언트 %d 송신 대기열 %zu바이트, 서버 전체 송신 버퍼 상한을 넘어 연결 종료",
+                 conn->fd, conn->out.bytes);
+    return false;
+}
+
+// 여러 조각을 sendmsg 한 번으로 전송
+// 즉시 보내지 못한 나머지는 송신 대기열에 이어 붙여 두고 EPOLLOUT을 기다린다. (블로킹하지 않음)
+// 이미 대기 중인 응답이 있으면 순서가 섞이지 않도록 보내지 않고 뒤에 붙이기만 한다.
+// io_uring 방식은 응답을 송신 대기열에 모은 뒤 전송 요청을 제출 큐에 넣기만 하고, 실제 제출은 루프가 한 번에 한다.
+// 대기열에 복사하므로 모아 보내기(reply_append_ref)의 복사 없는 전송은 epoll 방식에서만 이루어진다.
+// (커널이 전송을 마칠 때까지 응답이 붙잡은 메모 노드를 대기열이 대신 붙잡아야 io_uring에서도 복사를 없앨 수 있음)
+static bool send_iov(Connection *conn, struct iovec *iov, int iov_count)
+{
+    if (conn->shard->use_uring)
+        return append_pending(conn, iov, iov_count, 0) && uring_start_send(conn);
+    if (conn->out.bytes > 0)
+        return append_pending(conn, iov, iov_count, 0);
+
+    // 한 번에 IOV_MAX개까지만 넘길 수 있으므로 나눠서 전송
+    for (int start = 0; start < iov_count;)
+    {
+        int batch = iov_count - start < IOV_MAX ? iov_count - start : IOV_MAX;
+        size_t total = 0;
+        for (int i = start; i < start + batch; i++)
+        {
+            total += iov[i].iov_len;
+        }
+
+        struct msghdr msg = {0};
+        msg.msg_iov = iov + start;
+        msg.msg_iovlen = batch;
+        ssize_t sent;
+        do
+        {
+            conn->shard->io_syscalls++;
+            sent = sendmsg(conn->fd, &msg, MSG_NOSIGNAL);
+        } while (sent < 0 && errno == EINTR);
+        if (sent < 0)
+        {
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                return false;
+            sent = 0;
+        }
+        // 남은 조각들을 송신 대기열에 복사
+        if ((size_t)sent < total)
+        {
+            return append_pending(conn, iov + start, iov_count - start, (size_t)sent);
+        }
+        start += batch;
+    }
+    return true;
+}
+
+// 작업의 응답들을 한 번에 전송 (프레임 방식이면 각 응답 앞에 길이 헤더를 붙임)
+static bool send_job_replies(Connection *conn, RequestJob *job)
+{
+    unsigned char headers[PIPELINE_MAX_BATCH][FRAME_HEADER_SIZE + FRAME_REQUEST_ID_SIZE];
+    struct iovec stack_iov[PIPELINE_MAX_BATCH * 2];
+    // 조각으로 된 응답(전체 내보내기 등)이 있으면 조각 수만큼 배열 할당
+    int iov_max = 0;
+    for (int i = 0; i < job->processed; i++)
+    {
+        iov_max += 1 + reply_piece_count(&job->items[i].reply);
+    }
+    struct iovec *iov = stack_iov;
+    if (iov_max > PIPELINE_MAX_BATCH * 2)
+    {
+        iov = (struct iovec *)malloc(sizeof(struct iovec) * (size_t)iov_max);
+        if (!iov)
+            return false;
+    }
+    int iov_count = 0;
+    for (int i = 0; i < job->processed; i++)
+    {
+        ReplyBuffer *reply = &job->items[i].reply;
+        if (conn->mode == WIRE_FRAMED)
+        {
+            // 요청 ID 지정 요청이면 헤더 뒤에 같은 ID를 붙임
+            size_t header_len = FRAME_HEADER_SIZE;
+            uint8_t flags = 0;
+            if (job->tagged)
+            {
+                flags = FRAME_FLAG_REQUEST_ID;
+                frame_put_u32(headers[i] + FRAME_HEADER_SIZE, job->request_id);
+                header_len += FRAME_REQUEST_ID_SIZE;
+            }
+            frame_encode_header(headers[i], flags, (uint32_t)(reply_total_len(reply) + header_len - FRAME_HEADER_SIZE));
+            iov[iov_count].iov_base = headers[i];
+            iov[iov_count].iov_len = header_len;
+            iov_count++;
+        }
+        // 응답 조각들 (직접 쓴 부분과 메모 내용 등 외부 바이트가 번갈아 나옴)
+        int pos = 0;
+        size_t piece_len;
+        const char *piece;
+        while ((piece = reply_next_piece(reply, &pos, &piece_len)) != NULL)
+        {
+            iov[iov_count].iov_base = (void *)piece;
+            iov[iov_count].iov_len = piece_len;
+            iov_count++;
+        }
+    }
+    bool ok = send_iov(conn, iov, iov_count);
+    if (iov != stack_iov)
+        free(iov);
+    return ok;
+}
+
+// 연결의 다음 유휴 시간 확인 시각 등록 (종료 시각과 연결 확인 시각 중 이른 쪽)
+static void schedule_idle_check(Connection *conn)
+{
+    uint64_t due = UINT64_MAX;
+    if (g_server_config.idle_timeout_sec > 0)
+        due = conn->last_active_ms + (uint64_t)g_server_config.idle_timeout_sec * 1000;
+    if (conn->keepalive)
+    {
+        uint64_t quiet_since = conn->last_active_ms > conn->last_ping_ms ? conn->last_active_ms : conn->last_ping_ms;
+        uint64_t ping_at = quiet_since + (uint64_t)g_server_config.keepalive_sec * 1000;
+        if (ping_at < due)
+            due = ping_at;
+    }
+    if (due != UINT64_MAX)
+        timer_wheel_schedule(&conn->shard->timers, &conn->idle_timer, due);
+}
+
+// 유휴 시간 타이머 만료: 오래 조용한 연결을 닫거나 연결 확인 프레임을 보냄
+// 데이터를 받을 때는 시각만 기록하고 타이머는 옮기지 않으므로, 만료되면 실제로 조용했던 시간을 다시 계산한다.
+static void connection_timer_fired(TimerNode *timer)
+{
+    Connection *conn = (Connection *)((char *)timer - offsetof(Connection, idle_timer));
+    uint64_t now = conn->shard->now_ms;
+    // 워커가 요청을 처리 중이면 클라이언트는 응답을 기다리는 중이므로 활동 중으로 봄
+    if (conn->busy || conn->tagged_inflight > 0)
+        conn->last_active_ms = now;
+
+    if (g_server_config.idle_timeout_sec > 0 &&
+        now - conn->last_active_ms >= (uint64_t)g_server_config.idle_timeout_sec * 1000)
+    {
+        logger_write(LOG_LEVEL_INFO, "[서버] 클라이언트 %d 유휴 시간 초과로 연결 종료", conn->fd);
+        close_connection(conn);
+        return;
+    }
+
+    // 보낼 응답이 남아 있지 않을 때만 연결 확인 프레임 전송 (응답 중간에 끼어들지 않도록)
+    uint64_t quiet_since = conn->last_active_ms > conn->last_ping_ms ? conn->last_active_ms : conn->last_ping_ms;
+    if (conn->keepalive && conn->out.bytes == 0 &&
+        now - quiet_since >= (uint64_t)g_server_config.keepalive_sec * 1000)
+    {
+        unsigned char ping[FRAME_HEADER_SIZE];
+        frame_encode_header(ping, FRAME_FLAG_KEEPALIVE, 0);
+        struct iovec iov = {ping, sizeof(ping)};
+        conn->last_ping_ms = now;
+        if (!send_iov(conn, &iov, 1))
+        {
+            close_connection(conn);
+            return;
+        }
+        refresh_interest(conn);
+    }
+    schedule_idle_check(conn);
+}
+
+// 대기에서 깨어난 시각 기록 (이번 바퀴에 받은 데이터의 시각으로 사용)
+static void update_clock(Shard *shard)
+{
+    if (g_idle_timers)
+        shard->now_ms = ps_now_ms();
+    if (load_shed_enabled())
+    {
+        // 대기가 바로 끝났거나 지난 바퀴에서 처리한 시간보다 짧으면(처리가 밀려 있음) 이번 데이터는 대부분 지난 바퀴를
+        // 처리하는 동안 도착한 것이므로 지난 바퀴의 시작 시각을, 아니면 깨어난 시각을 도착 시각으로 본다.
+        // 샤드가 핸들러를 직접 실행하는 샤드 모드에서는 바퀴가 길어지는 것 자체가 대기이므로,
+        // 이렇게 해야 바퀴의 첫 요청도 밀린 시간만큼의 체류 시간을 갖는다.
+        // (io_uring 방식은 대기 시간에 제출한 전송의 복사 시간도 들어가므로 처리 시간과도 비교)
+        unsigned long long now = ps_now_us();
+        unsigned long long waited = now - shard->wait_start_us;
+        bool backlogged = waited < SHED_BUSY_WAIT_US || waited < shard->wait_start_us - shard->wake_us;
+        shard->arrival_us = backlogged ? shard->wake_us : now;
+        shard->wake_us = now;
+    }
+}
+
+// 만료된 유휴 시간 타이머 처리 (이번 바퀴의 이벤트를 모두 처리한 뒤 호출)
+static void run_timers(Shard *shard)
+{
+    if (g_idle_timers)
+        timer_wheel_advance(&shard->timers, shard->now_ms);
+}
+
+// 다음 대기의 최대 시간 (밀리초, 타이머를 쓰지 않거나 등록된 타이머가 없으면 -1)
+// 대기 직전에 호출되므로 대기 시작 시각도 여기서 기록한다.
+static int wait_timeout(Shard *shard)
+{
+    if (load_shed_enabled())
+        shard->wait_start_us = ps_now_us();
+    // 미뤄 둔 일괄 작업이 남아 있으면 잠들지 않고 새 이벤트만 확인
+    if (shard->bulk_head)
+        return 0;
+    // 연결 정리 중에는 틱마다 깨어나 일을 마친 연결을 닫음
+    if (shard->draining || __atomic_load_n(&g_drain_requested, __ATOMIC_ACQUIRE))
+    {
+        int timeout = g_idle_timers ? timer_wheel_next_timeout(&shard->timers, ps_now_ms()) : -1;
+        return timeout >= 0 && timeout < IDLE_TICK_MS ? timeout : IDLE_TICK_MS;
+    }
+    return g_idle_timers ? timer_wheel_next_timeout(&shard->timers, ps_now_ms()) : -1;
+}
+
+// 수락한 연결의 상태를 만들고 수신 대기 시작
+// (epoll 방식은 논블로킹으로 바꿔 epoll에 등록, io_uring 방식은 블로킹 소켓 그대로 수신 요청을 걸어 둠)
+static void add_connection(Shard *shard, int client_fd)
+{
+    // 논블로킹 설정
+    if (!shard->use_uring && !set_nonblocking(client_fd))
+    {
+        close(client_fd);
+        return;
+    }
+    // 연결 상태 생성
+    Connection *conn = (Connection *)calloc(1, sizeof(Connection));
+    if (!conn)
+    {
+        close(client_fd);
+        return;
+    }
+    conn->shard = shard;
+    conn->fd = client_fd;
+    conn->mode = WIRE_UNKNOWN;
+    conn->events = EPOLLIN;
+    conn->linger_fd = -1;
+    timer_init(&conn->idle_timer, connection_timer_fired);
+    reply_init(&conn->in);
+    if (shard->use_uring)
+    {
+        uring_arm_recv(conn);
+    }
+    else
+    {
+        // epoll에 등록
+        struct epoll_event ev = {0};
+        ev.events = EPOLLIN;
+        ev.data.ptr = conn;
+        shard->io_syscalls++;
+        if (epoll_ctl(shard->epoll_fd, EPOLL_CTL_ADD, client_fd, &ev) < 0)
+        {
+            close(client_fd);
+            free(conn);
+            return;
+        }
+    }
+    shard->connection_count++;
+    conn->next = shard->connections;
+    if (conn->next)
+        conn->next->prev = conn;
+    shard->connections = conn;
+    logger_write(LOG_LEVEL_INFO, "[서버] 클라이언트 %d 연결됨 (현재 연결 수: %d)", client_fd, shard->connection_count);
+    if (g_idle_timers)
+    {
+        conn->last_active_ms = conn->last_ping_ms = shard->now_ms;
+        schedule_idle_check(conn);
+    }
+}
+
+// 서버 소켓(TCP 또는 로컬)에 들어온 새 클라이언트 연결을 가능한 만큼 수락 (epoll 방식)
+static void accept_connections(Shard *shard, int listen_fd)
+{
+    while (true)
+    {
+        shard->io_syscalls++;
+        int client_fd = accept(listen_fd, NULL, NULL);
+        if (client_fd < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            // 대기 중인 연결이 더 없음
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return;
+            logger_write(LOG_LEVEL_ERROR, "[서버] accept() 실패: %s", strerror(errno));
+            return;
+        }
+        add_connection(shard, client_fd);
+    }
+}
+
+// 샤드의 이벤트 루프 깨우기
+static void wake_shard(Shard *shard)
+{
+    uint64_t one = 1;
+    ssize_t written = write(shard->wakeup.fd, &one, sizeof(one));
+    (void)written;
+}
+
+// 모아 둔 샤드 깨우기 (같은 샤드에 여러 작업을 넘겨도 대기 전에 한 번만 깨움)
+static void flush_wakeups(Shard *shard)
+{
+    uint64_t mask = shard->wake_mask;
+    shard->wake_mask = 0;
+    for (int i = 0; mask != 0; i++, mask >>= 1)
+    {
+        if (mask & 1)
+        {
+            shard->io_syscalls++;
+            wake_shard(&g_shards[i]);
+        }
+    }
+}
+
+// 묶음의 요청을 순서대로 처리 (EXIT를 만나면 뒤의 요청은 처리하지 않음)
+// 작업의 요청/응답만 사용하고 연결은 건드리지 않으므로 어느 스레드에서 실행해도 된다.
+static void run_job_commands(RequestJob *job)
+{
+    // 받은 뒤 처리하기까지 기다린 시간(워커 대기열, 샤드 inbox, 같은 바퀴에서 앞선 요청들의 처리)을
+    // 부하 조절에 반영 (버릴지는 요청마다 디스패처가 판단)
+    load_shed_observe(job->queued_us);
+    while (job->processed < job->count && job->keep_open)
+    {
+        PipelinedRequest *item = &job->items[job->processed++];
+        if (job->binary && is_binary_request(item->request, item->request_len))
+            dispatch_binary_command(item->request, item->request_len, &item->reply, job->limit, item->deadline_ms);
+        else
+            job->keep_open = dispatch_command(item->request, &item->reply, job->limit, item->deadline_ms);
+    }
+}
+
+// 워커 스레드: 묶음의 요청을 처리하고 완료 큐에 넣은 뒤 이벤트 루프를 깨움
+static void run_request_job(WorkerTask *task)
+{
+    RequestJob *job = (RequestJob *)task;
+    Shard *origin = job->origin; // 넣은 뒤에는 이벤트 루프가 작업을 해제할 수 있음
+    run_job_commands(job);
+    mpsc_push(&origin->done, &job->link);
+    wake_shard(origin);
+}
+
+// 샤드 모드: 이 샤드의 파티션에 속한 일괄 작업을 처리 대기 목록에 추가
+static void queue_bulk_job(Shard *shard, RequestJob *job)
+{
+    job->next = NULL;
+    if (shard->bulk_tail)
+        shard->bulk_tail->next = job;
+    else
+        shard->bulk_head = job;
+    shard->bulk_tail = job;
+}
+
+// 샤드 모드: 미뤄 둔 일괄 작업을 한 바퀴에 bulk_limit개까지 처리 (루프가 대기 전에 호출)
+// 샤드는 핸들러를 직접 실행하므로, 한 바퀴에 처리하는 일괄 작업 수를 제한해야 그 사이에 받은 대화형 요청이
+// 일괄 작업 뒤에서 기다리는 시간이 일괄 작업 몇 개 분량으로 묶인다.
+static void run_bulk_jobs(Shard *shard)
+{
+    for (int i = 0; i < g_server_config.bulk_limit && shard->bulk_head; i++)
+    {
+        RequestJob *job = shard->bulk_head;
+        shard->bulk_head = job->next;
+        if (!shard->bulk_head)
+            shard->bulk_tail = NULL;
+        // 넣은 뒤에는 요청을 보낸 샤드가 작업을 해제할 수 있으므로 먼저 꺼내 둠
+        Shard *origin = job->origin;
+        run_job_commands(job);
+        if (origin == shard)
+        {
+            job->next = NULL;
+            if (shard->ready_tail)
+                shard->ready_tail->next = job;
+            else
+                shard->ready_head = job;
+            shard->ready_tail = job;
+        }
+        else
+        {
+            shard->wake_mask |= 1ULL << origin->index;
+            mpsc_push(&origin->done, &job->link);
+        }
+    }
+}
+
+// 샤드 모드: 요청 묶음을 사용자의 파티션을 맡은 샤드에서 처리
+// 자기 파티션(또는 사용자가 없는 요청)이면 바로 처리해서 완료 대기 목록에 넣고, 응답은 루프가 다음 대기 전에 보낸다.
+// (여기서 바로 응답을 보내면 complete_request → process_input → submit_job으로 재귀하게 됨)
+// 다른 파티션이면 그 샤드의 inbox에 넣고, 처리가 끝나면 이 샤드의 완료 큐로 돌아온다.
+static void route_job(Shard *shard, RequestJob *job)
+{
+    if (job->partition < 0 || job->partition == shard->index)
+    {
+        // 일괄 작업은 바로 처리하지 않고 미뤄 두어, 이번 바퀴의 다른 요청을 먼저 처리함
+        if (job->bulk)
+        {
+            queue_bulk_job(shard, job);
+            return;
+        }
+        run_job_commands(job);
+        job->next = NULL;
+        if (shard->ready_tail)
+            shard->ready_tail->next = job;
+        else
+            shard->ready_head = job;
+        shard->ready_tail = job;
+        return;
+    }
+    shard->forwarded++;
+    shard->wake_mask |= 1ULL << job->partition;
+    mpsc_push(&g_shards[job->partition].inbox, &job->link);
+}
+
+// 작업을 워커에게 넘김 (작업의 소유권은 워커 또는 이 함수로 넘어감)
+// 대기열이 가득 차면 묶음의 모든 요청에 과부하 응답을 보낸다.
+// 반환값: 연결이 유효하면 true, 오류로 연결을 닫았으면 false
+static bool submit_job(Connection *conn, RequestJob *job)
+{
+    // 수신 데이터 기록 (로거 링에 남기기만 하고 출력은 기록 스레드가 함)
+    for (int i = 0; i < job->count; i++)
+    {
+        PipelinedRequest *item = &job->items[i];
+        dispatch_log_request("클라이언트", conn->fd, item->request, item->request_len,
+                             job->binary && is_binary_request(item->request, item->request_len));
+    }
+
+    // 워커 대기열에 추가 (샤드 모드는 파티션을 맡은 샤드에 넘김)
+    conn->shard->request_total += job->count;
+    job->task.run = run_request_job;
+    if (job->tagged)
+        conn->tagged_inflight++;
+    else
+        conn->busy = true;
+    if (g_sharded)
+    {
+        route_job(conn->shard, job);
+        return true;
+    }
+    if (worker_pool_submit(&job->task, job->bulk ? WORKER_LANE_BULK : WORKER_LANE_INTERACTIVE))
+        return true;
+
+    // 대기열이 가득 찬 경우 과부하 응답
+    if (job->tagged)
+        conn->tagged_inflight--;
+    else
+        conn->busy = false;
+    for (int i = 0; i < job->count; i++)
+    {
+        reply_set(&job->items[i].reply, "%s", REPLY_BUSY);
+    }
+    job->processed = job->count;
+    bool ok = send_job_replies(conn, job);
+    free_job(job);
+    if (!ok)
+    {
+        close_connection(conn);
+        return false;
+    }
+    return true;
+}
+
+// 처리가 끝난 묶음의 응답 전송
+static void complete_request(RequestJob *job)
+{
+    Connection *conn = job->conn;
+    if (job->tagged)
+        conn->tagged_inflight--;
+    else
+        conn->busy = false;
+    // 처리 도중 연결이 끊긴 경우 (마지막 작업이면 연결 구조체 해제)
+    if (conn->fd < 0)
+    {
+        release_connection(conn);
+        return;
+    }
+    if (!job->keep_open)
+    {
+        logger_write(LOG_LEVEL_INFO, "[서버] 클라이언트 %d 정상 종료 요청", conn->fd);
+    }
+    // 응답 전송
+    if (!send_job_replies(conn, job))
+    {
+        close_connection(conn);
+        return;
+    }
+    // EXIT 요청 처리
+    if (!job->keep_open)
+    {
+        if (conn->out.bytes == 0)
+        {
+            close_connection(conn);
+            return;
+        }
+        conn->close_after_send = true;
+        refresh_interest(conn);
+        return;
+    }
+    // 연결 정리 중이면 응답을 다 보내고 더 받은 요청이 없는 연결은 바로 닫음
+    if (conn->shard->draining && connection_idle(conn))
+    {
+        close_connection(conn);
+        return;
+    }
+    // 이미 받아 둔 다음 요청 처리
+    process_input(conn);
+}
+
+// 다른 샤드가 넘긴 작업과 완료 큐에 쌓인 작업을 모두 처리
+// (넣는 도중인 작업은 넣은 쪽이 eventfd로 다시 깨우므로 다음 차례에 처리됨)
+static void drain_completions(Shard *shard)
+{
+    // eventfd 카운터 초기화 (io_uring 방식은 커널이 이미 읽어 둠)
+    if (!shard->use_uring)
+    {
+        uint64_t count;
+        shard->io_syscalls++;
+        ssize_t got = read(shard->wakeup.fd, &count, sizeof(count));
+        (void)got;
+    }
+
+    // 이 샤드의 파티션에 속한 요청을 처리해서 요청을 보낸 샤드로 돌려보냄
+    MpscNode *node;
+    while ((node = mpsc_pop(&shard->inbox)) != NULL)
+    {
+        RequestJob *job = job_of(node);
+        // 일괄 작업은 처리 대기 목록으로 (run_bulk_jobs)
+        if (job->bulk)
+        {
+            queue_bulk_job(shard, job);
+            continue;
+        }
+        // 넣은 뒤에는 요청을 보낸 샤드가 작업을 해제할 수 있으므로 먼저 꺼내 둠
+        Shard *origin = job->origin;
+        run_job_commands(job);
+        shard->wake_mask |= 1ULL << origin->index;
+        mpsc_push(&origin->done, &job->link);
+    }
+
+    // 처리가 끝난 작업의 응답 전송
+    while ((node = mpsc_pop(&shard->done)) != NULL)
+    {
+        RequestJob *job = job_of(node);
+        complete_request(job);
+        free_job(job);
+    }
+}
+
+// 이 샤드가 바로 처리한 작업의 응답 전송 (응답을 보내며 이어서 처리한 작업도 포함)
+static void drain_ready(Shard *shard)
+{
+    while (shard->ready_head)
+    {
+        RequestJob *job = shard->ready_head;
+        shard->ready_head = job->next;
+        if (!shard->ready_head)
+            shard->ready_tail = NULL;
+        complete_request(job);
+        free_job(job);
+    }
+}
+
+// 요청 본문이 다루는 사용자의 저장소 파티션 (샤드 모드가 아니면 항상 -1)
+static int request_partition(Connection *conn, const char *body, size_t len)
+{
+    if (!g_sharded)
+        return -1;
+    return dispatch_partition(body, len, conn->binary && is_binary_request(body, len));
+}
+
+// 수신 버퍼 앞의 used 바이트(완성된 프레임 count개)를 작업으로 옮김
+// 각 본문의 끝(다음 프레임 헤더의 첫 바이트)을 null 문자로 덮어써서 복사 없이 요청 문자열로 사용한다.
+static RequestJob *take_frames(Connection *conn, size_t used, int count)
+{
+    RequestJob *job = alloc_job(conn, count);
+    char *input = job ? (char *)malloc(used + 1) : NULL;
+    if (!input)
+    {
+        free(job);
+        return NULL;
+    }
+    memcpy(input, conn->in.data, used);
+    job->input = input;
+    size_t off = 0;
+    for (int i = 0; i < count; i++)
+    {
+        // 헤더를 읽은 뒤에 이전 요청의 끝을 표시해야 함
+        FrameHeader header;
+        frame_decode_header((const unsigned char *)input + off, &header);
+        input[off] = '\0';
+        size_t body = off + FRAME_HEADER_SIZE;
+        size_t prefix_len = frame_prefix_size(header.flags);
+        frame_decode_prefix((const unsigned char *)input + body, &header);
+        job->items[i].request_len = header.length - prefix_len;
+        // 요청 ID 지정 프레임은 항상 단독 작업
+        if (header.flags & FRAME_FLAG_REQUEST_ID)
+        {
+            job->tagged = true;
+            job->request_id = header.request_id;
+        }
+        // 기한은 프레임을 꺼낸 시각부터 셈 (제한 시간이 없으면 시계를 읽지 않음)
+        job->items[i].deadline_ms = header.timeout_ms ? ps_now_ms() + header.timeout_ms : 0;
+        job->items[i].request = input + body + prefix_len;
+        off += FRAME_HEADER_SIZE + header.length;
+    }
+    input[off] = '\0';
+
+    // 꺼낸 프레임을 수신 버퍼에서 제거 (비면 메모리 반환)
+    size_t rest = conn->in.len - used;
+    if (rest == 0)
+    {
+        reply_free(&conn->in);
+    }
+    else
+    {
+        memmove(conn->in.data, conn->in.data + used, rest);
+        conn->in.len = rest;
+        conn->in.data[rest] = '\0';
+    }
+    return job;
+}
+
+// 받아 둔 데이터에서 완성된 프레임들을 꺼내어 워커에게 넘김
+//  - ID 없는 요청: 연속된 것들을 한 묶음으로 넘기고, 묶음이 끝나야 다음 묶음을 넘김 (순서 보장)
+//  - ID 지정 요청: 하나씩 바로 넘김 (연결당 MAX_TAGGED_INFLIGHT개까지)
+// 과부하로 바로 BUSY 응답을 보낸 경우에는 이어서 다음 요청을 처리한다.
+static void process_input(Connection *conn)
+{
+    // 응답 전송이 기준 이상 밀려 있으면 클라이언트가 읽을 때까지 새 요청을 처리하지 않음
+    while (!output_pool_should_pause(&conn->out) && !conn->close_after_send && conn->mode == WIRE_FRAMED)
+    {
+        // 완성된 프레임 수와 전체 길이 계산
+        size_t used = 0;
+        int count = 0;
+        bool tagged = false;
+        bool bulk = false;
+        int partition = -1;
+        while (count < PIPELINE_MAX_BATCH && conn->in.len - used >= FRAME_HEADER_SIZE)
+        {
+            // 헤더 해석 (잘못된 헤더나 너무 큰 요청은 연결 종료)
+            FrameHeader header;
+            if (!frame_decode_header((const unsigned char *)conn->in.data + used, &header) || header.length > FRAME_MAX_REQUEST)
+            {
+                logger_write(LOG_LEVEL_WARN, "[서버] 클라이언트 %d 잘못된 프레임 수신", conn->fd);
+                close_connection(conn);
+                return;
+            }
+            // 본문을 아직 다 받지 못함
+            if (conn->in.len - used < FRAME_HEADER_SIZE + header.length)
+                break;
+            // 샤드 모드: 한 묶음에는 같은 파티션의 요청만 담음 (사용자가 없는 요청은 어디든 포함)
+            size_t prefix_len = frame_prefix_size(header.flags);
+            const char *body = conn->in.data + used + FRAME_HEADER_SIZE + prefix_len;
+            size_t body_len = header.length - prefix_len;
+            int frame_partition = request_partition(conn, body, body_len);
+            bool frame_bulk = conn->greeted && dispatch_is_bulk(body, body_len, conn->binary && is_binary_request(body, body_len));
+            // ID 지정 요청은 단독으로, ID 없는 요청은 연속된 것끼리 묶음
+            if (header.flags & FRAME_FLAG_REQUEST_ID)
+            {
+                if (count == 0)
+                {
+                    tagged = true;
+                    bulk = frame_bulk;
+                    used = FRAME_HEADER_SIZE + header.length;
+                    count = 1;
+                    partition = frame_partition;
+                }
+                break;
+            }
+            // 일괄 작업은 단독 묶음으로 (앞의 요청들은 먼저 대화형 묶음으로 넘김)
+            // 뒤의 ID 없는 요청은 응답 순서를 지키려고 일괄 작업이 끝날 때까지(conn->busy) 기다린다.
+            if (frame_bulk)
+            {
+                if (count == 0)
+                {
+                    bulk = true;
+                    used = FRAME_HEADER_SIZE + header.length;
+                    count = 1;
+                    partition = frame_partition;
+                }
+                break;
+            }
+            if (frame_partition >= 0)
+            {
+                if (partition >= 0 && frame_partition != partition)
+                    break;
+                partition = frame_partition;
+            }
+            used += FRAME_HEADER_SIZE + header.length;
+            count++;
+            // 첫 요청은 HELLO인지 확인해야 하므로 단독으로 꺼냄
+            if (!conn->greeted)
+                break;
+        }
+        if (count == 0)
+            break;
+        // 첫 요청이 HELLO면 워커를 거치지 않고 바로 프로토콜 협상 (아직 처리 중인 요청이 없음)
+        if (!conn->greeted)
+        {
+            conn->greeted = true;
+            RequestJob *job = take_frames(conn, used, count);
+            if (!job)
+            {
+                close_connection(conn);
+                return;
+            }
+            job->partition = partition;
+            // HELLO가 아니면 첫 묶음을 그대로 워커에게 넘김
+            bool binary = false;
+            bool ping = false;
+            if (!dispatch_hello(job->items[0].request, &job->items[0].reply, &binary,
+                                g_server_config.keepalive_sec > 0 ? &ping : NULL))
+            {
+                if (!submit_job(conn, job))
+                    return;
+                continue;
+            }
+            // 협상 결과는 이후에 꺼내는 요청부터 적용
+            conn->binary = binary;
+            conn->keepalive = ping;
+            if (ping)
+                schedule_idle_check(conn);
+            job->processed = 1;
+            bool ok = send_job_replies(conn, job);
+            free_job(job);
+            if (!ok)
+            {
+                close_connection(conn);
+                return;
+            }
+            continue;
+        }
+        // 처리 가능한 상태가 아니면 대기
+        if (tagged ? conn->tagged_inflight >= MAX_TAGGED_INFLIGHT : conn->busy)
+            break;
+
+        RequestJob *job = take_frames(conn, used, count);
+        if (!job)
+        {
+            close_connection(conn);
+            return;
+        }
+        job->partition = partition;
+        job->bulk = bulk;
+        if (!submit_job(conn, job))
+            return;
+    }
+    refresh_interest(conn);
+}
+
+// 받은 데이터 처리 (bytes가 0 이하이면 수신 실패 또는 연결 종료)
+static void handle_received(Connection *conn, const char *data, ssize_t bytes)
+{
+    // 수신 실패 또는 연결 종료 시
+    if (bytes <= 0)
+    {
+        close_connection(conn);
+        return;
+    }
+    // 유휴 시간 기준 시각 갱신 (타이머는 만료될 때 이 값을 보고 다시 등록됨)
+    conn->last_active_ms = conn->shard->now_ms;
+
+    // 첫 바이트로 통신 방식 판별
+    if (conn->mode == WIRE_UNKNOWN)
+    {
+        conn->mode = ((unsigned char)data[0] == FRAME_MAGIC) ? WIRE_FRAMED : WIRE_LEGACY;
+    }
+
+    // 이전 방식: 한 번 받은 데이터를 요청 하나로 처리
+    if (conn->mode == WIRE_LEGACY)
+    {
+        RequestJob *job = alloc_job(conn, 1);
+        char *input = job ? (char *)malloc(bytes + 1) : NULL;
+        if (!input)
+        {
+            free(job);
+            close_connection(conn);
+            return;
+        }
+        memcpy(input, data, bytes);
+        input[bytes] = '\0';
+        job->input = input;
+        job->items[0].request = input;
+        job->items[0].request_len = bytes;
+        job->partition = request_partition(conn, input, bytes);
+        job->bulk = dispatch_is_bulk(input, bytes, false);
+        if (submit_job(conn, job))
+            refresh_interest(conn);
+        return;
+    }
+
+    // 프레임 방식: 수신 버퍼에 이어 붙인 뒤 완성된 프레임 처리
+    if (!reply_append(&conn->in, data, bytes))
+    {
+        close_connection(conn);
+        return;
+    }
+    process_input(conn);
+}
+
+// 수신 이벤트 처리 (epoll 방식)
+static void handle_readable(Connection *conn)
+{
+    // 클라이언트로부터 데이터 수신
+    Shard *shard = conn->shard;
+    size_t max_read = conn->mode == WIRE_FRAMED ? sizeof(shard->read_buf) : LEGACY_BUF_SIZE - 1;
+    shard->io_syscalls++;
+    ssize_t bytes = recv(conn->fd, shard->read_buf, max_read, 0);
+    if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        return;
+    handle_received(conn, shard->read_buf, bytes);
+}
+
+// 송신 대기열을 모두 보낸 뒤 처리
+static void output_drained(Connection *conn)
+{
+    // EXIT 응답까지 보냈으면 연결 종료
+    if (conn->close_after_send)
+    {
+        close_connection(conn);
+        return;
+    }
+    // 연결 정리 중이면 응답을 다 보내고 더 받은 요청이 없는 연결은 바로 닫음
+    if (conn->shard->draining && connection_idle(conn))
+    {
+        close_connection(conn);
+        return;
+    }
+    // 이미 받아 둔 요청을 처리하고 다시 수신 대기
+    process_input(conn);
+}
+
+// 송신 가능 이벤트 처리: 송신 대기열의 응답을 마저 전송 (epoll 방식)
+static void handle_writable(Connection *conn)
+{
+    if (!flush_pending(conn))
+    {
+        close_connection(conn);
+        return;
+    }
+    // 아직 남은 응답이 있으면 계속 대기 (기준 아래로 내려왔으면 받아 둔 요청을 처리하고 다시 읽기 시작)
+    if (conn->out.bytes > 0)
+    {
+        process_input(conn);
+        return;
+    }
+    output_drained(conn);
+}
+
+// io_uring 요청의 user_data (연결 구조체 주소 + 요청 종류)
+static uint64_t uring_user_data(Connection *conn, uint64_t op)
+{
+    return (uint64_t)(uintptr_t)conn | op;
+}
+
+// 연결 수락 요청 (multishot: 커널이 F_MORE 없이 완료할 때까지 연결마다 완료 항목이 생김)
+// listener: 샤드의 서버 소켓 식별용 구조체 (완료 항목의 user_data로 어느 서버 소켓인지 구분)
+static void uring_arm_accept(Shard *shard, Connection *listener)
+{
+    struct io_uring_sqe *sqe = uring_get_sqe(&shard->ring);
+    if (!sqe)
+        return;
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listener->fd;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->user_data = uring_user_data(listener, URING_OP_ACCEPT);
+}
+
+// 워커 완료 알림 eventfd 읽기 요청
+static void uring_arm_wakeup(Shard *shard)
+{
+    struct io_uring_sqe *sqe = uring_get_sqe(&shard->ring);
+    if (!sqe)
+        return;
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = shard->wakeup.fd;
+    sqe->addr = (uint64_t)(uintptr_t)&shard->wakeup_value;
+    sqe->len = sizeof(shard->wakeup_value);
+    sqe->user_data = uring_user_data(NULL, URING_OP_WAKEUP);
+}
+
+// 수신 요청 (버퍼는 커널이 버퍼 링에서 골라 채움)
+static void uring_arm_recv(Connection *conn)
+{
+    struct io_uring_sqe *sqe = uring_get_sqe(&conn->shard->ring);
+    if (!sqe)
+        return;
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = conn->fd;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BUF_GROUP;
+    // 이전 방식 연결은 epoll 방식과 같이 한 번에 LEGACY_BUF_SIZE - 1바이트까지만 받음 (0이면 버퍼 크기만큼)
+    sqe->len = conn->mode == WIRE_FRAMED ? 0 : LEGACY_BUF_SIZE - 1;
+    sqe->user_data = uring_user_data(conn, URING_OP_RECV);
+    conn->recv_armed = true;
+}
+
+// 송신 대기열 앞쪽의 청크들을 커널에 맡김 (이미 전송 중이면 완료된 뒤에 이어서 보냄)
+// 커널은 맡긴 청크들만 읽으므로, 완료되기 전까지 그 청크들을 돌려주지 않으면 새 응답은 대기열 뒤에 계속 붙여도 된다.
+static bool uring_start_send(Connection *conn)
+{
+    if (conn->sending || conn->out.bytes == 0)
+        return true;
+    struct io_uring_sqe *sqe = uring_get_sqe(&conn->shard->ring);
+    if (!sqe)
+        return false;
+    memset(&conn->send_msg, 0, sizeof(conn->send_msg));
+    conn->send_msg.msg_iov = conn->send_iov;
+    conn->send_msg.msg_iovlen = output_queue_peek(&conn->out, conn->send_iov, URING_SEND_IOV);
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = conn->fd;
+    sqe->addr = (uint64_t)(uintptr_t)&conn->send_msg;
+    sqe->len = 1;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = uring_user_data(conn, URING_OP_SEND);
+    conn->sending = true;
+    return true;
+}
+
+// 연결 수락 완료
+static void uring_accepted(Shard *shard, Connection *listener, int res, uint32_t flags)
+{
+    // 취소하기 전에 수락한 연결은 받아서 정리 대상으로 둠
+    if (res >= 0)
+        add_connection(shard, res);
+    else if (res != -ECANCELED)
+        logger_write(LOG_LEVEL_ERROR, "[서버] accept 실패: %s", strerror(-res));
+    // multishot 수락이 끝났으면 다시 요청 (연결 정리 중이면 그대로 멈춤)
+    if (!(flags & IORING_CQE_F_MORE) && !shard->draining)
+        uring_arm_accept(shard, listener);
+}
+
+// 연결 수락 요청 취소 (연결 정리 시작 시, 수락 요청은 -ECANCELED로 완료됨)
+static void uring_cancel_accept(Shard *shard, Connection *listener)
+{
+    struct io_uring_sqe *sqe = uring_get_sqe(&shard->ring);
+    if (!sqe)
+        return;
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->fd = -1;
+    sqe->addr = uring_user_data(listener, URING_OP_ACCEPT);
+    sqe->user_data = uring_user_data(listener, URING_OP_WAKEUP); // eventfd 읽기와 구분되도록 서버 소켓 주소를 붙임
+}
+
+// 수신 완료
+static void uring_received(Connection *conn, int res, uint32_t flags)
+{
+    Uring *ring = &conn->shard->ring;
+    conn->recv_armed = false;
+    bool has_buffer = (flags & IORING_CQE_F_BUFFER) != 0;
+    uint16_t bid = (uint16_t)(flags >> IORING_CQE_BUFFER_SHIFT);
+    const char *data = has_buffer ? uring_buffer(ring, bid) : NULL;
+
+    // 종료된 연결: 버퍼만 돌려주고 마지막 요청이었으면 연결 구조체 해제
+    if (conn->fd < 0)
+    {
+        if (has_buffer)
+            uring_recycle_buffer(ring, bid);
+        release_connection(conn);
+        return;
+    }
+    // 버퍼가 모두 사용 중이거나 중단된 경우 다시 수신 요청 (이번 완료 묶음을 처리하며 버퍼가 반환됨)
+    if (res == -ENOBUFS || res == -EINTR || res == -EAGAIN)
+    {
+        refresh_interest(conn);
+        return;
+    }
+    handle_received(conn, data, res);
+    // 받은 데이터는 모두 복사했으므로 버퍼 반환 (연결은 이미 해제되었을 수 있음)
+    if (has_buffer)
+        uring_recycle_buffer(ring, bid);
+}
+
+// 전송 완료
+static void uring_sent(Connection *conn, int res)
+{
+    conn->sending = false;
+    // 전송 실패 또는 종료된 연결
+    if (res < 0 || conn->fd < 0)
+    {
+        if (conn->fd >= 0)
+        {
+            close_connection(conn);
+            return;
+        }
+        output_queue_free(&conn->out);
+        release_connection(conn);
+        return;
+    }
+    // 보낸 만큼 청크를 풀에 돌려주고, 남았거나 전송하는 동안 쌓인 응답이 있으면 이어서 전송
+    output_queue_consume(&conn->out, (size_t)res);
+    if (conn->out.bytes > 0)
+    {
+        if (!uring_start_send(conn))
+        {
+            close_connection(conn);
+            return;
+        }
+        // 기준 아래로 내려왔으면 받아 둔 요청을 처리하고 다시 수신 요청
+        process_input(conn);
+        return;
+    }
+    output_drained(conn);
+}
+
+// 연결 정리 (event_loop_drain, 이번 바퀴의 이벤트를 모두 처리한 뒤 호출)
+// 처음 호출되면 새 연결 수락을 멈추고, 그 뒤로는 바퀴마다 일을 마친 연결을 닫는다.
+// 수락하지 않은 연결은 리스너의 대기열에 남아 리스너를 넘겨받은 새 프로세스가 수락한다.
+// 모든 샤드가 연결을 다 닫거나 제한 시각이 지나면 이벤트 루프를 종료한다.
+static void drain_connections(Shard *shard)
+{
+    bool first = !shard->draining;
+    if (first)
+    {
+        shard->draining = true;
+        Connection *listeners[2] = {&shard->listener, &shard->local_listener};
+        for (int i = 0; i < 2; i++)
+        {
+            if (listeners[i]->fd < 0)
+                continue;
+            if (shard->use_uring)
+                uring_cancel_accept(shard, listeners[i]);
+            else
+                epoll_ctl(shard->epoll_fd, EPOLL_CTL_DEL, listeners[i]->fd, NULL);
+        }
+    }
+    Connection *conn = shard->connections;
+    while (conn)
+    {
+        Connection *next = conn->next;
+        // 수락 직후 아직 아무것도 받지 않은 연결은 곧 첫 요청을 보낼 것이므로 닫지 않음 (끝내 보내지 않으면 제한 시각에 종료)
+        if (conn->mode != WIRE_UNKNOWN && connection_idle(conn))
+            close_connection(conn);
+        conn = next;
+    }
+    // 수락 취소가 끝나기 전에 수락한 연결이 있을 수 있으므로 첫 바퀴에는 마친 것으로 세지 않음
+    if (shard->connection_count == 0)
+    {
+        if (!first && !shard->drained)
+        {
+            shard->drained = true;
+            if (__atomic_add_fetch(&g_drained_shards, 1, __ATOMIC_ACQ_REL) == g_shard_total)
+            {
+                logger_write(LOG_LEVEL_INFO, "[서버] 모든 연결을 정리했습니다.");
+                event_loop_stop();
+            }
+        }
+    }
+    else if (ps_now_ms() >= g_drain_deadline_ms)
+    {
+        logger_write(LOG_LEVEL_WARN, "[서버] 연결 정리 제한 시간이 지나 연결 %d개를 닫고 종료합니다.", shard->connection_count);
+        event_loop_stop();
+    }
+}
+
+// io_uring 방식 루프
+// 루프를 한 바퀴 돌 때마다 쌓인 수락/수신/전송 요청을 io_uring_enter 한 번으로 제출하고 완료를 기다린다.
+static void uring_loop(Shard *shard)
+{
+    uring_arm_accept(shard, &shard->listener);
+    if (shard->local_listener.fd >= 0)
+        uring_arm_accept(shard, &shard->local_listener);
+    uring_arm_wakeup(shard);
+    while (!__atomic_load_n(&g_stop_requested, __ATOMIC_RELAXED))
+    {
+        run_bulk_jobs(shard);
+        drain_ready(shard);
+        flush_wakeups(shard);
+        int ret = uring_submit_and_wait_timeout(&shard->ring, 1, wait_timeout(shard));
+        update_clock(shard);
+        // 시그널에 의한 중단은 종료 플래그를 다시 확인, EBUSY는 완료 항목을 먼저 비우면 해결됨
+        if (ret < 0 && ret != -EINTR && ret != -EBUSY)
+        {
+            logger_write(LOG_LEVEL_ERROR, "[서버] io_uring_enter 실패: %s", strerror(-ret));
+            break;
+        }
+        struct io_uring_cqe *cqe;
+        while ((cqe = uring_peek_cqe(&shard->ring)) != NULL)
+        {
+            // 처리 중에 새 요청을 제출할 수 있으므로 값을 복사한 뒤 항목 반환
+            uint64_t data = cqe->user_data;
+            int res = cqe->res;
+            uint32_t flags = cqe->flags;
+            uring_cqe_seen(&shard->ring);
+
+            Connection *conn = (Connection *)(uintptr_t)(data & ~URING_OP_MASK);
+            switch (data & URING_OP_MASK)
+            {
+            case URING_OP_ACCEPT:
+                uring_accepted(shard, conn, res, flags);
+                break;
+            case URING_OP_WAKEUP:
+                // 연결 주소가 붙어 있으면 수락 취소 요청의 완료 (결과는 쓰지 않음)
+                if (conn)
+                    break;
+                uring_arm_wakeup(shard);
+                drain_completions(shard);
+                break;
+            case URING_OP_RECV:
+                uring_received(conn, res, flags);
+                break;
+            case URING_OP_SEND:
+                uring_sent(conn, res);
+                break;
+            }
+        }
+        run_timers(shard);
+        if (__atomic_load_n(&g_drain_requested, __ATOMIC_ACQUIRE))
+            drain_connections(shard);
+    }
+}
+
+// io_uring 준비 (커널이 지원하지 않으면 false → epoll 방식 사용)
+// 제출은 만든 스레드만 하도록(SINGLE_ISSUER) 만들므로 샤드 스레드 안에서 호출한다.
+static bool uring_setup(Shard *shard)
+{
+    if (!uring_init(&shard->ring, URING_ENTRIES))
+    {
+        logger_write(LOG_LEVEL_WARN, "[서버] io_uring을 사용할 수 없어 epoll 방식으로 실행합니다: %s", strerror(errno));
+        return false;
+    }
+    if (!uring_setup_buffers(&shard->ring, URING_BUF_GROUP, URING_BUF_COUNT, URING_BUF_SIZE))
+    {
+        logger_write(LOG_LEVEL_WARN, "[서버] io_uring 버퍼 링을 등록할 수 없어(커널 5.19 이상 필요) epoll 방식으로 실행합니다: %s", strerror(errno));
+        uring_exit(&shard->ring);
+        return false;
+    }
+    // eventfd에는 블로킹 읽기 요청을 걸어 두므로 논블로킹 해제 (논블로킹이면 커널이 바로 EAGAIN으로 완료함)
+    int flags = fcntl(shard->wakeup.fd, F_GETFL, 0);
+    fcntl(shard->wakeup.fd, F_SETFL, flags & ~O_NONBLOCK);
+    return true;
+}
+
+// epoll 준비: 서버 소켓과 완료 알림 eventfd 등록
+static bool epoll_setup(Shard *shard)
+{
+    // epoll 인스턴스 생성
+    shard->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (shard->epoll_fd < 0)
+    {
+        logger_write(LOG_LEVEL_ERROR, "[서버] epoll_create1 실패: %s", strerror(errno));
+        return false;
+    }
+    // 서버 소켓 등록 (로컬 서버 소켓이 있으면 함께 등록)
+    Connection *listeners[2] = {&shard->listener, &shard->local_listener};
+    struct epoll_event ev = {0};
+    for (int i = 0; i < 2; i++)
+    {
+        if (listeners[i]->fd < 0)
+            continue;
+        set_nonblocking(listeners[i]->fd);
+        ev.events = EPOLLIN;
+        ev.data.ptr = listeners[i];
+        if (epoll_ctl(shard->epoll_fd, EPOLL_CTL_ADD, listeners[i]->fd, &ev) < 0)
+        {
+            logger_write(LOG_LEVEL_ERROR, "[서버] 서버 소켓 epoll 등록 실패: %s", strerror(errno));
+            close(shard->epoll_fd);
+            return false;
+        }
+    }
+    // 완료 알림용 eventfd 등록
+    ev.events = EPOLLIN;
+    ev.data.ptr = &shard->wakeup;
+    if (epoll_ctl(shard->epoll_fd, EPOLL_CTL_ADD, shard->wakeup.fd, &ev) < 0)
+    {
+        logger_write(LOG_LEVEL_ERROR, "[서버] eventfd epoll 등록 실패: %s", strerror(errno));
+        close(shard->epoll_fd);
+        return false;
+    }
+    return true;
+}
+
+// epoll 방식 루프
+static void epoll_loop(Shard *shard)
+{
+    struct epoll_event events[MAX_EVENTS];
+    while (!__atomic_load_n(&g_stop_requested, __ATOMIC_RELAXED))
+    {
+        run_bulk_jobs(shard);
+        drain_ready(shard);
+        flush_wakeups(shard);
+        shard->io_syscalls++;
+        int n = epoll_wait(shard->epoll_fd, events, MAX_EVENTS, wait_timeout(shard));
+        update_clock(shard);
+        if (n < 0)
+        {
+            // 시그널에 의한 중단은 종료 플래그를 다시 확인
+            if (errno == EINTR)
+                continue;
+            logger_write(LOG_LEVEL_ERROR, "[서버] epoll_wait 실패: %s", strerror(errno));
+            break;
+        }
+        bool woken = false;
+        for (int i = 0; i < n; i++)
+        {
+            Connection *conn = (Connection *)events[i].data.ptr;
+            // 새 연결 (TCP 또는 로컬 서버 소켓)
+            if (conn == &shard->listener || conn == &shard->local_listener)
+            {
+                accept_connections(shard, conn->fd);
+                continue;
+            }
+            // 워커 또는 다른 샤드의 알림
+            if (conn == &shard->wakeup)
+            {
+                woken = true;
+                continue;
+            }
+            // 오류 또는 연결 끊김
+            if (events[i].events & (EPOLLERR | EPOLLHUP))
+            {
+                close_connection(conn);
+                continue;
+            }
+            if (events[i].events & EPOLLOUT)
+            {
+                handle_writable(conn);
+            }
+            else if (events[i].events & EPOLLIN)
+            {
+                handle_readable(conn);
+            }
+        }
+        // 완료된 작업은 이번 이벤트를 모두 처리한 뒤에 처리
+        // (완료 처리 중에 연결이 닫혀 해제될 수 있으므로, 그 연결의 이벤트가 배열 뒤쪽에 남아 있으면 안 됨)
+        if (woken)
+            drain_completions(shard);
+        run_timers(shard);
+        if (__atomic_load_n(&g_drain_requested, __ATOMIC_ACQUIRE))
+            drain_connections(shard);
+    }
+}
+
+// 샤드 스레드를 CPU 하나에 고정 (연결과 파티션 데이터가 한 코어의 캐시에 머물도록)
+static void pin_to_cpu(int cpu)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+// 샤드 하나의 이벤트 루프 실행 (입출력 방식 준비 → 루프 → 정리)
+static void shard_run(Shard *shard)
+{
+    if (g_sharded)
+        pin_to_cpu(shard->index % ps_cpu_count());
+
+    // 입출력 방식 선택 (io_uring을 쓸 수 없으면 epoll)
+    shard->use_uring = g_server_config.io_backend == IO_BACKEND_IO_URING && uring_setup(shard);
+    if (!shard->use_uring && !epoll_setup(shard))
+    {
+        // 이 샤드의 리스너로 들어오는 연결을 받을 수 없으므로 서버 전체 종료
+        shard->failed = true;
+        event_loop_stop();
+        return;
+    }
+
+    if (g_sharded)
+        logger_write(LOG_LEVEL_INFO, "[서버] 샤드 %d 시작 (입출력 방식: %s)", shard->index, shard->use_uring ? "io_uring" : "epoll");
+    else
+        logger_write(LOG_LEVEL_INFO, "[서버] 입출력 방식: %s", shard->use_uring ? "io_uring" : "epoll");
+    if (shard->use_uring)
+        uring_loop(shard);
+    else
+        epoll_loop(shard);
+
+    // 입출력 시스템 콜 통계에 io_uring_enter 호출 수 포함
+    if (shard->use_uring)
+    {
+        shard->io_syscalls += shard->ring.enter_calls;
+        uring_exit(&shard->ring);
+    }
+    else
+    {
+        close(shard->epoll_fd);
+        shard->epoll_fd = -1;
+    }
+}
+
+// 샤드 스레드 (샤드 1부터, 샤드 0은 메인 스레드)
+static PS_THREAD_FUNC(shard_thread)
+{
+    shard_run((Shard *)arg);
+    PS_THREAD_RETURN;
+}
+
+// 샤드 모드: 같은 주소/포트에 리스너를 하나 더 엶 (SO_REUSEPORT로 커널이 연결을 리스너들에 나눠 줌)
+static int open_shard_listener(int listen_fd)
+{
+    struct sockaddr_storage addr;
+    socklen_t addr_len = sizeof(addr);
+    if (getsockname(listen_fd, (struct sockaddr *)&addr, &addr_len) < 0)
+        return -1;
+    int fd = socket(addr.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return -1;
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) < 0 ||
+        bind(fd, (struct sockaddr *)&addr, addr_len) < 0 ||
+        listen(fd, SOMAXCONN) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// 샤드가 넘겨받거나 돌려받고 아직 처리하지 않은 작업 해제 (모든 샤드와 워커가 멈춘 뒤 호출)
+static void discard_jobs(Shard *shard)
+{
+    MpscNode *node;
+    while ((node = mpsc_pop(&shard->inbox)) != NULL)
+    {
+        free_job(job_of(node));
+    }
+    while ((node = mpsc_pop(&shard->done)) != NULL)
+    {
+        free_job(job_of(node));
+    }
+    while (shard->ready_head)
+    {
+        RequestJob *job = shard->ready_head;
+        shard->ready_head = job->next;
+        free_job(job);
+    }
+    shard->ready_tail = NULL;
+    while (shard->bulk_head)
+    {
+        RequestJob *job = shard->bulk_head;
+        shard->bulk_head = job->next;
+        free_job(job);
+    }
+    shard->bulk_tail = NULL;
+}
+
+// 샤드 준비: 완료 알림 eventfd와 리스너 (샤드 0은 받은 서버 소켓을 그대로 사용)
+// 로컬 서버 소켓은 SO_REUSEPORT로 나눌 수 없으므로 샤드 0만 받고,
+// 그 연결의 다른 파티션 요청은 TCP 연결과 마찬가지로 파티션을 맡은 샤드로 넘긴다.
+static bool shard_init(Shard *shard, int index, int listen_fd, int local_fd)
+{
+    shard->index = index;
+    shard->epoll_fd = -1;
+    shard->ring.fd = -1;
+    mpsc_init(&shard->done);
+    mpsc_init(&shard->inbox);
+    shard->now_ms = ps_now_ms();
+    timer_wheel_init(&shard->timers, shard->now_ms, IDLE_TICK_MS);
+    shard->wakeup.fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (shard->wakeup.fd < 0)
+    {
+        logger_write(LOG_LEVEL_ERROR, "[서버] eventfd 생성 실패: %s", strerror(errno));
+        return false;
+    }
+    // 샤드 1부터는 넘겨받은 리스너가 있으면 그것을, 없으면 새로 엶
+    if (index == 0)
+        shard->listen_fd = listen_fd;
+    else
+        shard->listen_fd = index < g_listen_count ? g_listen_fds[index] : open_shard_listener(listen_fd);
+    if (shard->listen_fd < 0)
+    {
+        logger_write(LOG_LEVEL_ERROR, "[서버] 샤드 리스너 생성 실패: %s", strerror(errno));
+        close(shard->wakeup.fd);
+        return false;
+    }
+    shard->listener.fd = shard->listen_fd;
+    shard->local_listener.fd = index == 0 ? local_fd : -1;
+    return true;
+}
+
+// 이벤트 루프 실행
+int event_loop_run(int listen_fd, int local_fd)
+{
+    raise_fd_limit();
+    output_pool_configure((size_t)g_server_config.output_cap_mb * 1024 * 1024,
+                          (size_t)g_server_config.output_high_water_kb * 1024);
+
+    // 샤드 준비 (기본 모드는 샤드 하나)
+    g_sharded = g_server_config.shard_count > 0;
+    g_idle_timers = g_server_config.idle_timeout_sec > 0 || g_server_config.keepalive_sec > 0;
+    int shard_count = g_sharded ? g_server_config.shard_count : 1;
+    g_shards = (Shard *)calloc(shard_count, sizeof(Shard));
+    if (!g_shards)
+        return -1;
+    int ready = 0;
+    for (; ready < shard_count; ready++)
+    {
+        if (!shard_init(&g_shards[ready], ready, listen_fd, local_fd))
+            break;
+    }
+    ps_mutex_lock(&g_shards_lock);
+    g_shard_total = ready;
+    ps_mutex_unlock(&g_shards_lock);
+    bool ok = ready == shard_count;
+
+    if (ok && g_sharded)
+    {
+        // 샤드마다 자기 파티션만 처리하므로 핸들러 직렬화 해제, 샤드 1부터 스레드 시작
+        dispatch_set_sharded(true);
+        logger_write(LOG_LEVEL_INFO, "[서버] 샤드 %d개로 실행합니다. (CPU 코어 %d개)", shard_count, ps_cpu_count());
+        int started = 1;
+        for (; started < shard_count; started++)
+        {
+            if (!ps_thread_create(&g_shards[started].thread, shard_thread, &g_shards[started]))
+            {
+                logger_write(LOG_LEVEL_ERROR, "[서버] 샤드 %d 스레드 시작 실패", started);
+                event_loop_stop();
+                ok = false;
+                break;
+            }
+        }
+        if (ok)
+            shard_run(&g_shards[0]);
+        for (int i = 1; i < started; i++)
+        {
+            ps_thread_join(g_shards[i].thread);
+        }
+    }
+    else if (ok)
+    {
+        // 명령어 핸들러를 실행할 워커 풀 시작
+        if (!worker_pool_start(g_server_config.worker_count, g_server_config.queue_depth, g_server_config.bulk_limit))
+        {
+            logger_write(LOG_LEVEL_ERROR, "[서버] 워커 풀 시작 실패");
+            ok = false;
+        }
+        else
+        {
+            shard_run(&g_shards[0]);
+            // 대기 중인 요청까지 처리한 뒤 워커 종료 (응답은 보내지 않고 버림)
+            worker_pool_stop();
+        }
+    }
+
+    // 입출력 시스템 콜 통계 (io_uring 방식은 io_uring_enter 호출 수 포함)
+    unsigned long long syscalls = 0, requests = 0, forwarded = 0;
+    for (int i = 0; i < ready; i++)
+    {
+        Shard *shard = &g_shards[i];
+        syscalls += shard->io_syscalls;
+        requests += shard->request_total;
+        forwarded += shard->forwarded;
+        ok = ok && !shard->failed;
+    }
+    logger_write(LOG_LEVEL_INFO, "[서버] 입출력 시스템 콜 %llu회 / 요청 %llu개 (요청당 %.2f회)", syscalls, requests,
+                 requests ? (double)syscalls / (double)requests : 0.0);
+    if (g_sharded)
+        logger_write(LOG_LEVEL_INFO, "[서버] 다른 샤드로 넘긴 요청 묶음 %llu개", forwarded);
+    if (load_shed_enabled())
+        logger_write(LOG_LEVEL_INFO, "[서버] 부하 조절로 거절한 요청 %llu개", load_shed_dropped());
+    logger_write(LOG_LEVEL_INFO, "[서버] 송신 대기열 최대 사용량 %zuKB, 상한에 걸려 닫은 연결 %llu개", output_pool_peak() / 1024,
+                 output_pool_overflows());
+
+    // 남은 작업과 샤드 자원 정리 (샤드 0의 서버 소켓과 로컬 서버 소켓은 호출한 쪽이 닫음)
+    // 연결 정리를 요청받았으면 샤드 리스너는 새 프로세스에게 넘기도록 닫지 않고 남겨 둠
+    bool keep_listeners = __atomic_load_n(&g_drain_requested, __ATOMIC_ACQUIRE) != 0;
+    ps_mutex_lock(&g_shards_lock);
+    g_shard_total = 0;
+    ps_mutex_unlock(&g_shards_lock);
+    g_listen_count = keep_listeners ? ready : 0;
+    for (int i = 0; i < ready; i++)
+    {
+        discard_jobs(&g_shards[i]);
+        close(g_shards[i].wakeup.fd);
+        if (keep_listeners)
+            g_listen_fds[i] = g_shards[i].listen_fd;
+        else if (i > 0)
+            close(g_shards[i].listen_fd);
+    }
+    free(g_shards);
+    g_shards = NULL;
+    return ok ? 0 : -1;
+}
+
+// 이벤트 루프 종료 요청 (샤드마다 eventfd로 깨워서 종료 플래그를 확인하게 함)
+void event_loop_stop(void)
+{
+    // 시그널 핸들러에서 호출되므로 중단된 코드의 errno를 보존
+    int saved_errno = errno;
+    __atomic_store_n(&g_stop_requested, 1, __ATOMIC_RELAXED); // 샤드 스레드들이 읽으므로 원자적으로 씀
+    for (int i = 0; i < g_shard_total; i++)
+    {
+        wake_shard(&g_shards[i]);
+    }
+    errno = saved_errno;
+}
+
+// 샤드 1부터의 리스너로 넘겨받은 소켓 사용
+void event_loop_adopt_listeners(const int *fds, int count)
+{
+    g_listen_count = count < MAX_STORE_PARTITIONS ? count : MAX_STORE_PARTITIONS;
+    memcpy(g_listen_fds, fds, sizeof(int) * g_listen_count);
+}
+
+// 연결 정리 요청 (제한 시각을 먼저 기록한 뒤 플래그를 켜고 샤드들을 깨움)
+void event_loop_drain(int timeout_ms)
+{
+    g_drain_deadline_ms = ps_now_ms() + (unsigned long long)timeout_ms;
+    __atomic_store_n(&g_drain_requested, 1, __ATOMIC_RELEASE);
+    ps_mutex_lock(&g_shards_lock);
+    for (int i = 0; i < g_shard_total; i++)
+    {
+        wake_shard(&g_shards[i]);
+    }
+    ps_mutex_unlock(&g_shards_lock);
+}
+
+// event_loop_run이 남겨 둔 샤드 리스너 꺼냄
+int event_loop_take_listeners(int *fds, int max)
+{
+    int count = g_listen_count < max ? g_listen_count : max;
+    memcpy(fds, g_listen_fds, sizeof(int) * count);
+    g_listen_count = 0;
+    return count;
+}
@@ -0,0 +1,35 @@
+// src/event_loop.h
+
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+// Linux 전용: 논블로킹 소켓과 epoll로 모든 클라이언트 연결을 하나의 스레드에서 처리하는 이벤트 루프
+// 연결마다 스레드를 만들지 않으므로 대부분 유휴 상태인 수천~수만 개의 연결도 일정한 메모리로 유지할 수 있다.
+// 이벤트 루프는 요청을 읽고 응답을 쓰는 일만 하고, 명령어 처리는 워커 풀(worker_pool.c)이 담당한다.
+// 샤드 모드(--shards N)에서는 코어마다 이벤트 루프 하나를 두고, 각 루프가 자기 리스너(SO_REUSEPORT)로
+// 연결을 받으며, 자기 파티션(store_partition.h)의 사용자 요청은 워커 없이 직접 처리한다.
+
+// 이벤트 루프 실행 (event_loop_stop이 호출될 때까지 반환하지 않음)
+// - listen_fd: bind/listen이 끝난 서버 소켓 (샤드 모드면 SO_REUSEPORT를 켠 상태여야 함)
+// - local_fd: bind/listen이 끝난 로컬(AF_UNIX) 서버 소켓, 없으면 -1 (샤드 모드에서도 샤드 0이 받음)
+// 반환값: 정상 종료 시 0, epoll/워커 풀/샤드 초기화 실패 시 -1
+int event_loop_run(int listen_fd, int local_fd);
+
+// 이벤트 루프 종료 요청 (시그널 핸들러에서 호출해도 안전)
+void event_loop_stop(void);
+
+// 무중단 재시작(handoff.h)으로 넘겨받은 샤드 리스너 지정 (event_loop_run 전에 호출)
+// fds[i]는 샤드 i의 리스너이며 fds[0]은 event_loop_run의 listen_fd와 같다. 샤드 1부터 새로 열지 않고 이 소켓을 쓴다.
+void event_loop_adopt_listeners(const int *fds, int count);
+
+// 연결 정리 요청 (무중단 재시작 시 이전 프로세스, 다른 스레드에서 호출)
+// 모든 샤드가 새 연결 수락을 멈추고, 열린 연결은 처리 중인 요청의 응답을 보낸 뒤 닫는다.
+// 연결이 모두 닫히거나 timeout_ms가 지나면 이벤트 루프가 종료된다. (event_loop_run 반환)
+// 이때 event_loop_run은 샤드 리스너를 닫지 않고 남겨 두므로 event_loop_take_listeners로 꺼내야 한다.
+void event_loop_drain(int timeout_ms);
+
+// event_loop_run이 남겨 둔 샤드 리스너를 꺼냄 (fds[0]은 listen_fd, 샤드 1부터의 리스너는 꺼낸 쪽이 닫음)
+// 반환값: 꺼낸 리스너 수 (연결 정리를 요청하지 않았으면 0)
+int event_loop_take_listeners(int *fds, int max);
+
+#endif
@@ -1,11 +1,14 @@
 // src/export_util.c
 
 #include "export_util.h"
+#include "platform.h"
+#include "deadline.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <stdbool.h>
+#include <stdarg.h>
 
 // 내부 헬퍼 함수 선언
 static char *format_memo_as_md(const Memo *memo);   // MD 포맷 변환
@@ -125,6 +128,29 @@ static void escape_csv_chars(const char *input, char *output, int out_size)
     output[j] = '\0';
 }
 
+// printf 형식으로 필요한 만큼 할당한 문자열을 만듦 (메모 내용 길이에 제한이 없으므로 고정 버퍼를 쓰지 않음)
+static char *format_string(const char *format, ...)
+{
+    va_list args, copy;
+    va_start(args, format);
+    // 필요한 길이 계산
+    va_copy(copy, args);
+    int needed = vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+    char *result = needed < 0 ? NULL : (char *)malloc((size_t)needed + 1);
+    if (result)
+        vsnprintf(result, (size_t)needed + 1, format, args);
+    va_end(args);
+    return result;
+}
+
+// 이스케이프 결과를 담을 버퍼 할당 (문자 하나가 최대 expand바이트로 늘어남, extra: 따옴표 등 덧붙는 바이트)
+static char *alloc_escaped(size_t len, size_t expand, size_t extra, int *size)
+{
+    *size = (int)(len * expand + extra + 1);
+    return (char *)malloc((size_t)*size);
+}
+
 // 단일 메모 변환 함수 구현
 char *export_single_memo_to_string(const Memo *memo, const char *format)
 {
@@ -146,21 +172,26 @@ char *export_single_memo_to_string(const Memo *memo, const char *format)
     // CSV 포맷
     if (strcmp(format, "CSV") == 0)
     {
-        char buffer[2048];                                  // 버퍼 선언
-        char escaped_title[MAX_MEMO_TITLE_LEN * 2 + 3];     // 제목 이스케이프
-        char escaped_content[MAX_MEMO_CONTENT_LEN * 2 + 3]; // 내용 이스케이프
-        // 제목 이스케이프
-        escape_csv_chars(memo->title, escaped_title, sizeof(escaped_title));
-        // 내용 이스케이프
-        escape_csv_chars(memo->content, escaped_content, sizeof(escaped_content));
+        int title_size, content_size;
+        char *escaped_title = alloc_escaped(memo->title_len, 2, 2, &title_size);       // 제목 이스케이프
+        char *escaped_content = alloc_escaped(memo->content_len, 2, 2, &content_size); // 내용 이스케이프
+        char *result = NULL;
+        if (escaped_title && escaped_content)
+        {
+            // 제목 이스케이프
+            escape_csv_chars(memo->title, escaped_title, title_size);
+            // 내용 이스케이프
+            escape_csv_chars(memo->content, escaped_content, content_size);
 
-        // 헤더와 데이터를 함께 생성 + BOM 추가
-        snprintf(buffer, sizeof(buffer),
-                 "\xEF\xBB\xBF" // UTF-8 BOM for Excel
-                 "id,title,content,created_at,updated_at\n"
-                 "%d,\"%s\",\"%s\",\"=\"\"%s\"\"\",\"=\"\"%s\"\"\"\n", // 날짜/시간을 텍스트로 강제
-                 memo->id, escaped_title, escaped_content, memo->created_at, memo->updated_at);
-        return strdup(buffer);
+            // 헤더와 데이터를 함께 생성 + BOM 추가
+            result = format_string("\xEF\xBB\xBF" // UTF-8 BOM for Excel
+                                   "id,title,content,created_at,updated_at\n"
+                                   "%d,\"%s\",\"%s\",\"=\"\"%s\"\"\",\"=\"\"%s\"\"\"\n", // 날짜/시간을 텍스트로 강제
+                                   memo->id, escaped_title, escaped_content, memo->created_at, memo->updated_at);
+        }
+        free(escaped_title);
+        free(escaped_content);
+        return result;
     }
     // XML 포맷
     if (strcmp(format, "XML") == 0)
@@ -170,103 +201,219 @@ char *export_single_memo_to_string(const Memo *memo, const char *format)
     return NULL;
 }
 
-// 전체 메모 변환 함수 구현 (구조적 결함 수정)
-char *export_all_memos_to_string(const Memo *memo_list, int memo_count, const char *format)
+// 전체 내보내기에서 이스케이프할 문자의 대체 문자열 (없으면 NULL)
+static const char *xml_escape_of(char c)
 {
-    size_t buffer_size = memo_count * (MAX_MEMO_CONTENT_LEN + 512) + 1024; // 여유있는 버퍼 크기
-    char *result_buffer = (char *)malloc(buffer_size);
-    if (result_buffer == NULL)
+    switch (c)
+    {
+    case '<':
+        return "&lt;";
+    case '>':
+        return "&gt;";
+    case '&':
+        return "&amp;";
+    case '\"':
+        return "&quot;";
+    case '\'':
+        return "&apos;";
+    default:
         return NULL;
-    result_buffer[0] = '\0';
-    size_t offset = 0;
+    }
+}
 
-    // CSV 포맷
-    if (strcmp(format, "CSV") == 0)
+static const char *json_escape_of(char c)
+{
+    switch (c)
     {
-        // BOM 추가 (Excel 호환을 위해)
-        offset += snprintf(result_buffer + offset, buffer_size - offset, "\xEF\xBB\xBF");
-        // 헤더 추가
-        offset += snprintf(result_buffer + offset, buffer_size - offset, "id,title,content,created_at,updated_at\n");
-        for (int i = 0; i < memo_count; i++)
-        {
-            char escaped_title[MAX_MEMO_TITLE_LEN * 2 + 3];     // 제목 이스케이프
-            char escaped_content[MAX_MEMO_CONTENT_LEN * 2 + 3]; // 내용 이스케이프
-            // 제목 이스케이프
-            escape_csv_chars(memo_list[i].title, escaped_title, sizeof(escaped_title));
-            // 내용 이스케이프
-            escape_csv_chars(memo_list[i].content, escaped_content, sizeof(escaped_content));
-            offset += snprintf(result_buffer + offset, buffer_size - offset, "%d,\"%s\",\"%s\",\"=\"\"%s\"\"\",\"=\"\"%s\"\"\"\n", // 날짜/시간을 텍스트로 강제
-                               memo_list[i].id, escaped_title, escaped_content, memo_list[i].created_at, memo_list[i].updated_at);
-        }
+    case '\"':
+        return "\\\"";
+    case '\\':
+        return "\\\\";
+    case '\b':
+        return "\\b";
+    case '\f':
+        return "\\f";
+    case '\n':
+        return "\\n";
+    case '\r':
+        return "\\r";
+    case '\t':
+        return "\\t";
+    default:
+        return NULL;
     }
-    // JSON 포맷
-    else if (strcmp(format, "JSON") == 0)
+}
+
+static const char *csv_escape_of(char c)
+{
+    return c == '\"' ? "\"\"" : NULL;
+}
+
+// 문자열을 이스케이프하며 응답에 붙임
+// 이스케이프할 문자 사이의 구간은 복사하지 않고 가리키고, 대체 문자열만 붙인다. (escape_*_chars와 같은 결과)
+static void append_escaped(ReplyBuffer *reply, const char *input, const char *(*escape_of)(char))
+{
+    const char *run = input;
+    const char *p = input;
+    for (; *p != '\0'; p++)
     {
-        offset += snprintf(result_buffer + offset, buffer_size - offset, "[\n");
-        for (int i = 0; i < memo_count; i++)
+        const char *escaped = escape_of(*p);
+        if (escaped)
         {
-            char escaped_title[MAX_MEMO_TITLE_LEN * 6];     // 제목 이스케이프
-            char escaped_content[MAX_MEMO_CONTENT_LEN * 6]; // 내용 이스케이프
-            // 제목 이스케이프
-            escape_json_chars(memo_list[i].title, escaped_title, sizeof(escaped_title));
-            // 내용 이스케이프
-            escape_json_chars(memo_list[i].content, escaped_content, sizeof(escaped_content));
-            offset += snprintf(result_buffer + offset, buffer_size - offset, "  {\"id\":%d,\"title\":\"%s\",\"content\":\"%s\",\"created_at\":\"%s\",\"updated_at\":\"%s\"}",
-                               memo_list[i].id, escaped_title, escaped_content, memo_list[i].created_at, memo_list[i].updated_at);
-            if (i < memo_count - 1)
-            {
-                offset += snprintf(result_buffer + offset, buffer_size - offset, ",\n");
-            }
+            reply_append_ref(reply, run, (size_t)(p - run));
+            reply_append(reply, escaped, strlen(escaped));
+            run = p + 1;
         }
-        offset += snprintf(result_buffer + offset, buffer_size - offset, "\n]");
     }
-    // XML 포맷
-    else if (strcmp(format, "XML") == 0)
+    reply_append_ref(reply, run, (size_t)(p - run));
+}
+
+// 문자열을 그대로 응답에 붙임 (메모 필드, 정적 형식 문자열)
+static void append_field(ReplyBuffer *reply, const char *field)
+{
+    reply_append_ref(reply, field, strlen(field));
+}
+
+// CSV 필드를 응답에 붙임 (escape_csv_chars와 같은 규칙: 쉼표, 큰따옴표, 줄바꿈이 있으면 큰따옴표로 감쌈)
+static void append_csv_field(ReplyBuffer *reply, const char *input)
+{
+    if (strpbrk(input, ",\"\n") == NULL)
     {
-        offset += snprintf(result_buffer + offset, buffer_size - offset, "<memos>\n");
-        for (int i = 0; i < memo_count; i++)
-        {
-            char escaped_title[MAX_MEMO_TITLE_LEN * 6];     // 제목 이스케이프
-            char escaped_content[MAX_MEMO_CONTENT_LEN * 6]; // 내용 이스케이프
-            // 제목 이스케이프
-            escape_xml_chars(memo_list[i].title, escaped_title, sizeof(escaped_title));
-            // 내용 이스케이프
-            escape_xml_chars(memo_list[i].content, escaped_content, sizeof(escaped_content));
-            offset += snprintf(result_buffer + offset, buffer_size - offset,
-                               "  <memo>\n"
-                               "    <id>%d</id>\n"
-                               "    <title>%s</title>\n"
-                               "    <content>%s</content>\n"
-                               "    <created_at>%s</created_at>\n"
-                               "    <updated_at>%s</updated_at>\n"
-                               "  </memo>\n",
-                               memo_list[i].id, escaped_title, escaped_content, memo_list[i].created_at, memo_list[i].updated_at);
-        }
-        offset += snprintf(result_buffer + offset, buffer_size - offset, "</memos>");
+        append_field(reply, input);
+        return;
     }
-    // MD & TXT 포맷
-    else
+    append_field(reply, "\"");
+    append_escaped(reply, input, csv_escape_of);
+    append_field(reply, "\"");
+}
+
+// 전체 내보내기 형식
+typedef enum
+{
+    EXPORT_CSV,
+    EXPORT_JSON,
+    EXPORT_XML,
+    EXPORT_MD,
+    EXPORT_TXT
+} ExportFormat;
+
+// 전체 내보내기 중인 응답 (memo_visit_user의 visitor 인자)
+typedef struct
+{
+    ReplyBuffer *reply;  // 응답
+    ExportFormat format; // 형식
+    int count;           // 지금까지 붙인 메모 수
+} ExportContext;
+
+// 메모 하나를 형식에 맞춰 응답에 붙임
+// 메모의 제목/내용/날짜는 복사하지 않고 가리키므로, 응답을 보낼 때까지 메모를 붙잡아 둔다.
+static void append_memo(const Memo *memo, void *ctx)
+{
+    ExportContext *export = (ExportContext *)ctx;
+    ReplyBuffer *reply = export->reply;
+    memo_pin(memo, reply);
+    switch (export->format)
     {
-        for (int i = 0; i < memo_count; i++)
-        {
-            char *single_memo_str = export_single_memo_to_string(&memo_list[i], format);
-            if (single_memo_str)
-            {
-                offset += snprintf(result_buffer + offset, buffer_size - offset, "%s", single_memo_str);
-                if (strcmp(format, "MD") == 0)
-                {
-                    offset += snprintf(result_buffer + offset, buffer_size - offset, "\n---\n\n");
-                }
-                else if (strcmp(format, "TXT") == 0)
-                {
-                    offset += snprintf(result_buffer + offset, buffer_size - offset, "====================\n\n");
-                }
-                free(single_memo_str);
-            }
-        }
+    case EXPORT_CSV:
+        // "%d,\"%s\",\"%s\",\"=\"\"%s\"\"\",\"=\"\"%s\"\"\"\n" (날짜/시간을 텍스트로 강제)
+        reply_printf(reply, "%d,\"", memo->id);
+        append_csv_field(reply, memo->title);
+        append_field(reply, "\",\"");
+        append_csv_field(reply, memo->content);
+        append_field(reply, "\",\"=\"\"");
+        append_field(reply, memo->created_at);
+        append_field(reply, "\"\"\",\"=\"\"");
+        append_field(reply, memo->updated_at);
+        append_field(reply, "\"\"\"\n");
+        break;
+    case EXPORT_JSON:
+        // 메모 사이에만 ",\n"
+        reply_printf(reply, "%s  {\"id\":%d,\"title\":\"", export->count > 0 ? ",\n" : "", memo->id);
+        append_escaped(reply, memo->title, json_escape_of);
+        append_field(reply, "\",\"content\":\"");
+        append_escaped(reply, memo->content, json_escape_of);
+        append_field(reply, "\",\"created_at\":\"");
+        append_field(reply, memo->created_at);
+        append_field(reply, "\",\"updated_at\":\"");
+        append_field(reply, memo->updated_at);
+        append_field(reply, "\"}");
+        break;
+    case EXPORT_XML:
+        reply_printf(reply, "  <memo>\n    <id>%d</id>\n    <title>", memo->id);
+        append_escaped(reply, memo->title, xml_escape_of);
+        append_field(reply, "</title>\n    <content>");
+        append_escaped(reply, memo->content, xml_escape_of);
+        append_field(reply, "</content>\n    <created_at>");
+        append_field(reply, memo->created_at);
+        append_field(reply, "</created_at>\n    <updated_at>");
+        append_field(reply, memo->updated_at);
+        append_field(reply, "</updated_at>\n  </memo>\n");
+        break;
+    case EXPORT_MD:
+        // format_memo_as_md 뒤에 구분선
+        reply_printf(reply, "---\nid: %d\ncreated_at: ", memo->id);
+        append_field(reply, memo->created_at);
+        append_field(reply, "\nupdated_at: ");
+        append_field(reply, memo->updated_at);
+        append_field(reply, "\n---\n\n# ");
+        append_field(reply, memo->title);
+        append_field(reply, "\n\n");
+        append_field(reply, memo->content);
+        append_field(reply, "\n\n\n---\n\n");
+        break;
+    case EXPORT_TXT:
+        // format_memo_as_txt 뒤에 구분선
+        reply_printf(reply, "ID: %d\n작성일시: ", memo->id);
+        append_field(reply, memo->created_at);
+        append_field(reply, "\n수정일시: ");
+        append_field(reply, memo->updated_at);
+        append_field(reply, "\n제목: ");
+        append_field(reply, memo->title);
+        append_field(reply, "\n\n--------------------\n");
+        append_field(reply, memo->content);
+        append_field(reply, "\n\n====================\n\n");
+        break;
     }
+    export->count++;
+}
+
+// 사용자의 모든 메모를 지정된 형식으로 응답 끝에 붙임
+// 메모 사이마다 요청 기한(deadline.h)을 확인하고, 지났으면 남은 메모를 건너뜀 (만들다 만 응답은 호출자가 버림)
+int export_all_memos_to_reply(const char *user_id, const char *format, ReplyBuffer *reply)
+{
+    ExportContext export = {reply, EXPORT_CSV, 0};
+    if (strcmp(format, "CSV") == 0)
+        export.format = EXPORT_CSV;
+    else if (strcmp(format, "JSON") == 0)
+        export.format = EXPORT_JSON;
+    else if (strcmp(format, "XML") == 0)
+        export.format = EXPORT_XML;
+    else if (strcmp(format, "MD") == 0)
+        export.format = EXPORT_MD;
+    else if (strcmp(format, "TXT") == 0)
+        export.format = EXPORT_TXT;
+    else
+        return -1;
+
+    // 머리말 (CSV는 Excel 호환을 위한 BOM과 헤더)
+    if (export.format == EXPORT_CSV)
+        append_field(reply, "\xEF\xBB\xBF"
+                            "id,title,content,created_at,updated_at\n");
+    else if (export.format == EXPORT_JSON)
+        append_field(reply, "[\n");
+    else if (export.format == EXPORT_XML)
+        append_field(reply, "<memos>\n");
 
-    return result_buffer;
+    // 메모가 없으면 호출자가 실패 응답으로 바꿈
+    if (memo_visit_user(user_id, append_memo, &export) == 0)
+        return 0;
+
+    // 맺음말
+    if (export.format == EXPORT_JSON)
+        append_field(reply, "\n]");
+    else if (export.format == EXPORT_XML)
+        append_field(reply, "</memos>");
+    return export.count;
 }
 
 // 각 포맷별 실제 변환 로직
@@ -274,69 +421,73 @@ char *export_all_memos_to_string(const Memo *memo_list, int memo_count, const ch
 // MD 포맷
 static char *format_memo_as_md(const Memo *memo)
 {
-    char buffer[2048];
-    snprintf(buffer, sizeof(buffer),
-             "---\nid: %d\ncreated_at: %s\nupdated_at: %s\n---\n\n# %s\n\n%s\n\n",
-             memo->id, memo->created_at, memo->updated_at, memo->title, memo->content);
-    return strdup(buffer);
+    return format_string("---\nid: %d\ncreated_at: %s\nupdated_at: %s\n---\n\n# %s\n\n%s\n\n",
+                         memo->id, memo->created_at, memo->updated_at, memo->title, memo->content);
 }
 
 // TXT 포맷
 static char *format_memo_as_txt(const Memo *memo)
 {
-    char buffer[2048];
-    snprintf(buffer, sizeof(buffer),
-             "ID: %d\n작성일시: %s\n수정일시: %s\n제목: %s\n\n--------------------\n%s\n\n",
-             memo->id, memo->created_at, memo->updated_at, memo->title, memo->content);
-    return strdup(buffer);
+    return format_string("ID: %d\n작성일시: %s\n수정일시: %s\n제목: %s\n\n--------------------\n%s\n\n",
+                         memo->id, memo->created_at, memo->updated_at, memo->title, memo->content);
 }
 
 // JSON 포맷
 static char *format_memo_as_json(const Memo *memo)
 {
-    char escaped_title[MAX_MEMO_TITLE_LEN * 6];     // 제목 이스케이프
-    char escaped_content[MAX_MEMO_CONTENT_LEN * 6]; // 내용 이스케이프
-    // 제목 이스케이프
-    escape_json_chars(memo->title, escaped_title, sizeof(escaped_title));
-    // 내용 이스케이프
-    escape_json_chars(memo->content, escaped_content, sizeof(escaped_content));
+    int title_size, content_size;
+    char *escaped_title = alloc_escaped(memo->title_len, 2, 0, &title_size);       // 제목 이스케이프
+    char *escaped_content = alloc_escaped(memo->content_len, 2, 0, &content_size); // 내용 이스케이프
+    char *result = NULL;
+    if (escaped_title && escaped_content)
+    {
+        // 제목 이스케이프
+        escape_json_chars(memo->title, escaped_title, title_size);
+        // 내용 이스케이프
+        escape_json_chars(memo->content, escaped_content, content_size);
 
-    char buffer[2048];
-    snprintf(buffer, sizeof(buffer),
-             "[\n"
-             "  {\n"
-             "    \"id\": %d,\n"
-             "    \"title\": \"%s\",\n"
-             "    \"content\": \"%s\",\n"
-             "    \"created_at\": \"%s\",\n"
-             "    \"updated_at\": \"%s\"\n"
-             "  }\n"
-             "]",
-             memo->id, escaped_title, escaped_content, memo->created_at, memo->updated_at);
-    return strdup(buffer);
+        result = format_string("[\n"
+                               "  {\n"
+                               "    \"id\": %d,\n"
+                               "    \"title\": \"%s\",\n"
+                               "    \"content\": \"%s\",\n"
+                               "    \"created_at\": \"%s\",\n"
+                               "    \"updated_at\": \"%s\"\n"
+                               "  }\n"
+                               "]",
+                               memo->id, escaped_title, escaped_content, memo->created_at, memo->updated_at);
+    }
+    free(escaped_title);
+    free(escaped_content);
+    return result;
 }
 
 // XML 포맷
 static char *format_memo_as_xml(const Memo *memo)
 {
-    char escaped_title[MAX_MEMO_TITLE_LEN * 6];     // 제목 이스케이프
-    char escaped_content[MAX_MEMO_CONTENT_LEN * 6]; // 내용 이스케이프
-    // 제목 이스케이프
-    escape_xml_chars(memo->title, escaped_title, sizeof(escaped_title));
-    // 내용 이스케이프
-    escape_xml_chars(memo->content, escaped_content, sizeof(escaped_content));
+    int title_size, content_size;
+    char *escaped_title = alloc_escaped(memo->title_len, 6, 0, &title_size);       // 제목 이스케이프
+    char *escaped_content = alloc_escaped(memo->content_len, 6, 0, &content_size); // 내용 이스케이프
+    char *result = NULL;
+    if (escaped_title && escaped_content)
+    {
+        // 제목 이스케이프
+        escape_xml_chars(memo->title, escaped_title, title_size);
+        // 내용 이스케이프
+        escape_xml_chars(memo->content, escaped_content, content_size);
 
-    char buffer[2048];
-    snprintf(buffer, sizeof(buffer),
-             "<memos>\n"
-             "  <memo>\n"
-             "    <id>%d</id>\n"
-             "    <title>%s</title>\n"
-             "    <content>%s</content>\n"
-             "    <created_at>%s</created_at>\n"
-             "    <updated_at>%s</updated_at>\n"
-             "  </memo>\n"
-             "</memos>",
-             memo->id, escaped_title, escaped_content, memo->created_at, memo->updated_at);
-    return strdup(buffer);
+        result = format_string("<memos>\n"
+                               "  <memo>\n"
+                               "    <id>%d</id>\n"
+                               "    <title>%s</title>\n"
+                               "    <content>%s</content>\n"
+                               "    <created_at>%s</created_at>\n"
+                               "    <updated_at>%s</updated_at>\n"
+                               "  </memo>\n"
+                               "</memos>",
+                               memo->id, escaped_title, escaped_content, memo->created_at, memo->updated_at);
+    }
+    free(escaped_title);
+    free(escaped_content);
+    return result;
 }
@@ -10,9 +10,11 @@
 // 호출자는 반환된 문자열을 free() 해주어야 함
 char *export_single_memo_to_string(const Memo *memo, const char *format);
 
-// 사용자의 모든 메모 목록을 지정된 형식의 문자열로 변환
-// 성공 시 동적으로 할당된 문자열 포인터 반환, 실패 시 NULL 반환
-// 호출자는 반환된 문자열을 free() 해주어야 함
-char *export_all_memos_to_string(const Memo *memo_list, int memo_count, const char *format);
+// 사용자의 모든 메모를 지정된 형식으로 응답 끝에 붙임
+// 메모를 따로 복사하거나 중간 문자열을 만들지 않는다. 응답이 모아 보내기(gather)면 메모의 제목/내용/날짜와
+// 긴 정적 형식 문자열은 가리키기만 하고(memo_pin으로 메모를 붙잡음), 아니면 응답에 한 번만 복사한다.
+// 요청 기한(deadline.h)이 지나면 메모 사이에서 멈추므로, 호출자는 deadline_expired()로 결과가 완전한지 확인해야 함
+// 반환값: 붙인 메모 수 (지원하지 않는 형식이면 -1)
+int export_all_memos_to_reply(const char *user_id, const char *format, ReplyBuffer *reply);
 
 #endif
@@ -0,0 +1,185 @@
+// src/frame.c
+
+#include "frame.h"
+#include <string.h>
+#include <errno.h>
+
+#define RECV_CHUNK 65536 // 본문을 나누어 받을 때의 단위
+
+// 빅 엔디언 32비트 값 쓰기
+void frame_put_u32(unsigned char *out, uint32_t value)
+{
+    out[0] = (unsigned char)(value >> 24);
+    out[1] = (unsigned char)(value >> 16);
+    out[2] = (unsigned char)(value >> 8);
+    out[3] = (unsigned char)value;
+}
+
+// 빅 엔디언 32비트 값 읽기
+uint32_t frame_get_u32(const unsigned char *in)
+{
+    return ((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) | ((uint32_t)in[2] << 8) | (uint32_t)in[3];
+}
+
+// 헤더 8바이트 생성
+void frame_encode_header(unsigned char *out, uint8_t flags, uint32_t length)
+{
+    out[0] = FRAME_MAGIC;
+    out[1] = flags;
+    out[2] = 0;
+    out[3] = 0;
+    // 본문 길이 (빅 엔디언)
+    frame_put_u32(out + 4, length);
+}
+
+// 헤더 8바이트 해석
+bool frame_decode_header(const unsigned char *in, FrameHeader *header)
+{
+    if (in[0] != FRAME_MAGIC)
+        return false;
+    header->flags = in[1];
+    header->length = frame_get_u32(in + 4);
+    header->request_id = 0;
+    header->timeout_ms = 0;
+    // 요청 ID나 제한 시간이 있다고 표시했으면 본문이 그보다 짧을 수 없음
+    if (header->length < frame_prefix_size(header->flags))
+        return false;
+    return header->length <= FRAME_MAX_PAYLOAD;
+}
+
+// 본문 앞에 붙는 요청 ID와 제한 시간의 크기 합
+size_t frame_prefix_size(uint8_t flags)
+{
+    return ((flags & FRAME_FLAG_REQUEST_ID) ? FRAME_REQUEST_ID_SIZE : 0) +
+           ((flags & FRAME_FLAG_DEADLINE) ? FRAME_DEADLINE_SIZE : 0);
+}
+
+// 본문 앞의 요청 ID와 제한 시간 해석
+void frame_decode_prefix(const unsigned char *in, FrameHeader *header)
+{
+    header->request_id = 0;
+    header->timeout_ms = 0;
+    if (header->flags & FRAME_FLAG_REQUEST_ID)
+    {
+        header->request_id = frame_get_u32(in);
+        in += FRAME_REQUEST_ID_SIZE;
+    }
+    if (header->flags & FRAME_FLAG_DEADLINE)
+        header->timeout_ms = frame_get_u32(in);
+}
+
+// 요청한 바이트를 모두 보낼 때까지 반복 전송
+static bool send_all(SOCKET sock, const char *data, size_t len)
+{
+    while (len > 0)
+    {
+        int chunk = len > RECV_CHUNK ? RECV_CHUNK : (int)len;
+        int sent = send(sock, data, chunk, 0);
+        if (sent < 0 && errno == EINTR)
+            continue;
+        if (sent <= 0)
+            return false;
+        data += sent;
+        len -= (size_t)sent;
+    }
+    return true;
+}
+
+// 요청한 바이트를 모두 받을 때까지 반복 수신
+static bool recv_all(SOCKET sock, char *data, size_t len)
+{
+    while (len > 0)
+    {
+        int chunk = len > RECV_CHUNK ? RECV_CHUNK : (int)len;
+        int bytes = recv(sock, data, chunk, 0);
+        if (bytes < 0 && errno == EINTR)
+            continue;
+        // 연결 종료 또는 오류
+        if (bytes <= 0)
+            return false;
+        data += bytes;
+        len -= (size_t)bytes;
+    }
+    return true;
+}
+
+// 본문에 헤더를 붙여 전부 전송
+bool frame_send(SOCKET sock, const char *payload, size_t len)
+{
+    return frame_send_ex(sock, 0, 0, payload, len);
+}
+
+// 플래그와 요청 ID를 지정하여 전송
+bool frame_send_ex(SOCKET sock, uint8_t flags, uint32_t request_id, const char *payload, size_t len)
+{
+    return frame_send_request(sock, flags & (uint8_t)~FRAME_FLAG_DEADLINE, request_id, 0, payload, len);
+}
+
+// 플래그, 요청 ID, 제한 시간을 지정하여 전송
+bool frame_send_request(SOCKET sock, uint8_t flags, uint32_t request_id, uint32_t timeout_ms, const char *payload, size_t len)
+{
+    // 헤더와 요청 ID, 제한 시간을 한 번에 전송
+    unsigned char header[FRAME_HEADER_SIZE + FRAME_REQUEST_ID_SIZE + FRAME_DEADLINE_SIZE];
+    size_t header_len = FRAME_HEADER_SIZE;
+    if (flags & FRAME_FLAG_REQUEST_ID)
+    {
+        frame_put_u32(header + header_len, request_id);
+        header_len += FRAME_REQUEST_ID_SIZE;
+    }
+    if (flags & FRAME_FLAG_DEADLINE)
+    {
+        frame_put_u32(header + header_len, timeout_ms);
+        header_len += FRAME_DEADLINE_SIZE;
+    }
+    if (len + (header_len - FRAME_HEADER_SIZE) > FRAME_MAX_PAYLOAD)
+        return false;
+    frame_encode_header(header, flags, (uint32_t)(len + header_len - FRAME_HEADER_SIZE));
+    return send_all(sock, (const char *)header, header_len) && send_all(sock, payload, len);
+}
+
+// 프레임 하나를 끝까지 수신
+bool frame_recv(SOCKET sock, ReplyBuffer *payload)
+{
+    FrameHeader header;
+    return frame_recv_ex(sock, payload, &header);
+}
+
+// 프레임 하나를 수신하고 헤더 정보도 돌려줌
+bool frame_recv_ex(SOCKET sock, ReplyBuffer *payload, FrameHeader *header)
+{
+    // 헤더 수신 및 해석 (연결 확인 프레임은 본문까지 읽어 버림)
+    unsigned char raw[FRAME_HEADER_SIZE];
+    do
+    {
+        if (!recv_all(sock, (char *)raw, sizeof(raw)) || !frame_decode_header(raw, header))
+            return false;
+        if ((header->flags & FRAME_FLAG_KEEPALIVE) && header->length > 0)
+        {
+            reply_clear(payload);
+            if (!reply_reserve(payload, header->length) || !recv_all(sock, payload->data, header->length))
+                return false;
+        }
+    } while (header->flags & FRAME_FLAG_KEEPALIVE);
+
+    // 요청 ID와 제한 시간 수신
+    uint32_t body_len = header->length;
+    size_t prefix_len = frame_prefix_size(header->flags);
+    if (prefix_len > 0)
+    {
+        unsigned char prefix[FRAME_REQUEST_ID_SIZE + FRAME_DEADLINE_SIZE];
+        if (!recv_all(sock, (char *)prefix, prefix_len))
+            return false;
+        frame_decode_prefix(prefix, header);
+        body_len -= (uint32_t)prefix_len;
+    }
+
+    // 본문 크기만큼 버퍼 확보 후 직접 수신
+    reply_clear(payload);
+    if (!reply_reserve(payload, body_len))
+        return false;
+    if (!recv_all(sock, payload->data, body_len))
+        return false;
+    payload->len = body_len;
+    payload->data[payload->len] = '\0';
+    return true;
+}
@@ -0,0 +1,92 @@
+// src/frame.h
+
+#ifndef FRAME_H
+#define FRAME_H
+
+#include "platform.h"
+#include "reply_buffer.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 길이 헤더가 붙은 메시지(프레임) 형식
+//
+//   바이트 0    : FRAME_MAGIC (0xF5)
+//   바이트 1    : 플래그 (FRAME_FLAG_*)
+//   바이트 2~3  : 예약 (0)
+//   바이트 4~7  : 본문 길이 (빅 엔디언 32비트)
+//   이후        : 본문 (요청 또는 응답 문자열, null 문자 없음)
+//
+// FRAME_FLAG_REQUEST_ID가 켜져 있으면 본문 앞 4바이트(빅 엔디언)가 요청 ID이고,
+// 서버는 응답에 같은 ID를 붙여 돌려준다. ID가 붙은 요청은 같은 연결의 다른 요청을
+// 기다리지 않고 처리되므로 응답 순서가 요청 순서와 다를 수 있다.
+// (ID 없는 요청끼리는 항상 보낸 순서대로 처리/응답한다.)
+//
+// FRAME_FLAG_DEADLINE이 켜져 있으면 (요청 ID가 있으면 그 뒤의) 다음 4바이트(빅 엔디언)가 제한 시간(밀리초, 0이면 제한 없음)이다.
+// 클라이언트가 그 시간이 지나면 응답을 기다리지 않는다는 뜻이며, 서버는 프레임을 받은 시각 + 제한 시간을
+// 요청의 기한으로 기록하고 기한이 지난 요청은 처리하지 않거나 중간에 멈춘다 (deadline.h).
+// 시계가 서로 다른 호스트 사이에서도 쓸 수 있도록 절대 시각이 아니라 남은 시간을 보낸다. 응답에는 붙지 않는다.
+//
+// FRAME_FLAG_KEEPALIVE 프레임은 서버가 오래 조용한 연결에 보내는 빈 확인 프레임(keepalive ping)이다.
+// HELLO에서 "PING"을 제시한 연결에만 보내며, 클라이언트는 응답하지 않고 버린다 (frame_recv가 알아서 건너뜀).
+//
+// 0xF5는 ASCII 문자도 UTF-8 시작 바이트도 아니므로, 서버는 첫 바이트만 보고
+// 길이 헤더 없이 요청을 보내는 이전 클라이언트와 구분할 수 있다.
+
+#define FRAME_MAGIC 0xF5                       // 프레임 시작 바이트
+#define FRAME_HEADER_SIZE 8                    // 헤더 크기
+#define FRAME_MAX_REQUEST (1024 * 1024)        // 서버가 받아들이는 최대 요청 본문 크기
+#define FRAME_MAX_PAYLOAD (256u * 1024 * 1024) // 최대 본문 크기 (응답 포함)
+#define FRAME_REQUEST_ID_SIZE 4                // 요청 ID 크기
+#define FRAME_DEADLINE_SIZE 4                  // 제한 시간 크기
+
+// 플래그
+#define FRAME_FLAG_REQUEST_ID 0x01 // 본문 앞에 요청 ID가 있음
+#define FRAME_FLAG_DEADLINE 0x02   // 본문 앞(요청 ID 뒤)에 제한 시간이 있음 (요청에만 사용)
+#define FRAME_FLAG_KEEPALIVE 0x04  // 서버가 보낸 연결 확인 프레임 (본문 없음, 응답 아님)
+
+// 해석된 프레임 헤더
+typedef struct
+{
+    uint8_t flags;       // 플래그
+    uint32_t length;     // 본문 길이 (요청 ID와 제한 시간 포함)
+    uint32_t request_id; // 요청 ID (frame_recv_ex/frame_decode_prefix가 채움, 없으면 0)
+    uint32_t timeout_ms; // 제한 시간 (frame_recv_ex/frame_decode_prefix가 채움, 없으면 0)
+} FrameHeader;
+
+// 헤더 8바이트 생성
+void frame_encode_header(unsigned char *out, uint8_t flags, uint32_t length);
+
+// 헤더 8바이트 해석
+// 반환값: 올바른 헤더면 true, 시작 바이트가 다르거나 길이가 FRAME_MAX_PAYLOAD를 넘으면 false
+bool frame_decode_header(const unsigned char *in, FrameHeader *header);
+
+// 본문 앞에 붙는 요청 ID와 제한 시간의 크기 합 (플래그로 결정)
+size_t frame_prefix_size(uint8_t flags);
+
+// 본문 앞의 요청 ID와 제한 시간 해석 (in은 frame_prefix_size(header->flags)바이트 이상이어야 함)
+void frame_decode_prefix(const unsigned char *in, FrameHeader *header);
+
+// 빅 엔디언 32비트 값 쓰기/읽기
+void frame_put_u32(unsigned char *out, uint32_t value);
+uint32_t frame_get_u32(const unsigned char *in);
+
+// 본문에 헤더를 붙여 전부 전송 (블로킹 소켓용)
+bool frame_send(SOCKET sock, const char *payload, size_t len);
+
+// 플래그와 요청 ID를 지정하여 전송 (FRAME_FLAG_REQUEST_ID가 없으면 request_id는 무시)
+bool frame_send_ex(SOCKET sock, uint8_t flags, uint32_t request_id, const char *payload, size_t len);
+
+// 플래그, 요청 ID, 제한 시간을 지정하여 전송 (FRAME_FLAG_DEADLINE이 없으면 timeout_ms는 무시)
+bool frame_send_request(SOCKET sock, uint8_t flags, uint32_t request_id, uint32_t timeout_ms, const char *payload, size_t len);
+
+// 프레임 하나를 끝까지 수신하여 payload에 저장 (블로킹 소켓용)
+// 중간에 온 연결 확인 프레임(FRAME_FLAG_KEEPALIVE)은 건너뛰고 다음 프레임을 받는다.
+// 반환값: 수신 성공 시 true, 연결 종료/오류/잘못된 헤더면 false
+bool frame_recv(SOCKET sock, ReplyBuffer *payload);
+
+// 프레임 하나를 수신하고 헤더 정보도 돌려줌
+// 요청 ID와 제한 시간이 있으면 header->request_id/timeout_ms에 저장하고 payload에는 그 뒤의 본문만 담는다.
+bool frame_recv_ex(SOCKET sock, ReplyBuffer *payload, FrameHeader *header);
+
+#endif
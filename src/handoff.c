@@ -0,0 +1,330 @@
+// src/handoff.c
+
+#define _GNU_SOURCE // accept4 (SOCK_CLOEXEC)
+
+#include "handoff.h"
+#include "platform.h"
+#include "logger.h"
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+#define HANDOFF_MAGIC "HANDOFF2"                   // 요청과 응답 앞의 식별 문자열 (형식이 바뀌면 숫자를 올림)
+#define HANDOFF_MAGIC_LEN 8                        // 식별 문자열 길이
+#define HANDOFF_REQUEST_SEC 5                      // 연결한 쪽이 요청을 보내기까지 기다리는 최대 시간
+#define HANDOFF_MAX_FDS (MAX_STORE_PARTITIONS + 1) // 한 번에 넘기는 최대 소켓 수 (TCP 리스너 + 로컬 리스너)
+
+// 새 프로세스가 보내는 요청
+typedef struct
+{
+    char magic[HANDOFF_MAGIC_LEN]; // HANDOFF_MAGIC
+    int32_t uses_shm;              // 새 프로세스가 공유 메모리 채널을 쓰면 1
+} HandoffRequest;
+
+// 리스너와 함께 보내는 정보 (소켓은 SCM_RIGHTS로 tcp_count개, 로컬 리스너가 있으면 그 뒤에 하나 더)
+typedef struct
+{
+    char magic[HANDOFF_MAGIC_LEN]; // HANDOFF_MAGIC
+    int32_t tcp_count;             // TCP 리스너 수 (0이면 거절, 소켓 없음)
+    int32_t has_local;             // 로컬 리스너를 함께 보냈으면 1
+    int32_t shard_count;           // 보내는 프로세스의 샤드 수
+} HandoffMessage;
+
+// 소켓 전달용 제어 메시지 버퍼 (cmsghdr 정렬 보장)
+typedef union
+{
+    char buf[CMSG_SPACE(sizeof(int) * HANDOFF_MAX_FDS)];
+    struct cmsghdr align;
+} HandoffControl;
+
+// 이전 프로세스 쪽 상태
+static int g_listen_fd = -1;               // 제어 소켓 (-1이면 닫힘)
+static int g_peer_fd = -1;                 // 넘겨 달라고 요청한 새 프로세스와의 연결 (-1이면 없음)
+static char g_path[108];                   // 제어 소켓 경로 (닫을 때 삭제, sockaddr_un.sun_path 크기)
+static ps_thread_t g_thread;               // 요청 대기 스레드
+static bool g_thread_started = false;      // 대기 스레드 시작 여부
+static int g_requested = 0;                // 요청을 받았는지 여부 (원자적으로 접근)
+static int g_shard_count = 0;              // 이 프로세스의 샤드 수
+static void (*g_on_request)(void) = NULL;  // 요청을 받으면 호출할 함수
+
+// 제어 소켓 주소 준비
+static bool make_address(const char *path, struct sockaddr_un *addr)
+{
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr->sun_path))
+    {
+        logger_write(LOG_LEVEL_ERROR, "[서버] 재시작 제어 소켓 경로가 너무 깁니다: %s", path);
+        return false;
+    }
+    strcpy(addr->sun_path, path);
+    return true;
+}
+
+// 받은 제어 메시지의 소켓들을 꺼냄
+// 반환값: 꺼낸 소켓 수 (max보다 많이 왔으면 나머지는 닫음)
+static int take_fds(struct msghdr *msg, int *fds, int max)
+{
+    int count = 0;
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(msg); cmsg; cmsg = CMSG_NXTHDR(msg, cmsg))
+    {
+        if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+            continue;
+        int n = (int)((cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+        const unsigned char *data = CMSG_DATA(cmsg);
+        for (int i = 0; i < n; i++)
+        {
+            int fd;
+            memcpy(&fd, data + i * sizeof(int), sizeof(int));
+            if (count < max)
+                fds[count++] = fd;
+            else
+                close(fd);
+        }
+    }
+    return count;
+}
+
+// 새 프로세스: 실행 중인 이전 프로세스에게서 리스너를 넘겨받음
+HandoffResult handoff_receive(const char *path, bool uses_shm, HandoffSockets *out)
+{
+    struct sockaddr_un addr;
+    if (!make_address(path, &addr))
+        return HANDOFF_NONE;
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return HANDOFF_NONE;
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        // 제어 소켓이 없거나 듣는 프로세스가 없으면(이전 프로세스가 비정상 종료) 처음 시작하는 것으로 봄
+        if (errno != ENOENT && errno != ECONNREFUSED)
+            logger_write(LOG_LEVEL_WARN, "[서버] 재시작 제어 소켓 연결 실패: %s (%s)", path, strerror(errno));
+        close(fd);
+        return HANDOFF_NONE;
+    }
+
+    // 요청을 보내고, 이전 프로세스가 연결을 정리하고 저장을 마칠 때까지 기다림
+    logger_write(LOG_LEVEL_INFO, "[서버] 실행 중인 서버에게 리스너를 요청합니다: %s", path);
+    struct timeval tv = {HANDOFF_WAIT_SEC, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    HandoffMessage message = {0};
+    HandoffControl control;
+    struct iovec iov = {&message, sizeof(message)};
+    struct msghdr msg = {0};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+    HandoffRequest request = {0};
+    memcpy(request.magic, HANDOFF_MAGIC, HANDOFF_MAGIC_LEN);
+    request.uses_shm = uses_shm ? 1 : 0;
+    ssize_t received = -1;
+    if (send(fd, &request, sizeof(request), MSG_NOSIGNAL) == (ssize_t)sizeof(request))
+        received = recvmsg(fd, &msg, MSG_WAITALL | MSG_CMSG_CLOEXEC);
+    int saved_errno = errno;
+    close(fd);
+
+    int fds[HANDOFF_MAX_FDS];
+    int fd_count = received > 0 ? take_fds(&msg, fds, HANDOFF_MAX_FDS) : 0;
+    if (received == (ssize_t)sizeof(message) && fd_count == 0 && message.tcp_count == 0 &&
+        memcmp(message.magic, HANDOFF_MAGIC, HANDOFF_MAGIC_LEN) == 0)
+    {
+        logger_write(LOG_LEVEL_ERROR, "[서버] 실행 중인 서버(--shards %d)가 리스너 넘기기를 거절했습니다. "
+                                      "샤드 모드로 넘겨받으면 --shm을 사용할 수 없습니다.",
+                     (int)message.shard_count);
+        return HANDOFF_REFUSED;
+    }
+    bool valid = received == (ssize_t)sizeof(message) && !(msg.msg_flags & MSG_CTRUNC) &&
+                 memcmp(message.magic, HANDOFF_MAGIC, HANDOFF_MAGIC_LEN) == 0 &&
+                 message.tcp_count >= 1 && message.tcp_count <= MAX_STORE_PARTITIONS &&
+                 fd_count == message.tcp_count + (message.has_local ? 1 : 0);
+    if (!valid)
+    {
+        for (int i = 0; i < fd_count; i++)
+        {
+            close(fds[i]);
+        }
+        logger_write(LOG_LEVEL_ERROR, "[서버] 리스너를 넘겨받지 못했습니다: %s",
+                     received < 0 ? strerror(saved_errno) : "잘못된 응답");
+        return HANDOFF_NONE;
+    }
+
+    memcpy(out->tcp_fds, fds, sizeof(int) * message.tcp_count);
+    out->tcp_count = message.tcp_count;
+    out->local_fd = message.has_local ? fds[message.tcp_count] : -1;
+    out->shard_count = message.shard_count;
+    logger_write(LOG_LEVEL_INFO, "[서버] 리스너 %d개를 넘겨받았습니다.", fd_count);
+    return HANDOFF_ADOPTED;
+}
+
+// 받아들일 수 없는 요청을 거절 (연결 정리를 시작하지 않고 계속 실행)
+static void refuse_request(int fd)
+{
+    HandoffMessage message = {0};
+    memcpy(message.magic, HANDOFF_MAGIC, HANDOFF_MAGIC_LEN);
+    message.shard_count = g_shard_count;
+    send(fd, &message, sizeof(message), MSG_NOSIGNAL);
+    close(fd);
+}
+
+// 새 프로세스의 요청 대기 스레드 (요청 하나를 받으면 종료)
+static PS_THREAD_FUNC(handoff_thread)
+{
+    (void)arg;
+    while (true)
+    {
+        int fd = accept4(g_listen_fd, NULL, NULL, SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            // handoff_stop이 제어 소켓을 shutdown한 경우
+            break;
+        }
+        // 다른 프로그램이 잘못 연결한 경우는 무시하고 계속 대기
+        struct timeval tv = {HANDOFF_REQUEST_SEC, 0};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        HandoffRequest request;
+        if (recv(fd, &request, sizeof(request), MSG_WAITALL) != (ssize_t)sizeof(request) ||
+            memcmp(request.magic, HANDOFF_MAGIC, HANDOFF_MAGIC_LEN) != 0)
+        {
+            logger_write(LOG_LEVEL_WARN, "[서버] 재시작 제어 소켓에 잘못된 요청이 들어와 무시합니다.");
+            close(fd);
+            continue;
+        }
+        // 새 프로세스는 이 프로세스의 샤드 구성을 따르므로, 샤드 모드와 함께 쓸 수 없는 공유 메모리 채널을 쓰면 거절
+        if (g_shard_count > 0 && request.uses_shm)
+        {
+            logger_write(LOG_LEVEL_WARN, "[서버] --shm을 쓰는 새 프로세스는 샤드 모드(--shards %d)의 리스너를 넘겨받을 수 없어 거절합니다.",
+                         g_shard_count);
+            refuse_request(fd);
+            continue;
+        }
+        g_peer_fd = fd;
+        __atomic_store_n(&g_requested, 1, __ATOMIC_RELEASE);
+        logger_write(LOG_LEVEL_INFO, "[서버] 새 프로세스가 리스너를 요청했습니다. 새 연결 수락을 멈추고 열린 연결을 정리합니다...");
+        g_on_request();
+        break;
+    }
+    PS_THREAD_RETURN;
+}
+
+// 이전 프로세스: 제어 소켓을 열고 새 프로세스의 요청을 기다리는 스레드 시작
+bool handoff_listen(const char *path, int shard_count, void (*on_request)(void))
+{
+    struct sockaddr_un addr;
+    if (!make_address(path, &addr))
+        return false;
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        logger_write(LOG_LEVEL_ERROR, "[서버] 재시작 제어 소켓 생성 실패: %s", strerror(errno));
+        return false;
+    }
+    // 비정상 종료한 프로세스가 남긴 소켓 파일 삭제 (넘겨준 프로세스는 넘기기 전에 이미 지움)
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 1) < 0)
+    {
+        logger_write(LOG_LEVEL_ERROR, "[서버] 재시작 제어 소켓 bind/listen 실패: %s (%s)", path, strerror(errno));
+        close(fd);
+        return false;
+    }
+    strcpy(g_path, path);
+    g_listen_fd = fd;
+    g_shard_count = shard_count;
+    g_on_request = on_request;
+    if (!ps_thread_create(&g_thread, handoff_thread, NULL))
+    {
+        logger_write(LOG_LEVEL_ERROR, "[서버] 재시작 제어 스레드 시작 실패");
+        close(fd);
+        unlink(path);
+        g_listen_fd = -1;
+        return false;
+    }
+    g_thread_started = true;
+    logger_write(LOG_LEVEL_INFO, "[서버] 재시작 제어 소켓: %s (같은 --handoff로 새 프로세스를 실행하면 리스너를 넘겨줌)", path);
+    return true;
+}
+
+// 새 프로세스가 넘겨 달라고 요청했는지 여부
+bool handoff_requested(void)
+{
+    return __atomic_load_n(&g_requested, __ATOMIC_ACQUIRE) != 0;
+}
+
+// 대기 스레드를 멈추고 제어 소켓을 닫은 뒤 소켓 파일 삭제 (새 프로세스가 같은 경로로 다시 열 수 있도록)
+static void close_control(void)
+{
+    if (g_listen_fd < 0)
+        return;
+    // 리스너를 shutdown하면 accept에서 기다리던 대기 스레드가 깨어나 종료함
+    shutdown(g_listen_fd, SHUT_RDWR);
+    if (g_thread_started)
+        ps_thread_join(g_thread);
+    g_thread_started = false;
+    close(g_listen_fd);
+    g_listen_fd = -1;
+    unlink(g_path);
+}
+
+// 이전 프로세스: 요청한 새 프로세스에게 리스너를 넘김
+bool handoff_send(const HandoffSockets *sockets)
+{
+    close_control();
+    if (g_peer_fd < 0)
+        return false;
+
+    HandoffMessage message = {0};
+    memcpy(message.magic, HANDOFF_MAGIC, HANDOFF_MAGIC_LEN);
+    message.tcp_count = sockets->tcp_count;
+    message.has_local = sockets->local_fd >= 0;
+    message.shard_count = sockets->shard_count;
+    int fds[HANDOFF_MAX_FDS];
+    int fd_count = 0;
+    for (int i = 0; i < sockets->tcp_count && fd_count < MAX_STORE_PARTITIONS; i++)
+    {
+        fds[fd_count++] = sockets->tcp_fds[i];
+    }
+    if (sockets->local_fd >= 0)
+        fds[fd_count++] = sockets->local_fd;
+
+    HandoffControl control;
+    memset(&control, 0, sizeof(control));
+    struct iovec iov = {&message, sizeof(message)};
+    struct msghdr msg = {0};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = CMSG_SPACE(sizeof(int) * fd_count);
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fd_count);
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(int) * fd_count);
+
+    bool sent = sendmsg(g_peer_fd, &msg, MSG_NOSIGNAL) == (ssize_t)sizeof(message);
+    if (sent)
+        logger_write(LOG_LEVEL_INFO, "[서버] 새 프로세스에게 리스너 %d개를 넘겼습니다.", fd_count);
+    else
+        logger_write(LOG_LEVEL_ERROR, "[서버] 리스너를 넘기지 못했습니다: %s", strerror(errno));
+    close(g_peer_fd);
+    g_peer_fd = -1;
+    return sent;
+}
+
+// 제어 소켓을 닫고 대기 스레드를 멈춤
+void handoff_stop(void)
+{
+    close_control();
+    // 요청을 받았지만 넘기지 못하고 종료하는 경우: 연결을 닫으면 새 프로세스는 직접 리스너를 열려고 시도함
+    if (g_peer_fd >= 0)
+    {
+        close(g_peer_fd);
+        g_peer_fd = -1;
+    }
+}
@@ -0,0 +1,63 @@
+// src/handoff.h
+
+#ifndef HANDOFF_H
+#define HANDOFF_H
+
+#include <stdbool.h>
+#include "store_partition.h"
+
+// 무중단 재시작: 리스너 넘겨주기 (Linux 전용, --handoff)
+//
+// 실행 중인 서버(이전 프로세스)는 제어 소켓(AF_UNIX)에서 새 프로세스의 요청을 기다린다.
+// 같은 --handoff 경로로 새 프로세스를 실행하면 다음 순서로 넘어간다.
+//  1. 새 프로세스가 제어 소켓에 연결해 넘겨 달라고 요청한다. (데이터 파일을 읽기 전)
+//  2. 이전 프로세스는 새 연결 수락을 멈추고, 열린 연결은 처리 중인 요청의 응답을 모두 보낸 뒤 닫는다.
+//     그동안 새로 들어온 연결은 리스너의 대기열(backlog)에 남아 있으므로 거부되지 않는다.
+//  3. 이전 프로세스가 모든 데이터를 파일에 저장한 뒤 리스너들을 SCM_RIGHTS로 새 프로세스에 넘기고 종료한다.
+//  4. 새 프로세스는 저장된 파일을 읽고 넘겨받은 리스너로 이벤트 루프를 시작해서 대기열의 연결부터 수락한다.
+// 넘기는 것은 리스너뿐이며, 세션과 공유 메모리 채널은 새 프로세스에서 새로 시작한다.
+// 새 프로세스는 넘겨받은 리스너에 맞춰 이전 프로세스의 샤드 수로 실행하므로, 공유 메모리 채널(--shm)을 쓰는
+// 새 프로세스는 샤드 모드인 이전 프로세스에게 거절당한다. (1에서 바로 거절하고 이전 프로세스는 계속 실행)
+
+#define HANDOFF_DRAIN_MS 5000 // 이전 프로세스가 열린 연결의 처리 중인 요청을 기다리는 최대 시간
+#define HANDOFF_WAIT_SEC 60   // 새 프로세스가 리스너를 기다리는 최대 시간 (이전 프로세스의 저장 시간 포함)
+
+// 주고받는 리스너
+typedef struct
+{
+    int tcp_fds[MAX_STORE_PARTITIONS]; // TCP 리스너 (샤드 순서, 샤드 모드가 아니면 하나)
+    int tcp_count;                     // TCP 리스너 수
+    int local_fd;                      // 로컬(AF_UNIX) 리스너 (--unix-socket, 없으면 -1)
+    int shard_count;                   // 이전 프로세스의 샤드 수 (--shards, 0이면 샤드 모드 아님)
+} HandoffSockets;
+
+// 넘겨받기 결과
+typedef enum
+{
+    HANDOFF_NONE,    // 실행 중인 이전 프로세스가 없거나 넘겨받지 못함 (리스너를 새로 열어야 함)
+    HANDOFF_ADOPTED, // 넘겨받음
+    HANDOFF_REFUSED  // 이전 프로세스가 거절함 (이전 프로세스가 계속 실행하므로 새 프로세스는 종료해야 함)
+} HandoffResult;
+
+// 새 프로세스: 실행 중인 이전 프로세스에게서 리스너를 넘겨받음
+// 이전 프로세스가 없으면(제어 소켓이 없거나 연결이 거부됨) 바로 HANDOFF_NONE을 반환하고, 호출자는 리스너를 새로 연다.
+// uses_shm: 새 프로세스가 공유 메모리 채널을 쓰는지 여부 (샤드 모드인 이전 프로세스는 거절)
+// 반환값: HANDOFF_ADOPTED면 out에 리스너가 채워짐
+HandoffResult handoff_receive(const char *path, bool uses_shm, HandoffSockets *out);
+
+// 이전 프로세스: 제어 소켓을 열고 새 프로세스의 요청을 기다리는 스레드 시작
+// shard_count: 이 프로세스의 샤드 수 (--shards, 0이면 샤드 모드 아님)
+// 받아들일 수 있는 요청이 오면 그 스레드에서 on_request를 한 번 호출한다. (이벤트 루프에 연결 정리를 요청하는 함수)
+bool handoff_listen(const char *path, int shard_count, void (*on_request)(void));
+
+// 새 프로세스가 넘겨 달라고 요청했는지 여부
+bool handoff_requested(void);
+
+// 이전 프로세스: 요청한 새 프로세스에게 리스너를 넘김 (저장을 마친 뒤 호출)
+// 넘긴 뒤에는 호출자가 리스너를 닫아도 된다. (새 프로세스가 같은 소켓을 가리키는 fd를 가짐)
+bool handoff_send(const HandoffSockets *sockets);
+
+// 제어 소켓을 닫고 대기 스레드를 멈춤 (요청 없이 종료할 때, handoff_send 뒤에도 호출해도 됨)
+void handoff_stop(void);
+
+#endif
@@ -0,0 +1,107 @@
+// src/load_shed.c
+
+#include "load_shed.h"
+#include "platform.h"
+#include "logger.h"
+
+#define SHED_MAX_LEVEL 3 // 조회까지 버리는 마지막 단계
+
+// 설정 (시작 시 정한 뒤에는 읽기만 함)
+static bool g_enabled = false;
+static unsigned long long g_target_us = 0;   // 목표 체류 시간
+static unsigned long long g_interval_us = 0; // 판단 간격
+
+// 상태 (모두 원자적으로 접근)
+static int g_level = 0;                      // 현재 단계 (0이면 버리지 않음)
+static unsigned long long g_above_since = 0; // 체류 시간이 목표를 넘기 시작한(또는 마지막으로 단계를 올린) 시각 (0이면 목표 아래)
+static unsigned long long g_below_since = 0; // 체류 시간이 목표 아래로 내려온(또는 마지막으로 단계를 내린) 시각 (0이면 목표 위)
+static unsigned long long g_dropped = 0;     // 버린 요청 수
+
+// 단계를 올리기까지 기다리는 시간 비율 (1/sqrt(현재 단계 + 1), 천분율)
+static const unsigned g_step_permille[SHED_MAX_LEVEL] = {1000, 707, 577};
+
+// 단계별로 새로 버리기 시작하는 요청 (로그용)
+static const char *g_level_names[SHED_MAX_LEVEL + 1] = {"없음", "내보내기", "내보내기/검색", "내보내기/검색/조회"};
+
+// 목표 체류 시간과 판단 간격 설정
+void load_shed_configure(int target_ms, int interval_ms)
+{
+    g_enabled = target_ms > 0;
+    g_target_us = (unsigned long long)target_ms * 1000ULL;
+    g_interval_us = (unsigned long long)(interval_ms > 0 ? interval_ms : 100) * 1000ULL;
+}
+
+// 사용 여부
+bool load_shed_enabled(void)
+{
+    return g_enabled;
+}
+
+// 단계 변경 (다른 스레드가 먼저 바꿨으면 아무것도 하지 않음)
+static void change_level(int from, int to, unsigned long long sojourn_us)
+{
+    if (!__atomic_compare_exchange_n(&g_level, &from, to, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        return;
+    logger_write(to > from ? LOG_LEVEL_WARN : LOG_LEVEL_INFO,
+                 "[서버] 부하 조절 단계 %d -> %d (체류 시간 %llums, 목표 %llums, 거절 대상: %s, 누적 거절 %llu건)", from, to,
+                 sojourn_us / 1000ULL, g_target_us / 1000ULL, g_level_names[to],
+                 __atomic_load_n(&g_dropped, __ATOMIC_RELAXED));
+}
+
+// 처리를 시작하는 요청의 체류 시간 반영
+// 시각 변수는 compare-and-swap으로 갱신해서, 같은 간격 안에 여러 스레드가 관찰해도 단계는 한 번만 바뀐다.
+void load_shed_observe(unsigned long long queued_us)
+{
+    if (!g_enabled)
+        return;
+    unsigned long long now = ps_now_us();
+    unsigned long long sojourn = now > queued_us ? now - queued_us : 0;
+    int level = __atomic_load_n(&g_level, __ATOMIC_RELAXED);
+
+    // 목표 아래: 버리는 중이면 간격 동안 계속 아래일 때 한 단계 내림
+    if (sojourn < g_target_us)
+    {
+        if (__atomic_load_n(&g_above_since, __ATOMIC_RELAXED) != 0)
+            __atomic_store_n(&g_above_since, 0, __ATOMIC_RELAXED);
+        if (level == 0)
+            return;
+        unsigned long long below = __atomic_load_n(&g_below_since, __ATOMIC_RELAXED);
+        if (below == 0)
+            __atomic_compare_exchange_n(&g_below_since, &below, now, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+        else if (now - below >= g_interval_us &&
+                 __atomic_compare_exchange_n(&g_below_since, &below, now, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            change_level(level, level - 1, sojourn);
+        return;
+    }
+
+    // 목표 위: 처음 넘었으면 시각만 기록하고, 계속 넘은 채 기다린 시간이 지나면 한 단계 올림
+    if (__atomic_load_n(&g_below_since, __ATOMIC_RELAXED) != 0)
+        __atomic_store_n(&g_below_since, 0, __ATOMIC_RELAXED);
+    unsigned long long above = __atomic_load_n(&g_above_since, __ATOMIC_RELAXED);
+    if (above == 0)
+    {
+        __atomic_compare_exchange_n(&g_above_since, &above, now, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+        return;
+    }
+    if (level < SHED_MAX_LEVEL && now - above >= g_interval_us * g_step_permille[level] / 1000ULL &&
+        __atomic_compare_exchange_n(&g_above_since, &above, now, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        change_level(level, level + 1, sojourn);
+}
+
+// 현재 단계에서 처리해도 되는 요청인지 여부
+bool load_shed_admit(ShedClass shed_class)
+{
+    if (shed_class == SHED_CLASS_KEEP)
+        return true;
+    // 종류 값이 클수록 낮은 단계에서부터 버림 (내보내기 = 단계 1부터)
+    if (__atomic_load_n(&g_level, __ATOMIC_RELAXED) <= SHED_MAX_LEVEL - (int)shed_class)
+        return true;
+    __atomic_fetch_add(&g_dropped, 1, __ATOMIC_RELAXED);
+    return false;
+}
+
+// 지금까지 버린 요청 수
+unsigned long long load_shed_dropped(void)
+{
+    return __atomic_load_n(&g_dropped, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,47 @@
+// src/load_shed.h
+
+#ifndef LOAD_SHED_H
+#define LOAD_SHED_H
+
+#include <stdbool.h>
+
+// 대기 시간 기반 부하 조절 (CoDel 방식)
+//
+// 요청을 받은 시각부터 핸들러가 처리를 시작할 때까지 기다린 시간(체류 시간)을 재서,
+// 체류 시간이 목표값을 넘은 상태가 간격(interval) 동안 계속되면 대기열이 일시적으로 몰린 것이 아니라
+// 처리량보다 요청이 많은 것으로 보고 우선순위가 낮은 요청부터 처리하지 않고 바로 BUSY로 응답한다.
+//   단계 1: 내보내기(DOWNLOAD_ALL, DOWNLOAD_SINGLE)
+//   단계 2: + 검색(MEMO_SEARCH)
+//   단계 3: + 조회(MEMO_LIST, MEMO_LIST_BY_MONTH, MEMO_VIEW)
+// 계속 넘으면 CoDel의 제어 법칙처럼 간격/sqrt(단계)마다 한 단계씩 올리고,
+// 체류 시간이 목표값 아래로 내려간 상태가 간격 동안 계속되면 한 단계씩 내린다.
+// 로그인/변경 명령은 작고 잃으면 안 되므로 버리지 않는다.
+//
+// 상태는 전역 하나이며 원자적 변수로만 갱신하므로 여러 워커/샤드에서 잠금 없이 호출할 수 있다.
+
+// 요청의 버리는 순서 (값이 클수록 먼저 버림)
+typedef enum
+{
+    SHED_CLASS_KEEP,        // 버리지 않음 (로그인, 변경 명령, EXIT 등)
+    SHED_CLASS_INTERACTIVE, // 조회 (단계 3부터 버림)
+    SHED_CLASS_SEARCH,      // 검색 (단계 2부터 버림)
+    SHED_CLASS_EXPORT       // 내보내기 (단계 1부터 버림)
+} ShedClass;
+
+// 목표 체류 시간과 판단 간격 설정 (서버 시작 시 한 번, target_ms가 0이면 사용 안 함)
+void load_shed_configure(int target_ms, int interval_ms);
+
+// 사용 여부 (꺼져 있으면 받은 시각을 기록하지 않아도 됨)
+bool load_shed_enabled(void);
+
+// 처리를 시작하는 요청의 체류 시간 반영 (queued_us: 요청을 받은 시각, ps_now_us 기준)
+// 대기열에서 꺼내 처리하는 쪽(워커, 파티션을 맡은 샤드)이 요청 묶음마다 한 번 호출한다.
+void load_shed_observe(unsigned long long queued_us);
+
+// 현재 단계에서 이 종류의 요청을 처리해도 되는지 여부 (버리는 요청이면 false, 버린 수를 셈)
+bool load_shed_admit(ShedClass shed_class);
+
+// 지금까지 버린 요청 수
+unsigned long long load_shed_dropped(void);
+
+#endif
@@ -0,0 +1,406 @@
+// src/logger.c
+
+#include "logger.h"
+#include "platform.h"
+#include <errno.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define LOG_RING_SIZE (64 * 1024)   // 스레드 하나의 링 크기 (2의 거듭제곱이어야 함)
+#define LOG_MESSAGE_MAX 512         // 기록 하나의 최대 메시지 길이 (넘으면 잘림)
+#define LOG_OUTPUT_SIZE (64 * 1024) // 기록 스레드가 한 번에 출력하는 최대 크기
+#define LOG_FLUSH_INTERVAL_MS 10    // 링이 모두 비어 있을 때 기록 스레드가 쉬는 시간
+#define LOG_PAD 64                  // 생산자/소비자 값이 같은 캐시 라인을 두고 다투지 않도록 띄우는 간격
+
+// 링에 쌓이는 기록 하나의 머리 (바로 뒤에 메시지 len바이트가 이어짐)
+typedef struct
+{
+    uint16_t len;     // 메시지 길이
+    uint8_t level;    // 로그 수준
+    uint8_t reserved; // 사용 안 함
+    uint32_t pad;     // 사용 안 함
+    uint64_t time_ms; // 기록 시각 (1970-01-01 UTC 기준 밀리초)
+} LogRecord;
+
+// 스레드 하나의 기록 링 (생산자: 소유한 스레드, 소비자: 기록 스레드)
+// head/tail은 계속 증가하는 값이고 (tail - head)가 쌓인 바이트 수다.
+typedef struct LogRing
+{
+    uint32_t tail;                      // 다음에 쓸 위치 (생산자만 씀)
+    char pad1[LOG_PAD - sizeof(uint32_t)];
+    uint32_t head;                      // 다음에 읽을 위치 (소비자만 씀)
+    char pad2[LOG_PAD - sizeof(uint32_t)];
+    uint32_t owned;                     // 스레드가 사용 중이면 1 (반납하면 0, 다른 스레드가 다시 차지)
+    uint32_t dropped;                   // 링이 가득 차서 버린 기록 수 (기록 스레드가 가져가며 0으로 되돌림)
+    struct LogRing *next;               // 전체 링 목록 (한 번 만든 링은 해제하지 않음)
+    unsigned char data[LOG_RING_SIZE];
+} LogRing;
+
+static int g_level = LOG_LEVEL_INFO;         // 기록할 최소 수준 (원자적으로 접근)
+static int g_running = 0;                    // 기록 스레드가 실행 중이면 1 (원자적으로 접근)
+static int g_stopping = 0;                   // 기록 스레드 종료 요청 (원자적으로 접근)
+static LogRing *g_rings = NULL;              // 전체 링 목록의 머리 (원자적으로 접근)
+static ps_thread_t g_flusher;                // 기록 스레드
+static _Thread_local LogRing *t_ring = NULL; // 호출한 스레드의 링
+
+// 수준별 출력 문자
+static const char g_level_chars[] = {'D', 'I', 'W', 'E'};
+
+void logger_set_level(LogLevel level)
+{
+    __atomic_store_n(&g_level, (int)level, __ATOMIC_RELAXED);
+}
+
+bool logger_parse_level(const char *name, LogLevel *level)
+{
+    static const char *names[] = {"debug", "info", "warn", "error", "off"};
+    for (int i = 0; i <= LOG_LEVEL_OFF; i++)
+    {
+        if (strcmp(name, names[i]) == 0)
+        {
+            *level = (LogLevel)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool logger_enabled(LogLevel level)
+{
+    return level != LOG_LEVEL_OFF && (int)level >= __atomic_load_n(&g_level, __ATOMIC_RELAXED);
+}
+
+// 호출한 스레드의 링 (처음 호출할 때 반납된 링을 차지하거나 새로 만듦)
+static LogRing *thread_ring(void)
+{
+    if (t_ring)
+        return t_ring;
+    for (LogRing *ring = __atomic_load_n(&g_rings, __ATOMIC_ACQUIRE); ring; ring = ring->next)
+    {
+        uint32_t expected = 0;
+        if (__atomic_compare_exchange_n(&ring->owned, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            return t_ring = ring;
+    }
+    LogRing *ring = (LogRing *)calloc(1, sizeof(LogRing));
+    if (!ring)
+        return NULL;
+    ring->owned = 1;
+    // 목록 머리에 추가 (기록 스레드와 다른 스레드가 동시에 목록을 읽을 수 있음)
+    ring->next = __atomic_load_n(&g_rings, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&g_rings, &ring->next, ring, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+    {
+    }
+    return t_ring = ring;
+}
+
+void logger_thread_detach(void)
+{
+    if (!t_ring)
+        return;
+    __atomic_store_n(&t_ring->owned, 0, __ATOMIC_RELEASE);
+    t_ring = NULL;
+}
+
+// 링의 pos 위치부터 len바이트 쓰기 (끝을 넘으면 앞으로 이어서)
+static void ring_copy_in(LogRing *ring, uint32_t pos, const void *src, size_t len)
+{
+    size_t offset = pos & (LOG_RING_SIZE - 1);
+    size_t first = len < LOG_RING_SIZE - offset ? len : LOG_RING_SIZE - offset;
+    memcpy(ring->data + offset, src, first);
+    memcpy(ring->data, (const unsigned char *)src + first, len - first);
+}
+
+// 링의 pos 위치부터 len바이트 읽기
+static void ring_copy_out(const LogRing *ring, uint32_t pos, void *dst, size_t len)
+{
+    size_t offset = pos & (LOG_RING_SIZE - 1);
+    size_t first = len < LOG_RING_SIZE - offset ? len : LOG_RING_SIZE - offset;
+    memcpy(dst, ring->data + offset, first);
+    memcpy((unsigned char *)dst + first, ring->data, len - first);
+}
+
+// 출력 버퍼
+typedef struct
+{
+    char data[LOG_OUTPUT_SIZE];
+    size_t len;
+    time_t cached_sec; // 마지막으로 변환한 시각(초)
+    struct tm cached_tm;
+} LogOutput;
+
+// 모은 출력을 콘솔에 씀
+// 콘솔(터미널)의 stdout은 줄 단위 버퍼라 fwrite도 줄마다 시스템 콜을 하므로, Linux에서는 write 한 번으로 씀
+static void output_flush(LogOutput *out)
+{
+    if (out->len == 0)
+        return;
+#ifdef _WIN32
+    fwrite(out->data, 1, out->len, stdout);
+    fflush(stdout);
+#else
+    fflush(stdout); // 먼저 printf로 출력한 내용과 순서가 섞이지 않도록
+    size_t written = 0;
+    while (written < out->len)
+    {
+        ssize_t n = write(STDOUT_FILENO, out->data + written, out->len - written);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        written += (size_t)n;
+    }
+#endif
+    out->len = 0;
+}
+
+// 기록 한 줄을 출력 버퍼에 추가 ("시:분:초.밀리초 수준문자 메시지")
+static void output_line(LogOutput *out, int level, uint64_t time_ms, const char *message, size_t len)
+{
+    if (out->len + len + 32 > sizeof(out->data))
+        output_flush(out);
+    time_t sec = (time_t)(time_ms / 1000);
+    if (sec != out->cached_sec)
+    {
+        ps_localtime(&sec, &out->cached_tm);
+        out->cached_sec = sec;
+    }
+    int n = snprintf(out->data + out->len, sizeof(out->data) - out->len, "%02d:%02d:%02d.%03d %c ",
+                     out->cached_tm.tm_hour, out->cached_tm.tm_min, out->cached_tm.tm_sec, (int)(time_ms % 1000),
+                     g_level_chars[level]);
+    out->len += (size_t)n;
+    memcpy(out->data + out->len, message, len);
+    out->len += len;
+    out->data[out->len++] = '\n';
+}
+
+// 기록 한 줄을 바로 출력 (기록 스레드가 없을 때)
+static void print_direct(int level, uint64_t time_ms, const char *message, size_t len)
+{
+    time_t sec = (time_t)(time_ms / 1000);
+    struct tm tm;
+    ps_localtime(&sec, &tm);
+    printf("%02d:%02d:%02d.%03d %c %.*s\n", tm.tm_hour, tm.tm_min, tm.tm_sec, (int)(time_ms % 1000),
+           g_level_chars[level], (int)len, message);
+}
+
+// 모든 링에 쌓인 기록을 출력 버퍼로 옮김
+// 반환값: 옮긴 기록 수
+static size_t drain_rings(LogOutput *out)
+{
+    size_t count = 0;
+    char message[LOG_MESSAGE_MAX];
+    for (LogRing *ring = __atomic_load_n(&g_rings, __ATOMIC_ACQUIRE); ring; ring = ring->next)
+    {
+        uint32_t head = ring->head;
+        uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        while (head != tail)
+        {
+            LogRecord record;
+            ring_copy_out(ring, head, &record, sizeof(record));
+            ring_copy_out(ring, head + sizeof(record), message, record.len);
+            output_line(out, record.level, record.time_ms, message, record.len);
+            head += (uint32_t)(sizeof(record) + record.len);
+            count++;
+        }
+        // 읽은 만큼 생산자에게 공간을 돌려줌
+        __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+
+        uint32_t dropped = __atomic_exchange_n(&ring->dropped, 0, __ATOMIC_RELAXED);
+        if (dropped > 0)
+        {
+            int n = snprintf(message, sizeof(message), "[로그] 링이 가득 차서 기록 %u개를 버렸습니다.", dropped);
+            output_line(out, LOG_LEVEL_WARN, ps_wall_ms(), message, (size_t)n);
+        }
+    }
+    return count;
+}
+
+// 기록 스레드: 링들을 돌며 모은 기록을 한 번에 출력
+static PS_THREAD_FUNC(flusher_main)
+{
+    (void)arg;
+    LogOutput *out = (LogOutput *)calloc(1, sizeof(LogOutput));
+    if (!out)
+        PS_THREAD_RETURN;
+    out->cached_sec = (time_t)-1;
+    while (true)
+    {
+        bool stopping = __atomic_load_n(&g_stopping, __ATOMIC_ACQUIRE);
+        size_t count = drain_rings(out);
+        output_flush(out);
+        // 종료 요청을 본 뒤의 마지막 비우기까지 마쳤으면 종료
+        if (stopping)
+            break;
+        if (count == 0)
+            ps_sleep_ms(LOG_FLUSH_INTERVAL_MS);
+    }
+    free(out);
+    PS_THREAD_RETURN;
+}
+
+bool logger_start(void)
+{
+    if (__atomic_load_n(&g_running, __ATOMIC_RELAXED))
+        return true;
+    __atomic_store_n(&g_stopping, 0, __ATOMIC_RELAXED);
+    if (!ps_thread_create(&g_flusher, flusher_main, NULL))
+        return false;
+    __atomic_store_n(&g_running, 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+void logger_stop(void)
+{
+    if (!__atomic_load_n(&g_running, __ATOMIC_RELAXED))
+        return;
+    // 이후 기록은 바로 출력 (이미 링에 쓰는 중이던 기록은 기록 스레드의 마지막 비우기에서 출력)
+    __atomic_store_n(&g_running, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&g_stopping, 1, __ATOMIC_RELEASE);
+    ps_thread_join(g_flusher);
+}
+
+void logger_write(LogLevel level, const char *format, ...)
+{
+    if (!logger_enabled(level))
+        return;
+    uint64_t now = ps_wall_ms();
+    char message[LOG_MESSAGE_MAX];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+    if (n < 0)
+        return;
+    size_t len = (size_t)n < sizeof(message) ? (size_t)n : sizeof(message) - 1;
+
+    // 기록 스레드가 없으면 바로 출력
+    LogRing *ring = __atomic_load_n(&g_running, __ATOMIC_ACQUIRE) ? thread_ring() : NULL;
+    if (!ring)
+    {
+        print_direct(level, now, message, len);
+        return;
+    }
+
+    // 남은 공간이 부족하면 기다리지 않고 버림
+    LogRecord record = {(uint16_t)len, (uint8_t)level, 0, 0, now};
+    uint32_t tail = ring->tail;
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    if (LOG_RING_SIZE - (tail - head) < sizeof(record) + len)
+    {
+        __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    ring_copy_in(ring, tail, &record, sizeof(record));
+    ring_copy_in(ring, tail + sizeof(record), message, len);
+    __atomic_store_n(&ring->tail, tail + (uint32_t)(sizeof(record) + len), __ATOMIC_RELEASE);
+}
+
+// 요청 종류별 가림 규칙: 앞의 keep_fields개 필드(명령어 포함)만 남기고 나머지를 가림
+typedef struct
+{
+    const char *command; // 명령어
+    int keep_fields;     // 그대로 남길 필드 수
+    bool secret;         // true면 "***"(비밀번호), false면 "<N바이트>"(메모 제목/내용)
+} RedactRule;
+
+static const RedactRule g_redact_rules[] = {
+    {"LOGIN", 2, true},       // LOGIN:아이디:비밀번호
+    {"REGISTER", 2, true},    // REGISTER:아이디:비밀번호
+    {"DELETE_USER", 2, true}, // DELETE_USER:아이디:비밀번호
+    {"UPDATE_PW", 2, true},   // UPDATE_PW:아이디:이전 비밀번호:새 비밀번호
+    {"MEMO_ADD", 2, false},   // MEMO_ADD:아이디:제목:내용
+    {"MEMO_UPDATE", 3, false} // MEMO_UPDATE:아이디:메모ID:내용
+};
+
+// 출력 버퍼에 덧붙임 (자리가 모자라면 잘린 것으로 표시)
+static bool redact_append(char *out, size_t out_size, size_t *pos, const char *src, size_t len)
+{
+    if (*pos + len >= out_size)
+        return false;
+    memcpy(out + *pos, src, len);
+    *pos += len;
+    return true;
+}
+
+void logger_redact_request(const char *request, size_t len, char *out, size_t out_size)
+{
+    if (out_size == 0)
+        return;
+    // 명령어로 규칙 찾기
+    size_t command_len = 0;
+    while (command_len < len && request[command_len] != ':')
+    {
+        command_len++;
+    }
+    int keep_fields = -1;
+    bool secret = false;
+    for (size_t i = 0; i < sizeof(g_redact_rules) / sizeof(g_redact_rules[0]); i++)
+    {
+        if (strlen(g_redact_rules[i].command) == command_len &&
+            memcmp(g_redact_rules[i].command, request, command_len) == 0)
+        {
+            keep_fields = g_redact_rules[i].keep_fields;
+            secret = g_redact_rules[i].secret;
+            break;
+        }
+    }
+
+    size_t pos = 0;
+    size_t start = 0;
+    bool complete = true;
+    for (int field = 0; complete; field++)
+    {
+        if (field == keep_fields)
+        {
+            // 남은 필드는 통째로 가림
+            char masked[32];
+            int n = secret ? snprintf(masked, sizeof(masked), "***")
+                           : snprintf(masked, sizeof(masked), "<%zu바이트>", len - start);
+            complete = redact_append(out, out_size, &pos, masked, (size_t)n);
+            break;
+        }
+        size_t end = start;
+        while (end < len && request[end] != ':')
+        {
+            end++;
+        }
+        if (field > 0 && end > start && request[start] == '@')
+        {
+            // 세션 토큰은 비밀번호처럼 가림
+            complete = redact_append(out, out_size, &pos, "@***", 4);
+        }
+        else
+        {
+            // 줄바꿈/탭은 한 줄 로그가 깨지지 않도록 공백으로
+            for (size_t i = start; i < end && complete; i++)
+            {
+                char c = (request[i] == '\n' || request[i] == '\r' || request[i] == '\t') ? ' ' : request[i];
+                complete = redact_append(out, out_size, &pos, &c, 1);
+            }
+        }
+        if (end >= len)
+            break;
+        if (complete)
+            complete = redact_append(out, out_size, &pos, ":", 1);
+        start = end + 1;
+    }
+    // 잘렸으면 끝을 "..."으로 표시
+    if (!complete && out_size > 3)
+    {
+        size_t written = pos;
+        if (pos + 3 >= out_size)
+            pos = out_size - 4;
+        // 여러 바이트 문자(UTF-8) 중간에서 자르지 않도록 문자 시작 위치로 물러남
+        while (pos > 0 && pos < written && ((unsigned char)out[pos] & 0xC0) == 0x80)
+        {
+            pos--;
+        }
+        memcpy(out + pos, "...", 3);
+        pos += 3;
+    }
+    out[pos] = '\0';
+}
@@ -0,0 +1,60 @@
+// src/logger.h
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// 비동기 로거
+//
+// 요청을 처리하는 스레드는 콘솔에 직접 쓰지 않고, 스레드마다 하나씩 가진 링 버퍼에 기록만 남긴다.
+// 링은 생산자(기록하는 스레드) 하나/소비자(기록 스레드) 하나만 쓰므로 잠금 없이 head/tail만 원자적으로 갱신하고,
+// 백그라운드 기록 스레드가 모든 링을 돌며 모아서 한 번에 출력한다.
+// 링이 가득 차면 기다리지 않고 기록을 버리며, 버린 개수는 나중에 경고로 출력한다.
+//
+// 출력 형식: "시:분:초.밀리초 수준문자 메시지" (예: "14:03:27.118 I [서버] 클라이언트 7 연결됨")
+// logger_start 전이나 logger_stop 뒤에는 기록을 바로 콘솔에 출력한다.
+
+// 로그 수준 (이 값 이상만 기록)
+typedef enum
+{
+    LOG_LEVEL_DEBUG, // 개발용 상세 기록
+    LOG_LEVEL_INFO,  // 연결/요청 등 일반 기록 (기본)
+    LOG_LEVEL_WARN,  // 처리는 계속하지만 확인이 필요한 상황
+    LOG_LEVEL_ERROR, // 실패
+    LOG_LEVEL_OFF    // 기록 안 함
+} LogLevel;
+
+// 기록할 최소 수준 설정 (기본: LOG_LEVEL_INFO)
+void logger_set_level(LogLevel level);
+
+// 수준 이름("debug", "info", "warn", "error", "off") 해석 (모르는 이름이면 false)
+bool logger_parse_level(const char *name, LogLevel *level);
+
+// 이 수준의 기록을 남기는지 여부 (메시지를 만드는 비용이 큰 기록 전에 확인)
+bool logger_enabled(LogLevel level);
+
+// 백그라운드 기록 스레드 시작
+bool logger_start(void);
+
+// 남은 기록을 모두 출력하고 기록 스레드 종료 (이후 기록은 바로 출력)
+void logger_stop(void);
+
+// printf 형식으로 기록 (끝의 줄바꿈은 붙이지 않음)
+void logger_write(LogLevel level, const char *format, ...)
+#ifdef __GNUC__
+    __attribute__((format(printf, 2, 3)))
+#endif
+    ;
+
+// 호출한 스레드의 링을 반납 (연결마다 스레드를 만드는 Windows 서버가 스레드를 끝낼 때 호출)
+// 남은 기록은 기록 스레드가 마저 출력하고, 링은 새로 기록하는 다른 스레드가 다시 사용한다.
+void logger_thread_detach(void);
+
+// 요청 문자열을 로그에 남길 수 있는 형태로 out에 기록 (비밀번호, 세션 토큰, 메모 제목/내용은 가림)
+// 예: "LOGIN:alice:pw1234" -> "LOGIN:alice:***", "MEMO_ADD:@0400...:제목:내용" -> "MEMO_ADD:@***:<13바이트>"
+// out에 다 들어가지 않으면 "..."으로 끝난다.
+void logger_redact_request(const char *request, size_t len, char *out, size_t out_size);
+
+#endif
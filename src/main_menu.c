@@ -4,6 +4,7 @@
 #include "memo_menu.h"
 #include "common_input.h"
 #include "user.h"
+#include "client_net.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -13,31 +14,9 @@
 #include <time.h>
 
 #define REQUEST_BUF_SIZE 2048 // 요청 버퍼 크기
-#define REPLY_BUF_SIZE 65536  // 응답 버퍼 크기
 
 // 함수 선언
-static bool communicate_with_server(SOCKET sock, const char *request, char *reply); // 서버와 통신하는 헬퍼 함수
-static void handle_all_memos_download(SOCKET sock, const char *user_id);            // 전체 메모 다운로드 처리
-
-// 서버와 통신하는 헬퍼 함수
-static bool communicate_with_server(SOCKET sock, const char *request, char *reply)
-{
-    // 요청 전송
-    if (send(sock, request, strlen(request), 0) < 0)
-    {
-        printf("[클라이언트] 서버에 요청 전송 실패\n");
-        return false;
-    }
-    // 응답 수신
-    int bytes = recv(sock, reply, REPLY_BUF_SIZE - 1, 0);
-    if (bytes <= 0)
-    {
-        printf("[클라이언트] 서버로부터 응답 수신 실패\n");
-        return false;
-    }
-    reply[bytes] = '\0';
-    return true;
-}
+static void handle_all_memos_download(SOCKET sock, const char *user_id); // 전체 메모 다운로드 처리
 
 // 전체 메모 다운로드 처리
 static void handle_all_memos_download(SOCKET sock, const char *user_id)
@@ -126,13 +105,13 @@ static void handle_all_memos_download(SOCKET sock, const char *user_id)
     }
 
     // 5. 서버 요청
-    char request[REQUEST_BUF_SIZE], reply[REPLY_BUF_SIZE];
+    char request[REQUEST_BUF_SIZE], *reply;
     // 요청 전송
-    snprintf(request, sizeof(request), "DOWNLOAD_ALL:%s:%s", user_id, format_str);
+    snprintf(request, sizeof(request), "DOWNLOAD_ALL:%s:%s", client_user_key(user_id), format_str);
     // 다운로드 중 메시지 출력
     printf("\n다운로드 중...\n");
     // 서버 요청
-    if (!communicate_with_server(sock, request, reply) || strncmp(reply, "OK:", 3) != 0)
+    if (!communicate_with_server(sock, request, &reply) || strncmp(reply, "OK:", 3) != 0)
     {
         // 다운로드 실패 메시지 출력
         printf("\n[오류] 다운로드에 실패했습니다: %s\n", reply + 3);
@@ -166,7 +145,7 @@ static void handle_all_memos_download(SOCKET sock, const char *user_id)
 void main_menu_loop(SOCKET sock, const char *user_id)
 {
     char choice;
-    char request[REQUEST_BUF_SIZE], reply[REPLY_BUF_SIZE];
+    char request[REQUEST_BUF_SIZE], *reply;
 
     while (true)
     {
@@ -230,7 +209,7 @@ void main_menu_loop(SOCKET sock, const char *user_id)
             else
             {
                 snprintf(request, sizeof(request), "UPDATE_PW:%s:%s:%s", user_id, old_pw, new_pw);
-                communicate_with_server(sock, request, reply);
+                communicate_with_server(sock, request, &reply);
                 printf("[클라이언트] %s\n", strncmp(reply, "OK", 2) == 0 ? reply + 3 : reply + 5);
             }
         }
@@ -249,7 +228,7 @@ void main_menu_loop(SOCKET sock, const char *user_id)
                 if (!get_secure_input(pw, sizeof(pw), "비밀번호 확인", true, true))
                     continue;
                 snprintf(request, sizeof(request), "DELETE_USER:%s:%s", user_id, pw);
-                if (communicate_with_server(sock, request, reply) && strncmp(reply, "OK", 2) == 0)
+                if (communicate_with_server(sock, request, &reply) && strncmp(reply, "OK", 2) == 0)
                 {
                     printf("[클라이언트] %s\n", reply + 3);
                     printf("계정 삭제가 완료되었습니다. 초기 메뉴로 돌아갑니다.\n");
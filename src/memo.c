@@ -1,34 +1,424 @@
 // src/memo.c
 
 #include "memo.h"
-#include <windows.h>
+#include "platform.h"
+#include "store_partition.h"
+#include "logger.h"
+#include "deadline.h"
+#include "epoch.h"
 #include <stdio.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <ctype.h>
+#ifndef _WIN32
+#include <dirent.h>
+#endif
+
+#define INITIAL_USER_SLOT_BITS 4 // 사용자 테이블의 처음 칸 수 (2^4 = 16)
+#define INITIAL_USER_MEMOS 8     // 사용자 메모 판의 처음 배열 크기
+#define INITIAL_ID_SLOT_BITS 6   // 메모 ID 색인의 처음 칸 수 (2^6 = 64)
+#define NODE_ALIGN 8             // 청크 안 노드의 정렬 단위
+#define MIN_CHUNK_SIZE 512       // 사용자 아레나의 첫 청크 크기
+#define MAX_CHUNK_SIZE 65536     // 두 배씩 늘리는 청크 크기의 상한
+#define LARGE_NODE_SIZE 16384    // 이보다 큰 노드는 자기 크기의 청크 하나를 따로 씀
+#define MIN_COMPACT_BYTES 4096   // 압축하려면 쌓여야 하는 죽은 바이트 수
+
+// 목록/월별/검색/내보내기는 저장소를 잠그지 않고 읽는다. (command_dispatch.c, 에포크 구간 안에서)
+// 그래서 읽는 쪽이 닿는 구조(사용자 테이블 -> 사용자 -> 메모 판 -> 메모 노드)는 제자리에서 고치지 않고,
+// 새 판을 만들어 포인터를 원자적으로 바꿔 끼운 뒤 이전 판은 epoch_retire로 넘긴다. (쓰는 쪽은 파티션 쓰기 잠금을 잡음)
+// 메모 ID 색인은 쓰기 잠금과 읽기 잠금 아래에서만 쓰므로 제자리에서 고친다.
+
+// 메모 텍스트는 사용자마다 아레나에 둔다.
+// 아레나는 청크(처음 512바이트, 다음부터 두 배씩 64KB까지)를 앞에서부터 잘라 노드 헤더와 사용자 ID/제목/내용을 이어 붙이므로,
+// 짧은 메모는 짧은 만큼만 차지하고 노드마다 malloc하지 않는다.
+// 노드는 제자리에서 해제하지 않고, 청크는 든 노드가 모두 해제되어야 해제된다. 그래서 삭제/수정으로 빠진 바이트(죽은 바이트)가
+// 산 바이트보다 많아지면 산 노드들을 새 청크로 모아 옮기고(압축) 이전 노드들을 한꺼번에 놓는다.
+
+// 아레나 청크
+typedef struct MemoChunk
+{
+    int refs;                         // 든 노드 중 해제되지 않은 수 + 아레나가 잘라 쓰는 중이면 1 (원자적으로 접근)
+    size_t size;                      // data 크기
+    size_t used;                      // 잘라 쓴 바이트 수 (쓰는 쪽만 사용)
+    _Alignas(NODE_ALIGN) char data[]; // 노드들
+} MemoChunk;
+
+// 사용자 한 명의 아레나 (쓰는 쪽만 사용)
+typedef struct
+{
+    MemoChunk *current; // 잘라 쓰는 중인 청크 (없으면 NULL)
+    size_t next_size;   // 다음에 만들 청크 크기 (0이면 MIN_CHUNK_SIZE)
+    size_t live_bytes;  // 판에 든 노드들이 차지하는 바이트 수
+    size_t dead_bytes;  // 마지막 압축 뒤 판에서 빠진 노드들이 차지했던 바이트 수
+} MemoArena;
+
+// 사용자 한 명의 메모 판 (작성 순서대로 노드 포인터를 담은 배열)
+// 읽는 쪽은 판 포인터와 count를 한 번 읽고 그 앞까지만 돌기 때문에, 읽기를 시작한 시점의 목록을 끝까지 본다.
+//  - 추가는 배열에 빈 칸이 있으면 count 뒤 칸에 넣고 count만 늘린다. (읽는 중인 범위는 바뀌지 않음)
+//  - 수정/삭제와 배열이 가득 찬 추가는 새 판을 만들어 바꿔 끼운다.
+typedef struct
+{
+    EpochRetired retired; // 해제 대기 (첫 멤버)
+    int count;            // 발행한 메모 수 (원자적으로 접근)
+    int capacity;         // 배열 크기
+    MemoNode *memos[];    // 메모 노드 (작성 순서대로)
+} MemoSnapshot;
+
+// 사용자 한 명의 메모 (사용자 단위 조회/내보내기는 이 사용자의 판만 돌고, 다른 사용자의 메모는 건드리지 않음)
+typedef struct
+{
+    EpochRetired retired;          // 해제 대기 (첫 멤버)
+    char user_id[MAX_USER_ID_LEN]; // 사용자 ID
+    MemoSnapshot *snapshot;        // 현재 판 (원자적으로 접근, 메모가 없으면 NULL)
+    MemoArena arena;               // 메모 텍스트 아레나 (쓰는 쪽만 사용)
+} MemoUser;
+
+// 사용자 테이블의 칸 배열 (열린 주소법, 선형 탐사)
+// 읽는 쪽이 탐사하는 동안 칸을 옮기지 않도록 사용자는 빼지 않고, 판이 빈 사용자는 배열을 새로 만들 때 버린다.
+typedef struct
+{
+    EpochRetired retired; // 해제 대기 (첫 멤버)
+    int bits;             // 칸 수 = 2^bits
+    MemoUser *users[];    // 칸 (원자적으로 접근, 빈 칸은 NULL)
+} MemoUserSlots;
+
+// 파티션 하나의 사용자 테이블
+typedef struct
+{
+    MemoUserSlots *slots; // 현재 칸 배열 (원자적으로 접근, 처음 메모를 추가할 때 할당)
+    int user_count;       // 칸에 들어 있는 사용자 수 (칸 수의 3/4에 닿으면 새 배열로 옮김, 쓰는 쪽만 사용)
+} MemoUserTable;
+
+// 파티션 하나의 메모 ID 색인 (열린 주소법, 선형 탐사)
+// 요청에는 항상 사용자 ID가 있으므로 그 사용자의 파티션 색인만 찾고, 찾은 메모의 소유자를 확인한다.
+typedef struct
+{
+    MemoNode **slots; // 칸 배열 (빈 칸은 NULL, 처음 메모를 추가할 때 할당)
+    int slot_bits;    // 칸 수 = 2^slot_bits
+    size_t count;     // 들어 있는 메모 수 (칸 수의 3/4에 닿으면 두 배로 늘림)
+} MemoIdIndex;
 
 // 전역 변수
-static MemoNode *g_memo_list_head = NULL; // 메모 노드 헤드
-static int g_next_memo_id = 1;            // 다음 메모 ID
+// 메모는 사용자 ID의 파티션(store_partition.h)마다 따로 두어, 샤드 모드에서 샤드끼리 같은 테이블을 건드리지 않게 함
+static MemoUserTable g_user_tables[MAX_STORE_PARTITIONS]; // 파티션별 사용자 해시 테이블
+static MemoIdIndex g_id_indexes[MAX_STORE_PARTITIONS];    // 파티션별 메모 ID 색인
+static int g_next_memo_id = 1;                            // 다음 메모 ID (여러 샤드가 동시에 발급하므로 원자적으로 증가)
 const char *DATA_DIR = "data/memo/";      // 데이터 디렉터리
 
-// 현재 날짜와 시간 가져오기
-static void get_current_datetime(char *datetime_str, int size)
+// 현재 날짜와 시간 가져오기 (반환값: 현재 시각)
+static int64_t get_current_datetime(char *datetime_str, int size)
 {
     // 현재 시간 가져오기
     time_t now = time(NULL);
-    // 현재 시간 구조체 가져오기
-    struct tm *t = localtime(&now);
+    // 현재 시간 구조체 가져오기 (여러 샤드에서 동시에 호출하므로 재진입 가능한 함수 사용)
+    struct tm t;
+    ps_localtime(&now, &t);
     // 현재 시간 포맷팅
-    strftime(datetime_str, size, "%Y-%m-%d %H:%M:%S", t);
+    strftime(datetime_str, size, "%Y-%m-%d %H:%M:%S", &t);
+    return (int64_t)now;
+}
+
+// "YYYY-MM-DD HH:MM:SS" 문자열을 시각으로 변환 (파일에서 읽은 메모용)
+static int64_t parse_datetime(const char *datetime_str)
+{
+    struct tm t = {0};
+    if (sscanf(datetime_str, "%d-%d-%d %d:%d:%d", &t.tm_year, &t.tm_mon, &t.tm_mday, &t.tm_hour, &t.tm_min, &t.tm_sec) != 6)
+        return 0;
+    t.tm_year -= 1900;
+    t.tm_mon -= 1;
+    t.tm_isdst = -1;
+    return (int64_t)mktime(&t);
+}
+
+// 사용자 ID 해시 (FNV-1a)
+static uint32_t user_hash(const char *user_id)
+{
+    uint32_t hash = 2166136261u;
+    for (const char *p = user_id; *p; p++)
+    {
+        hash ^= (unsigned char)*p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// 해시가 들어갈 칸 번호
+// 파티션은 해시의 위아래 비트를 섞은 값의 나머지로 정하므로(store_partition.c) 한 파티션의 해시는 비트 일부가 겹친다. 곱한 뒤 위 비트를 쓴다.
+static size_t bucket_of(uint32_t hash, int bits)
+{
+    return (size_t)((hash * 2654435769u) >> (32 - bits));
+}
+
+// 사용자 ID가 속한 파티션의 테이블
+static MemoUserTable *table_of(const char *user_id)
+{
+    return &g_user_tables[store_partition_of(user_id)];
+}
+
+// 청크 참조 해제 (마지막 참조면 청크 해제, 노드를 놓는 보내는 스레드에서도 호출하므로 원자적으로 줄임)
+static void release_chunk(MemoChunk *chunk)
+{
+    if (__atomic_sub_fetch(&chunk->refs, 1, __ATOMIC_ACQ_REL) == 0)
+        free(chunk);
+}
+
+// 새 청크 할당 (참조 수 0)
+static MemoChunk *create_chunk(size_t size)
+{
+    MemoChunk *chunk = (MemoChunk *)malloc(sizeof(MemoChunk) + size);
+    if (!chunk)
+        return NULL;
+    chunk->refs = 0;
+    chunk->size = size;
+    chunk->used = 0;
+    return chunk;
+}
+
+// 아레나에서 size 바이트 잘라 냄 (청크 참조를 하나 늘려 *chunk_out에 돌려줌, 메모리가 부족하면 NULL)
+static void *arena_alloc(MemoArena *arena, size_t size, MemoChunk **chunk_out)
+{
+    MemoChunk *chunk = arena->current;
+    if (size > LARGE_NODE_SIZE)
+    {
+        // 큰 노드는 자기 크기의 청크에 (잘라 쓰던 청크는 그대로 둠)
+        chunk = create_chunk(size);
+        if (!chunk)
+            return NULL;
+    }
+    else if (!chunk || chunk->size - chunk->used < size)
+    {
+        // 남은 자리가 모자라면 다음 크기의 청크로 넘어감 (이전 청크는 든 노드가 모두 해제되면 해제됨)
+        size_t chunk_size = arena->next_size ? arena->next_size : MIN_CHUNK_SIZE;
+        if (chunk_size < size)
+            chunk_size = size;
+        chunk = create_chunk(chunk_size);
+        if (!chunk)
+            return NULL;
+        chunk->refs = 1; // 아레나가 잘라 쓰는 중
+        if (arena->current)
+            release_chunk(arena->current);
+        arena->current = chunk;
+        arena->next_size = chunk_size * 2 < MAX_CHUNK_SIZE ? chunk_size * 2 : MAX_CHUNK_SIZE;
+    }
+    void *block = chunk->data + chunk->used;
+    chunk->used += size;
+    __atomic_add_fetch(&chunk->refs, 1, __ATOMIC_RELAXED);
+    *chunk_out = chunk;
+    return block;
 }
 
-// 메모 노드 생성
-static MemoNode *create_memo_node(const Memo *memo_data)
+// 아레나 비우기 (잘라 쓰던 청크를 놓음, 청크에 남은 노드는 해제될 때 청크를 놓음)
+static void arena_reset(MemoArena *arena)
 {
-    // 새 메모 노드 생성
-    MemoNode *new_node = (MemoNode *)malloc(sizeof(MemoNode));
+    if (arena->current)
+        release_chunk(arena->current);
+    memset(arena, 0, sizeof(*arena));
+}
+
+// 사용자의 메모 찾기 (메모를 추가한 적이 없으면 NULL, 잠그지 않고 읽는 쪽도 사용)
+static MemoUser *find_user(const char *user_id)
+{
+    MemoUserSlots *slots = __atomic_load_n(&table_of(user_id)->slots, __ATOMIC_ACQUIRE);
+    if (!slots)
+        return NULL;
+    size_t mask = ((size_t)1 << slots->bits) - 1;
+    for (size_t i = bucket_of(user_hash(user_id), slots->bits);; i = (i + 1) & mask)
+    {
+        MemoUser *user = __atomic_load_n(&slots->users[i], __ATOMIC_ACQUIRE);
+        if (!user)
+            return NULL;
+        if (strcmp(user->user_id, user_id) == 0)
+            return user;
+    }
+}
+
+// 사용자를 칸 배열에 넣음 (빈 칸이 있어야 함)
+static void put_user(MemoUserSlots *slots, MemoUser *user)
+{
+    size_t mask = ((size_t)1 << slots->bits) - 1;
+    size_t i = bucket_of(user_hash(user->user_id), slots->bits);
+    while (slots->users[i])
+    {
+        i = (i + 1) & mask;
+    }
+    __atomic_store_n(&slots->users[i], user, __ATOMIC_RELEASE);
+}
+
+// 새 칸 배열을 만들어 메모가 있는 사용자만 옮김 (판이 빈 사용자는 읽는 쪽이 떠난 뒤 해제)
+static bool rebuild_user_table(MemoUserTable *table)
+{
+    MemoUserSlots *old = table->slots;
+    size_t old_size = old ? (size_t)1 << old->bits : 0;
+    int live = 0;
+    for (size_t i = 0; i < old_size; i++)
+    {
+        if (old->users[i] && old->users[i]->snapshot)
+            live++;
+    }
+    // 옮긴 뒤 절반 이하로 차도록
+    int bits = INITIAL_USER_SLOT_BITS;
+    while ((size_t)(live + 1) * 2 > ((size_t)1 << bits))
+    {
+        bits++;
+    }
+    MemoUserSlots *slots = (MemoUserSlots *)calloc(1, sizeof(MemoUserSlots) + sizeof(MemoUser *) * ((size_t)1 << bits));
+    if (!slots)
+        return false;
+    slots->bits = bits;
+    for (size_t i = 0; i < old_size; i++)
+    {
+        if (old->users[i] && old->users[i]->snapshot)
+            put_user(slots, old->users[i]);
+    }
+    __atomic_store_n(&table->slots, slots, __ATOMIC_RELEASE);
+    table->user_count = live;
+    if (old)
+    {
+        for (size_t i = 0; i < old_size; i++)
+        {
+            if (old->users[i] && !old->users[i]->snapshot)
+            {
+                arena_reset(&old->users[i]->arena);
+                epoch_retire(&old->users[i]->retired, epoch_free);
+            }
+        }
+        epoch_retire(&old->retired, epoch_free);
+    }
+    return true;
+}
+
+// 사용자의 메모 찾기 (없으면 빈 판으로 등록)
+static MemoUser *find_or_add_user(const char *user_id)
+{
+    MemoUser *user = find_user(user_id);
+    if (user)
+        return user;
+    MemoUserTable *table = table_of(user_id);
+    if ((!table->slots || (size_t)(table->user_count + 1) * 4 > ((size_t)3 << table->slots->bits)) &&
+        !rebuild_user_table(table))
+    {
+        // 옮기지 못해도 빈 칸이 남아 있으면 그대로 사용 (탐사가 조금 길어질 뿐)
+        if (!table->slots || table->user_count + 1 >= (1 << table->slots->bits))
+            return NULL;
+    }
+    user = (MemoUser *)calloc(1, sizeof(MemoUser));
+    if (!user)
+        return NULL;
+    strcpy(user->user_id, user_id); // 메모의 사용자 ID (MAX_USER_ID_LEN보다 짧음)
+    put_user(table->slots, user);
+    table->user_count++;
+    return user;
+}
+
+// 메모 ID 색인에서 ID가 처음 찾아볼 칸
+static size_t id_slot_of(int memo_id, int bits)
+{
+    return (size_t)(((uint32_t)memo_id * 2654435769u) >> (32 - bits));
+}
+
+// 메모 ID가 들어 있는 칸 찾기 (없으면 NULL)
+static MemoNode **id_index_find(MemoIdIndex *index, int memo_id)
+{
+    if (!index->slots)
+        return NULL;
+    size_t mask = ((size_t)1 << index->slot_bits) - 1;
+    for (size_t i = id_slot_of(memo_id, index->slot_bits);; i = (i + 1) & mask)
+    {
+        MemoNode *node = index->slots[i];
+        // 빈 칸을 만나면 없음 (삭제할 때 뒤의 메모를 당겨 와 빈 칸이 탐사를 끊지 않음)
+        if (!node)
+            return NULL;
+        if (node->memo.id == memo_id)
+            return &index->slots[i];
+    }
+}
+
+// 칸 수를 두 배로 늘리고 메모들을 새 칸에 다시 넣음
+static bool id_index_grow(MemoIdIndex *index)
+{
+    int bits = index->slots ? index->slot_bits + 1 : INITIAL_ID_SLOT_BITS;
+    size_t mask = ((size_t)1 << bits) - 1;
+    MemoNode **slots = (MemoNode **)calloc(mask + 1, sizeof(MemoNode *));
+    if (!slots)
+        return false;
+    for (size_t i = 0; index->slots && i < ((size_t)1 << index->slot_bits); i++)
+    {
+        MemoNode *node = index->slots[i];
+        if (!node)
+            continue;
+        size_t j = id_slot_of(node->memo.id, bits);
+        while (slots[j])
+        {
+            j = (j + 1) & mask;
+        }
+        slots[j] = node;
+    }
+    free(index->slots);
+    index->slots = slots;
+    index->slot_bits = bits;
+    return true;
+}
+
+// 메모를 색인에 넣음 (반환값: 메모리가 부족하거나 같은 ID가 이미 있으면 false)
+static bool id_index_insert(MemoIdIndex *index, MemoNode *node)
+{
+    if ((!index->slots || (index->count + 1) * 4 > ((size_t)3 << index->slot_bits)) && !id_index_grow(index))
+        return false;
+    size_t mask = ((size_t)1 << index->slot_bits) - 1;
+    size_t i = id_slot_of(node->memo.id, index->slot_bits);
+    while (index->slots[i])
+    {
+        if (index->slots[i]->memo.id == node->memo.id)
+            return false;
+        i = (i + 1) & mask;
+    }
+    index->slots[i] = node;
+    index->count++;
+    return true;
+}
+
+// 칸을 비우고, 뒤에 이어진 메모 중 처음 찾아볼 칸이 빈 칸 이전인 것을 당겨 와 탐사가 끊기지 않게 함
+static void id_index_remove(MemoIdIndex *index, MemoNode **slot)
+{
+    size_t mask = ((size_t)1 << index->slot_bits) - 1;
+    size_t hole = (size_t)(slot - index->slots);
+    for (size_t j = (hole + 1) & mask; index->slots[j]; j = (j + 1) & mask)
+    {
+        size_t home = id_slot_of(index->slots[j]->memo.id, index->slot_bits);
+        // home에서 j까지의 거리가 빈 칸에서 j까지의 거리 이상이면 빈 칸으로 옮겨도 찾을 수 있음
+        if (((j - home) & mask) >= ((j - hole) & mask))
+        {
+            index->slots[hole] = index->slots[j];
+            hole = j;
+        }
+    }
+    index->slots[hole] = NULL;
+    index->count--;
+}
+
+// 텍스트를 노드 뒤에 복사하고 다음 자리로 넘어감 (반환값: 복사한 문자열)
+static const char *copy_text(char **at, const char *text, uint32_t len)
+{
+    char *copy = *at;
+    memcpy(copy, text, len);
+    copy[len] = '\0';
+    *at += len + 1;
+    return copy;
+}
+
+// 메모 노드 생성 (memo_data의 사용자 ID/제목/내용을 길이만큼 노드 바로 뒤에 복사)
+static MemoNode *create_memo_node(MemoArena *arena, const Memo *memo_data)
+{
+    // 노드 헤더와 텍스트 세 개('\0' 포함)를 합친 크기
+    size_t size = sizeof(MemoNode) + (size_t)memo_data->user_id_len + memo_data->title_len + memo_data->content_len + 3;
+    size = (size + NODE_ALIGN - 1) & ~(size_t)(NODE_ALIGN - 1);
+    if (size > UINT32_MAX)
+        return NULL;
+    // 아레나에서 새 메모 노드 자리를 잘라 냄
+    MemoChunk *chunk;
+    MemoNode *new_node = (MemoNode *)arena_alloc(arena, size, &chunk);
     // 새 메모 노드 생성 실패 시
     if (!new_node)
     {
@@ -37,75 +427,352 @@ static MemoNode *create_memo_node(const Memo *memo_data)
     }
     // 메모 노드 초기화
     new_node->memo = *memo_data;
-    // 다음 메모 노드 포인터 초기화
-    new_node->next = NULL;
+    char *text = (char *)(new_node + 1);
+    new_node->memo.user_id = copy_text(&text, memo_data->user_id, memo_data->user_id_len);
+    new_node->memo.title = copy_text(&text, memo_data->title, memo_data->title_len);
+    new_node->memo.content = copy_text(&text, memo_data->content, memo_data->content_len);
+    new_node->size = (uint32_t)size;
+    new_node->chunk = chunk;
+    // 저장소가 가진 참조 하나
+    new_node->refs = 1;
     // 새 메모 노드 반환
     return new_node;
 }
 
-// 메모 노드 추가
-static void append_memo_node(MemoNode *node_to_add)
+// 메모 노드 참조 해제 (저장소에서 빠졌고 붙잡은 응답도 없으면 노드가 든 청크의 참조를 놓음)
+// 응답은 보내는 스레드에서 놓아주므로 참조 수는 원자적으로 줄인다.
+static void release_memo_node(void *obj)
+{
+    MemoNode *node = (MemoNode *)obj;
+    if (__atomic_sub_fetch(&node->refs, 1, __ATOMIC_ACQ_REL) == 0)
+        release_chunk(node->chunk);
+}
+
+// 저장소에서 뺀 노드의 참조를 읽는 쪽이 모두 떠난 뒤 놓아줌 (epoch_retire의 해제 함수)
+static void release_retired_node(EpochRetired *item)
 {
-    // 메모 노드 헤드가 없으면
-    if (!g_memo_list_head)
+    release_memo_node((char *)item - offsetof(MemoNode, retired));
+}
+
+// 사용자 삭제로 버린 판의 노드를 모두 놓아주고 판 해제 (epoch_retire의 해제 함수)
+static void release_snapshot_nodes(EpochRetired *item)
+{
+    MemoSnapshot *snapshot = (MemoSnapshot *)item;
+    for (int i = 0; i < snapshot->count; i++)
     {
-        // 메모 노드 헤드 설정
-        g_memo_list_head = node_to_add;
+        release_memo_node(snapshot->memos[i]);
     }
-    else
+    free(snapshot);
+}
+
+// 빈 판 생성
+static MemoSnapshot *create_snapshot(int capacity)
+{
+    MemoSnapshot *snapshot = (MemoSnapshot *)malloc(sizeof(MemoSnapshot) + sizeof(MemoNode *) * (size_t)capacity);
+    if (!snapshot)
+        return NULL;
+    snapshot->count = 0;
+    snapshot->capacity = capacity;
+    return snapshot;
+}
+
+// 새 판을 발행하고 이전 판은 읽는 쪽이 떠난 뒤 해제
+static void publish_snapshot(MemoUser *user, MemoSnapshot *snapshot)
+{
+    MemoSnapshot *old = user->snapshot;
+    __atomic_store_n(&user->snapshot, snapshot, __ATOMIC_RELEASE);
+    if (old)
+        epoch_retire(&old->retired, epoch_free);
+}
+
+// 사용자 판 끝에 노드 추가 (빈 칸이 있으면 제자리에, 가득 찼으면 두 배 크기의 새 판으로)
+static bool snapshot_append(MemoUser *user, MemoNode *node)
+{
+    MemoSnapshot *snapshot = user->snapshot;
+    int count = snapshot ? snapshot->count : 0;
+    if (snapshot && count < snapshot->capacity)
+    {
+        // 읽는 쪽은 count 앞까지만 보므로 노드를 먼저 넣고 count를 늘림
+        snapshot->memos[count] = node;
+        __atomic_store_n(&snapshot->count, count + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+    MemoSnapshot *grown = create_snapshot(snapshot ? snapshot->capacity * 2 : INITIAL_USER_MEMOS);
+    if (!grown)
+        return false;
+    if (count > 0)
+        memcpy(grown->memos, snapshot->memos, sizeof(MemoNode *) * (size_t)count);
+    grown->memos[count] = node;
+    grown->count = count + 1;
+    publish_snapshot(user, grown);
+    return true;
+}
+
+// 사용자 판에서 노드를 바꾸거나(replacement) 빼서(NULL) 새 판 발행
+// 반환값: 메모리가 부족하면 false (판은 그대로)
+static bool snapshot_replace(MemoUser *user, const MemoNode *node, MemoNode *replacement)
+{
+    MemoSnapshot *snapshot = user->snapshot;
+    int count = snapshot->count - (replacement ? 0 : 1);
+    if (count == 0)
+    {
+        publish_snapshot(user, NULL);
+        return true;
+    }
+    // 많이 지워졌으면 배열도 줄임
+    int capacity = snapshot->capacity;
+    while (capacity > INITIAL_USER_MEMOS && count * 4 <= capacity)
+    {
+        capacity /= 2;
+    }
+    MemoSnapshot *next = create_snapshot(capacity);
+    if (!next)
+        return false;
+    for (int i = 0; i < snapshot->count; i++)
+    {
+        if (snapshot->memos[i] != node)
+            next->memos[next->count++] = snapshot->memos[i];
+        else if (replacement)
+            next->memos[next->count++] = replacement;
+    }
+    publish_snapshot(user, next);
+    return true;
+}
+
+// 메모 노드 추가 (메모 소유자의 판 끝과 파티션의 ID 색인에, 노드는 소유자의 아레나에서 만든 것)
+// 반환값: 메모리가 부족하거나 같은 ID의 메모가 이미 있으면 false (노드는 호출자가 해제)
+static bool append_memo_node(MemoUser *user, MemoNode *node_to_add)
+{
+    MemoIdIndex *index = &g_id_indexes[store_partition_of(node_to_add->memo.user_id)];
+    if (!id_index_insert(index, node_to_add))
+        return false;
+    if (!snapshot_append(user, node_to_add))
+    {
+        id_index_remove(index, id_index_find(index, node_to_add->memo.id));
+        return false;
+    }
+    user->arena.live_bytes += node_to_add->size;
+    return true;
+}
+
+// 사용자의 메모를 새 청크로 모아 옮김 (죽은 바이트가 산 바이트보다 많고 MIN_COMPACT_BYTES 이상일 때)
+// 옮긴 노드로 새 판을 발행하고 ID 색인도 새 노드를 가리키게 한 뒤, 이전 판과 노드는 읽는 쪽이 떠나면 놓는다.
+// 이전 노드를 붙잡은 응답이 있으면 그 노드가 든 청크는 전송이 끝난 뒤 해제된다. 메모리가 부족하면 옮기지 않는다.
+static void compact_user(MemoUser *user)
+{
+    MemoArena *arena = &user->arena;
+    MemoSnapshot *snapshot = user->snapshot;
+    if (!snapshot || arena->dead_bytes < MIN_COMPACT_BYTES || arena->dead_bytes <= arena->live_bytes)
+        return;
+    MemoSnapshot *next = create_snapshot(snapshot->capacity);
+    if (!next)
+        return;
+    // 큰 노드를 뺀 산 노드가 모두 첫 청크 하나에 들어가도록
+    MemoArena fresh = {NULL, 0, 0, 0};
+    for (int i = 0; i < snapshot->count; i++)
     {
-        // 메모 노드 헤드부터 끝까지 탐색
-        MemoNode *current = g_memo_list_head;
-        // 다음 메모 노드가 있으면
-        while (current->next)
+        if (snapshot->memos[i]->size <= LARGE_NODE_SIZE)
+            fresh.next_size += snapshot->memos[i]->size;
+    }
+    for (int i = 0; i < snapshot->count; i++)
+    {
+        MemoNode *copy = create_memo_node(&fresh, &snapshot->memos[i]->memo);
+        if (!copy)
         {
-            // 다음 메모 노드로 이동
-            current = current->next;
+            for (int j = 0; j < next->count; j++)
+            {
+                release_memo_node(next->memos[j]);
+            }
+            free(next);
+            arena_reset(&fresh);
+            return;
         }
-        // 마지막 메모 노드의 다음 메모 노드 포인터 설정
-        current->next = node_to_add;
+        next->memos[next->count++] = copy;
+        fresh.live_bytes += copy->size;
+    }
+    // ID 색인의 칸을 새 노드로 바꾸고 새 판 발행
+    MemoIdIndex *index = &g_id_indexes[store_partition_of(user->user_id)];
+    for (int i = 0; i < next->count; i++)
+    {
+        *id_index_find(index, next->memos[i]->memo.id) = next->memos[i];
     }
+    __atomic_store_n(&user->snapshot, next, __ATOMIC_RELEASE);
+    arena_reset(arena);
+    *arena = fresh;
+    epoch_retire(&snapshot->retired, release_snapshot_nodes);
+}
+
+// 메모 노드가 들어 있는 색인 칸 찾기 (ID 색인으로 찾은 뒤 소유자 확인, 없거나 다른 사용자의 메모면 NULL)
+static MemoNode **find_memo_slot(int memo_id, const char *user_id)
+{
+    MemoNode **slot = id_index_find(&g_id_indexes[store_partition_of(user_id)], memo_id);
+    if (!slot || strcmp((*slot)->memo.user_id, user_id) != 0)
+        return NULL;
+    return slot;
 }
 
 // 메모 노드 찾기
 static MemoNode *find_memo_node(int memo_id, const char *user_id)
 {
-    // 메모 노드 헤드부터 끝까지 탐색
-    MemoNode *current = g_memo_list_head;
-    // 메모 노드 탐색
-    while (current)
+    MemoNode **slot = find_memo_slot(memo_id, user_id);
+    return slot ? *slot : NULL;
+}
+
+// 판을 읽기 시작 (판 포인터와 발행된 메모 수를 한 번씩 읽음, 에포크 구간이나 잠금 안에서 호출)
+static MemoSnapshot *read_snapshot(const char *user_id, int *count)
+{
+    MemoUser *user = find_user(user_id);
+    MemoSnapshot *snapshot = user ? __atomic_load_n(&user->snapshot, __ATOMIC_ACQUIRE) : NULL;
+    *count = snapshot ? __atomic_load_n(&snapshot->count, __ATOMIC_ACQUIRE) : 0;
+    return snapshot;
+}
+
+// 파일에서 한 줄 읽기 (줄바꿈 문자는 빼고, 버퍼는 줄 길이에 맞춰 늘림)
+// 반환값: 더 읽을 줄이 없으면 false
+static bool read_line(FILE *file, char **line, size_t *capacity)
+{
+    size_t len = 0;
+    for (;;)
     {
-        if (current->memo.id == memo_id && strcmp(current->memo.user_id, user_id) == 0)
+        // fgets가 최소 한 글자는 읽을 수 있도록 버퍼 확보
+        if (*capacity - len < 2)
         {
-            // 메모 노드 반환
-            return current;
+            size_t grown = *capacity ? *capacity * 2 : 256;
+            char *buffer = (char *)realloc(*line, grown);
+            if (!buffer)
+                return false;
+            *line = buffer;
+            *capacity = grown;
+        }
+        if (!fgets(*line + len, (int)(*capacity - len), file))
+            return len > 0;
+        len += strlen(*line + len);
+        if (len > 0 && (*line)[len - 1] == '\n')
+        {
+            (*line)[len - 1] = '\0';
+            return true;
         }
-        // 다음 메모 노드로 이동
-        current = current->next;
     }
-    return NULL;
 }
 
-// UTF-8 소문자 변환
-static void to_lowercase_utf8(const char *src, char *dest, size_t dest_size)
+// 파일의 메모 한 줄("id\t생성일시\t수정일시\t제목\t내용")을 나눠 memo에 채움 (제목/내용은 line을 가리킴)
+// 반환값: 형식이 맞지 않으면 false
+static bool parse_memo_line(char *line, Memo *memo)
 {
-    // 소스 문자열 복사
-    strncpy(dest, src, dest_size);
-    // 대상 문자열 크기 체크
-    if (dest_size > 0)
+    // 탭으로 앞의 네 필드를 자르고, 나머지는 모두 내용 (내용에는 탭이 있어도 됨)
+    char *fields[4];
+    char *rest = line;
+    for (int i = 0; i < 4; i++)
     {
-        dest[dest_size - 1] = '\0';
+        char *tab = strchr(rest, '\t');
+        if (!tab || tab == rest)
+            return false;
+        *tab = '\0';
+        fields[i] = rest;
+        rest = tab + 1;
     }
-    // 대상 문자열 소문자 변환
-    for (int i = 0; dest[i] != '\0'; i++)
+    char *end;
+    long id = strtol(fields[0], &end, 10);
+    if (*end != '\0' || *rest == '\0' || strlen(fields[1]) >= MAX_DATETIME_LEN || strlen(fields[2]) >= MAX_DATETIME_LEN)
+        return false;
+    memo->id = (int)id;
+    strcpy(memo->created_at, fields[1]);
+    strcpy(memo->updated_at, fields[2]);
+    memo->title = fields[3];
+    memo->title_len = (uint32_t)strlen(fields[3]);
+    memo->content = rest;
+    memo->content_len = (uint32_t)strlen(rest);
+    return true;
+}
+
+// 텍스트에 키워드가 들어 있는지 대소문자 구분 없이 확인 (양쪽을 바이트마다 소문자로 비교, 영문만 변환)
+// 키워드를 복사하지 않으므로 길이 제한이 없다. (keyword_len은 1 이상)
+static bool contains_ignore_case(const char *text, size_t text_len, const char *keyword, size_t keyword_len)
+{
+    int first = tolower((unsigned char)keyword[0]);
+    for (size_t i = 0; i + keyword_len <= text_len; i++)
     {
-        dest[i] = tolower((unsigned char)dest[i]);
+        // 첫 글자가 맞는 자리에서만 나머지를 비교
+        if (tolower((unsigned char)text[i]) != first)
+            continue;
+        size_t j = 1;
+        while (j < keyword_len && tolower((unsigned char)text[i + j]) == tolower((unsigned char)keyword[j]))
+        {
+            j++;
+        }
+        if (j == keyword_len)
+            return true;
     }
+    return false;
+}
+
+// 사용자 메모 파일 하나를 읽어 메모 리스트에 추가
+static void load_memo_file(const char *file_name)
+{
+    // 파일 이름에서 사용자 ID 추출
+    char user_id[MAX_USER_ID_LEN] = {0};
+    const char *suffix = "_memos.txt";
+    const char *suffix_ptr = strstr(file_name, suffix);
+    // 파일 이름에서 사용자 ID 추출 실패 시
+    if (!suffix_ptr || suffix_ptr[strlen(suffix)] != '\0')
+        return;
+    // 사용자 ID 길이 계산
+    size_t user_id_len = suffix_ptr - file_name;
+    if (user_id_len == 0 || user_id_len >= MAX_USER_ID_LEN)
+        return;
+    // 사용자 ID 복사
+    strncpy(user_id, file_name, user_id_len);
+    // 사용자 ID 끝에 null 문자 추가
+    user_id[user_id_len] = '\0';
+    // 파일 경로 생성
+    char full_path[MAX_PATH];
+    snprintf(full_path, MAX_PATH, "%s%s", DATA_DIR, file_name);
+    // 파일 열기
+    FILE *file = fopen(full_path, "r");
+    if (!file)
+        return;
+    // 메모를 넣을 사용자 (파일 하나는 한 사용자의 메모)
+    MemoUser *user = find_or_add_user(user_id);
+    // 파일에서 메모 데이터 읽기 (줄 길이는 제한 없음, 형식이 맞지 않는 줄을 만나면 중단)
+    Memo memo;
+    memo.user_id = user_id;
+    memo.user_id_len = (uint32_t)user_id_len;
+    char *line = NULL;
+    size_t line_capacity = 0;
+    while (user && read_line(file, &line, &line_capacity))
+    {
+        // 빈 줄은 건너뜀
+        if (line[strspn(line, " \t\r")] == '\0')
+            continue;
+        if (!parse_memo_line(line, &memo))
+            break;
+        // 시각 변환은 로드할 때 한 번만 수행
+        memo.created_ts = parse_datetime(memo.created_at);
+        memo.updated_ts = parse_datetime(memo.updated_at);
+        // 메모 노드 생성
+        MemoNode *new_node = create_memo_node(&user->arena, &memo);
+        if (new_node && !append_memo_node(user, new_node))
+        {
+            release_memo_node(new_node);
+            new_node = NULL;
+        }
+        if (new_node)
+        {
+            // 다음 메모 ID 업데이트
+            if (memo.id >= g_next_memo_id)
+            {
+                g_next_memo_id = memo.id + 1;
+            }
+        }
+    }
+    free(line);
+    fclose(file);
 }
 
 // 메모 초기화
 void memo_init()
 {
+#ifdef _WIN32
     // 메모 파일 검색
     WIN32_FIND_DATA findFileData;
     // 메모 파일 검색 핸들
@@ -127,162 +794,155 @@ void memo_init()
         // 디렉토리가 아닌 경우에만 처리
         if (!(findFileData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
         {
-            // 파일 이름에서 사용자 ID 추출
-            char user_id[MAX_USER_ID_LEN] = {0};
-            char *suffix = "_memos.txt";
-            char *suffix_ptr = strstr(findFileData.cFileName, suffix);
-            if (suffix_ptr)
-            {
-                // 사용자 ID 길이 계산
-                size_t user_id_len = suffix_ptr - findFileData.cFileName;
-                // 사용자 ID 복사
-                strncpy(user_id, findFileData.cFileName, user_id_len);
-                // 사용자 ID 끝에 null 문자 추가
-                user_id[user_id_len] = '\0';
-            }
-            else
-            {
-                // 파일 이름에서 사용자 ID 추출 실패 시
-                continue;
-            }
-            // 파일 경로 생성
-            char full_path[MAX_PATH];
-            // 파일 경로 생성
-            snprintf(full_path, MAX_PATH, "%s%s", DATA_DIR, findFileData.cFileName);
-            // 파일 열기
-            FILE *file = fopen(full_path, "r");
-            if (!file)
-                continue;
-            // 파일에서 메모 데이터 읽기
-            Memo memo;
-            while (fscanf(file, "%d\t%[^\t]\t%[^\t]\t%[^\t]\t%[^\n]\n", &memo.id, memo.created_at, memo.updated_at, memo.title, memo.content) == 5)
-            {
-                strncpy(memo.user_id, user_id, MAX_USER_ID_LEN - 1);
-                memo.user_id[MAX_USER_ID_LEN - 1] = '\0';
-                // 메모 노드 생성
-                MemoNode *new_node = create_memo_node(&memo);
-                if (new_node)
-                {
-                    append_memo_node(new_node);
-                    // 다음 메모 ID 업데이트
-                    if (memo.id >= g_next_memo_id)
-                    {
-                        g_next_memo_id = memo.id + 1;
-                    }
-                }
-            }
-            fclose(file);
+            load_memo_file(findFileData.cFileName);
         }
         // 다음 파일 찾기
     } while (FindNextFile(hFind, &findFileData) != 0);
     // 파일 핸들 닫기
     FindClose(hFind);
+#else
+    // 메모 디렉터리 열기
+    DIR *dir = opendir(DATA_DIR);
+    // 메모 디렉터리 열기 실패 시
+    if (!dir)
+    {
+        printf("No memo files found. Initializing empty memo list.\n");
+        return;
+    }
+    // 메모 파일 검색
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        // 일반 파일만 처리 (이름 패턴은 load_memo_file에서 확인)
+        if (entry->d_type == DT_REG || entry->d_type == DT_UNKNOWN)
+        {
+            load_memo_file(entry->d_name);
+        }
+    }
+    // 디렉터리 닫기
+    closedir(dir);
+#endif
     printf("Memo data loaded. Next memo ID is %d\n", g_next_memo_id);
 }
 
-// 메모 정리
+// 메모 정리 (다른 스레드가 모두 멈춘 뒤 호출)
 void memo_cleanup()
 {
-    // 메모 노드 정리
-    MemoNode *current = g_memo_list_head;
-    while (current)
+    // 모든 파티션의 사용자와 메모 노드 정리
+    for (int p = 0; p < MAX_STORE_PARTITIONS; p++)
+    {
+        MemoUserTable *table = &g_user_tables[p];
+        if (!table->slots)
+            continue;
+        for (size_t i = 0; i < ((size_t)1 << table->slots->bits); i++)
+        {
+            MemoUser *user = table->slots->users[i];
+            if (!user)
+                continue;
+            // 노드 참조 해제 (보내는 중인 응답이 붙잡은 노드는 전송이 끝난 뒤 해제됨)
+            if (user->snapshot)
+                release_snapshot_nodes(&user->snapshot->retired);
+            arena_reset(&user->arena);
+            free(user);
+        }
+        free(table->slots);
+        table->slots = NULL;
+        table->user_count = 0;
+        // ID 색인 정리 (노드는 위에서 놓아줌)
+        free(g_id_indexes[p].slots);
+        g_id_indexes[p].slots = NULL;
+        g_id_indexes[p].slot_bits = 0;
+        g_id_indexes[p].count = 0;
+    }
+    // 해제를 미뤄 둔 이전 판과 뺀 노드 정리
+    epoch_drain();
+}
+
+// 사용자 한 명의 메모를 파일에 저장 (snapshot: 그 사용자의 판, 없으면 빈 파일)
+static void save_user_file(const MemoSnapshot *snapshot, const char *user_id)
+{
+    // 파일 경로 생성
+    char filepath[MAX_PATH];
+    snprintf(filepath, MAX_PATH, "%s%s_memos.txt", DATA_DIR, user_id);
+    // 파일 열기
+    FILE *file = fopen(filepath, "w");
+    // 파일 열기 실패 시
+    if (!file)
+        return;
+    // 메모 목록 저장
+    for (int i = 0; snapshot && i < snapshot->count; i++)
     {
-        // 다음 노드 저장
-        MemoNode *next = current->next;
-        free(current);
-        current = next;
+        const Memo *memo = &snapshot->memos[i]->memo;
+        fprintf(file, "%d\t%s\t%s\t%s\t%s\n", memo->id, memo->created_at, memo->updated_at, memo->title, memo->content);
     }
-    // 메모 노드 헤드 초기화
-    g_memo_list_head = NULL;
+    fclose(file);
+}
+
+// 사용자 한 명의 메모를 파일에 저장
+void memo_save_user(const char *user_id)
+{
+    MemoUser *user = find_user(user_id);
+    save_user_file(user ? user->snapshot : NULL, user_id);
 }
 
-// 모든 메모를 파일에 저장
+// 모든 메모를 파일에 저장 (메모가 있는 사용자마다 한 번)
 void memo_save_all_to_files()
 {
-    // 사용자별 메모 목록 생성
-    char users[100][MAX_USER_ID_LEN];
-    int user_count = 0;
-    MemoNode *current = g_memo_list_head;
-    while (current)
+    for (int p = 0; p < MAX_STORE_PARTITIONS; p++)
     {
-        // 이미 처리한 사용자인지 확인
-        bool found = false;
-        for (int i = 0; i < user_count; i++)
-        {
-            // 사용자 ID 비교
-            if (strcmp(users[i], current->memo.user_id) == 0)
-            {
-                found = true;
-                break;
-            }
-        }
-        // 사용자 ID 비교 실패 시
-        if (!found && user_count < 100)
+        MemoUserSlots *slots = g_user_tables[p].slots;
+        for (size_t i = 0; slots && i < ((size_t)1 << slots->bits); i++)
         {
-            // 새로운 사용자 추가
-            strncpy(users[user_count], current->memo.user_id, MAX_USER_ID_LEN - 1);
-            users[user_count][MAX_USER_ID_LEN - 1] = '\0';
-            user_count++;
-        }
-        current = current->next;
-    }
-    // 각 사용자별 메모 목록 저장
-    for (int i = 0; i < user_count; i++)
-    {
-        // 파일 경로
-        char filepath[MAX_PATH];
-        // 파일 경로 생성
-        snprintf(filepath, MAX_PATH, "%s%s_memos.txt", DATA_DIR, users[i]);
-        // 파일 열기
-        FILE *file = fopen(filepath, "w");
-        // 파일 열기 실패 시
-        if (!file)
-            continue;
-        // 메모 목록 저장
-        current = g_memo_list_head;
-        while (current)
-        {
-            // 사용자 ID 비교
-            if (strcmp(current->memo.user_id, users[i]) == 0)
-            {
-                fprintf(file, "%d\t%s\t%s\t%s\t%s\n", current->memo.id, current->memo.created_at, current->memo.updated_at, current->memo.title, current->memo.content);
-            }
-            // 다음 메모 노드로 이동
-            current = current->next;
+            MemoUser *user = slots->users[i];
+            if (user && user->snapshot)
+                save_user_file(user->snapshot, user->user_id);
         }
-        fclose(file);
     }
 }
 
 // 메모 추가
 bool memo_add(const char *user_id, const char *title, const char *content)
 {
-    // 새 메모 노드 생성
+    // 잘리는 사용자 ID로는 저장하지 않음 (잘린 ID의 다른 사용자 메모가 됨)
+    size_t user_id_len = strlen(user_id);
+    if (user_id_len >= MAX_USER_ID_LEN)
+        return false;
+    // 새 메모 정보 (텍스트는 노드를 만들 때 아레나로 복사)
     Memo new_memo;
     // 새 메모 ID 생성
-    new_memo.id = g_next_memo_id++;
-    // 사용자 ID 복사
-    strncpy(new_memo.user_id, user_id, MAX_USER_ID_LEN);
-    new_memo.user_id[MAX_USER_ID_LEN - 1] = '\0';
-    // 제목 복사
-    strncpy(new_memo.title, title, MAX_MEMO_TITLE_LEN);
-    new_memo.title[MAX_MEMO_TITLE_LEN - 1] = '\0';
-    // 내용 복사
-    strncpy(new_memo.content, content, MAX_MEMO_CONTENT_LEN);
-    new_memo.content[MAX_MEMO_CONTENT_LEN - 1] = '\0';
+    new_memo.id = __atomic_fetch_add(&g_next_memo_id, 1, __ATOMIC_RELAXED);
+    // 사용자 ID
+    new_memo.user_id = user_id;
+    new_memo.user_id_len = (uint32_t)user_id_len;
+    // 제목 (최대 길이까지만)
+    size_t title_len = strlen(title);
+    new_memo.title = title;
+    new_memo.title_len = (uint32_t)(title_len < MAX_MEMO_TITLE_LEN ? title_len : MAX_MEMO_TITLE_LEN - 1);
+    // 내용 (길이 제한 없음)
+    new_memo.content = content;
+    new_memo.content_len = (uint32_t)strlen(content);
     // 현재 날짜와 시간 설정
-    get_current_datetime(new_memo.created_at, MAX_DATETIME_LEN);
+    new_memo.created_ts = get_current_datetime(new_memo.created_at, MAX_DATETIME_LEN);
     // 수정 날짜와 시간 설정
     strcpy(new_memo.updated_at, new_memo.created_at);
+    new_memo.updated_ts = new_memo.created_ts;
+    // 메모 소유자 찾기
+    MemoUser *user = find_or_add_user(user_id);
+    if (!user)
+        return false;
     // 메모 노드 생성
-    MemoNode *new_node = create_memo_node(&new_memo);
+    MemoNode *new_node = create_memo_node(&user->arena, &new_memo);
     // 메모 노드 생성 실패 시
     if (!new_node)
         return false;
     // 메모 노드 추가
-    append_memo_node(new_node);
-    // 모든 메모를 파일에 저장
-    memo_save_all_to_files(); // 즉시 저장
+    if (!append_memo_node(user, new_node))
+    {
+        release_memo_node(new_node);
+        return false;
+    }
+    // 사용자의 메모 파일 저장
+    memo_save_user(user_id); // 즉시 저장
     return true;
 }
 
@@ -290,71 +950,48 @@ bool memo_add(const char *user_id, const char *title, const char *content)
 bool memo_delete(int memo_id, const char *user_id)
 {
     // 메모 노드 탐색
-    MemoNode *current = g_memo_list_head;
-    MemoNode *prev = NULL;
-    // 메모 노드 삭제
-    while (current)
-    {
-        if (current->memo.id == memo_id && strcmp(current->memo.user_id, user_id) == 0)
-        {
-            // 이전 노드가 있는 경우
-            if (prev)
-            {
-                prev->next = current->next;
-            }
-            else
-            {
-                g_memo_list_head = current->next;
-            }
-            free(current);
-            memo_save_all_to_files(); // 즉시 저장
-            return true;
-        }
-        prev = current;
-        current = current->next;
-    }
-    return false;
+    MemoNode **slot = find_memo_slot(memo_id, user_id);
+    if (!slot)
+        return false;
+    MemoNode *node = *slot;
+    MemoUser *user = find_user(user_id);
+    // 노드를 뺀 새 판 발행 (읽는 중인 쪽은 이전 판에서 이 메모를 계속 봄)
+    if (!snapshot_replace(user, node, NULL))
+        return false;
+    id_index_remove(&g_id_indexes[store_partition_of(user_id)], slot);
+    user->arena.live_bytes -= node->size;
+    user->arena.dead_bytes += node->size;
+    epoch_retire(&node->retired, release_retired_node);
+    // 메모가 남지 않았으면 아레나를 비우고, 죽은 바이트가 많으면 남은 메모를 모아 옮김
+    if (!user->snapshot)
+        arena_reset(&user->arena);
+    else
+        compact_user(user);
+    memo_save_user(user_id); // 즉시 저장
+    return true;
 }
 
 // 회원 탈퇴 시, 해당 사용자의 모든 메모 데이터를 삭제
 bool memo_delete_by_user_id(const char *user_id)
 {
-    // 메모 노드 탐색
-    MemoNode *current = g_memo_list_head;
-    MemoNode *prev = NULL;
     // 변경 표시
     bool changed = false;
-    // 메모 노드 탐색
-    while (current != NULL)
+    MemoUser *user = find_user(user_id);
+    if (user && user->snapshot)
     {
-        // 사용자 ID 비교
-        if (strcmp(current->memo.user_id, user_id) == 0)
+        // 빈 판 발행 (사용자는 테이블에 남았다가 칸 배열을 새로 만들 때 버려짐)
+        MemoSnapshot *snapshot = user->snapshot;
+        __atomic_store_n(&user->snapshot, NULL, __ATOMIC_RELEASE);
+        changed = true;
+        // ID 색인에서 사용자의 메모 빼기
+        MemoIdIndex *index = &g_id_indexes[store_partition_of(user_id)];
+        for (int i = 0; i < snapshot->count; i++)
         {
-            // 삭제할 노드 저장
-            MemoNode *node_to_delete = current;
-            // 이전 노드가 없는 경우
-            if (prev == NULL)
-            {
-                g_memo_list_head = current->next;
-            }
-            // 이전 노드가 있는 경우
-            else
-            {
-                prev->next = current->next;
-            }
-            // 현재 노드 이동
-            current = current->next;
-            // 노드 메모리 해제
-            free(node_to_delete);
-            // 변경 표시
-            changed = true;
-        }
-        else
-        {
-            // 이전 노드 업데이트
-            prev = current;
-            current = current->next;
+            id_index_remove(index, id_index_find(index, snapshot->memos[i]->memo.id));
         }
+        // 읽는 쪽이 떠난 뒤 노드 참조 해제 (보내는 중인 응답이 붙잡고 있으면 전송이 끝난 뒤 해제됨)
+        epoch_retire(&snapshot->retired, release_snapshot_nodes);
+        arena_reset(&user->arena);
     }
     // 파일 경로 생성
     char filepath[MAX_PATH];
@@ -362,11 +999,11 @@ bool memo_delete_by_user_id(const char *user_id)
     // 파일 삭제
     if (remove(filepath) == 0)
     {
-        printf("[정보] %s 파일이 성공적으로 삭제되었습니다.\n", filepath);
+        logger_write(LOG_LEVEL_INFO, "[정보] %s 파일이 성공적으로 삭제되었습니다.", filepath);
     }
     else
     {
-        printf("[정보] %s 파일을 찾을 수 없거나 삭제할 수 없습니다.\n", filepath);
+        logger_write(LOG_LEVEL_INFO, "[정보] %s 파일을 찾을 수 없거나 삭제할 수 없습니다.", filepath);
     }
     return changed;
 }
@@ -375,52 +1012,137 @@ bool memo_delete_by_user_id(const char *user_id)
 bool memo_update(int memo_id, const char *user_id, const char *new_content)
 {
     // 메모 노드 탐색
-    MemoNode *node_to_update = find_memo_node(memo_id, user_id);
-    // 메모 노드 업데이트
-    if (node_to_update)
-    {
-        // 내용 복사
-        strncpy(node_to_update->memo.content, new_content, MAX_MEMO_CONTENT_LEN);
-        node_to_update->memo.content[MAX_MEMO_CONTENT_LEN - 1] = '\0';
-        // 수정 시간 업데이트
-        get_current_datetime(node_to_update->memo.updated_at, MAX_DATETIME_LEN);
-        memo_save_all_to_files(); // 즉시 저장
-        return true;
+    MemoNode **slot = find_memo_slot(memo_id, user_id);
+    if (!slot)
+        return false;
+    MemoNode *old_node = *slot;
+    MemoUser *user = find_user(user_id);
+    // 읽는 쪽이 보고 있을 수 있으므로 항상 복사본을 만들어 바꿔 끼움 (읽는 중인 쪽과 보내는 중인 응답은 수정 전 내용을 봄)
+    Memo updated = old_node->memo;
+    // 새 내용 (길이 제한 없음)
+    updated.content = new_content;
+    updated.content_len = (uint32_t)strlen(new_content);
+    // 수정 시간 업데이트
+    updated.updated_ts = get_current_datetime(updated.updated_at, MAX_DATETIME_LEN);
+    MemoNode *copy = create_memo_node(&user->arena, &updated);
+    if (!copy)
+        return false;
+    // 사용자 판과 ID 색인의 같은 자리에 끼움
+    if (!snapshot_replace(user, old_node, copy))
+    {
+        release_memo_node(copy);
+        return false;
     }
-    return false;
+    *slot = copy;
+    user->arena.live_bytes += copy->size;
+    user->arena.live_bytes -= old_node->size;
+    user->arena.dead_bytes += old_node->size;
+    epoch_retire(&old_node->retired, release_retired_node);
+    // 수정 전 노드가 쌓였으면 모아 옮김
+    compact_user(user);
+    memo_save_user(user_id); // 즉시 저장
+    return true;
 }
 
-// 사용자의 메모 목록 출력
-bool memo_list_for_user(const char *user_id, char *output, int output_size)
-{
-    // 출력 오프셋
-    int offset = 0;
-    // 검색 결과 표시
-    bool found = false;
-    // 사용자 ID 비교
-    offset += snprintf(output + offset, output_size - offset, "OK:[%s님의 메모 목록]\n", user_id);
-    // 메모 노드 탐색
-    MemoNode *current = g_memo_list_head;
-    // 메모 노드 탐색
-    while (current)
+// 사용자의 모든 메모마다 visitor 호출
+int memo_visit_user(const char *user_id, MemoVisitor visitor, void *ctx)
+{
+    int count = 0, total;
+    MemoSnapshot *snapshot = read_snapshot(user_id, &total);
+    // 사용자의 메모 판 탐색 (요청 기한이 지나면 중단)
+    for (int i = 0; i < total && !deadline_expired(); i++)
+    {
+        visitor(&snapshot->memos[i]->memo, ctx);
+        count++;
+    }
+    return count;
+}
+
+// 사용자의 메모 중 해당 월에 작성된 메모마다 visitor 호출
+int memo_visit_month(const char *user_id, int year, int month, MemoVisitor visitor, void *ctx)
+{
+    int count = 0, total;
+    MemoSnapshot *snapshot = read_snapshot(user_id, &total);
+    // 사용자의 메모 판 탐색 (요청 기한이 지나면 중단)
+    for (int i = 0; i < total && !deadline_expired(); i++)
+    {
+        const Memo *memo = &snapshot->memos[i]->memo;
+        // 메모 날짜 분리
+        int memo_year, memo_month;
+        if (sscanf(memo->created_at, "%d-%d", &memo_year, &memo_month) == 2)
+        {
+            // 년도와 월 비교
+            if (memo_year == year && memo_month == month)
+            {
+                visitor(memo, ctx);
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+// 사용자의 메모 중 검색어가 포함된 메모마다 visitor 호출
+int memo_visit_search(const char *user_id, const char *field, const char *keyword, size_t keyword_len,
+                      MemoVisitor visitor, void *ctx)
+{
+    // 키워드가 없으면 종료
+    if (keyword_len == 0)
+        return 0;
+    int count = 0, total;
+    MemoSnapshot *snapshot = read_snapshot(user_id, &total);
+    // 사용자의 메모 판 탐색 (메모마다 텍스트 전체를 훑으므로 메모 사이에서 요청 기한을 확인하고, 지났으면 중단)
+    for (int i = 0; i < total && !deadline_expired(); i++)
     {
-        // 사용자 ID 비교
-        if (strcmp(current->memo.user_id, user_id) == 0)
+        const Memo *memo = &snapshot->memos[i]->memo;
+        // 제목 또는 내용 검색
+        bool match = false;
+        // 제목 검색
+        if (strcmp(field, "title") == 0 || strcmp(field, "all") == 0)
+        {
+            match = contains_ignore_case(memo->title, memo->title_len, keyword, keyword_len);
+        }
+        // 내용 검색 (길이 제한이 없으므로 복사하지 않고 제자리에서 비교)
+        if (!match && (strcmp(field, "content") == 0 || strcmp(field, "all") == 0))
         {
-            offset += snprintf(output + offset, output_size - offset, "  - [%d] %s\n", current->memo.id, current->memo.title);
-            found = true;
+            match = contains_ignore_case(memo->content, memo->content_len, keyword, keyword_len);
+        }
+        // 검색 결과 표시
+        if (match)
+        {
+            visitor(memo, ctx);
+            count++;
         }
-        current = current->next;
     }
-    if (!found)
+    return count;
+}
+
+// 목록 한 줄 출력: "  - [id] 제목"
+static void print_title_line(const Memo *memo, void *ctx)
+{
+    reply_printf((ReplyBuffer *)ctx, "  - [%d] %s\n", memo->id, memo->title);
+}
+
+// 목록 한 줄 출력: "id\t생성일시\t수정일시\t제목"
+static void print_summary_line(const Memo *memo, void *ctx)
+{
+    reply_printf((ReplyBuffer *)ctx, "%d\t%s\t%s\t%s\n", memo->id, memo->created_at, memo->updated_at, memo->title);
+}
+
+// 사용자의 메모 목록 출력
+bool memo_list_for_user(const char *user_id, ReplyBuffer *output)
+{
+    // 목록 헤더 출력
+    reply_set(output, "OK:[%s님의 메모 목록]\n", user_id);
+    if (memo_visit_user(user_id, print_title_line, output) == 0)
     {
-        snprintf(output, output_size, "OK:작성된 메모가 없습니다.");
+        reply_set(output, "OK:작성된 메모가 없습니다.");
     }
     return true;
 }
 
 // 메모 조회
-bool memo_get_by_id(int memo_id, const char *user_id, char *output, int output_size)
+bool memo_get_by_id(int memo_id, const char *user_id, ReplyBuffer *output)
 {
     // 메모 노드 탐색
     MemoNode *node = find_memo_node(memo_id, user_id);
@@ -428,117 +1150,36 @@ bool memo_get_by_id(int memo_id, const char *user_id, char *output, int output_s
     if (node)
     {
         Memo *m = &node->memo;
-        snprintf(output, output_size, "OK:%d\t%s\t%s\t%s\t%s", m->id, m->created_at, m->updated_at, m->title, m->content);
+        reply_set(output, "OK:%d\t%s\t%s\t%s\t%s", m->id, m->created_at, m->updated_at, m->title, m->content);
         return true;
     }
     // 메모 노드 존재 실패 시
-    snprintf(output, output_size, "FAIL:메모 ID %d를 찾을 수 없습니다.", memo_id);
+    reply_set(output, "FAIL:메모 ID %d를 찾을 수 없습니다.", memo_id);
     return false;
 }
 
 // 월별 메모 목록 출력
-bool memo_list_by_month(const char *user_id, int year, int month, char *output, int output_size)
+bool memo_list_by_month(const char *user_id, int year, int month, ReplyBuffer *output)
 {
     // 출력 초기화
-    output[0] = '\0';
-    // 출력 오프셋
-    int offset = 0;
-    // 검색
-    bool found = false;
-    MemoNode *current = g_memo_list_head;
-    while (current)
-    {
-        // 사용자 ID 비교
-        if (strcmp(current->memo.user_id, user_id) == 0)
-        {
-            // 메모 날짜 분리
-            int memo_year, memo_month;
-            if (sscanf(current->memo.created_at, "%d-%d", &memo_year, &memo_month) == 2)
-            {
-                // 년도와 월 비교
-                if (memo_year == year && memo_month == month)
-                {
-                    // 메모 출력
-                    offset += snprintf(output + offset, output_size - offset, "%d\t%s\t%s\t%s\n", current->memo.id, current->memo.created_at, current->memo.updated_at, current->memo.title);
-                    found = true;
-                }
-            }
-        }
-        current = current->next;
-    }
-    if (!found)
+    reply_clear(output);
+    if (memo_visit_month(user_id, year, month, print_summary_line, output) == 0)
     {
         // 메모 없음
-        snprintf(output, output_size, "OK");
+        reply_set(output, "OK");
     }
     return true;
 }
 
 // 메모 검색
-bool memo_search(const char *user_id, const char *field, const char *keyword, char *output, int output_size)
+bool memo_search(const char *user_id, const char *field, const char *keyword, ReplyBuffer *output)
 {
     // 출력 초기화
-    output[0] = '\0';
-    int offset = 0;
-    // 검색 결과 표시
-    bool found = false;
-    // 키워드 소문자 변환
-    char lower_keyword[MAX_MEMO_CONTENT_LEN];
-    to_lowercase_utf8(keyword, lower_keyword, sizeof(lower_keyword));
-    // 키워드가 없으면 종료
-    if (strlen(lower_keyword) == 0)
+    reply_clear(output);
+    if (memo_visit_search(user_id, field, keyword, strlen(keyword), print_summary_line, output) == 0)
     {
         // 검색 결과 없음
-        snprintf(output, output_size, "OK");
-        return true;
-    }
-    // 메모 노드 탐색
-    MemoNode *current = g_memo_list_head;
-    while (current)
-    {
-        // 사용자 ID 비교
-        if (strcmp(current->memo.user_id, user_id) == 0)
-        {
-            // 제목 또는 내용 검색
-            bool match = false;
-            char lower_buffer[MAX_MEMO_CONTENT_LEN];
-            // 제목 검색
-            if (strcmp(field, "title") == 0 || strcmp(field, "all") == 0)
-            {
-                // 제목 소문자 변환
-                to_lowercase_utf8(current->memo.title, lower_buffer, sizeof(lower_buffer));
-                // 제목 검색
-                if (strstr(lower_buffer, lower_keyword))
-                {
-                    match = true;
-                }
-            }
-            // 내용 검색
-            if (!match && (strcmp(field, "content") == 0 || strcmp(field, "all") == 0))
-            {
-                // 내용 소문자 변환
-                to_lowercase_utf8(current->memo.content, lower_buffer, sizeof(lower_buffer));
-                // 내용 검색
-                if (strstr(lower_buffer, lower_keyword))
-                {
-                    match = true;
-                }
-            }
-            // 검색 결과 표시
-            if (match)
-            {
-                // 메모 출력
-                offset += snprintf(output + offset, output_size - offset, "%d\t%s\t%s\t%s\n", current->memo.id, current->memo.created_at, current->memo.updated_at, current->memo.title);
-                found = true;
-            }
-        }
-        current = current->next;
-    }
-    // 검색 결과 없음
-    if (!found)
-    {
-        // 검색 결과 없음
-        snprintf(output, output_size, "OK");
+        reply_set(output, "OK");
     }
     return true;
 }
@@ -557,22 +1198,19 @@ const Memo *memo_get_by_id_internal(int memo_id, const char *user_id)
     return NULL;
 }
 
-// 특정 사용자의 모든 메모를 배열 형태로 가져오는 함수
-int memo_get_all_for_user_internal(const char *user_id, Memo *memo_array, int max_count)
+// 응답을 보낼 때까지 메모를 붙잡아 둠 (visitor가 받은 메모에만 사용)
+bool memo_pin(const Memo *memo, ReplyBuffer *reply)
 {
-    // 메모 개수
-    int count = 0;
-    // 메모 노드 탐색
-    MemoNode *current = g_memo_list_head;
-    while (current != NULL && count < max_count)
+    // 복사해서 보내는 응답은 붙잡을 필요 없음
+    if (!reply->gather)
+        return true;
+    // memo는 노드의 첫 멤버
+    MemoNode *node = (MemoNode *)memo;
+    __atomic_add_fetch(&node->refs, 1, __ATOMIC_RELAXED);
+    if (!reply_hold(reply, node, release_memo_node))
     {
-        // 사용자 ID 비교
-        if (strcmp(current->memo.user_id, user_id) == 0)
-        {
-            // 메모 배열에 추가
-            memo_array[count++] = current->memo;
-        }
-        current = current->next;
+        release_memo_node(node);
+        return false;
     }
-    return count;
+    return true;
 }
@@ -4,47 +4,77 @@
 #define MEMO_H
 
 #include <stdbool.h>
+#include <stdint.h>
+#include "reply_buffer.h"
+#include "epoch.h"
 
-#define MAX_USER_ID_LEN 50        // 최대 사용자 ID 길이
-#define MAX_MEMO_TITLE_LEN 100    // 최대 메모 제목 길이
-#define MAX_MEMO_CONTENT_LEN 1024 // 최대 메모 내용 길이
-#define MAX_DATETIME_LEN 20       // 최대 날짜/시간 문자열 길이
+#define MAX_USER_ID_LEN 50     // 최대 사용자 ID 길이
+#define MAX_MEMO_TITLE_LEN 100 // 최대 메모 제목 길이 (내용은 길이 제한 없음, 요청 프레임 크기까지)
+#define MAX_DATETIME_LEN 20    // 최대 날짜/시간 문자열 길이
 
 // 메모 정보를 담는 구조체
+// 사용자 ID/제목/내용은 노드 뒤에 길이만큼 붙은 바이트(사용자 아레나, memo.c)를 가리키며, 각각 '\0'으로 끝난다.
 typedef struct
 {
-    int id;                             // 각 메모의 고유 ID (전체 메모에서 고유)
-    char user_id[MAX_USER_ID_LEN];      // 이 메모를 소유한 사용자 ID
-    char title[MAX_MEMO_TITLE_LEN];     // 메모 제목
-    char content[MAX_MEMO_CONTENT_LEN]; // 메모 내용
-    char created_at[MAX_DATETIME_LEN];  // 생성 날짜/시간
-    char updated_at[MAX_DATETIME_LEN];  // 수정 날짜/시간
+    int id;                            // 각 메모의 고유 ID (전체 메모에서 고유)
+    uint32_t user_id_len;              // 사용자 ID 길이 (바이트)
+    uint32_t title_len;                // 제목 길이 (바이트)
+    uint32_t content_len;              // 내용 길이 (바이트)
+    const char *user_id;               // 이 메모를 소유한 사용자 ID
+    const char *title;                 // 메모 제목
+    const char *content;               // 메모 내용
+    char created_at[MAX_DATETIME_LEN]; // 생성 날짜/시간
+    char updated_at[MAX_DATETIME_LEN]; // 수정 날짜/시간
+    int64_t created_ts;                // 생성 시각 (1970-01-01 기준 초, 바이너리 프로토콜용)
+    int64_t updated_ts;                // 수정 시각 (1970-01-01 기준 초, 바이너리 프로토콜용)
 } Memo;
 
-// 메모를 연결 리스트로 관리하기 위한 노드 구조체
+// 메모 하나를 담는 노드 구조체
+// 노드는 소유자의 아레나 청크(memo.c의 MemoChunk)에서 헤더와 텍스트를 한 번에 잘라 쓰며, 따로 malloc하지 않는다.
+// 메모는 사용자별 판(memo.c의 MemoSnapshot)에 노드 포인터로 들어가므로, 새 판을 만들어도 노드 주소는 바뀌지 않는다.
+// 노드는 만든 뒤 고치지 않는다. 수정하면 복사본을 만들어 바꿔 끼우고, 삭제하면 새 판에서 뺀다.
+// 저장소가 참조 하나를 갖고 (빠진 뒤에는 읽는 쪽이 모두 떠나면 놓음, epoch.h),
+// 메모 바이트를 복사하지 않고 가리키는 응답(memo_pin)이 전송을 마칠 때까지 하나씩 더 갖는다.
+// 참조가 모두 사라지면 노드가 든 청크의 참조를 놓고, 청크는 든 노드가 모두 해제되면 해제된다.
 typedef struct MemoNode
 {
-    Memo memo;             // 메모 정보
-    struct MemoNode *next; // 다음 메모 노드 포인터
+    Memo memo;               // 메모 정보 (첫 멤버여야 함, memo_pin 참고)
+    int refs;                // 참조 수 (원자적으로 접근)
+    uint32_t size;           // 청크에서 차지하는 바이트 수 (헤더 + 텍스트, 정렬 포함)
+    struct MemoChunk *chunk; // 노드가 든 아레나 청크
+    EpochRetired retired;    // 저장소에서 뺀 뒤의 해제 대기
 } MemoNode;
 
-void memo_init();    // 메모 초기화
-void memo_cleanup(); // 메모 정리
+void memo_init();                                                                                   // 메모 초기화
+void memo_cleanup();                                                                                // 메모 정리
 
-bool memo_list_for_user(const char *user_id, char *output, int output_size);                                  // 사용자별 메모 목록 출력
-bool memo_get_by_id(int memo_id, const char *user_id, char *output, int output_size);                         // 메모 조회
-bool memo_add(const char *user_id, const char *title, const char *content);                                   // 메모 추가
-bool memo_update(int memo_id, const char *user_id, const char *new_content);                                  // 메모 수정
-bool memo_delete(int memo_id, const char *user_id);                                                           // 메모 삭제
-bool memo_delete_by_user_id(const char *user_id);                                                             // 회원 탈퇴 시, 해당 사용자의 모든 메모 데이터를 삭제
-bool memo_list_by_month(const char *user_id, int year, int month, char *output, int output_size);             // 월별 메모 목록 출력
-bool memo_search(const char *user_id, const char *field, const char *keyword, char *output, int output_size); // 메모 검색
-void memo_save_all_to_files();                                                                                // 모든 메모를 파일에 저장
+bool memo_list_for_user(const char *user_id, ReplyBuffer *output);                                  // 사용자별 메모 목록 출력
+bool memo_get_by_id(int memo_id, const char *user_id, ReplyBuffer *output);                         // 메모 조회
+bool memo_add(const char *user_id, const char *title, const char *content);                         // 메모 추가
+bool memo_update(int memo_id, const char *user_id, const char *new_content);                        // 메모 수정
+bool memo_delete(int memo_id, const char *user_id);                                                 // 메모 삭제
+bool memo_delete_by_user_id(const char *user_id);                                                   // 회원 탈퇴 시, 해당 사용자의 모든 메모 데이터를 삭제
+bool memo_list_by_month(const char *user_id, int year, int month, ReplyBuffer *output);             // 월별 메모 목록 출력
+bool memo_search(const char *user_id, const char *field, const char *keyword, ReplyBuffer *output); // 메모 검색
+void memo_save_all_to_files();                                                                      // 모든 메모를 파일에 저장
+void memo_save_user(const char *user_id);                                                           // 사용자 한 명의 메모를 파일에 저장
 
-// ID로 메모리에서 직접 메모 구조체 포인터를 찾는 함수
+// 조건에 맞는 메모마다 호출되는 함수 (텍스트/바이너리 응답 생성에 공용으로 사용)
+typedef void (*MemoVisitor)(const Memo *memo, void *ctx);
+
+// 사용자의 메모 중 조건에 맞는 것마다 visitor 호출, 반환값은 호출 횟수
+// 저장소를 잠그지 않고 에포크 구간(epoch_enter) 안에서 호출해도 되며, 시작할 때의 판을 끝까지 돌므로 도중의 수정은 보이지 않는다.
+// 처리 중인 요청의 기한(deadline.h)이 지나면 남은 메모를 건너뛰고 멈춘다.
+int memo_visit_user(const char *user_id, MemoVisitor visitor, void *ctx);                                           // 전체
+int memo_visit_month(const char *user_id, int year, int month, MemoVisitor visitor, void *ctx);                     // 월별
+int memo_visit_search(const char *user_id, const char *field, const char *keyword, size_t keyword_len,
+                      MemoVisitor visitor, void *ctx); // 검색 (검색어는 null 문자로 끝나지 않아도 됨)
+
+// ID로 메모리에서 직접 메모 구조체 포인터를 찾는 함수 (메모 ID 색인을 쓰므로 파티션 잠금 안에서 호출)
 const Memo *memo_get_by_id_internal(int memo_id, const char *user_id);
 
-// 특정 사용자의 모든 메모를 배열 형태로 가져오는 함수
-int memo_get_all_for_user_internal(const char *user_id, Memo *memo_array, int max_count);
+// 응답을 보낼 때까지 메모를 붙잡아 둠 (visitor가 받은 메모의 바이트를 reply_append_ref로 가리킬 때)
+// 응답이 모아 보내기(gather)가 아니면 바이트가 복사되므로 아무것도 하지 않는다.
+bool memo_pin(const Memo *memo, ReplyBuffer *reply);
 
 #endif
@@ -2,8 +2,11 @@
 
 #include "memo_command.h"
 #include "memo.h"
+#include "platform.h"
 #include "export_util.h"
 #include "user.h"
+#include "session.h"
+#include "deadline.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -52,46 +55,55 @@ static char *trim_leading_garbage(char *str)
 }
 
 // 클라이언트로부터 받은 메모 관련 명령을 처리하고 응답 문자열을 생성
-void handle_memo_command(const char *request, char *reply, int reply_size)
+void handle_memo_command(const char *request, ReplyBuffer *reply)
 {
     // strdup를 사용하여 원본 요청 문자열을 복사
     char *request_copy = strdup(request);
     if (request_copy == NULL)
     {
-        snprintf(reply, reply_size, "FAIL:메모리 할당 오류");
+        reply_set(reply, "FAIL:메모리 할당 오류");
         return;
     }
-    // 명령어 파싱
-    char *command = strtok(request_copy, DELIMITER);
+    // 명령어 파싱 (여러 샤드에서 동시에 실행될 수 있으므로 재진입 가능한 분리 함수 사용)
+    char *save_ptr = NULL;
+    char *command = ps_strtok_r(request_copy, DELIMITER, &save_ptr);
     if (!command)
     {
-        snprintf(reply, reply_size, "FAIL:잘못된 요청입니다.");
+        reply_set(reply, "FAIL:잘못된 요청입니다.");
         free(request_copy);
         return;
     }
-    // 사용자 ID 파싱
-    char *user_id = strtok(NULL, DELIMITER);
+    // 사용자 ID 또는 세션 토큰 파싱
+    char *key = ps_strtok_r(NULL, DELIMITER, &save_ptr);
+    if (!key)
+    {
+        reply_set(reply, "FAIL:사용자 ID가 필요합니다.");
+        free(request_copy);
+        return;
+    }
+    // 세션 토큰이면 로그인한 사용자 ID로 변환 (슬롯 번호로 바로 찾음)
+    const char *user_id = session_resolve(key);
     if (!user_id)
     {
-        snprintf(reply, reply_size, "FAIL:사용자 ID가 필요합니다.");
+        reply_set(reply, "FAIL:세션이 만료되었습니다. 다시 로그인하세요.");
         free(request_copy);
         return;
     }
     // 메모 목록 조회
     if (strcmp(command, "MEMO_LIST") == 0)
     {
-        if (!memo_list_for_user(user_id, reply, reply_size))
+        if (!memo_list_for_user(user_id, reply))
         {
-            snprintf(reply, reply_size, "FAIL:메모 목록을 불러오는 데 실패했습니다.");
+            reply_set(reply, "FAIL:메모 목록을 불러오는 데 실패했습니다.");
         }
     }
     // 메모 목록 조회 (월별)
     else if (strcmp(command, "MEMO_LIST_BY_MONTH") == 0)
     {
         // 연도 파싱
-        char *year_str = strtok(NULL, DELIMITER);
+        char *year_str = ps_strtok_r(NULL, DELIMITER, &save_ptr);
         // 월 파싱
-        char *month_str = strtok(NULL, DELIMITER);
+        char *month_str = ps_strtok_r(NULL, DELIMITER, &save_ptr);
         // 연도와 월이 모두 있는 경우
         if (year_str && month_str)
         {
@@ -100,7 +112,7 @@ void handle_memo_command(const char *request, char *reply, int reply_size)
             // 월 변환
             int month = atoi(month_str);
             // 메모 목록 조회
-            if (!memo_list_by_month(user_id, year, month, reply, reply_size))
+            if (!memo_list_by_month(user_id, year, month, reply))
             {
                 // 실패 메시지는 함수 내에서 생성됨
             }
@@ -108,14 +120,14 @@ void handle_memo_command(const char *request, char *reply, int reply_size)
         // 연도와 월이 모두 없는 경우
         else
         {
-            snprintf(reply, reply_size, "FAIL:연도와 월 정보가 필요합니다.");
+            reply_set(reply, "FAIL:연도와 월 정보가 필요합니다.");
         }
     }
     // 메모 추가
     else if (strcmp(command, "MEMO_ADD") == 0)
     {
         // 제목 파싱
-        char *title = strtok(NULL, DELIMITER);
+        char *title = ps_strtok_r(NULL, DELIMITER, &save_ptr);
         // 제목이 있는 경우
         if (title)
         {
@@ -127,45 +139,44 @@ void handle_memo_command(const char *request, char *reply, int reply_size)
 
             if (content && *content && memo_add(user_id, title, content))
             {
-                memo_save_all_to_files(); // 변경사항 즉시 저장
-                snprintf(reply, reply_size, "OK:메모가 성공적으로 추가되었습니다.");
+                reply_set(reply, "OK:메모가 성공적으로 추가되었습니다.");
             }
             else
             {
-                snprintf(reply, reply_size, "FAIL:메모 추가에 실패했습니다. (내용 누락 등)");
+                reply_set(reply, "FAIL:메모 추가에 실패했습니다. (내용 누락 등)");
             }
         }
         else
         {
-            snprintf(reply, reply_size, "FAIL:메모 제목이 필요합니다.");
+            reply_set(reply, "FAIL:메모 제목이 필요합니다.");
         }
     }
     // 메모 상세 조회
     else if (strcmp(command, "MEMO_VIEW") == 0)
     {
         // 메모 ID 파싱
-        char *memo_id_str = strtok(NULL, DELIMITER);
+        char *memo_id_str = ps_strtok_r(NULL, DELIMITER, &save_ptr);
         // 메모 ID가 있는 경우
         if (memo_id_str)
         {
             // 메모 ID 변환
             int memo_id = atoi(memo_id_str);
             // 메모 상세 조회
-            if (!memo_get_by_id(memo_id, user_id, reply, reply_size))
+            if (!memo_get_by_id(memo_id, user_id, reply))
             {
                 // 실패 메시지는 함수에서 생성
             }
         }
         else
         {
-            snprintf(reply, reply_size, "FAIL:조회할 메모 ID가 필요합니다.");
+            reply_set(reply, "FAIL:조회할 메모 ID가 필요합니다.");
         }
     }
     // 메모 수정
     else if (strcmp(command, "MEMO_UPDATE") == 0)
     {
         // 메모 ID 파싱
-        char *memo_id_str = strtok(NULL, DELIMITER);
+        char *memo_id_str = ps_strtok_r(NULL, DELIMITER, &save_ptr);
         // 메모 ID가 있는 경우
         if (memo_id_str)
         {
@@ -178,24 +189,23 @@ void handle_memo_command(const char *request, char *reply, int reply_size)
 
             if (content && *content && memo_update(memo_id, user_id, content))
             {
-                memo_save_all_to_files(); // 변경사항 즉시 저장
-                snprintf(reply, reply_size, "OK:메모가 성공적으로 수정되었습니다.");
+                reply_set(reply, "OK:메모가 성공적으로 수정되었습니다.");
             }
             else
             {
-                snprintf(reply, reply_size, "FAIL:메모 수정에 실패했습니다. (내용 누락 등)");
+                reply_set(reply, "FAIL:메모 수정에 실패했습니다. (내용 누락 등)");
             }
         }
         else
         {
-            snprintf(reply, reply_size, "FAIL:수정할 메모 ID가 필요합니다.");
+            reply_set(reply, "FAIL:수정할 메모 ID가 필요합니다.");
         }
     }
     // 메모 삭제
     else if (strcmp(command, "MEMO_DELETE") == 0)
     {
         // 메모 ID 파싱
-        char *memo_id_str = strtok(NULL, DELIMITER);
+        char *memo_id_str = ps_strtok_r(NULL, DELIMITER, &save_ptr);
         // 메모 ID가 있는 경우
         if (memo_id_str)
         {
@@ -203,50 +213,49 @@ void handle_memo_command(const char *request, char *reply, int reply_size)
             int memo_id = atoi(memo_id_str);
             if (memo_delete(memo_id, user_id))
             {
-                memo_save_all_to_files();
-                snprintf(reply, reply_size, "OK:메모가 성공적으로 삭제되었습니다.");
+                reply_set(reply, "OK:메모가 성공적으로 삭제되었습니다.");
             }
             else
             {
-                snprintf(reply, reply_size, "FAIL:메모 삭제에 실패했습니다 (ID 불일치 등).");
+                reply_set(reply, "FAIL:메모 삭제에 실패했습니다 (ID 불일치 등).");
             }
         }
         else
         {
-            snprintf(reply, reply_size, "FAIL:삭제할 메모 ID가 필요합니다.");
+            reply_set(reply, "FAIL:삭제할 메모 ID가 필요합니다.");
         }
     }
     // 메모 검색
     else if (strcmp(command, "MEMO_SEARCH") == 0)
     {
         // 검색 필드 파싱
-        char *field = strtok(NULL, DELIMITER);
+        char *field = ps_strtok_r(NULL, DELIMITER, &save_ptr);
         // 검색 필드가 있는 경우
         if (field)
         {
             // 검색어 파싱
             char *keyword = field + strlen(field) + 1;
-            if (*keyword && !memo_search(user_id, field, keyword, reply, reply_size))
+            if (*keyword && !memo_search(user_id, field, keyword, reply))
             {
                 // 실패 메시지는 함수 내부에서 생성됨
             }
             else if (!*keyword)
             {
-                snprintf(reply, reply_size, "FAIL:검색어가 필요합니다.");
+                reply_set(reply, "FAIL:검색어가 필요합니다.");
             }
         }
         else
         {
-            snprintf(reply, reply_size, "FAIL:검색 필드가 필요합니다.");
+            reply_set(reply, "FAIL:검색 필드가 필요합니다.");
         }
     }
     // 메모 다운로드
     else if (strcmp(command, "DOWNLOAD_SINGLE") == 0)
     {
         // 메모 ID 파싱
-        char *memo_id_str = strtok(NULL, DELIMITER);
+        char *memo_id_str = ps_strtok_r(NULL, DELIMITER, &save_ptr);
         // 포맷 파싱
-        char *format = strtok(NULL, DELIMITER);
+        char *format = ps_strtok_r(NULL, DELIMITER, &save_ptr);
         // 메모 ID와 포맷이 모두 있는 경우
         if (memo_id_str && format)
         {
@@ -262,66 +271,58 @@ void handle_memo_command(const char *request, char *reply, int reply_size)
                 // 내보내기 성공 시
                 if (exported_string)
                 {
-                    snprintf(reply, reply_size, "OK:%s", exported_string);
+                    reply_set(reply, "OK:%s", exported_string);
                     free(exported_string);
                 }
                 else
                 {
-                    snprintf(reply, reply_size, "FAIL:지원하지 않는 포맷입니다.");
+                    reply_set(reply, "FAIL:지원하지 않는 포맷입니다.");
                 }
             }
             else
             {
-                snprintf(reply, reply_size, "FAIL:메모를 찾을 수 없습니다.");
+                reply_set(reply, "FAIL:메모를 찾을 수 없습니다.");
             }
         }
         else
         {
-            snprintf(reply, reply_size, "FAIL:메모 ID 또는 포맷이 누락되었습니다.");
+            reply_set(reply, "FAIL:메모 ID 또는 포맷이 누락되었습니다.");
         }
     }
     // 전체 메모 다운로드
     else if (strcmp(command, "DOWNLOAD_ALL") == 0)
     {
         // 포맷 파싱
-        char *format = strtok(NULL, DELIMITER);
+        char *format = ps_strtok_r(NULL, DELIMITER, &save_ptr);
         // 포맷이 있는 경우
         if (format)
         {
-            // 최대 1024개 메모 가정
-            Memo user_memos[1024];
-            // 메모 개수 조회
-            int memo_count = memo_get_all_for_user_internal(user_id, user_memos, 1024);
-            // 메모가 있는 경우
-            if (memo_count > 0)
+            // 메모를 응답에 바로 붙임
+            reply_set(reply, "OK:");
+            int memo_count = export_all_memos_to_reply(user_id, format, reply);
+            // 붙이는 동안 요청 기한이 지났으면 만들다 만 응답은 버림 (응답은 디스패처가 기한 초과로 바꿈)
+            if (deadline_expired())
             {
-                // 메모 내보내기
-                char *exported_string = export_all_memos_to_string(user_memos, memo_count, format);
-                // 내보내기 성공 시
-                if (exported_string)
-                {
-                    snprintf(reply, reply_size, "OK:%s", exported_string);
-                    free(exported_string);
-                }
-                else
-                {
-                    snprintf(reply, reply_size, "FAIL:지원하지 않는 포맷입니다.");
-                }
+                reply_clear(reply);
             }
-            else
+            else if (memo_count < 0)
+            {
+                reply_set(reply, "FAIL:지원하지 않는 포맷입니다.");
+            }
+            else if (memo_count == 0)
             {
-                snprintf(reply, reply_size, "FAIL:다운로드할 메모가 없습니다.");
+                reply_set(reply, "FAIL:다운로드할 메모가 없습니다.");
             }
         }
         else
         {
-            snprintf(reply, reply_size, "FAIL:포맷이 누락되었습니다.");
+            reply_set(reply, "FAIL:포맷이 누락되었습니다.");
         }
     }
     // 알 수 없는 명령어
     else
     {
-        snprintf(reply, reply_size, "FAIL:알 수 없는 MEMO 명령입니다: %s", command);
+        reply_set(reply, "FAIL:알 수 없는 MEMO 명령입니다: %s", command);
     }
     free(request_copy);
 }
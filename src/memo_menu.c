@@ -3,6 +3,8 @@
 #include "memo_menu.h"
 #include "common_input.h"
 #include "memo.h"
+#include "client_net.h"
+#include "bin_protocol.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -11,10 +13,11 @@
 #include <time.h>
 
 #define REQUEST_BUF_SIZE 2048      // 요청 버퍼 크기
-#define REPLY_BUF_SIZE 65536       // 응답 버퍼 크기
 #define ITEMS_PER_PAGE 10          // 페이지당 아이템 수
 #define CLIENT_MEMO_CACHE_SIZE 100 // 클라이언트 메모 캐시 크기
 #define MAX_MEMOS_PER_PAGE 10      // 페이지당 최대 메모 수
+#define PREFETCH_MONTHS 3          // 월별 목록을 한 번에 미리 가져올 개월 수 (현재 달 포함)
+#define CONTENT_INPUT_LEN 1024     // 메모 내용 입력 버퍼 크기 (서버는 내용 길이를 제한하지 않음)
 
 // 화면 모드 관리
 typedef enum
@@ -23,12 +26,31 @@ typedef enum
     MODE_SEARCH   // 검색 결과 보기 모드
 } ViewMode;
 
+// 목록 화면에 표시할 메모 정보 (서버의 Memo는 서버 아레나를 가리키므로 클라이언트는 필요한 필드만 복사해 둠)
+typedef struct
+{
+    int id;                            // 메모 ID
+    char title[MAX_MEMO_TITLE_LEN];    // 메모 제목
+    char created_at[MAX_DATETIME_LEN]; // 생성 날짜/시간
+    char updated_at[MAX_DATETIME_LEN]; // 수정 날짜/시간
+} MemoSummary;
+
 //  전역 변수 및 구조체
-static Memo g_memo_cache[CLIENT_MEMO_CACHE_SIZE];       // 서버에서 받아온 메모를 캐싱하는 배열
+static MemoSummary g_memo_cache[CLIENT_MEMO_CACHE_SIZE]; // 서버에서 받아온 메모를 캐싱하는 배열
 static int g_memo_count = 0;                            // 캐시된 메모의 수
 static ViewMode g_view_mode = MODE_MONTHLY;             // 현재 화면 모드
 static char g_search_keyword[MAX_MEMO_TITLE_LEN] = {0}; // 현재 검색어
 
+// 미리 받아 둔 월별 목록 응답
+typedef struct
+{
+    int year;          // 년도
+    int month;         // 월
+    bool valid;        // 아직 사용하지 않은 응답인지 여부
+    ReplyBuffer reply; // 서버 응답
+} MonthPrefetch;
+static MonthPrefetch g_month_prefetch[PREFETCH_MONTHS]; // 현재 달과 그 이전 달들의 응답
+
 // 함수 원형 선언
 static void display_ui(int year, int month, int page);                              // 화면 표시
 static void fetch_and_display_memos(SOCKET sock, const char *user_id, int page);    // 메모 데이터 가져오기 및 표시
@@ -67,22 +89,6 @@ static void trim_whitespace(char *str)
     *(end + 1) = '\0';
 }
 
-// 서버와 통신
-static bool communicate_with_server(SOCKET sock, const char *request, char *reply)
-{
-    // 요청 전송
-    if (send(sock, request, strlen(request), 0) < 0)
-        return false;
-    // 응답 수신
-    int bytes = recv(sock, reply, REPLY_BUF_SIZE - 1, 0);
-    // 응답 수신 실패 시
-    if (bytes <= 0)
-        return false;
-    // 응답 버퍼 끝에 null 문자 추가
-    reply[bytes] = '\0';
-    return true;
-}
-
 // 서버에서 받은 데이터를 파싱하여 g_memo_cache에 저장
 static void parse_and_cache_memos(char *data)
 {
@@ -108,7 +114,7 @@ static void parse_and_cache_memos(char *data)
         if (id_str && created_at_str && updated_at_str && title_str)
         {
             // 메모 데이터 저장
-            Memo *m = &g_memo_cache[g_memo_count];
+            MemoSummary *m = &g_memo_cache[g_memo_count];
             m->id = atoi(id_str);
             // 생성일시 복사
             strncpy(m->created_at, created_at_str, MAX_DATETIME_LEN - 1);
@@ -128,6 +134,56 @@ static void parse_and_cache_memos(char *data)
     }
 }
 
+// 바이너리 응답의 시각(1970-01-01 기준 초)을 "YYYY-MM-DD HH:MM:SS" 형식으로 변환
+static void format_timestamp(int64_t timestamp, char *buffer, size_t buffer_size)
+{
+    time_t t = (time_t)timestamp;
+    struct tm tm_info;
+    if (localtime_s(&tm_info, &t) != 0 || strftime(buffer, buffer_size, "%Y-%m-%d %H:%M:%S", &tm_info) == 0)
+    {
+        buffer[0] = '\0';
+    }
+}
+
+// 바이너리 목록 응답(메모 레코드 필드들)을 파싱하여 g_memo_cache에 저장
+// 텍스트 응답과 달리 줄바꿈/탭으로 자르지 않고 필드 길이만큼 바로 복사한다.
+static void parse_binary_memos(const ReplyBuffer *reply)
+{
+    // 데이터 초기화
+    g_memo_count = 0;
+    if (reply->len == 0 || (unsigned char)reply->data[0] != BIN_STATUS_OK)
+    {
+        return;
+    }
+
+    BinReader reader, record;
+    BinField field, item;
+    bin_reader_init(&reader, reply->data + 1, reply->len - 1);
+    // 메모 레코드마다 하위 필드 읽기
+    while (g_memo_count < CLIENT_MEMO_CACHE_SIZE && bin_next_field(&reader, &field))
+    {
+        if (field.tag != BIN_TAG_MEMO)
+            continue;
+
+        MemoSummary *m = &g_memo_cache[g_memo_count];
+        memset(m, 0, sizeof(*m));
+        bin_reader_init(&record, field.value, field.len);
+        while (bin_next_field(&record, &item))
+        {
+            if (item.tag == BIN_TAG_MEMO_ID)
+                m->id = (int)bin_field_u32(&item);
+            else if (item.tag == BIN_TAG_CREATED_AT)
+                format_timestamp(bin_field_i64(&item), m->created_at, sizeof(m->created_at));
+            else if (item.tag == BIN_TAG_UPDATED_AT)
+                format_timestamp(bin_field_i64(&item), m->updated_at, sizeof(m->updated_at));
+            else if (item.tag == BIN_TAG_TITLE)
+                bin_field_str(&item, m->title, sizeof(m->title));
+        }
+        // 메모 카운트 증가
+        g_memo_count++;
+    }
+}
+
 // UTF-8 문자의 시작 바이트만 인식하여 너비를 계산하는 안정적인 함수
 static void format_title_for_display(const char *original, char *buffer, int buffer_size, int visual_width)
 {
@@ -260,7 +316,7 @@ static void display_ui(int year, int month, int page)
             if (current_index < g_memo_count)
             {
                 // 메모 데이터 가져오기
-                Memo *m = &g_memo_cache[current_index];
+                MemoSummary *m = &g_memo_cache[current_index];
                 char formatted_title[100];
                 format_title_for_display(m->title, formatted_title, sizeof(formatted_title), 42);
                 printf(" %-4d | %s | %-19s |", m->id, formatted_title, m->created_at);
@@ -327,8 +383,8 @@ static void display_detail_template(const char *title, const char *created_at, c
 // 새 메모 추가 기능
 static void add_new_memo(SOCKET sock, const char *user_id)
 {
-    char title[MAX_MEMO_TITLE_LEN], content[MAX_MEMO_CONTENT_LEN];
-    char request[REQUEST_BUF_SIZE], reply[REPLY_BUF_SIZE];
+    char title[MAX_MEMO_TITLE_LEN], content[CONTENT_INPUT_LEN];
+    char request[REQUEST_BUF_SIZE], *reply;
 
     clear_screen();
     printf("──────────────────────────────────────────────────────────────────────────────────────────────────\n");
@@ -347,9 +403,9 @@ static void add_new_memo(SOCKET sock, const char *user_id)
     }
 
     // 요청 전송
-    snprintf(request, sizeof(request), "MEMO_ADD:%s:%s:%s", user_id, title, content);
+    snprintf(request, sizeof(request), "MEMO_ADD:%s:%s:%s", client_user_key(user_id), title, content);
     // 서버 응답 파싱
-    if (communicate_with_server(sock, request, reply) && strncmp(reply, "OK", 2) == 0)
+    if (communicate_with_server(sock, request, &reply) && strncmp(reply, "OK", 2) == 0)
     {
         printf("[클라이언트] %s\n", reply + 3);
     }
@@ -365,21 +421,28 @@ static void view_memo_details(SOCKET sock, const char *user_id)
 {
     // 메모 ID 버퍼 선언
     char memo_id_str[10];
-    char request[REQUEST_BUF_SIZE], reply[REPLY_BUF_SIZE];
+    char request[REQUEST_BUF_SIZE], *reply;
     // 메모 ID 입력받기
     if (get_secure_input(memo_id_str, sizeof(memo_id_str), "\n조회할 메모 ID", false, true))
     {
         // 요청 전송
-        snprintf(request, sizeof(request), "MEMO_VIEW:%s:%s", user_id, memo_id_str);
+        snprintf(request, sizeof(request), "MEMO_VIEW:%s:%s", client_user_key(user_id), memo_id_str);
         // 서버 응답 파싱
-        if (communicate_with_server(sock, request, reply) && strncmp(reply, "OK:", 3) == 0)
+        if (communicate_with_server(sock, request, &reply) && strncmp(reply, "OK:", 3) == 0)
         {
             // 서버 응답 형식: OK:id\tcreated_at\tupdated_at\ttitle\tcontent
-            char *p_reply = reply + 3;
-            // 메모 데이터 변수 선언
-            char created_at[MAX_DATETIME_LEN], updated_at[MAX_DATETIME_LEN], title[MAX_MEMO_TITLE_LEN], content[MAX_MEMO_CONTENT_LEN];
+            // 내용 길이에 제한이 없으므로 고정 버퍼에 복사하지 않고 응답을 제자리에서 나눔
+            char *inner_context = NULL;
+            strtok_s(reply + 3, "\t", &inner_context); // id
             // 메모 데이터 파싱
-            sscanf(p_reply, "%*[^\t]\t%[^\t]\t%[^\t]\t%[^\t]\t%[^\n]", created_at, updated_at, title, content);
+            char *created_at = strtok_s(NULL, "\t", &inner_context);
+            char *updated_at = strtok_s(NULL, "\t", &inner_context);
+            char *title = strtok_s(NULL, "\t", &inner_context);
+            char *content = strtok_s(NULL, "\n", &inner_context);
+            if (!created_at || !updated_at || !title)
+                created_at = updated_at = title = "";
+            if (!content)
+                content = "";
             // 메모 상세보기 템플릿 표시
             display_detail_template(title, created_at, updated_at, content);
             printf("D: 메모 다운로드 | Enter: 뒤로가기\n");
@@ -407,7 +470,7 @@ static void view_memo_details(SOCKET sock, const char *user_id)
 static void update_existing_memo(SOCKET sock, const char *user_id)
 {
     char request[REQUEST_BUF_SIZE];
-    char reply[REPLY_BUF_SIZE];
+    char *reply;
     char id_str[10];
 
     // 1. 수정할 메모 ID 입력 받기
@@ -426,8 +489,8 @@ static void update_existing_memo(SOCKET sock, const char *user_id)
     }
 
     // 2. 서버에 기존 메모 내용 요청 (MEMO_VIEW)
-    snprintf(request, sizeof(request), "MEMO_VIEW:%s:%d", user_id, memo_id);
-    if (!communicate_with_server(sock, request, reply) || strncmp(reply, "OK:", 3) != 0)
+    snprintf(request, sizeof(request), "MEMO_VIEW:%s:%d", client_user_key(user_id), memo_id);
+    if (!communicate_with_server(sock, request, &reply) || strncmp(reply, "OK:", 3) != 0)
     {
         printf("\n[오류] 메모를 불러오는 데 실패했습니다: %s\n", reply);
         Sleep(1000);
@@ -470,7 +533,7 @@ static void update_existing_memo(SOCKET sock, const char *user_id)
     printf("---------------------------------\n\n");
 
     // 5. 새로운 내용 입력 받기 (add_new_memo와 유사한 방식)
-    char new_content[MAX_MEMO_CONTENT_LEN];
+    char new_content[CONTENT_INPUT_LEN];
     if (!get_line_input(new_content, sizeof(new_content), "새로운 내용을 입력하세요"))
     {
         return; // ESC 입력 시 복귀
@@ -484,8 +547,8 @@ static void update_existing_memo(SOCKET sock, const char *user_id)
     }
 
     // 6. 서버에 수정 요청 (MEMO_UPDATE)
-    snprintf(request, sizeof(request), "MEMO_UPDATE:%s:%d:%s", user_id, memo_id, new_content);
-    if (communicate_with_server(sock, request, reply) && strncmp(reply, "OK", 2) == 0)
+    snprintf(request, sizeof(request), "MEMO_UPDATE:%s:%d:%s", client_user_key(user_id), memo_id, new_content);
+    if (communicate_with_server(sock, request, &reply) && strncmp(reply, "OK", 2) == 0)
     {
         printf("\n[성공] 메모가 수정되었습니다.\n");
     }
@@ -501,7 +564,7 @@ static void delete_existing_memo(SOCKET sock, const char *user_id)
 {
     // 메모 ID 버퍼 선언
     char memo_id_str[10];
-    char request[REQUEST_BUF_SIZE], reply[REPLY_BUF_SIZE];
+    char request[REQUEST_BUF_SIZE], *reply;
     int memo_id;
 
     if (!get_secure_input(memo_id_str, sizeof(memo_id_str), "삭제할 메모 ID", false, true))
@@ -509,9 +572,9 @@ static void delete_existing_memo(SOCKET sock, const char *user_id)
     // 메모 ID 변환
     memo_id = atoi(memo_id_str);
     // 요청 전송
-    snprintf(request, sizeof(request), "MEMO_DELETE:%s:%d", user_id, memo_id);
+    snprintf(request, sizeof(request), "MEMO_DELETE:%s:%d", client_user_key(user_id), memo_id);
     // 서버 응답 파싱
-    if (communicate_with_server(sock, request, reply) && strncmp(reply, "OK", 2) == 0)
+    if (communicate_with_server(sock, request, &reply) && strncmp(reply, "OK", 2) == 0)
     {
         // 서버 응답 표시
         printf("[클라이언트] %s\n", reply + 3);
@@ -574,11 +637,29 @@ static bool prompt_and_execute_search(SOCKET sock, const char *user_id)
     strncpy(g_search_keyword, keyword, sizeof(g_search_keyword) - 1);
     g_search_keyword[sizeof(g_search_keyword) - 1] = '\0';
 
+    // 바이너리 프로토콜을 협상한 연결이면 검색어를 이스케이프 없이 필드로 전송
+    if (client_binary_enabled())
+    {
+        static ReplyBuffer bin_request, bin_reply;
+        reply_clear(&bin_request);
+        bool built = bin_put_u8(&bin_request, BIN_OP_MEMO_SEARCH) &&
+                     client_put_user_field(&bin_request, user_id) &&
+                     bin_put_str_field(&bin_request, BIN_TAG_FIELD, field) &&
+                     bin_put_str_field(&bin_request, BIN_TAG_KEYWORD, keyword);
+        const char *request_list[1] = {bin_request.data};
+        if (!built || !client_send_burst(sock, request_list, &bin_request.len, 1) ||
+            !client_recv_reply(sock, &bin_reply))
+            return false;
+        parse_binary_memos(&bin_reply);
+        g_view_mode = MODE_SEARCH;
+        return true;
+    }
+
     // 요청 전송
-    char request[REQUEST_BUF_SIZE], reply[REPLY_BUF_SIZE];
-    snprintf(request, sizeof(request), "MEMO_SEARCH:%s:%s:%s", user_id, field, keyword);
+    char request[REQUEST_BUF_SIZE], *reply;
+    snprintf(request, sizeof(request), "MEMO_SEARCH:%s:%s:%s", client_user_key(user_id), field, keyword);
     // 서버 응답 파싱
-    if (communicate_with_server(sock, request, reply))
+    if (communicate_with_server(sock, request, &reply))
     {
         // 서버 응답 파싱
         parse_and_cache_memos(reply);
@@ -589,6 +670,96 @@ static bool prompt_and_execute_search(SOCKET sock, const char *user_id)
     return false;
 }
 
+// 미리 받아 둔 월별 목록 버리기 (메모가 추가/수정/삭제된 경우)
+static void invalidate_month_prefetch(void)
+{
+    for (int i = 0; i < PREFETCH_MONTHS; i++)
+    {
+        g_month_prefetch[i].valid = false;
+    }
+}
+
+// 월별 메모 목록을 가져와 g_memo_cache에 저장
+// 미리 받아 둔 응답이 없으면 현재 달과 그 이전 달들의 목록을 한 번에(파이프라인으로) 요청해 둔다.
+// 아래 방향키로 이전 달을 넘겨 볼 때 달마다 서버 왕복을 기다리지 않아도 된다.
+static bool fetch_month_memos(SOCKET sock, const char *user_id, int year, int month)
+{
+    // 바이너리 프로토콜을 협상한 연결이면 목록을 바이너리로 요청
+    bool binary = client_binary_enabled();
+
+    // 미리 받아 둔 응답이 있으면 사용 (한 번 사용한 응답은 버림)
+    for (int i = 0; i < PREFETCH_MONTHS; i++)
+    {
+        MonthPrefetch *slot = &g_month_prefetch[i];
+        if (slot->valid && slot->year == year && slot->month == month)
+        {
+            slot->valid = false;
+            if (binary)
+                parse_binary_memos(&slot->reply);
+            else
+                parse_and_cache_memos(slot->reply.data);
+            return true;
+        }
+    }
+
+    // 현재 달부터 이전 달 순서로 요청 생성
+    char requests[PREFETCH_MONTHS][REQUEST_BUF_SIZE];
+    static ReplyBuffer bin_requests[PREFETCH_MONTHS];
+    const char *request_list[PREFETCH_MONTHS];
+    size_t request_lens[PREFETCH_MONTHS];
+    invalidate_month_prefetch();
+    for (int i = 0; i < PREFETCH_MONTHS; i++)
+    {
+        if (binary)
+        {
+            ReplyBuffer *req = &bin_requests[i];
+            reply_clear(req);
+            if (!bin_put_u8(req, BIN_OP_MEMO_LIST_BY_MONTH) ||
+                !client_put_user_field(req, user_id) ||
+                !bin_put_u32_field(req, BIN_TAG_YEAR, (uint32_t)year) ||
+                !bin_put_u32_field(req, BIN_TAG_MONTH, (uint32_t)month))
+                return false;
+            request_list[i] = req->data;
+            request_lens[i] = req->len;
+        }
+        else
+        {
+            snprintf(requests[i], sizeof(requests[i]), "MEMO_LIST_BY_MONTH:%s:%d:%d", client_user_key(user_id), year, month);
+            request_list[i] = requests[i];
+            request_lens[i] = strlen(requests[i]);
+        }
+        g_month_prefetch[i].year = year;
+        g_month_prefetch[i].month = month;
+        // 이전 달로 이동
+        if (--month < 1)
+        {
+            month = 12;
+            year--;
+        }
+    }
+
+    // 요청을 한 번에 보낸 뒤 응답을 순서대로 수신
+    if (!client_send_burst(sock, request_list, request_lens, PREFETCH_MONTHS))
+        return false;
+    for (int i = 0; i < PREFETCH_MONTHS; i++)
+    {
+        if (!client_recv_reply(sock, &g_month_prefetch[i].reply))
+        {
+            invalidate_month_prefetch();
+            return false;
+        }
+        g_month_prefetch[i].valid = true;
+    }
+
+    // 현재 달 응답은 바로 사용
+    g_month_prefetch[0].valid = false;
+    if (binary)
+        parse_binary_memos(&g_month_prefetch[0].reply);
+    else
+        parse_and_cache_memos(g_month_prefetch[0].reply.data);
+    return true;
+}
+
 // 다운로드 과정을 처리하는 핵심 핸들러 함수
 static void handle_download_process(SOCKET sock, const char *user_id, int memo_id)
 {
@@ -676,19 +847,19 @@ static void handle_download_process(SOCKET sock, const char *user_id, int memo_i
     }
 
     // 5. 서버 요청
-    char request[REQUEST_BUF_SIZE], reply[REPLY_BUF_SIZE];
+    char request[REQUEST_BUF_SIZE], *reply;
     if (memo_id == -1) // 모든 메모 다운로드
     {
-        snprintf(request, sizeof(request), "DOWNLOAD_ALL:%s:%s", user_id, format_str);
+        snprintf(request, sizeof(request), "DOWNLOAD_ALL:%s:%s", client_user_key(user_id), format_str);
     }
     else // 개별 메모 다운로드
     {
-        snprintf(request, sizeof(request), "DOWNLOAD_SINGLE:%s:%d:%s", user_id, memo_id, format_str);
+        snprintf(request, sizeof(request), "DOWNLOAD_SINGLE:%s:%d:%s", client_user_key(user_id), memo_id, format_str);
     }
 
     printf("\n다운로드 중...\n");
     // 서버 요청
-    if (!communicate_with_server(sock, request, reply) || strncmp(reply, "OK:", 3) != 0)
+    if (!communicate_with_server(sock, request, &reply) || strncmp(reply, "OK:", 3) != 0)
     {
         printf("\n[오류] 다운로드에 실패했습니다: %s\n", reply);
         Sleep(1500);
@@ -717,8 +888,6 @@ static void handle_download_process(SOCKET sock, const char *user_id, int memo_i
 
 void memo_menu_loop(SOCKET sock, const char *logged_in_id)
 {
-    // 요청 버퍼 선언
-    char request[REQUEST_BUF_SIZE], reply[REPLY_BUF_SIZE];
     // 현재 시간 가져오기
     time_t t;
     struct tm tm_now;
@@ -741,11 +910,8 @@ void memo_menu_loop(SOCKET sock, const char *logged_in_id)
             // 월별 모드일 때만 서버에서 월별 데이터를 가져옴 (검색 모드에서는 사용하지 않음)
             if (g_view_mode == MODE_MONTHLY)
             {
-                snprintf(request, sizeof(request), "MEMO_LIST_BY_MONTH:%s:%d:%d", logged_in_id, current_year, current_month);
-                if (communicate_with_server(sock, request, reply))
+                if (fetch_month_memos(sock, logged_in_id, current_year, current_month))
                 {
-                    // 서버 응답 파싱
-                    parse_and_cache_memos(reply);
                     current_page = 0;
                 }
             }
@@ -842,18 +1008,22 @@ void memo_menu_loop(SOCKET sock, const char *logged_in_id)
                 break;
             case '\r': // Enter
                 view_memo_details(sock, logged_in_id);
+                invalidate_month_prefetch();
                 needs_update = true; // 상세보기 후, 화면을 새로고침
                 break;
             case '1':
                 add_new_memo(sock, logged_in_id);
+                invalidate_month_prefetch();
                 needs_update = true; // 새 메모 추가 후, 화면을 새로고침
                 break;
             case '2':
                 update_existing_memo(sock, logged_in_id);
+                invalidate_month_prefetch();
                 needs_update = true; // 기존 메모 수정 후, 화면을 새로고침
                 break;
             case '3':
                 delete_existing_memo(sock, logged_in_id);
+                invalidate_month_prefetch();
                 needs_update = true; // 기존 메모 삭제 후, 화면을 새로고침
                 break;
             case '4': // 월별 모드에서만 '검색'으로 동작
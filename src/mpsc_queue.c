@@ -0,0 +1,54 @@
+// src/mpsc_queue.c
+
+#include "mpsc_queue.h"
+#include <stddef.h>
+
+// 빈 큐로 초기화 (head와 tail 모두 더미 노드)
+void mpsc_init(MpscQueue *queue)
+{
+    queue->stub.next = NULL;
+    queue->head = &queue->stub;
+    queue->tail = &queue->stub;
+}
+
+// 노드 추가
+void mpsc_push(MpscQueue *queue, MpscNode *node)
+{
+    __atomic_store_n(&node->next, NULL, __ATOMIC_RELAXED);
+    // 마지막 노드를 새 노드로 바꾼 뒤, 이전 마지막 노드에 이어 붙임
+    MpscNode *prev = __atomic_exchange_n(&queue->head, node, __ATOMIC_ACQ_REL);
+    __atomic_store_n(&prev->next, node, __ATOMIC_RELEASE);
+}
+
+// 가장 먼저 넣은 노드 꺼내기
+MpscNode *mpsc_pop(MpscQueue *queue)
+{
+    MpscNode *tail = queue->tail;
+    MpscNode *next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+    // 더미 노드는 건너뜀
+    if (tail == &queue->stub)
+    {
+        if (!next)
+            return NULL;
+        queue->tail = next;
+        tail = next;
+        next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+    }
+    if (next)
+    {
+        queue->tail = next;
+        return tail;
+    }
+    // tail이 마지막 노드가 아니면 생산자가 이어 붙이는 중
+    if (tail != __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE))
+        return NULL;
+    // 마지막 노드를 꺼내기 위해 더미 노드를 뒤에 다시 넣음
+    mpsc_push(queue, &queue->stub);
+    next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+    if (next)
+    {
+        queue->tail = next;
+        return tail;
+    }
+    return NULL;
+}
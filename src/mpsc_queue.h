@@ -0,0 +1,38 @@
+// src/mpsc_queue.h
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <stdbool.h>
+
+// 잠금 없는 다중 생산자/단일 소비자 큐 (침입형)
+// 여러 스레드가 동시에 넣을 수 있고, 꺼내는 것은 큐를 소유한 스레드 하나만 한다.
+// 넣는 쪽은 원자적 교환 한 번으로 끝나므로 생산자끼리 서로 기다리지 않는다.
+// 항목 구조체에 MpscNode를 멤버로 두고, 꺼낸 노드에서 원래 구조체 주소를 계산하여 사용한다.
+
+// 큐에 연결되는 노드
+typedef struct MpscNode
+{
+    struct MpscNode *next; // 다음 노드 (원자적으로 접근)
+} MpscNode;
+
+// 큐
+typedef struct
+{
+    MpscNode *head; // 마지막으로 넣은 노드 (생산자들이 원자적으로 교환)
+    MpscNode *tail; // 다음에 꺼낼 노드 (소비자 전용)
+    MpscNode stub;  // 빈 큐를 표현하는 더미 노드
+} MpscQueue;
+
+// 빈 큐로 초기화
+void mpsc_init(MpscQueue *queue);
+
+// 노드 추가 (여러 스레드에서 동시에 호출 가능)
+void mpsc_push(MpscQueue *queue, MpscNode *node);
+
+// 가장 먼저 넣은 노드 꺼내기 (소유 스레드만 호출)
+// 비어 있거나, 생산자가 넣는 도중이라 아직 이어지지 않았으면 NULL
+// (생산자는 넣은 뒤에 소비자를 깨우므로 그 노드는 다음 깨어날 때 꺼내진다)
+MpscNode *mpsc_pop(MpscQueue *queue);
+
+#endif
@@ -0,0 +1,202 @@
+// src/output_pool.c
+
+#include "output_pool.h"
+#include "platform.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 설정 (시작 시 정한 뒤에는 읽기만 함)
+static size_t g_cap_chunks = 0;  // 빌려 줄 수 있는 청크 수 (0이면 제한 없음)
+static size_t g_high_water = 0;  // 연결 하나의 대기열 기준 (0이면 보낼 응답이 남아 있는 동안 읽지 않음)
+
+// 풀 상태
+static ps_mutex_t g_pool_lock = PS_MUTEX_INITIALIZER; // g_free_head, g_free_count 보호
+static OutputChunk *g_free_head = NULL;               // 빈 청크 목록
+static size_t g_free_count = 0;                       // 빈 청크 수
+static size_t g_used_chunks = 0;                      // 빌려 준 청크 수 (원자적으로 접근)
+static size_t g_peak_chunks = 0;                      // 빌려 준 청크 수의 최댓값 (원자적으로 접근)
+static unsigned long long g_overflows = 0;            // 상한에 걸린 횟수 (원자적으로 접근)
+
+// 풀 설정
+void output_pool_configure(size_t cap_bytes, size_t high_water)
+{
+    g_cap_chunks = (cap_bytes + OUTPUT_CHUNK_SIZE - 1) / OUTPUT_CHUNK_SIZE;
+    g_high_water = high_water;
+}
+
+// 풀에서 청크 하나를 빌림 (상한에 걸리거나 메모리가 부족하면 NULL)
+static OutputChunk *chunk_get(void)
+{
+    // 상한 확인과 예약을 한 번에 (여러 샤드가 동시에 빌림)
+    size_t used = __atomic_add_fetch(&g_used_chunks, 1, __ATOMIC_RELAXED);
+    if (g_cap_chunks > 0 && used > g_cap_chunks)
+    {
+        __atomic_sub_fetch(&g_used_chunks, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&g_overflows, 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    size_t peak = __atomic_load_n(&g_peak_chunks, __ATOMIC_RELAXED);
+    while (used > peak && !__atomic_compare_exchange_n(&g_peak_chunks, &peak, used, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+
+    ps_mutex_lock(&g_pool_lock);
+    OutputChunk *chunk = g_free_head;
+    if (chunk)
+    {
+        g_free_head = chunk->next;
+        g_free_count--;
+    }
+    ps_mutex_unlock(&g_pool_lock);
+    if (!chunk)
+    {
+        chunk = (OutputChunk *)malloc(sizeof(OutputChunk));
+        if (!chunk)
+        {
+            __atomic_sub_fetch(&g_used_chunks, 1, __ATOMIC_RELAXED);
+            return NULL;
+        }
+    }
+    chunk->next = NULL;
+    chunk->len = 0;
+    return chunk;
+}
+
+// 청크를 풀에 돌려줌 (빈 청크가 충분히 남아 있으면 해제)
+static void chunk_put(OutputChunk *chunk)
+{
+    __atomic_sub_fetch(&g_used_chunks, 1, __ATOMIC_RELAXED);
+    ps_mutex_lock(&g_pool_lock);
+    if (g_free_count < OUTPUT_POOL_KEEP)
+    {
+        chunk->next = g_free_head;
+        g_free_head = chunk;
+        g_free_count++;
+        chunk = NULL;
+    }
+    ps_mutex_unlock(&g_pool_lock);
+    free(chunk);
+}
+
+// 빈 대기열로 초기화
+void output_queue_init(OutputQueue *queue)
+{
+    queue->head = NULL;
+    queue->tail = NULL;
+    queue->head_off = 0;
+    queue->bytes = 0;
+}
+
+// 남은 청크를 모두 풀에 돌려줌
+void output_queue_free(OutputQueue *queue)
+{
+    OutputChunk *chunk = queue->head;
+    while (chunk)
+    {
+        OutputChunk *next = chunk->next;
+        chunk_put(chunk);
+        chunk = next;
+    }
+    output_queue_init(queue);
+}
+
+// 조각들 중 앞의 skip 바이트를 제외한 나머지를 대기열 끝에 복사
+bool output_queue_append(OutputQueue *queue, const struct iovec *iov, int iov_count, size_t skip)
+{
+    for (int i = 0; i < iov_count; i++)
+    {
+        const char *src = (const char *)iov[i].iov_base;
+        size_t len = iov[i].iov_len;
+        if (skip >= len)
+        {
+            skip -= len;
+            continue;
+        }
+        src += skip;
+        len -= skip;
+        skip = 0;
+        while (len > 0)
+        {
+            // 마지막 청크가 가득 찼으면 새 청크를 빌려 뒤에 붙임
+            if (!queue->tail || queue->tail->len == OUTPUT_CHUNK_SIZE)
+            {
+                OutputChunk *chunk = chunk_get();
+                if (!chunk)
+                    return false;
+                if (queue->tail)
+                    queue->tail->next = chunk;
+                else
+                    queue->head = chunk;
+                queue->tail = chunk;
+            }
+            size_t room = OUTPUT_CHUNK_SIZE - queue->tail->len;
+            size_t n = len < room ? len : room;
+            memcpy(queue->tail->data + queue->tail->len, src, n);
+            queue->tail->len += n;
+            queue->bytes += n;
+            src += n;
+            len -= n;
+        }
+    }
+    return true;
+}
+
+// 보낼 바이트들을 iovec 배열에 채움
+int output_queue_peek(const OutputQueue *queue, struct iovec *iov, int max)
+{
+    int count = 0;
+    size_t off = queue->head_off;
+    for (OutputChunk *chunk = queue->head; chunk && count < max; chunk = chunk->next)
+    {
+        iov[count].iov_base = chunk->data + off;
+        iov[count].iov_len = chunk->len - off;
+        count++;
+        off = 0;
+    }
+    return count;
+}
+
+// 앞에서부터 bytes 바이트를 보낸 것으로 처리
+void output_queue_consume(OutputQueue *queue, size_t bytes)
+{
+    queue->bytes -= bytes;
+    while (bytes > 0)
+    {
+        OutputChunk *chunk = queue->head;
+        size_t left = chunk->len - queue->head_off;
+        if (bytes < left)
+        {
+            queue->head_off += bytes;
+            return;
+        }
+        bytes -= left;
+        queue->head = chunk->next;
+        queue->head_off = 0;
+        if (!queue->head)
+            queue->tail = NULL;
+        chunk_put(chunk);
+    }
+}
+
+// 연결이 새 요청 읽기를 멈춰야 하는지 여부
+bool output_pool_should_pause(const OutputQueue *queue)
+{
+    if (queue->bytes == 0)
+        return false;
+    if (queue->bytes >= g_high_water)
+        return true;
+    // 풀이 거의 찼으면 응답이 밀린 연결부터 멈춰 상한에 닿기 전에 늘어나는 속도를 줄임
+    return g_cap_chunks > 0 && __atomic_load_n(&g_used_chunks, __ATOMIC_RELAXED) >= g_cap_chunks / 4 * 3;
+}
+
+// 빌려 준 청크 크기 합의 최댓값
+size_t output_pool_peak(void)
+{
+    return __atomic_load_n(&g_peak_chunks, __ATOMIC_RELAXED) * OUTPUT_CHUNK_SIZE;
+}
+
+// 상한에 걸려 닫은 연결 수
+unsigned long long output_pool_overflows(void)
+{
+    return __atomic_load_n(&g_overflows, __ATOMIC_RELAXED);
+}
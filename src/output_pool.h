@@ -0,0 +1,67 @@
+// src/output_pool.h
+
+#ifndef OUTPUT_POOL_H
+#define OUTPUT_POOL_H
+
+// Linux 전용: 연결별 송신 대기열과 모든 연결이 함께 쓰는 청크 풀
+//
+// 클라이언트가 응답을 천천히 읽으면 소켓 송신 버퍼가 차서 보내지 못한 응답이 남는다.
+// 이벤트 루프는 기다리지 않고(논블로킹) 남은 바이트를 연결의 송신 대기열에 넣어 두었다가 소켓이 쓰기 가능해지면 보낸다.
+//  - 대기열은 고정 크기 청크의 연결 리스트라서, 큰 응답이 밀려도 한 덩어리로 재할당/복사하지 않는다.
+//  - 청크는 서버 전체가 공유하는 풀에서 빌려 오고, 다 보내면 돌려준다. (풀에는 OUTPUT_POOL_KEEP개까지만 남겨 둠)
+//  - 풀 전체가 빌려 준 청크 크기의 합은 상한(--output-cap)을 넘지 않는다. 넘게 빌리려는 연결은 너무 느린 것으로 보고 닫는다.
+// 대기열이 연결별 기준(--output-high-water)을 넘거나, 풀이 상한의 3/4 이상 찼는데 대기열에 보낼 응답이 남아 있으면
+// 이벤트 루프는 그 연결의 새 요청을 읽지 않는다. (output_pool_should_pause)
+// 대기열 하나는 그 연결을 맡은 샤드 스레드만 사용하며, 풀은 잠금으로 보호한다.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/uio.h>
+
+#define OUTPUT_CHUNK_SIZE 16384 // 청크 하나의 데이터 크기
+#define OUTPUT_POOL_KEEP 256    // 풀에 남겨 두는 빈 청크 최대 수 (나머지는 해제해 메모리를 돌려줌)
+
+// 송신 대기열 청크
+typedef struct OutputChunk
+{
+    struct OutputChunk *next; // 다음 청크
+    size_t len;               // 채운 바이트 수
+    char data[OUTPUT_CHUNK_SIZE];
+} OutputChunk;
+
+// 연결 하나의 송신 대기열 (보낼 순서대로)
+typedef struct
+{
+    OutputChunk *head; // 가장 먼저 보낼 청크 (비었으면 NULL)
+    OutputChunk *tail; // 마지막 청크
+    size_t head_off;   // 첫 청크에서 이미 보낸 바이트 수
+    size_t bytes;      // 아직 보내지 않은 바이트 수
+} OutputQueue;
+
+// 풀 설정 (서버 시작 시 한 번)
+// - cap_bytes: 모든 연결이 빌릴 수 있는 청크 크기의 합 (0이면 제한 없음)
+// - high_water: 연결 하나의 대기열이 이만큼 쌓이면 그 연결의 요청을 더 읽지 않음
+void output_pool_configure(size_t cap_bytes, size_t high_water);
+
+void output_queue_init(OutputQueue *queue); // 빈 대기열로 초기화
+void output_queue_free(OutputQueue *queue); // 남은 청크를 모두 풀에 돌려줌
+
+// 조각들 중 앞의 skip 바이트를 제외한 나머지를 대기열 끝에 복사
+// 반환값: 풀의 상한에 걸렸거나 메모리가 부족하면 false (일부만 들어갔을 수 있으므로 호출자는 연결을 닫음)
+bool output_queue_append(OutputQueue *queue, const struct iovec *iov, int iov_count, size_t skip);
+
+// 보낼 바이트들을 iovec 배열에 채움 (최대 max개, 청크마다 하나)
+// 반환값: 채운 개수
+int output_queue_peek(const OutputQueue *queue, struct iovec *iov, int max);
+
+// 앞에서부터 bytes 바이트를 보낸 것으로 처리 (다 보낸 청크는 풀에 돌려줌)
+void output_queue_consume(OutputQueue *queue, size_t bytes);
+
+// 연결이 새 요청 읽기를 멈춰야 하는지 여부 (대기열이 기준 이상이거나 풀이 거의 찼음)
+bool output_pool_should_pause(const OutputQueue *queue);
+
+// 통계 (서버 종료 시 로그용)
+size_t output_pool_peak(void);                 // 빌려 준 청크 크기 합의 최댓값
+unsigned long long output_pool_overflows(void); // 상한에 걸려 닫은 연결 수
+
+#endif
@@ -0,0 +1,239 @@
+// src/platform.h
+
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+// Windows(MinGW) 빌드와 Linux 빌드의 차이를 흡수하는 헤더
+// 서버 쪽 공용 모듈(memo.c, export_util.c 등)이 두 환경에서 모두 컴파일되도록 한다.
+
+#include <stdbool.h>
+
+#ifdef _WIN32
+
+#include <winsock2.h> // windows.h보다 먼저 포함해야 함
+#include <windows.h>
+#include <direct.h> // _mkdir
+
+// 스레드/동기화 타입
+typedef HANDLE ps_thread_t;                    // 스레드 핸들
+typedef SRWLOCK ps_mutex_t;                    // 뮤텍스
+typedef SRWLOCK ps_rwlock_t;                   // 읽기/쓰기 잠금
+typedef CONDITION_VARIABLE ps_cond_t;          // 조건 변수
+typedef DWORD(WINAPI *ps_thread_fn)(LPVOID);   // 스레드 함수 타입
+#define PS_THREAD_FUNC(name) DWORD WINAPI name(LPVOID arg)
+#define PS_THREAD_RETURN return 0
+#define PS_MUTEX_INITIALIZER SRWLOCK_INIT
+
+// 스레드 생성
+static inline bool ps_thread_create(ps_thread_t *thread, ps_thread_fn fn, void *arg)
+{
+    *thread = CreateThread(NULL, 0, fn, arg, 0, NULL);
+    return *thread != NULL;
+}
+
+// 스레드 종료 대기
+static inline void ps_thread_join(ps_thread_t thread)
+{
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+
+static inline void ps_mutex_init(ps_mutex_t *m) { InitializeSRWLock(m); }
+static inline void ps_mutex_destroy(ps_mutex_t *m) { (void)m; }
+static inline void ps_mutex_lock(ps_mutex_t *m) { AcquireSRWLockExclusive(m); }
+static inline void ps_mutex_unlock(ps_mutex_t *m) { ReleaseSRWLockExclusive(m); }
+static inline bool ps_mutex_trylock(ps_mutex_t *m) { return TryAcquireSRWLockExclusive(m) != 0; }
+static inline void ps_rwlock_init(ps_rwlock_t *l) { InitializeSRWLock(l); }
+static inline void ps_rwlock_read_lock(ps_rwlock_t *l) { AcquireSRWLockShared(l); }
+static inline void ps_rwlock_read_unlock(ps_rwlock_t *l) { ReleaseSRWLockShared(l); }
+static inline void ps_rwlock_write_lock(ps_rwlock_t *l) { AcquireSRWLockExclusive(l); }
+static inline void ps_rwlock_write_unlock(ps_rwlock_t *l) { ReleaseSRWLockExclusive(l); }
+static inline void ps_cond_init(ps_cond_t *c) { InitializeConditionVariable(c); }
+static inline void ps_cond_destroy(ps_cond_t *c) { (void)c; }
+static inline void ps_cond_wait(ps_cond_t *c, ps_mutex_t *m) { SleepConditionVariableSRW(c, m, INFINITE, 0); }
+static inline void ps_cond_signal(ps_cond_t *c) { WakeConditionVariable(c); }
+static inline void ps_cond_broadcast(ps_cond_t *c) { WakeAllConditionVariable(c); }
+
+// 재진입 가능한 문자열 분리/시각 변환 (여러 스레드에서 동시에 호출 가능)
+#define ps_strtok_r(str, delim, saveptr) strtok_s((str), (delim), (saveptr))
+#define ps_localtime(timer, result) localtime_s((result), (timer))
+
+// 사용 가능한 CPU 코어 수
+static inline int ps_cpu_count(void)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+}
+
+// 단조 시계 (밀리초, 시스템 시각 변경의 영향을 받지 않음)
+static inline unsigned long long ps_now_ms(void)
+{
+    return GetTickCount64();
+}
+
+// 단조 시계 (마이크로초, 대기 시간 측정용)
+static inline unsigned long long ps_now_us(void)
+{
+    static LARGE_INTEGER frequency; // 한 번만 조회 (여러 스레드가 같은 값을 써도 무방)
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0)
+        QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (unsigned long long)(counter.QuadPart / frequency.QuadPart) * 1000000ULL +
+           (unsigned long long)(counter.QuadPart % frequency.QuadPart) * 1000000ULL / (unsigned long long)frequency.QuadPart;
+}
+
+// 현재 스레드가 사용한 CPU 시간 (마이크로초, 사용자 + 커널)
+static inline unsigned long long ps_thread_cpu_us(void)
+{
+    FILETIME created, exited, kernel, user; // 100ns 단위
+    if (!GetThreadTimes(GetCurrentThread(), &created, &exited, &kernel, &user))
+        return 0;
+    unsigned long long k = ((unsigned long long)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime;
+    unsigned long long u = ((unsigned long long)user.dwHighDateTime << 32) | user.dwLowDateTime;
+    return (k + u) / 10ULL;
+}
+
+// 현재 시각 (1970-01-01 UTC 기준 밀리초, 로그 시각 표시용)
+static inline unsigned long long ps_wall_ms(void)
+{
+    FILETIME ft;
+    GetSystemTimeAsFileTime(&ft); // 1601-01-01 기준 100ns 단위
+    unsigned long long t = ((unsigned long long)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+    return t / 10000ULL - 11644473600000ULL;
+}
+
+// 밀리초 동안 잠듦
+static inline void ps_sleep_ms(unsigned ms)
+{
+    Sleep(ms);
+}
+
+#else
+
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef MAX_PATH
+#define MAX_PATH 260 // Windows와 동일한 경로 길이 제한
+#endif
+
+// MSVC/MinGW 전용 함수 대체
+#define _mkdir(path) mkdir((path), 0755)
+#define strcpy_s(dest, size, src) snprintf((dest), (size), "%s", (src))
+
+// Windows 소켓 타입/함수를 POSIX 소켓으로 대체
+typedef int SOCKET;
+#define INVALID_SOCKET (-1)
+#define closesocket close
+
+// 스레드/동기화 타입
+typedef pthread_t ps_thread_t;          // 스레드 핸들
+typedef pthread_mutex_t ps_mutex_t;     // 뮤텍스
+typedef pthread_rwlock_t ps_rwlock_t;   // 읽기/쓰기 잠금
+typedef pthread_cond_t ps_cond_t;       // 조건 변수
+typedef void *(*ps_thread_fn)(void *);  // 스레드 함수 타입
+#define PS_THREAD_FUNC(name) void *name(void *arg)
+#define PS_THREAD_RETURN return NULL
+#define PS_MUTEX_INITIALIZER PTHREAD_MUTEX_INITIALIZER
+
+// 스레드 생성
+static inline bool ps_thread_create(ps_thread_t *thread, ps_thread_fn fn, void *arg)
+{
+    return pthread_create(thread, NULL, fn, arg) == 0;
+}
+
+// 스레드 종료 대기
+static inline void ps_thread_join(ps_thread_t thread)
+{
+    pthread_join(thread, NULL);
+}
+
+static inline void ps_mutex_init(ps_mutex_t *m) { pthread_mutex_init(m, NULL); }
+static inline void ps_mutex_destroy(ps_mutex_t *m) { pthread_mutex_destroy(m); }
+static inline void ps_mutex_lock(ps_mutex_t *m) { pthread_mutex_lock(m); }
+static inline void ps_mutex_unlock(ps_mutex_t *m) { pthread_mutex_unlock(m); }
+static inline bool ps_mutex_trylock(ps_mutex_t *m) { return pthread_mutex_trylock(m) == 0; }
+
+// 읽기/쓰기 잠금 초기화
+// glibc의 기본 잠금은 읽기 우선이라 읽기가 끊이지 않으면 쓰기가 계속 밀리므로, 쓰기 대기 중에는 새 읽기를 막도록 설정
+// (pthread_rwlockattr_setkind_np는 _GNU_SOURCE를 정의한 파일에서만 보임)
+static inline void ps_rwlock_init(ps_rwlock_t *l)
+{
+    pthread_rwlockattr_t attr;
+    pthread_rwlockattr_init(&attr);
+#if defined(__GLIBC__) && defined(__USE_GNU)
+    pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+#endif
+    pthread_rwlock_init(l, &attr);
+    pthread_rwlockattr_destroy(&attr);
+}
+static inline void ps_rwlock_read_lock(ps_rwlock_t *l) { pthread_rwlock_rdlock(l); }
+static inline void ps_rwlock_read_unlock(ps_rwlock_t *l) { pthread_rwlock_unlock(l); }
+static inline void ps_rwlock_write_lock(ps_rwlock_t *l) { pthread_rwlock_wrlock(l); }
+static inline void ps_rwlock_write_unlock(ps_rwlock_t *l) { pthread_rwlock_unlock(l); }
+static inline void ps_cond_init(ps_cond_t *c) { pthread_cond_init(c, NULL); }
+static inline void ps_cond_destroy(ps_cond_t *c) { pthread_cond_destroy(c); }
+static inline void ps_cond_wait(ps_cond_t *c, ps_mutex_t *m) { pthread_cond_wait(c, m); }
+static inline void ps_cond_signal(ps_cond_t *c) { pthread_cond_signal(c); }
+static inline void ps_cond_broadcast(ps_cond_t *c) { pthread_cond_broadcast(c); }
+
+// 재진입 가능한 문자열 분리/시각 변환 (여러 스레드에서 동시에 호출 가능)
+#define ps_strtok_r(str, delim, saveptr) strtok_r((str), (delim), (saveptr))
+#define ps_localtime(timer, result) localtime_r((timer), (result))
+
+// 사용 가능한 CPU 코어 수
+static inline int ps_cpu_count(void)
+{
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+// 단조 시계 (밀리초, 시스템 시각 변경의 영향을 받지 않음)
+static inline unsigned long long ps_now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000ULL + (unsigned long long)ts.tv_nsec / 1000000ULL;
+}
+
+// 단조 시계 (마이크로초, 대기 시간 측정용)
+static inline unsigned long long ps_now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000ULL + (unsigned long long)ts.tv_nsec / 1000ULL;
+}
+
+// 현재 스레드가 사용한 CPU 시간 (마이크로초, 사용자 + 커널)
+static inline unsigned long long ps_thread_cpu_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000ULL + (unsigned long long)ts.tv_nsec / 1000ULL;
+}
+
+// 현재 시각 (1970-01-01 UTC 기준 밀리초, 로그 시각 표시용)
+static inline unsigned long long ps_wall_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (unsigned long long)ts.tv_sec * 1000ULL + (unsigned long long)ts.tv_nsec / 1000000ULL;
+}
+
+// 밀리초 동안 잠듦
+static inline void ps_sleep_ms(unsigned ms)
+{
+    struct timespec ts = {ms / 1000, (long)(ms % 1000) * 1000000L};
+    nanosleep(&ts, NULL);
+}
+
+#endif
+
+#endif
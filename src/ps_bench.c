@@ -0,0 +1,421 @@
+// src/ps_bench.c
+
+// Linux 전용: 서버 부하 측정 도구
+// 여러 연결에서 동시에 요청을 보내고(연결마다 스레드 하나, 요청 하나를 보내고 응답을 받은 뒤 다음 요청),
+// 요청별 왕복 지연 시간의 분포(p50/p90/p99/p99.9/최대)와 초당 처리량을 출력한다.
+// 서버를 --io-backend epoll / io_uring으로 각각 실행해 같은 조건으로 측정하면,
+// 지연 시간은 이 도구가, 입출력 시스템 콜 수는 서버가 종료할 때 출력하는 통계가 비교 자료가 된다.
+// --unix로 서버의 로컬(AF_UNIX) 소켓에, --shm으로 서버의 공유 메모리 링(shm_ring.h)에 연결할 수 있고,
+// --compare를 함께 주면 TCP 루프백과 지정한 로컬 전송 방식들을 같은 조건으로 차례로 측정해 지연 시간을 나란히 출력한다.
+// --deadline-ms를 주면 요청마다 제한 시간(frame.h의 FRAME_FLAG_DEADLINE)을 붙이고, 기한 초과 응답을 받은 수를 함께 출력한다.
+
+#include "frame.h"
+#include "reply_buffer.h"
+#include "command_dispatch.h"
+#include "platform.h"
+#include "shm_ring.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/un.h>
+
+#define DEFAULT_CONNECTIONS 32        // 기본 동시 연결 수
+#define DEFAULT_REQUESTS 10000        // 기본 연결당 요청 수
+#define DEFAULT_REQUEST "MEMO_LIST:bench1" // 기본 요청 (존재하지 않는 사용자의 목록: 저장소를 거의 건드리지 않음)
+
+// 측정 옵션
+typedef struct
+{
+    const char *host;    // 서버 IP 주소
+    int port;            // 서버 포트
+    int connections;     // 동시 연결 수
+    int requests;        // 연결당 요청 수
+    const char *request; // 보낼 요청
+    const char *unix_path; // 로컬(AF_UNIX) 소켓 경로 (NULL이면 TCP만 사용)
+    const char *shm_name;  // 공유 메모리 세그먼트 이름 (NULL이면 사용 안 함)
+    bool compare;          // TCP와 로컬 전송 방식을 차례로 측정해 비교
+    int deadline_ms;       // 요청마다 붙이는 제한 시간 (밀리초, 0이면 붙이지 않음, 소켓 연결만)
+} BenchConfig;
+
+// 서버와 통신하는 방식
+typedef enum
+{
+    TRANSPORT_TCP,   // TCP 루프백
+    TRANSPORT_LOCAL, // 로컬(AF_UNIX) 소켓
+    TRANSPORT_SHM    // 공유 메모리 링
+} Transport;
+
+// 연결 하나의 측정 결과
+typedef struct
+{
+    ps_thread_t thread;  // 측정 스레드
+    uint64_t *latencies; // 요청별 왕복 시간 (나노초)
+    int completed;       // 응답까지 받은 요청 수
+    int expired;         // 기한 초과 응답을 받은 요청 수
+    bool failed;         // 연결 또는 통신 실패 여부
+    Transport transport; // 통신 방식
+} BenchWorker;
+
+// 측정 한 번의 결과 요약
+typedef struct
+{
+    size_t total;      // 완료된 요청 수
+    size_t expired;    // 그중 기한 초과 응답 수
+    double elapsed;    // 걸린 시간 (초)
+    double pct[4];     // p50/p90/p99/p99.9 지연 (마이크로초)
+    double max_us;     // 최대 지연 (마이크로초)
+    int failed;        // 실패한 연결 수
+} BenchResult;
+
+static BenchConfig g_config = {"127.0.0.1", 12345, DEFAULT_CONNECTIONS, DEFAULT_REQUESTS, DEFAULT_REQUEST, NULL, NULL, false, 0};
+
+// 단조 시계 (나노초)
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// 서버의 로컬 소켓에 연결
+static SOCKET connect_local(void)
+{
+    struct sockaddr_un addr = {0};
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", g_config.unix_path);
+    SOCKET sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock == INVALID_SOCKET)
+        return INVALID_SOCKET;
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        closesocket(sock);
+        return INVALID_SOCKET;
+    }
+    return sock;
+}
+
+// 서버에 TCP로 연결 (Nagle 알고리즘을 꺼서 작은 요청이 지연되지 않도록 함)
+static SOCKET connect_server(void)
+{
+    SOCKET sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock == INVALID_SOCKET)
+        return INVALID_SOCKET;
+    struct sockaddr_in addr = {0};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)g_config.port);
+    addr.sin_addr.s_addr = inet_addr(g_config.host);
+    if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        closesocket(sock);
+        return INVALID_SOCKET;
+    }
+    int one = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return sock;
+}
+
+// 공유 메모리 링으로 측정 (소켓 대신 채널 하나를 차지해서 같은 요청을 반복)
+static void bench_shm(BenchWorker *worker)
+{
+    ShmClient *client = shm_client_attach(g_config.shm_name);
+    if (!client)
+    {
+        worker->failed = true;
+        return;
+    }
+
+    ReplyBuffer reply;
+    reply_init(&reply);
+    size_t request_len = strlen(g_config.request);
+    for (int i = 0; i < g_config.requests; i++)
+    {
+        uint64_t start = now_ns();
+        if (!shm_client_call(client, g_config.request, request_len, &reply))
+        {
+            worker->failed = true;
+            break;
+        }
+        worker->latencies[worker->completed++] = now_ns() - start;
+    }
+
+    // 정상 종료 요청
+    shm_client_call(client, "EXIT", 4, &reply);
+    reply_free(&reply);
+    shm_client_detach(client);
+}
+
+// 측정 스레드: 요청을 하나씩 보내고 응답을 받을 때까지의 시간을 기록
+static PS_THREAD_FUNC(bench_thread)
+{
+    BenchWorker *worker = (BenchWorker *)arg;
+    if (worker->transport == TRANSPORT_SHM)
+    {
+        bench_shm(worker);
+        PS_THREAD_RETURN;
+    }
+    SOCKET sock = worker->transport == TRANSPORT_LOCAL ? connect_local() : connect_server();
+    if (sock == INVALID_SOCKET)
+    {
+        worker->failed = true;
+        PS_THREAD_RETURN;
+    }
+
+    ReplyBuffer reply;
+    reply_init(&reply);
+    size_t request_len = strlen(g_config.request);
+    uint8_t flags = g_config.deadline_ms > 0 ? FRAME_FLAG_DEADLINE : 0;
+    for (int i = 0; i < g_config.requests; i++)
+    {
+        uint64_t start = now_ns();
+        if (!frame_send_request(sock, flags, 0, (uint32_t)g_config.deadline_ms, g_config.request, request_len) ||
+            !frame_recv(sock, &reply))
+        {
+            worker->failed = true;
+            break;
+        }
+        worker->latencies[worker->completed++] = now_ns() - start;
+        // 기한 초과 응답은 코드 5바이트("LATE:")로 구분
+        if (reply.len >= 5 && memcmp(reply_str(&reply), REPLY_EXPIRED, 5) == 0)
+            worker->expired++;
+    }
+
+    // 정상 종료 요청
+    frame_send(sock, "EXIT", 4);
+    frame_recv(sock, &reply);
+    reply_free(&reply);
+    closesocket(sock);
+    PS_THREAD_RETURN;
+}
+
+// qsort용 비교 함수
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+// 정렬된 값에서 백분위수 (마이크로초)
+static double percentile_us(const uint64_t *sorted, size_t count, double pct)
+{
+    size_t index = (size_t)(pct / 100.0 * (double)(count - 1) + 0.5);
+    return (double)sorted[index] / 1000.0;
+}
+
+// 사용법 출력
+static void print_usage(const char *program)
+{
+    printf("사용법: %s [옵션]\n", program);
+    printf("  --host IP          서버 IP 주소 (기본: 127.0.0.1)\n");
+    printf("  --port N           서버 포트 (기본: 12345)\n");
+    printf("  --connections N    동시 연결 수 (기본: %d)\n", DEFAULT_CONNECTIONS);
+    printf("  --requests N       연결당 요청 수 (기본: %d)\n", DEFAULT_REQUESTS);
+    printf("  --request STR      보낼 요청 (기본: %s)\n", DEFAULT_REQUEST);
+    printf("  --unix PATH        TCP 대신 서버의 로컬(AF_UNIX) 소켓으로 연결 (서버의 --unix-socket 경로)\n");
+    printf("  --shm NAME         TCP 대신 서버의 공유 메모리 링으로 연결 (서버의 --shm 이름, 연결 수는 최대 %d)\n", SHM_CHANNELS);
+    printf("  --compare          --unix/--shm과 함께 사용: TCP 루프백과 지정한 방식들을 차례로 측정해 비교\n");
+    printf("  --deadline-ms N    요청마다 제한 시간 N밀리초를 붙이고 기한 초과 응답 수를 출력 (TCP/--unix만)\n");
+}
+
+// 명령행 인자 해석
+static bool parse_args(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++)
+    {
+        // 값이 없는 옵션
+        if (strcmp(argv[i], "--compare") == 0)
+        {
+            g_config.compare = true;
+            continue;
+        }
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (value == NULL)
+        {
+            print_usage(argv[0]);
+            return false;
+        }
+        if (strcmp(argv[i], "--host") == 0)
+            g_config.host = value;
+        else if (strcmp(argv[i], "--port") == 0)
+            g_config.port = atoi(value);
+        else if (strcmp(argv[i], "--connections") == 0)
+            g_config.connections = atoi(value);
+        else if (strcmp(argv[i], "--requests") == 0)
+            g_config.requests = atoi(value);
+        else if (strcmp(argv[i], "--request") == 0)
+            g_config.request = value;
+        else if (strcmp(argv[i], "--unix") == 0)
+            g_config.unix_path = value;
+        else if (strcmp(argv[i], "--shm") == 0)
+            g_config.shm_name = value;
+        else if (strcmp(argv[i], "--deadline-ms") == 0)
+            g_config.deadline_ms = atoi(value);
+        else
+        {
+            print_usage(argv[0]);
+            return false;
+        }
+        i++;
+    }
+    if (g_config.port <= 0 || g_config.connections <= 0 || g_config.requests <= 0 ||
+        (g_config.compare && g_config.unix_path == NULL && g_config.shm_name == NULL) ||
+        (!g_config.compare && g_config.unix_path != NULL && g_config.shm_name != NULL) ||
+        (g_config.shm_name != NULL && g_config.connections > SHM_CHANNELS) ||
+        g_config.deadline_ms < 0 || (g_config.deadline_ms > 0 && g_config.shm_name != NULL))
+    {
+        print_usage(argv[0]);
+        return false;
+    }
+    return true;
+}
+
+// 한 가지 연결 방식으로 측정
+static bool run_bench(Transport transport, BenchResult *result)
+{
+    memset(result, 0, sizeof(*result));
+
+    // 측정 스레드 준비
+    BenchWorker *workers = (BenchWorker *)calloc(g_config.connections, sizeof(BenchWorker));
+    if (!workers)
+        return false;
+    for (int i = 0; i < g_config.connections; i++)
+    {
+        workers[i].transport = transport;
+        workers[i].latencies = (uint64_t *)malloc(sizeof(uint64_t) * g_config.requests);
+        if (!workers[i].latencies)
+            return false;
+    }
+
+    // 모든 연결에서 동시에 측정
+    uint64_t start = now_ns();
+    int started = 0;
+    for (; started < g_config.connections; started++)
+    {
+        if (!ps_thread_create(&workers[started].thread, bench_thread, &workers[started]))
+            break;
+    }
+    for (int i = 0; i < started; i++)
+    {
+        ps_thread_join(workers[i].thread);
+    }
+    result->elapsed = (double)(now_ns() - start) / 1e9;
+
+    // 결과 모으기
+    size_t total = 0;
+    for (int i = 0; i < started; i++)
+    {
+        total += workers[i].completed;
+        result->expired += workers[i].expired;
+        result->failed += workers[i].failed ? 1 : 0;
+    }
+    uint64_t *all = (uint64_t *)malloc(sizeof(uint64_t) * (total > 0 ? total : 1));
+    if (!all)
+        return false;
+    size_t n = 0;
+    for (int i = 0; i < g_config.connections; i++)
+    {
+        memcpy(all + n, workers[i].latencies, sizeof(uint64_t) * workers[i].completed);
+        n += workers[i].completed;
+        free(workers[i].latencies);
+    }
+    free(workers);
+
+    // 지연 시간 분포
+    result->total = total;
+    if (total > 0)
+    {
+        static const double pcts[4] = {50.0, 90.0, 99.0, 99.9};
+        qsort(all, total, sizeof(uint64_t), compare_u64);
+        for (int i = 0; i < 4; i++)
+        {
+            result->pct[i] = percentile_us(all, total, pcts[i]);
+        }
+        result->max_us = (double)all[total - 1] / 1000.0;
+    }
+    free(all);
+    return true;
+}
+
+// 측정 결과 출력
+static void print_result(const char *label, const BenchResult *result)
+{
+    if (result->failed > 0)
+        printf("[벤치] %s 실패한 연결: %d개\n", label, result->failed);
+    if (result->total == 0)
+    {
+        printf("[벤치] %s 완료된 요청이 없습니다.\n", label);
+        return;
+    }
+    printf("[벤치] %s 완료 %zu개, %.2f초, 초당 %.0f개\n", label, result->total, result->elapsed,
+           (double)result->total / result->elapsed);
+    printf("[벤치] %s 지연(us) p50 %.1f  p90 %.1f  p99 %.1f  p99.9 %.1f  최대 %.1f\n", label,
+           result->pct[0], result->pct[1], result->pct[2], result->pct[3], result->max_us);
+    if (g_config.deadline_ms > 0)
+        printf("[벤치] %s 제한 시간 %dms: 기한 초과 응답 %zu개 (%.1f%%)\n", label, g_config.deadline_ms, result->expired,
+               100.0 * (double)result->expired / (double)result->total);
+}
+
+// 한 방식의 결과를 TCP 루프백과 비교한 비율 출력
+static void print_ratio(const char *label, const BenchResult *result, const BenchResult *tcp)
+{
+    printf("[벤치] %s / TCP 비율: p50 %.2f  p99 %.2f  처리량 %.2f\n", label,
+           result->pct[0] / tcp->pct[0], result->pct[2] / tcp->pct[2],
+           ((double)result->total / result->elapsed) / ((double)tcp->total / tcp->elapsed));
+}
+
+int main(int argc, char *argv[])
+{
+    if (!parse_args(argc, argv))
+        return 1;
+
+    if (g_config.compare)
+        printf("[벤치] %s:%d%s%s%s%s, 연결 %d개 x 요청 %d개 (%s)\n", g_config.host, g_config.port,
+               g_config.unix_path ? " / " : "", g_config.unix_path ? g_config.unix_path : "",
+               g_config.shm_name ? " / 공유 메모리 " : "", g_config.shm_name ? g_config.shm_name : "",
+               g_config.connections, g_config.requests, g_config.request);
+    else if (g_config.unix_path || g_config.shm_name)
+        printf("[벤치] %s%s, 연결 %d개 x 요청 %d개 (%s)\n", g_config.shm_name ? "공유 메모리 " : "",
+               g_config.shm_name ? g_config.shm_name : g_config.unix_path,
+               g_config.connections, g_config.requests, g_config.request);
+    else
+        printf("[벤치] %s:%d, 연결 %d개 x 요청 %d개 (%s)\n", g_config.host, g_config.port,
+               g_config.connections, g_config.requests, g_config.request);
+
+    // 비교 모드: TCP 루프백과 지정한 로컬 전송 방식들을 같은 조건으로 차례로 측정
+    if (g_config.compare)
+    {
+        BenchResult tcp, local, shm;
+        if (!run_bench(TRANSPORT_TCP, &tcp) ||
+            (g_config.unix_path && !run_bench(TRANSPORT_LOCAL, &local)) ||
+            (g_config.shm_name && !run_bench(TRANSPORT_SHM, &shm)))
+            return 1;
+        int status = tcp.failed > 0 || tcp.total == 0;
+        print_result("TCP        ", &tcp);
+        if (g_config.unix_path)
+        {
+            print_result("로컬       ", &local);
+            status |= local.failed > 0 || local.total == 0;
+        }
+        if (g_config.shm_name)
+        {
+            print_result("공유 메모리", &shm);
+            status |= shm.failed > 0 || shm.total == 0;
+        }
+        if (tcp.total > 0 && g_config.unix_path && local.total > 0)
+            print_ratio("로컬 소켓", &local, &tcp);
+        if (tcp.total > 0 && g_config.shm_name && shm.total > 0)
+            print_ratio("공유 메모리", &shm, &tcp);
+        return status;
+    }
+
+    Transport transport = g_config.shm_name ? TRANSPORT_SHM : g_config.unix_path ? TRANSPORT_LOCAL : TRANSPORT_TCP;
+    BenchResult result;
+    if (!run_bench(transport, &result))
+        return 1;
+    print_result(transport == TRANSPORT_SHM ? "공유 메모리" : transport == TRANSPORT_LOCAL ? "로컬" : "TCP", &result);
+    return result.failed > 0 || result.total == 0 ? 1 : 0;
+}
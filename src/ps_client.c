@@ -2,8 +2,11 @@
 
 #include <stdio.h>
 #include <winsock2.h>
+#include <afunix.h> // AF_UNIX (Windows 10 1803 이상)
 #include <locale.h>
+#include <string.h>
 #include "user_menu.h"
+#include "client_net.h"
 #include <direct.h>   // for _mkdir
 #include <sys/stat.h> // for stat
 
@@ -25,8 +28,58 @@ void create_downloads_directory()
     }
 }
 
-int main()
+// TCP로 서버에 연결
+static SOCKET connect_tcp(void)
 {
+    // 소켓 생성
+    SOCKET sock = socket(AF_INET, SOCK_STREAM, 0);
+    // 서버 주소 구조체
+    struct sockaddr_in serv_addr = {0};
+    // 서버 주소 구조체 초기화
+    serv_addr.sin_family = AF_INET;
+    serv_addr.sin_addr.s_addr = inet_addr(SERVER_IP);
+    serv_addr.sin_port = htons(PORT);
+
+    if (sock != INVALID_SOCKET && connect(sock, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0)
+    {
+        closesocket(sock);
+        return INVALID_SOCKET;
+    }
+    return sock;
+}
+
+// 같은 호스트에서 실행 중인 서버의 로컬(AF_UNIX) 소켓에 연결 (서버의 --unix-socket 경로)
+static SOCKET connect_local(const char *path)
+{
+    struct sockaddr_un addr = {0};
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path))
+        return INVALID_SOCKET;
+    strcpy(addr.sun_path, path);
+
+    SOCKET sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock != INVALID_SOCKET && connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        closesocket(sock);
+        return INVALID_SOCKET;
+    }
+    return sock;
+}
+
+int main(int argc, char *argv[])
+{
+    // 명령행 옵션: --unix 경로 (서버와 같은 호스트라면 TCP 대신 로컬 소켓 사용)
+    const char *unix_path = NULL;
+    if (argc == 3 && strcmp(argv[1], "--unix") == 0)
+    {
+        unix_path = argv[2];
+    }
+    else if (argc != 1)
+    {
+        printf("사용법: %s [--unix 소켓경로]\n", argv[0]);
+        return 1;
+    }
+
     // 로케일 설정
     setlocale(LC_ALL, ".UTF8");
     // 콘솔 출력 코드 페이지 설정
@@ -45,16 +98,9 @@ int main()
         return 1;
     }
 
-    // 소켓 생성
-    SOCKET sock = socket(AF_INET, SOCK_STREAM, 0);
-    // 서버 주소 구조체
-    struct sockaddr_in serv_addr = {0};
-    // 서버 주소 구조체 초기화
-    serv_addr.sin_family = AF_INET;
-    serv_addr.sin_addr.s_addr = inet_addr(SERVER_IP);
-    serv_addr.sin_port = htons(PORT);
-
-    if (connect(sock, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0)
+    // 서버 연결
+    SOCKET sock = unix_path ? connect_local(unix_path) : connect_tcp();
+    if (sock == INVALID_SOCKET)
     {
         printf("[클라이언트] 서버 연결 실패\n");
         WSACleanup();
@@ -62,7 +108,9 @@ int main()
         return 1;
     }
 
-    printf("[클라이언트] 서버에 연결되었습니다.\n");
+    printf("[클라이언트] 서버에 연결되었습니다.%s\n", unix_path ? " (로컬 소켓)" : "");
+    // 프로토콜 협상 (서버가 지원하면 목록 조회에 바이너리 프로토콜 사용)
+    client_hello(sock);
     Sleep(500);
 
     // 모든 UI와 로직은 user_menu_loop가 담당
@@ -3,29 +3,207 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#ifdef _WIN32
 #include <winsock2.h>
 #include <ws2tcpip.h>
+#include <afunix.h> // AF_UNIX (Windows 10 1803 이상)
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include "event_loop.h"
+#include "shm_server.h"
+#include "handoff.h"
+#endif
 #include <stdbool.h>
+#include <limits.h>
 #include <locale.h>
+#include "platform.h"
 #include "user.h"
-#include "user_command.h"
 #include "memo.h"
-#include "memo_command.h"
+#include "command_dispatch.h"
+#include "server_config.h"
+#include "worker_pool.h"
+#include "frame.h"
+#include "store_partition.h"
+#include "session.h"
+#include "deadline.h"
+#include "timer_wheel.h"
+#include "logger.h"
+#include "load_shed.h"
 #include <signal.h>
-#include <direct.h>
 #include <sys/stat.h>
 
+#ifdef _WIN32
 #pragma comment(lib, "ws2_32.lib") // 소켓 라이브러리
+#endif
 
 #define PORT 12345      // 포트 번호
-#define BUF_SIZE 2048   // 버퍼 크기
+#define BUF_SIZE 2048   // 이전 방식(길이 헤더 없음) 요청의 최대 크기
 #define MAX_CLIENTS 100 // 최대 클라이언트 수
+#define IDLE_TICK_MS 100 // 유휴 시간 타이머 휠의 틱 길이 (Windows)
+#define SEND_TIMEOUT_MS 30000 // 응답을 읽지 않는 클라이언트에게 전송이 막혀 있을 수 있는 최대 시간 (Windows)
 
 // 전역 서버 소켓
-static SOCKET g_serv_sock = INVALID_SOCKET; // 서버 소켓
+static SOCKET g_serv_sock = INVALID_SOCKET;  // 서버 소켓
+static SOCKET g_local_sock = INVALID_SOCKET; // 로컬(AF_UNIX) 서버 소켓 (--unix-socket)
 
+#ifdef _WIN32
 // 클라이언트 연결과 통신 처리
 DWORD WINAPI handle_client(LPVOID client_socket);
+// 로컬 소켓 클라이언트 연결과 통신 처리
+DWORD WINAPI handle_local_client(LPVOID client_socket);
+// 로컬 서버 소켓의 연결 수락 스레드
+DWORD WINAPI accept_local_clients(LPVOID arg);
+// 유휴 연결 종료 / 연결 확인 타이머 스레드 시작
+static void start_idle_timers(void);
+#endif
+
+// 같은 호스트의 클라이언트용 로컬(AF_UNIX) 서버 소켓 생성
+// TCP 루프백과 달리 TCP/IP 스택(체크섬, 혼잡 제어, ACK 등)을 거치지 않아 요청당 지연이 줄어든다.
+static SOCKET open_local_listener(const char *path)
+{
+    struct sockaddr_un addr = {0};
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path))
+    {
+        logger_write(LOG_LEVEL_ERROR, "[서버] 로컬 소켓 경로가 너무 깁니다: %s", path);
+        return INVALID_SOCKET;
+    }
+    strcpy(addr.sun_path, path);
+    SOCKET sock = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (sock == INVALID_SOCKET)
+    {
+        logger_write(LOG_LEVEL_ERROR, "[서버] 로컬 소켓 생성 실패");
+        return INVALID_SOCKET;
+    }
+    // 이전 실행이 남긴 소켓 파일 삭제 (남아 있으면 bind 실패)
+    remove(path);
+    if (bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(sock, SOMAXCONN) < 0)
+    {
+        logger_write(LOG_LEVEL_ERROR, "[서버] 로컬 소켓 bind/listen 실패: %s", path);
+        closesocket(sock);
+        return INVALID_SOCKET;
+    }
+    logger_write(LOG_LEVEL_INFO, "[서버] 로컬 소켓에서도 연결을 받습니다: %s", path);
+    return sock;
+}
+
+#ifndef _WIN32
+// 무중단 재시작: 새 프로세스가 요청했으면 이벤트 루프가 남겨 둔 리스너를 넘김 (저장을 마친 뒤 호출)
+// 반환값: 넘겼으면 true (로컬 소켓 파일은 새 프로세스가 계속 쓰므로 지우면 안 됨)
+static bool hand_over_listeners(void)
+{
+    if (!g_server_config.handoff_path)
+        return false;
+    int fds[MAX_STORE_PARTITIONS];
+    int count = event_loop_take_listeners(fds, MAX_STORE_PARTITIONS);
+    bool sent = false;
+    if (handoff_requested() && count > 0)
+    {
+        HandoffSockets sockets;
+        memcpy(sockets.tcp_fds, fds, sizeof(int) * count);
+        sockets.tcp_count = count;
+        sockets.local_fd = g_local_sock == INVALID_SOCKET ? -1 : g_local_sock;
+        sockets.shard_count = g_server_config.shard_count;
+        sent = handoff_send(&sockets);
+    }
+    handoff_stop();
+    // 샤드 1부터의 리스너 닫기 (샤드 0의 리스너는 g_serv_sock으로 닫음)
+    for (int i = 1; i < count; i++)
+    {
+        close(fds[i]);
+    }
+    return sent;
+}
+
+// 새 프로세스가 리스너를 요청함 (재시작 제어 스레드에서 호출): 연결을 정리하고 이벤트 루프 종료
+static void begin_handoff(void)
+{
+    event_loop_drain(HANDOFF_DRAIN_MS);
+}
+
+// TCP 서버 소켓 생성
+static SOCKET open_tcp_listener(void)
+{
+    SOCKET sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock == INVALID_SOCKET)
+    {
+        perror("[서버] socket 생성 실패");
+        return INVALID_SOCKET;
+    }
+    // 재시작 직후에도 같은 포트를 바로 사용할 수 있도록 설정
+    int reuse = 1;
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    // 샤드 모드: 샤드마다 같은 포트에 리스너를 따로 열고, 커널이 새 연결을 리스너들에 나눠 줌
+    if (g_server_config.shard_count > 0)
+        setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse));
+    struct sockaddr_in serv_addr = {0};
+    serv_addr.sin_family = AF_INET;
+    serv_addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    serv_addr.sin_port = htons(PORT);
+
+    // 서버 소켓 바인딩
+    if (bind(sock, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0 ||
+        listen(sock, SOMAXCONN) < 0)
+    {
+        perror("[서버] bind/listen 실패");
+        closesocket(sock);
+        return INVALID_SOCKET;
+    }
+    return sock;
+}
+#endif
+
+// 모든 데이터를 파일에 저장하고 리소스 정리
+static void shutdown_server()
+{
+    // 기한이 지난 요청을 버리거나 중단한 적이 있으면 아낀 CPU 시간 추정값 기록
+    if (deadline_skipped() + deadline_abandoned() > 0)
+        logger_write(LOG_LEVEL_INFO, "[서버] 기한이 지난 요청: 시작 전 %llu개, 처리 중 중단 %llu개 (아낀 CPU 약 %llums, 중단 전에 쓴 CPU %llums)",
+                     deadline_skipped(), deadline_abandoned(), deadline_saved_us() / 1000ULL, deadline_wasted_us() / 1000ULL);
+    // 사용자 정보 파일에 저장
+    printf("[서버] 모든 사용자 정보를 파일에 저장 중...\n");
+    user_save_to_file();
+    // 모든 메모 정보 파일에 저장
+    printf("[서버] 모든 메모 정보를 파일에 저장 중...\n");
+    memo_save_all_to_files();
+    bool handed_off = false;
+#ifndef _WIN32
+    // 저장을 마쳤으므로 새 프로세스에게 리스너를 넘김 (넘긴 뒤 닫아도 새 프로세스가 받은 소켓은 유지됨)
+    handed_off = hand_over_listeners();
+#endif
+
+    // 리소스 정리
+    if (g_serv_sock != INVALID_SOCKET) // 서버 소켓 유효 시
+    {
+        // 서버 소켓 닫기
+        closesocket(g_serv_sock);
+        g_serv_sock = INVALID_SOCKET;
+    }
+    if (g_local_sock != INVALID_SOCKET) // 로컬 서버 소켓 유효 시
+    {
+        // 로컬 서버 소켓을 닫고 소켓 파일 삭제 (리스너를 넘겼으면 새 프로세스가 계속 사용)
+        closesocket(g_local_sock);
+        g_local_sock = INVALID_SOCKET;
+        if (!handed_off)
+            remove(g_server_config.unix_socket_path);
+    }
+    // 사용자 정보 정리
+    user_cleanup();
+    // 메모 정보 정리
+    memo_cleanup();
+    // 세션 정리
+    session_cleanup();
+#ifdef _WIN32
+    // 소켓 라이브러리
+    WSACleanup();
+#endif
+
+    printf("[서버] 모든 리소스가 정리되었습니다. 프로그램을 종료합니다.\n");
+}
 
 // Ctrl+C 신호 처리
 void signal_handler(int signum) // 신호 처리
@@ -33,31 +211,17 @@ void signal_handler(int signum) // 신호 처리
     // Ctrl+C 신호 수신 시
     if (signum == SIGINT)
     {
+#ifdef _WIN32
         // 종료 메시지 출력
         printf("\n[서버] 종료 신호(Ctrl+C) 수신. 서버를 안전하게 종료합니다...\n");
-
-        // 사용자 정보 파일에 저장
-        printf("[서버] 모든 사용자 정보를 파일에 저장 중...\n");
-        user_save_to_file();
-        // 모든 메모 정보 파일에 저장
-        printf("[서버] 모든 메모 정보를 파일에 저장 중...\n");
-        memo_save_all_to_files();
-
-        // 리소스 정리
-        if (g_serv_sock != INVALID_SOCKET) // 서버 소켓 유효 시
-        {
-            // 서버 소켓 닫기
-            closesocket(g_serv_sock);
-        }
-        // 사용자 정보 정리
-        user_cleanup();
-        // 메모 정보 정리
-        memo_cleanup();
-        // 소켓 라이브러리
-        WSACleanup();
-
-        printf("[서버] 모든 리소스가 정리되었습니다. 프로그램을 종료합니다.\n");
+        // 링에 남은 로그를 먼저 출력 (이후 기록은 바로 출력됨)
+        logger_stop();
+        shutdown_server();
         exit(0);
+#else
+        // 이벤트 루프를 멈추면 main에서 저장 및 정리를 수행
+        event_loop_stop();
+#endif
     }
 }
 
@@ -93,8 +257,23 @@ void create_data_directories()
     }
 }
 
-int main()
+#ifdef _WIN32
+int main(int argc, char *argv[])
 {
+    // 명령행 옵션 해석
+    if (!server_config_parse(argc, argv))
+        return 1;
+    // 로그 기록 스레드 시작 (실패하면 로그를 바로 출력)
+    // 시작 중에 실패해서 main이 바로 끝나도 링에 남은 로그가 출력되도록 종료 시 비우기를 등록
+    logger_set_level(g_server_config.log_level);
+    if (logger_start())
+        atexit(logger_stop);
+    // 명령 종류별 요청 빈도 제한 예산 (--rate-read/--rate-write/--rate-bulk)
+    for (int c = 0; c < RATE_CLASS_COUNT; c++)
+        rate_limit_configure((RateClass)c, g_server_config.rate_per_sec[c], g_server_config.rate_burst[c]);
+    // 대기 시간 기반 부하 조절 (--shed-target/--shed-interval)
+    load_shed_configure(g_server_config.shed_target_ms, g_server_config.shed_interval_ms);
+
     create_data_directories(); // 데이터 디렉터리 생성
 
     setlocale(LC_ALL, ".UTF8");
@@ -106,6 +285,15 @@ int main()
     user_init();
     memo_init();
 
+    // 명령어 핸들러를 실행할 워커 풀 시작
+    if (!worker_pool_start(g_server_config.worker_count, g_server_config.queue_depth, g_server_config.bulk_limit))
+    {
+        printf("[서버] 워커 풀 시작 실패\n");
+        return 1;
+    }
+    // 유휴 연결 종료 / 연결 확인 타이머
+    start_idle_timers();
+
     WSADATA wsa;
     if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0)
     {
@@ -123,7 +311,16 @@ int main()
     bind(g_serv_sock, (struct sockaddr *)&serv_addr, sizeof(serv_addr));
     listen(g_serv_sock, MAX_CLIENTS);
 
-    printf("[서버] 클라이언트 연결 대기 중... (Ctrl+C로 종료)\n");
+    // 로컬 서버 소켓은 별도 스레드에서 연결 수락
+    if (g_server_config.unix_socket_path)
+    {
+        g_local_sock = open_local_listener(g_server_config.unix_socket_path);
+        if (g_local_sock == INVALID_SOCKET)
+            return 1;
+        CreateThread(NULL, 0, accept_local_clients, NULL, 0, NULL);
+    }
+
+    logger_write(LOG_LEVEL_INFO, "[서버] 클라이언트 연결 대기 중... (Ctrl+C로 종료)");
 
     // 클라이언트 연결 대기
     while (true)
@@ -142,7 +339,7 @@ int main()
             {
                 break; // 루프 종료
             }
-            printf("[서버] accept() 실패\n");
+            logger_write(LOG_LEVEL_ERROR, "[서버] accept() 실패");
             continue;
         }
 
@@ -152,71 +349,459 @@ int main()
 
     // 서버 소켓 닫기
     closesocket(g_serv_sock);
+    if (g_local_sock != INVALID_SOCKET)
+        closesocket(g_local_sock);
+    // 워커 종료
+    worker_pool_stop();
     // 사용자 정보 정리
     user_cleanup();
     // 메모 정보 정리
     memo_cleanup();
+    // 세션 정리
+    session_cleanup();
     // 소켓 라이브러리
     WSACleanup();
     return 0;
 }
 
-// 클라이언트 처리 스레드
-DWORD WINAPI handle_client(LPVOID client_socket)
+#else
+int main(int argc, char *argv[])
 {
-    // 클라이언트 소켓
-    SOCKET sock = (SOCKET)(ULONG_PTR)client_socket;
-    // 버퍼
-    char buffer[BUF_SIZE], reply[BUF_SIZE];
+    // 명령행 옵션 해석
+    if (!server_config_parse(argc, argv))
+        return 1;
+    // 로그 기록 스레드 시작 (실패하면 로그를 바로 출력)
+    // 시작 중에 실패해서 main이 바로 끝나도 링에 남은 로그가 출력되도록 종료 시 비우기를 등록
+    logger_set_level(g_server_config.log_level);
+    if (logger_start())
+        atexit(logger_stop);
+    // 명령 종류별 요청 빈도 제한 예산 (--rate-read/--rate-write/--rate-bulk)
+    for (int c = 0; c < RATE_CLASS_COUNT; c++)
+        rate_limit_configure((RateClass)c, g_server_config.rate_per_sec[c], g_server_config.rate_burst[c]);
+    // 대기 시간 기반 부하 조절 (--shed-target/--shed-interval)
+    load_shed_configure(g_server_config.shed_target_ms, g_server_config.shed_interval_ms);
+
+    create_data_directories(); // 데이터 디렉터리 생성
+
+    setlocale(LC_ALL, "C.UTF-8");
+
+    // 시그널 핸들러 등록 (끊어진 소켓에 쓰기 시 프로세스가 종료되지 않도록 SIGPIPE 무시)
+    signal(SIGINT, signal_handler);
+    signal(SIGTERM, signal_handler);
+    signal(SIGPIPE, SIG_IGN);
 
-    printf("[서버] 클라이언트 %llu 연결됨\n", sock);
+    // 무중단 재시작 (--handoff): 실행 중인 이전 프로세스가 있으면 리스너를 넘겨받음
+    // 이전 프로세스가 연결을 정리하고 데이터를 저장한 뒤에 넘겨주므로 데이터를 읽기 전에 호출한다.
+    // --shm을 쓰면 샤드 모드인 이전 프로세스는 거절하고 계속 실행하므로 이쪽이 종료한다.
+    HandoffSockets inherited = {0};
+    HandoffResult handoff = HANDOFF_NONE;
+    if (g_server_config.handoff_path)
+        handoff = handoff_receive(g_server_config.handoff_path, g_server_config.shm_name != NULL, &inherited);
+    if (handoff == HANDOFF_REFUSED)
+        return 1;
+    bool adopted = handoff == HANDOFF_ADOPTED;
+    if (adopted && inherited.shard_count != g_server_config.shard_count)
+    {
+        // 넘겨받은 리스너마다 그 대기열을 수락할 샤드가 있어야 하므로 이전 프로세스의 샤드 구성을 따름
+        logger_write(LOG_LEVEL_WARN, "[서버] 넘겨받은 리스너에 맞춰 이전 프로세스와 같은 --shards %d로 실행합니다.",
+                     inherited.shard_count);
+        g_server_config.shard_count = inherited.shard_count;
+        // 바뀐 샤드 구성으로 옵션을 다시 확인 (이전 프로세스가 거절하지 않고 넘겨준 경우에 대비)
+        if (!server_config_check())
+        {
+            for (int i = 0; i < inherited.tcp_count; i++)
+            {
+                closesocket(inherited.tcp_fds[i]);
+            }
+            if (inherited.local_fd >= 0)
+                closesocket(inherited.local_fd);
+            return 1;
+        }
+    }
+
+    // 사용자/메모 목록을 파티션으로 나눠서 읽음 (샤드 모드면 샤드 수만큼, 아니면 잠금 수만큼)
+    store_set_partition_count(g_server_config.shard_count > 0 ? g_server_config.shard_count : STORE_LOCK_STRIPES);
+    user_init();
+    memo_init();
+
+    // 서버 소켓 생성 (넘겨받았으면 그대로 사용, 샤드 1부터의 리스너는 이벤트 루프가 넘겨받은 것을 사용)
+    if (adopted)
+    {
+        g_serv_sock = inherited.tcp_fds[0];
+        g_local_sock = inherited.local_fd;
+        event_loop_adopt_listeners(inherited.tcp_fds, inherited.tcp_count);
+        // 이번 실행에서 로컬 소켓을 쓰지 않으면 넘겨받은 로컬 리스너는 닫음
+        if (g_local_sock != INVALID_SOCKET && !g_server_config.unix_socket_path)
+        {
+            closesocket(g_local_sock);
+            g_local_sock = INVALID_SOCKET;
+        }
+    }
+    else
+    {
+        g_serv_sock = open_tcp_listener();
+        if (g_serv_sock == INVALID_SOCKET)
+            return 1;
+    }
+
+    // 같은 호스트의 클라이언트용 로컬 서버 소켓
+    if (g_server_config.unix_socket_path && g_local_sock == INVALID_SOCKET)
+    {
+        g_local_sock = open_local_listener(g_server_config.unix_socket_path);
+        if (g_local_sock == INVALID_SOCKET)
+        {
+            closesocket(g_serv_sock);
+            return 1;
+        }
+    }
+
+    // 같은 호스트의 클라이언트용 공유 메모리 링 (채널 스레드가 이벤트 루프와 별도로 요청을 처리)
+    if (g_server_config.shm_name && !shm_server_start(g_server_config.shm_name))
+    {
+        shutdown_server();
+        return 1;
+    }
+
+    // 새 프로세스의 요청을 받으면 연결을 정리하고 리스너를 넘겨줌
+    if (g_server_config.handoff_path && !handoff_listen(g_server_config.handoff_path, g_server_config.shard_count, begin_handoff))
+        logger_write(LOG_LEVEL_WARN, "[서버] 재시작 제어 소켓 없이 실행합니다. (무중단 재시작 불가)");
+
+    logger_write(LOG_LEVEL_INFO, "[서버] 클라이언트 연결 대기 중... (Ctrl+C로 종료)");
+
+    // 모든 연결을 epoll 이벤트 루프에서 처리
+    int result = event_loop_run(g_serv_sock, g_local_sock == INVALID_SOCKET ? -1 : g_local_sock);
+
+    logger_write(LOG_LEVEL_INFO, "[서버] 종료 신호 수신. 서버를 안전하게 종료합니다...");
+    // 저장하기 전에 공유 메모리 채널 스레드가 처리 중인 요청을 마치고 멈추도록 함
+    shm_server_stop();
+    // 링에 남은 로그를 모두 출력한 뒤 저장/정리 메시지 출력
+    logger_stop();
+    shutdown_server();
+    return result == 0 ? 0 : 1;
+}
+#endif
+
+#ifdef _WIN32
+// 연결 하나의 유휴 시간 타이머 (연결 스레드의 스택에 두고 g_idle_wheel에 등록)
+// 연결 스레드는 recv에서 잠들어 있으므로 타이머 스레드가 대신 만료를 확인하고,
+// 유휴 시간이 지나면 소켓을 shutdown해서 연결 스레드의 recv가 실패하며 정리되게 한다.
+typedef struct
+{
+    TimerNode node;                 // 타이머 휠 노드 (반드시 첫 멤버)
+    SOCKET sock;                    // 클라이언트 소켓
+    unsigned long long last_active; // 마지막으로 요청을 받거나 응답을 보낸 시각 (원자적으로 접근)
+    int busy;                       // 워커가 요청을 처리 중이면 1 (원자적으로 접근)
+    unsigned long long last_ping;   // 마지막으로 연결 확인 프레임을 보낸 시각 (g_idle_lock 보호)
+    bool keepalive;                 // HELLO로 연결 확인 프레임(PING)을 협상했는지 여부 (g_idle_lock 보호)
+    ps_mutex_t send_lock;           // 응답과 연결 확인 프레임이 섞이지 않도록 전송을 직렬화
+} ClientTimer;
+
+static TimerWheel g_idle_wheel;    // 모든 연결의 유휴 시간 타이머
+static ps_mutex_t g_idle_lock;     // g_idle_wheel 보호
+static bool g_idle_timers = false; // 유휴 시간 종료 또는 연결 확인을 사용하는지 여부
+
+// 연결의 다음 확인 시각 등록 (g_idle_lock을 잡은 상태에서 호출)
+static void schedule_client_timer(ClientTimer *timer, unsigned long long last_active)
+{
+    unsigned long long due = ULLONG_MAX;
+    if (g_server_config.idle_timeout_sec > 0)
+        due = last_active + (unsigned long long)g_server_config.idle_timeout_sec * 1000;
+    if (timer->keepalive)
+    {
+        unsigned long long quiet_since = last_active > timer->last_ping ? last_active : timer->last_ping;
+        unsigned long long ping_at = quiet_since + (unsigned long long)g_server_config.keepalive_sec * 1000;
+        if (ping_at < due)
+            due = ping_at;
+    }
+    if (due != ULLONG_MAX)
+        timer_wheel_schedule(&g_idle_wheel, &timer->node, due);
+}
+
+// 타이머 만료 (타이머 스레드가 g_idle_lock을 잡은 상태에서 호출)
+// 요청을 받을 때는 시각만 기록하므로 만료되면 실제로 조용했던 시간을 다시 계산한다.
+static void client_timer_fired(TimerNode *node)
+{
+    ClientTimer *timer = (ClientTimer *)node;
+    unsigned long long now = ps_now_ms();
+    unsigned long long last_active = __atomic_load_n(&timer->last_active, __ATOMIC_RELAXED);
+    if (__atomic_load_n(&timer->busy, __ATOMIC_RELAXED))
+        last_active = now;
+
+    if (g_server_config.idle_timeout_sec > 0 &&
+        now - last_active >= (unsigned long long)g_server_config.idle_timeout_sec * 1000)
+    {
+        // 연결 스레드가 recv에서 깨어나 연결을 정리함 (타이머는 다시 등록하지 않음)
+        logger_write(LOG_LEVEL_INFO, "[서버] 클라이언트 %llu 유휴 시간 초과로 연결 종료", timer->sock);
+        shutdown(timer->sock, SD_BOTH);
+        return;
+    }
+
+    // 연결 스레드가 응답을 보내는 중이면 이번 확인은 건너뜀 (타이머 스레드가 전송을 기다리지 않도록)
+    unsigned long long quiet_since = last_active > timer->last_ping ? last_active : timer->last_ping;
+    if (timer->keepalive && now - quiet_since >= (unsigned long long)g_server_config.keepalive_sec * 1000 &&
+        ps_mutex_trylock(&timer->send_lock))
+    {
+        frame_send_ex(timer->sock, FRAME_FLAG_KEEPALIVE, 0, "", 0);
+        ps_mutex_unlock(&timer->send_lock);
+        timer->last_ping = now;
+    }
+    schedule_client_timer(timer, last_active);
+}
+
+// 타이머 스레드: 틱마다 휠을 진행하며 만료된 연결 처리
+static DWORD WINAPI idle_timer_thread(LPVOID arg)
+{
+    (void)arg;
+    while (true)
+    {
+        Sleep(IDLE_TICK_MS);
+        ps_mutex_lock(&g_idle_lock);
+        timer_wheel_advance(&g_idle_wheel, ps_now_ms());
+        ps_mutex_unlock(&g_idle_lock);
+    }
+    return 0;
+}
+
+// 유휴 시간 관리를 사용하면 타이머 스레드 시작
+static void start_idle_timers(void)
+{
+    g_idle_timers = g_server_config.idle_timeout_sec > 0 || g_server_config.keepalive_sec > 0;
+    if (!g_idle_timers)
+        return;
+    ps_mutex_init(&g_idle_lock);
+    timer_wheel_init(&g_idle_wheel, ps_now_ms(), IDLE_TICK_MS);
+    CreateThread(NULL, 0, idle_timer_thread, NULL, 0, NULL);
+}
+
+// 클라이언트 스레드가 워커에게 넘기고 완료를 기다리는 요청
+typedef struct
+{
+    WorkerTask task;     // 워커 풀 작업 (반드시 첫 멤버)
+    const char *request; // 요청 문자열
+    size_t request_len;  // 요청 길이 (바이너리 요청은 null 문자를 포함할 수 있음)
+    bool binary;         // 바이너리 요청 여부
+    RateLimit limit;     // 연결의 요청 빈도 제한 버킷
+    unsigned long long queued_us; // 워커 대기열에 넣은 시각 (부하 조절의 체류 시간 기준)
+    unsigned long long deadline_ms; // 기한 (요청을 받은 시각 + 프레임의 제한 시간, 0이면 없음)
+    ReplyBuffer reply;   // 워커가 채우는 응답
+    bool keep_open;      // EXIT가 아니면 true
+    bool done;           // 처리 완료 여부
+    ps_mutex_t lock;     // 완료 대기용 뮤텍스
+    ps_cond_t cond;      // 완료 알림
+} SyncRequest;
+
+// 워커 스레드: 요청 처리 후 기다리는 클라이언트 스레드를 깨움
+static void run_sync_request(WorkerTask *task)
+{
+    SyncRequest *req = (SyncRequest *)task;
+    bool keep_open = true;
+    load_shed_observe(req->queued_us);
+    if (req->binary)
+        dispatch_binary_command(req->request, req->request_len, &req->reply, &req->limit, req->deadline_ms);
+    else
+        keep_open = dispatch_command(req->request, &req->reply, &req->limit, req->deadline_ms);
+    ps_mutex_lock(&req->lock);
+    req->keep_open = keep_open;
+    req->done = true;
+    ps_cond_signal(&req->cond);
+    ps_mutex_unlock(&req->lock);
+}
+
+// 통신 방식에 맞춰 응답 전송 (프레임 방식이면 길이 헤더와 요청 ID를 붙임)
+static bool send_client_reply(SOCKET sock, bool framed, const FrameHeader *request, const char *reply, size_t len)
+{
+    if (framed)
+        return frame_send_ex(sock, request->flags & FRAME_FLAG_REQUEST_ID, request->request_id, reply, len);
+    return send(sock, reply, (int)len, 0) == (int)len;
+}
+
+// 클라이언트 연결 하나의 요청을 차례로 처리 (요청 수신/응답 송신만 담당하고 명령어 처리는 워커에게 맡김)
+// - local: 로컬(AF_UNIX) 소켓 연결 여부 (로컬 소켓은 프레임 방식 클라이언트만 사용하므로 첫 바이트를 확인하지 않음)
+static void serve_client(SOCKET sock, bool local)
+{
+    // 수신 버퍼
+    ReplyBuffer buffer;
+    reply_init(&buffer);
+    // 워커 요청
+    SyncRequest req;
+    req.task.run = run_sync_request;
+    memset(&req.limit, 0, sizeof(req.limit));
+    reply_init(&req.reply);
+    ps_mutex_init(&req.lock);
+    ps_cond_init(&req.cond);
+    // 유휴 시간 타이머 등록
+    ClientTimer timer = {0};
+    timer.sock = sock;
+    timer.last_active = ps_now_ms();
+    ps_mutex_init(&timer.send_lock);
+    timer_init(&timer.node, client_timer_fired);
+    if (g_idle_timers)
+    {
+        ps_mutex_lock(&g_idle_lock);
+        timer.last_ping = timer.last_active;
+        schedule_client_timer(&timer, timer.last_active);
+        ps_mutex_unlock(&g_idle_lock);
+    }
+
+    logger_write(LOG_LEVEL_INFO, "[서버] 클라이언트 %llu 연결됨", sock);
+
+    // 연결마다 스레드가 블로킹 전송을 하므로 응답을 읽지 않는 클라이언트가 스레드(와 연결 확인 타이머)를 붙잡지 않도록
+    // 송신 버퍼가 SEND_TIMEOUT_MS 동안 비지 않으면 전송을 실패시켜 연결을 닫음 (Linux는 송신 대기열, output_pool.h)
+    DWORD send_timeout = SEND_TIMEOUT_MS;
+    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, (const char *)&send_timeout, sizeof(send_timeout));
+
+    // 첫 바이트로 통신 방식 판별 (길이 헤더가 없는 이전 클라이언트도 지원)
+    unsigned char first;
+    bool framed = local || (recv(sock, (char *)&first, 1, MSG_PEEK) == 1 && first == FRAME_MAGIC);
+    // HELLO로 바이너리 프로토콜을 협상했는지 여부
+    bool binary = false;
+    bool greeted = false;
 
     // 클라이언트 연결 유지
+    // (연결마다 스레드 하나가 요청을 차례로 처리하므로 요청 ID가 있어도 순서대로 응답한다)
     while (true)
     {
-        // 클라이언트로부터 데이터 수신
-        int bytes = recv(sock, buffer, sizeof(buffer) - 1, 0);
+        // 클라이언트로부터 요청 하나 수신
+        bool received;
+        FrameHeader header = {0};
+        if (framed)
+        {
+            received = frame_recv_ex(sock, &buffer, &header);
+        }
+        else
+        {
+            received = reply_reserve(&buffer, BUF_SIZE);
+            int bytes = received ? recv(sock, buffer.data, BUF_SIZE - 1, 0) : 0;
+            received = bytes > 0;
+            buffer.len = received ? (size_t)bytes : 0;
+            if (buffer.data)
+                buffer.data[buffer.len] = '\0';
+        }
         // 수신 실패 시
-        if (bytes <= 0)
+        if (!received)
         {
-            printf("[서버] 클라이언트 %llu 연결 해제됨\n", sock);
+            logger_write(LOG_LEVEL_INFO, "[서버] 클라이언트 %llu 연결 해제됨", sock);
             break;
         }
-        // 버퍼 끝에 null 문자 추가
-        buffer[bytes] = '\0';
-        // 수신 데이터 출력
-        printf("[서버] 클라이언트 %llu 수신: %s\n", sock, buffer);
-
-        // "EXIT" 명령어 처리
-        if (strcmp(buffer, "EXIT") == 0)
+        __atomic_store_n(&timer.last_active, ps_now_ms(), __ATOMIC_RELAXED);
+        // 첫 요청이 HELLO면 워커를 거치지 않고 바로 프로토콜 협상
+        if (framed && !greeted)
         {
-            printf("[서버] 클라이언트 %llu 정상 종료 요청\n", sock);
-            // 클라이언트에게 정상적으로 응답을 보내고 루프를 탈출
-            snprintf(reply, sizeof(reply), "OK:서버와 연결을 종료합니다.");
-            // 응답 전송
-            send(sock, reply, strlen(reply), 0);
-            break;
+            greeted = true;
+            bool ping = false;
+            if (dispatch_hello(reply_str(&buffer), &req.reply, &binary, g_server_config.keepalive_sec > 0 ? &ping : NULL))
+            {
+                // 타이머 스레드가 읽으므로 잠근 상태에서 기록
+                if (ping && g_idle_timers)
+                {
+                    ps_mutex_lock(&g_idle_lock);
+                    timer.keepalive = true;
+                    schedule_client_timer(&timer, timer.last_active);
+                    ps_mutex_unlock(&g_idle_lock);
+                }
+                ps_mutex_lock(&timer.send_lock);
+                send_client_reply(sock, framed, &header, reply_str(&req.reply), req.reply.len);
+                ps_mutex_unlock(&timer.send_lock);
+                continue;
+            }
         }
 
-        // 명령어에 따라 핸들러 분기
-        if (strncmp(buffer, "MEMO_", 5) == 0 ||
-            strncmp(buffer, "DOWNLOAD_ALL", 12) == 0 ||
-            strncmp(buffer, "DOWNLOAD_SINGLE", 15) == 0)
+        // 수신 데이터 기록 (로거 링에 남기기만 하고 출력은 기록 스레드가 함)
+        req.binary = binary && is_binary_request(reply_str(&buffer), buffer.len);
+        dispatch_log_request("클라이언트", (long long)sock, reply_str(&buffer), buffer.len, req.binary);
+
+        // 워커에게 명령어 처리 요청
+        req.request = reply_str(&buffer);
+        req.request_len = buffer.len;
+        req.done = false;
+        req.queued_us = load_shed_enabled() ? ps_now_us() : 0;
+        req.deadline_ms = header.timeout_ms ? ps_now_ms() + header.timeout_ms : 0;
+        // 내보내기/검색/회원 탈퇴는 낮은 우선순위 대기열로 넘겨 다른 연결의 조회가 뒤에서 기다리지 않게 함
+        WorkerLane lane = dispatch_is_bulk(req.request, req.request_len, req.binary) ? WORKER_LANE_BULK
+                                                                                    : WORKER_LANE_INTERACTIVE;
+        if (!worker_pool_submit(&req.task, lane))
         {
-            // 메모 명령어 처리
-            handle_memo_command(buffer, reply, sizeof(reply));
+            // 대기열이 가득 찬 경우 과부하 응답
+            ps_mutex_lock(&timer.send_lock);
+            send_client_reply(sock, framed, &header, REPLY_BUSY, strlen(REPLY_BUSY));
+            ps_mutex_unlock(&timer.send_lock);
+            continue;
         }
-        else
+        // 처리 완료 대기 (처리 중에는 유휴 시간으로 치지 않음)
+        __atomic_store_n(&timer.busy, 1, __ATOMIC_RELAXED);
+        ps_mutex_lock(&req.lock);
+        while (!req.done)
         {
-            // 사용자 명령어 처리
-            handle_user_command(buffer, reply, sizeof(reply));
+            ps_cond_wait(&req.cond, &req.lock);
         }
+        ps_mutex_unlock(&req.lock);
+        bool keep_open = req.keep_open;
 
         // 응답 전송
-        send(sock, reply, strlen(reply), 0);
+        ps_mutex_lock(&timer.send_lock);
+        send_client_reply(sock, framed, &header, reply_str(&req.reply), req.reply.len);
+        ps_mutex_unlock(&timer.send_lock);
+        __atomic_store_n(&timer.last_active, ps_now_ms(), __ATOMIC_RELAXED);
+        __atomic_store_n(&timer.busy, 0, __ATOMIC_RELAXED);
+
+        // "EXIT" 명령어 처리
+        if (!keep_open)
+        {
+            logger_write(LOG_LEVEL_INFO, "[서버] 클라이언트 %llu 정상 종료 요청", sock);
+            break;
+        }
     }
 
+    // 타이머 해제 (타이머 스레드가 잠금을 잡고 콜백을 실행하므로, 해제 후에는 이 연결에 접근하지 않음)
+    if (g_idle_timers)
+    {
+        ps_mutex_lock(&g_idle_lock);
+        timer_wheel_cancel(&g_idle_wheel, &timer.node);
+        ps_mutex_unlock(&g_idle_lock);
+    }
+    ps_mutex_destroy(&timer.send_lock);
+
     // 클라이언트 소켓 닫기
     closesocket(sock);
+    reply_free(&buffer);
+    reply_free(&req.reply);
+    ps_cond_destroy(&req.cond);
+    ps_mutex_destroy(&req.lock);
+    // 연결 스레드가 끝나므로 로그 링을 다음 스레드가 쓰도록 반납
+    logger_thread_detach();
+}
+
+// 클라이언트 처리 스레드 (TCP)
+DWORD WINAPI handle_client(LPVOID client_socket)
+{
+    serve_client((SOCKET)(ULONG_PTR)client_socket, false);
+    return 0;
+}
+
+// 클라이언트 처리 스레드 (로컬 소켓)
+DWORD WINAPI handle_local_client(LPVOID client_socket)
+{
+    serve_client((SOCKET)(ULONG_PTR)client_socket, true);
+    return 0;
+}
+
+// 로컬 서버 소켓의 연결 수락 스레드 (TCP 연결은 메인 스레드가 수락)
+DWORD WINAPI accept_local_clients(LPVOID arg)
+{
+    (void)arg;
+    while (true)
+    {
+        SOCKET client_sock = accept(g_local_sock, NULL, NULL);
+        if (client_sock == INVALID_SOCKET)
+        {
+            // 서버 종료로 소켓이 닫힌 경우
+            if (g_local_sock == INVALID_SOCKET || WSAGetLastError() == WSAENOTSOCK || WSAGetLastError() == WSAEINTR)
+                break;
+            logger_write(LOG_LEVEL_ERROR, "[서버] 로컬 소켓 accept() 실패");
+            continue;
+        }
+        CreateThread(NULL, 0, handle_local_client, (LPVOID)client_sock, 0, NULL);
+    }
     return 0;
 }
+#endif
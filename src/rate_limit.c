@@ -0,0 +1,121 @@
+// src/rate_limit.c
+
+#include "rate_limit.h"
+#include "platform.h"
+
+#define DEFICIT_BITS 24                                // 상태 값에서 부족한 토큰 수가 차지하는 하위 비트 수
+#define DEFICIT_MASK ((1ULL << DEFICIT_BITS) - 1)
+#define TIME_MASK ((1ULL << (64 - DEFICIT_BITS)) - 1)  // 충전 시각 40비트 (밀리초, 약 34년)
+#define TOKEN_UNIT 1000ULL                             // 토큰 하나 (1/1000 단위로 세어 느린 충전 속도도 표현)
+
+// 종류별 예산 (시작 시 설정한 뒤에는 읽기만 함)
+static uint64_t g_refill_per_ms[RATE_CLASS_COUNT]; // 1밀리초에 채워지는 토큰 수 (1/1000 단위 = 초당 개수)
+static uint64_t g_capacity[RATE_CLASS_COUNT];      // 버킷 크기 (1/1000 단위, 0이면 제한 안 함)
+static bool g_enabled = false;                     // 제한하는 종류가 있는지 여부
+static uint64_t g_epoch_ms = 0;                    // 버킷 시각의 기준 (상태 값에는 이 시각부터 지난 시간을 담음)
+
+// 사용자 버킷 테이블 (사용자 ID 해시로 칸을 고름)
+static RateBucket g_user_buckets[RATE_USER_SLOTS][RATE_CLASS_COUNT];
+
+// 종류별 예산 설정
+void rate_limit_configure(RateClass rate_class, int per_sec, int burst)
+{
+    if (g_epoch_ms == 0)
+        g_epoch_ms = ps_now_ms();
+    if (per_sec <= 0)
+    {
+        g_capacity[rate_class] = 0;
+        g_refill_per_ms[rate_class] = 0;
+    }
+    else
+    {
+        if (burst <= 0)
+            burst = per_sec;
+        if (burst > RATE_MAX_BURST)
+            burst = RATE_MAX_BURST;
+        g_capacity[rate_class] = (uint64_t)burst * TOKEN_UNIT;
+        g_refill_per_ms[rate_class] = (uint64_t)per_sec;
+    }
+    g_enabled = false;
+    for (int i = 0; i < RATE_CLASS_COUNT; i++)
+    {
+        if (g_capacity[i] > 0)
+            g_enabled = true;
+    }
+}
+
+// 제한 사용 여부
+bool rate_limit_enabled(void)
+{
+    return g_enabled;
+}
+
+// 종류 이름
+const char *rate_class_name(RateClass rate_class)
+{
+    switch (rate_class)
+    {
+    case RATE_CLASS_READ:
+        return "read";
+    case RATE_CLASS_WRITE:
+        return "write";
+    case RATE_CLASS_BULK:
+        return "bulk";
+    default:
+        return "?";
+    }
+}
+
+// 버킷에서 토큰 하나 차감 (지난 시간만큼 먼저 충전)
+// 충전과 차감을 새 상태 값 하나로 계산해서 compare-and-swap하고, 그 사이 다른 스레드가 바꿨으면 다시 계산한다.
+static bool take_token(RateBucket *bucket, RateClass rate_class, uint64_t now)
+{
+    uint64_t capacity = g_capacity[rate_class];
+    uint64_t refill = g_refill_per_ms[rate_class];
+    uint64_t old = __atomic_load_n(&bucket->state, __ATOMIC_RELAXED);
+    while (true)
+    {
+        uint64_t last = old >> DEFICIT_BITS;
+        uint64_t deficit = old & DEFICIT_MASK;
+        // 다른 스레드가 더 늦은 시각으로 갱신했으면 그 시각 기준으로 계산
+        if (now > last)
+        {
+            uint64_t elapsed = now - last;
+            // 가득 찰 만큼 지났으면 곱셈 없이 비움 (오래 쉰 버킷의 곱셈 넘침 방지)
+            deficit = elapsed >= capacity ? 0 : (elapsed * refill >= deficit ? 0 : deficit - elapsed * refill);
+            last = now;
+        }
+        if (deficit + TOKEN_UNIT > capacity)
+            return false;
+        uint64_t next = (last << DEFICIT_BITS) | (deficit + TOKEN_UNIT);
+        if (__atomic_compare_exchange_n(&bucket->state, &old, next, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            return true;
+    }
+}
+
+// 사용자 ID가 쓰는 버킷 테이블 칸 (FNV-1a 해시)
+static RateBucket *user_bucket(const char *user_id, size_t len, RateClass rate_class)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++)
+    {
+        hash ^= (unsigned char)user_id[i];
+        hash *= 16777619u;
+    }
+    // 아래 비트만 쓰면 바이트의 아래 비트가 같은 ID끼리 몰리므로 위 비트를 섞어서 칸을 고름 (store_partition.c와 같음)
+    hash ^= hash >> 16;
+    return &g_user_buckets[hash & (RATE_USER_SLOTS - 1)][rate_class];
+}
+
+// 요청 하나에 쓸 토큰 차감
+bool rate_limit_acquire(RateLimit *limit, const char *user_id, size_t len, RateClass rate_class)
+{
+    if (g_capacity[rate_class] == 0)
+        return true;
+    uint64_t now = (ps_now_ms() - g_epoch_ms) & TIME_MASK;
+    if (limit && !take_token(&limit->buckets[rate_class], rate_class, now))
+        return false;
+    if (user_id && !take_token(user_bucket(user_id, len, rate_class), rate_class, now))
+        return false;
+    return true;
+}
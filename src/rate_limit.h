@@ -0,0 +1,63 @@
+// src/rate_limit.h
+
+#ifndef RATE_LIMIT_H
+#define RATE_LIMIT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 요청 빈도 제한 (토큰 버킷)
+//
+// 명령을 비용에 따라 세 종류로 나누고, 종류마다 초당 허용 개수(충전 속도)와 한 번에 몰아 쓸 수 있는 개수(버스트)를 둔다.
+// 요청 하나는 사용자의 버킷과 연결의 버킷에서 토큰을 하나씩 써야 처리된다.
+//  - 사용자 버킷: 한 사용자가 연결을 여러 개 열어도 같은 예산을 나눠 씀
+//  - 연결 버킷: 한 연결이 여러 사용자 ID를 바꿔 가며 보내도 예산을 넘지 못함
+//
+// 버킷 하나는 [마지막 충전 시각 40비트 | 부족한 토큰 수(1/1000 단위) 24비트]를 담은 64비트 값 하나이고,
+// 충전과 차감을 한 번의 compare-and-swap으로 하므로 잠금 없이 여러 스레드(워커, 샤드)에서 동시에 사용할 수 있다.
+// 0으로 채운 버킷은 가득 찬 버킷이므로 연결 구조체를 calloc/memset으로 만들면 따로 초기화하지 않아도 된다.
+// 사용자 버킷은 사용자 ID 해시로 고른 고정 크기 테이블의 칸이며, 해시가 겹친 사용자는 예산을 함께 쓴다.
+
+#define RATE_MAX_BURST 10000   // 버스트 최대값 (부족한 토큰 수 24비트에 들어가야 함)
+#define RATE_USER_SLOTS 4096   // 사용자 버킷 테이블 칸 수 (2의 거듭제곱)
+
+// 명령 종류
+typedef enum
+{
+    RATE_CLASS_READ,  // 가벼운 조회 (MEMO_LIST, MEMO_LIST_BY_MONTH, MEMO_VIEW, DOWNLOAD_SINGLE)
+    RATE_CLASS_WRITE, // 변경 (MEMO_ADD/UPDATE/DELETE, LOGIN, LOGOUT, REGISTER, UPDATE_PW)
+    RATE_CLASS_BULK,  // 무거운 일괄 작업 (MEMO_SEARCH, DOWNLOAD_ALL, DELETE_USER)
+    RATE_CLASS_COUNT
+} RateClass;
+
+// 버킷 하나 (원자적으로만 접근)
+typedef struct
+{
+    uint64_t state;
+} RateBucket;
+
+// 연결 하나의 버킷들 (연결 상태 구조체에 멤버로 둠, 0으로 채우면 가득 찬 상태)
+typedef struct
+{
+    RateBucket buckets[RATE_CLASS_COUNT];
+} RateLimit;
+
+// 종류별 예산 설정 (서버 시작 시 한 번, per_sec가 0이면 그 종류는 제한하지 않음)
+// burst가 0이면 per_sec와 같은 값을 사용한다.
+void rate_limit_configure(RateClass rate_class, int per_sec, int burst);
+
+// 제한하는 종류가 하나라도 있는지 여부 (없으면 요청을 해석하지 않고 바로 처리)
+bool rate_limit_enabled(void);
+
+// 종류 이름("read", "write", "bulk")
+const char *rate_class_name(RateClass rate_class);
+
+// 요청 하나에 쓸 토큰을 연결 버킷과 사용자 버킷에서 차감
+// - limit: 연결의 버킷 (NULL이면 사용자 버킷만 확인)
+// - user_id/len: 요청이 다루는 사용자 (NULL이면 연결 버킷만 확인)
+// 반환값: 처리해도 되면 true, 예산을 넘었으면 false (연결 버킷을 통과하고 사용자 버킷에서 막힌 경우에도
+// 연결 버킷의 토큰은 돌려주지 않는다. 막힌 요청을 계속 보내는 연결도 그만큼 예산을 쓴 것으로 본다.)
+bool rate_limit_acquire(RateLimit *limit, const char *user_id, size_t len, RateClass rate_class);
+
+#endif
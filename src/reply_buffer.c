@@ -0,0 +1,231 @@
+// src/reply_buffer.c
+
+#include "reply_buffer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+
+#define REPLY_INITIAL_CAP 256 // 첫 할당 크기
+#define REPLY_REF_MIN 16      // 이보다 짧은 외부 바이트는 복사 (조각 하나를 기록하는 비용이 그만큼 복사하는 것과 비슷함)
+
+// 최소 need 바이트(null 문자 포함)를 담을 수 있도록 버퍼 확장
+static bool reply_grow(ReplyBuffer *reply, size_t need)
+{
+    if (need <= reply->cap)
+        return true;
+    // 두 배씩 늘려 재할당 횟수를 줄임
+    size_t new_cap = reply->cap ? reply->cap : REPLY_INITIAL_CAP;
+    while (new_cap < need)
+    {
+        new_cap *= 2;
+    }
+    char *new_data = (char *)realloc(reply->data, new_cap);
+    if (!new_data)
+        return false;
+    reply->data = new_data;
+    reply->cap = new_cap;
+    return true;
+}
+
+// 배열이 count + 1개를 담을 수 있도록 확장 (외부 조각, 붙잡은 객체 배열 공용)
+static bool grow_array(void **items, int *cap, int count, size_t item_size)
+{
+    if (count < *cap)
+        return true;
+    int new_cap = *cap ? *cap * 2 : 8;
+    void *grown = realloc(*items, (size_t)new_cap * item_size);
+    if (!grown)
+        return false;
+    *items = grown;
+    *cap = new_cap;
+    return true;
+}
+
+// 붙잡은 객체를 모두 놓아줌
+static void release_holds(ReplyBuffer *reply)
+{
+    for (int i = 0; i < reply->hold_count; i++)
+    {
+        reply->holds[i].release(reply->holds[i].obj);
+    }
+    reply->hold_count = 0;
+}
+
+// 빈 버퍼로 초기화
+void reply_init(ReplyBuffer *reply)
+{
+    reply->data = NULL;
+    reply->len = 0;
+    reply->cap = 0;
+    reply->gather = false;
+    reply->refs = NULL;
+    reply->ref_count = 0;
+    reply->ref_cap = 0;
+    reply->ref_len = 0;
+    reply->holds = NULL;
+    reply->hold_count = 0;
+    reply->hold_cap = 0;
+}
+
+// 버퍼 메모리 해제
+void reply_free(ReplyBuffer *reply)
+{
+    bool gather = reply->gather;
+    release_holds(reply);
+    free(reply->data);
+    free(reply->refs);
+    free(reply->holds);
+    reply_init(reply);
+    reply->gather = gather;
+}
+
+// 내용만 비움
+void reply_clear(ReplyBuffer *reply)
+{
+    reply->len = 0;
+    if (reply->data)
+        reply->data[0] = '\0';
+    reply->ref_count = 0;
+    reply->ref_len = 0;
+    release_holds(reply);
+}
+
+// 현재 내용 뒤에 extra 바이트를 더 쓸 수 있도록 공간 확보
+bool reply_reserve(ReplyBuffer *reply, size_t extra)
+{
+    if (!reply_grow(reply, reply->len + extra + 1))
+        return false;
+    reply->data[reply->len] = '\0';
+    return true;
+}
+
+// 버퍼 끝에 데이터 추가
+bool reply_append(ReplyBuffer *reply, const char *data, size_t len)
+{
+    if (!reply_grow(reply, reply->len + len + 1))
+        return false;
+    memcpy(reply->data + reply->len, data, len);
+    reply->len += len;
+    reply->data[reply->len] = '\0';
+    return true;
+}
+
+// 가변 인자 목록을 버퍼 끝에 추가
+static bool reply_vprintf(ReplyBuffer *reply, const char *format, va_list args)
+{
+    // 필요한 길이 계산
+    va_list copy;
+    va_copy(copy, args);
+    int needed = vsnprintf(NULL, 0, format, copy);
+    va_end(copy);
+    if (needed < 0)
+        return false;
+    // 공간 확보 후 출력
+    if (!reply_grow(reply, reply->len + (size_t)needed + 1))
+        return false;
+    vsnprintf(reply->data + reply->len, (size_t)needed + 1, format, args);
+    reply->len += (size_t)needed;
+    return true;
+}
+
+// 버퍼 끝에 printf 형식으로 추가
+bool reply_printf(ReplyBuffer *reply, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    bool ok = reply_vprintf(reply, format, args);
+    va_end(args);
+    return ok;
+}
+
+// 기존 내용을 지우고 printf 형식으로 설정
+bool reply_set(ReplyBuffer *reply, const char *format, ...)
+{
+    reply_clear(reply);
+    va_list args;
+    va_start(args, format);
+    bool ok = reply_vprintf(reply, format, args);
+    va_end(args);
+    return ok;
+}
+
+// 버퍼 내용을 문자열로 반환
+const char *reply_str(const ReplyBuffer *reply)
+{
+    return reply->data ? reply->data : "";
+}
+
+// 외부 바이트를 복사하지 않고 버퍼 끝에 붙임
+bool reply_append_ref(ReplyBuffer *reply, const char *data, size_t len)
+{
+    if (!reply->gather || len < REPLY_REF_MIN)
+        return reply_append(reply, data, len);
+    // 바로 앞 조각에 메모리상으로 이어지면 합침
+    if (reply->ref_count > 0)
+    {
+        ReplyRef *last = &reply->refs[reply->ref_count - 1];
+        if (last->at == reply->len && last->ptr + last->len == data)
+        {
+            last->len += len;
+            reply->ref_len += len;
+            return true;
+        }
+    }
+    if (!grow_array((void **)&reply->refs, &reply->ref_cap, reply->ref_count, sizeof(ReplyRef)))
+        return false;
+    ReplyRef *ref = &reply->refs[reply->ref_count++];
+    ref->at = reply->len;
+    ref->ptr = data;
+    ref->len = len;
+    reply->ref_len += len;
+    return true;
+}
+
+// 응답을 비우거나 해제할 때까지 객체를 붙잡아 둠
+bool reply_hold(ReplyBuffer *reply, void *obj, void (*release)(void *obj))
+{
+    if (!grow_array((void **)&reply->holds, &reply->hold_cap, reply->hold_count, sizeof(ReplyHold)))
+        return false;
+    reply->holds[reply->hold_count].obj = obj;
+    reply->holds[reply->hold_count].release = release;
+    reply->hold_count++;
+    return true;
+}
+
+// 외부 조각을 포함한 응답 전체 길이
+size_t reply_total_len(const ReplyBuffer *reply)
+{
+    return reply->len + reply->ref_len;
+}
+
+// 응답 조각 최대 개수 (외부 조각마다 그 앞의 직접 쓴 부분이 하나씩, 마지막에 남은 부분 하나)
+int reply_piece_count(const ReplyBuffer *reply)
+{
+    return reply->ref_count * 2 + 1;
+}
+
+// 응답 조각을 순서대로 하나씩 반환
+// *pos가 짝수면 (pos / 2)번째 외부 조각 앞의 직접 쓴 부분, 홀수면 그 외부 조각이며, 빈 부분은 건너뛴다.
+const char *reply_next_piece(const ReplyBuffer *reply, int *pos, size_t *len)
+{
+    while (*pos <= reply->ref_count * 2)
+    {
+        int index = *pos / 2;
+        bool external = (*pos % 2) != 0;
+        (*pos)++;
+        if (external)
+        {
+            *len = reply->refs[index].len;
+            return reply->refs[index].ptr;
+        }
+        size_t from = index == 0 ? 0 : reply->refs[index - 1].at;
+        size_t to = index < reply->ref_count ? reply->refs[index].at : reply->len;
+        if (to > from)
+        {
+            *len = to - from;
+            return reply->data + from;
+        }
+    }
+    return NULL;
+}
@@ -0,0 +1,84 @@
+// src/reply_buffer.h
+
+#ifndef REPLY_BUFFER_H
+#define REPLY_BUFFER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// 응답 중간에 복사하지 않고 끼워 넣은 외부 바이트 (data의 at 위치 앞에 들어감)
+typedef struct
+{
+    size_t at;       // 끼워 넣을 위치 (data 기준 오프셋)
+    const char *ptr; // 외부 바이트 (저장된 메모의 내용, 정적 문자열 등)
+    size_t len;      // 길이
+} ReplyRef;
+
+// 응답을 다 보낼 때까지 붙잡아 두는 객체 (응답을 비우거나 해제할 때 release 호출)
+typedef struct
+{
+    void *obj;                  // 붙잡은 객체
+    void (*release)(void *obj); // 놓아주는 함수
+} ReplyHold;
+
+// 필요한 만큼 자동으로 늘어나는 응답 문자열 버퍼
+// 고정 크기 배열과 달리 큰 월별 목록이나 전체 내보내기 결과도 잘리지 않는다.
+// data는 항상 null 문자로 끝나며, 아직 아무것도 쓰지 않았으면 NULL일 수 있다.
+//
+// 모아 보내기(gather): 전송하는 쪽이 여러 조각을 한 번에 보낼 수 있으면(writev/sendmsg) gather를 켜 둔다.
+// 그러면 reply_append_ref로 붙인 큰 외부 바이트는 복사하지 않고 위치만 기록하고,
+// 응답 내용은 data와 외부 조각을 위치 순서대로 이은 것이 된다. (reply_next_piece로 순회, 전체 길이는 reply_total_len)
+// 이때 reply_str/len은 직접 쓴 부분만 가리키므로, 모아 보내기를 켠 쪽은 조각 단위로 읽어야 한다.
+// gather가 꺼져 있으면 reply_append_ref는 reply_append와 같다. (Windows 연결 스레드, 공유 메모리 채널 등)
+typedef struct
+{
+    char *data;        // 문자열 데이터
+    size_t len;        // 문자열 길이 (null 문자 제외)
+    size_t cap;        // 할당된 크기
+    bool gather;       // 외부 바이트를 복사하지 않고 조각으로 둘지 여부 (전송하는 쪽이 정함)
+    ReplyRef *refs;    // 외부 조각 (at 순서)
+    int ref_count;     // 외부 조각 수
+    int ref_cap;       // 외부 조각 배열 크기
+    size_t ref_len;    // 외부 조각 길이 합
+    ReplyHold *holds;  // 전송이 끝날 때까지 붙잡아 둔 객체
+    int hold_count;    // 붙잡은 객체 수
+    int hold_cap;      // 붙잡은 객체 배열 크기
+} ReplyBuffer;
+
+void reply_init(ReplyBuffer *reply);  // 빈 버퍼로 초기화 (메모리 할당 없음, 모아 보내기 꺼짐)
+void reply_free(ReplyBuffer *reply);  // 버퍼 메모리 해제 (붙잡은 객체도 놓아줌, 모아 보내기 설정은 유지)
+void reply_clear(ReplyBuffer *reply); // 내용만 비움 (할당된 메모리는 재사용, 붙잡은 객체는 놓아줌)
+
+// 현재 내용 뒤에 extra 바이트를 더 쓸 수 있도록 공간 확보
+// 확보한 공간(data + len 이후)에 직접 쓴 뒤에는 호출자가 len을 늘리고 null 문자를 붙여야 한다.
+bool reply_reserve(ReplyBuffer *reply, size_t extra);
+
+// 버퍼 끝에 데이터 추가
+bool reply_append(ReplyBuffer *reply, const char *data, size_t len);
+
+// 버퍼 끝에 printf 형식으로 추가
+bool reply_printf(ReplyBuffer *reply, const char *format, ...);
+
+// 기존 내용을 지우고 printf 형식으로 설정
+bool reply_set(ReplyBuffer *reply, const char *format, ...);
+
+// 버퍼 내용을 문자열로 반환 (비어 있으면 "")
+const char *reply_str(const ReplyBuffer *reply);
+
+// 외부 바이트를 복사하지 않고 버퍼 끝에 붙임 (모아 보내기가 꺼져 있거나 짧으면 복사)
+// 응답을 보낼 때까지 바이트가 바뀌거나 해제되지 않아야 한다. (정적 문자열이거나 reply_hold로 붙잡은 객체의 바이트)
+bool reply_append_ref(ReplyBuffer *reply, const char *data, size_t len);
+
+// 응답을 비우거나 해제할 때까지 객체를 붙잡아 둠 (release는 그때 한 번 호출)
+bool reply_hold(ReplyBuffer *reply, void *obj, void (*release)(void *obj));
+
+// 외부 조각을 포함한 응답 전체 길이
+size_t reply_total_len(const ReplyBuffer *reply);
+
+// 응답 조각 최대 개수 (iovec 배열 크기 계산용)
+int reply_piece_count(const ReplyBuffer *reply);
+
+// 응답 조각을 순서대로 하나씩 반환 (*pos는 0에서 시작, 더 없으면 NULL)
+const char *reply_next_piece(const ReplyBuffer *reply, int *pos, size_t *len);
+
+#endif
@@ -0,0 +1,287 @@
+// src/server_config.c
+
+#include "server_config.h"
+#include "platform.h"
+#include "store_partition.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 전역 서버 설정 (기본값은 server_config_parse에서 채움)
+ServerConfig g_server_config;
+
+// 사용법 출력
+static void print_usage(const char *program)
+{
+    printf("사용법: %s [옵션]\n", program);
+    printf("  --workers N       명령어를 처리할 워커 스레드 수 (기본: CPU 코어 수)\n");
+    printf("  --queue-depth N   워커 대기열에 쌓일 수 있는 최대 요청 수 (기본: %d)\n", DEFAULT_QUEUE_DEPTH);
+    printf("  --bulk-workers N  DOWNLOAD_ALL, MEMO_SEARCH, DELETE_USER를 동시에 처리할 최대 워커 수 (기본: 1, 워커 수 - 1 이하)\n");
+    printf("  --io-backend B    Linux 입출력 방식: epoll 또는 io_uring (기본: epoll)\n");
+    printf("  --shards N        Linux: 코어마다 리스너/이벤트 루프/사용자 파티션을 하나씩 두는 샤드 수 (최대 %d, 기본: 사용 안 함)\n", MAX_STORE_PARTITIONS);
+    printf("  --unix-socket P   TCP와 함께 로컬(AF_UNIX) 소켓 P에서도 연결을 받음 (같은 호스트의 클라이언트용)\n");
+    printf("  --shm NAME        Linux: 공유 메모리 세그먼트 NAME('/'로 시작)의 링 버퍼로도 요청을 받음 (샤드 모드와 함께 사용 불가)\n");
+    printf("  --handoff P       Linux: 제어 소켓 P로 재시작하는 새 프로세스에게 리스너를 넘겨줌 (같은 P로 새 프로세스를 실행하면 넘겨받음)\n");
+    printf("  --idle-timeout S  요청이 S초 동안 없는 연결을 닫음 (기본: 사용 안 함)\n");
+    printf("  --keepalive S     S초 동안 조용한 연결에 연결 확인 프레임을 보냄 (HELLO에서 PING을 제시한 연결만, 기본: 사용 안 함)\n");
+    printf("  --log-level L     기록할 최소 로그 수준: debug, info, warn, error, off (기본: info)\n");
+    printf("  --rate-read N[:B] 조회(MEMO_LIST/LIST_BY_MONTH/VIEW, DOWNLOAD_SINGLE)를 사용자와 연결마다 초당 N개, 한 번에 최대 B개까지 허용\n");
+    printf("  --rate-write N[:B] 변경(MEMO_ADD/UPDATE/DELETE, LOGIN, REGISTER 등)의 초당/한 번에 허용 수\n");
+    printf("  --rate-bulk N[:B] 일괄 작업(MEMO_SEARCH, DOWNLOAD_ALL, DELETE_USER)의 초당/한 번에 허용 수\n");
+    printf("                    (B 생략 시 N과 같음, 최대 %d, 넘은 요청은 SLOW 응답, 기본: 제한 안 함)\n", RATE_MAX_BURST);
+    printf("  --shed-target MS  요청이 처리되기까지 기다린 시간이 MS밀리초를 넘은 상태가 계속되면 내보내기, 검색, 조회 순으로 BUSY 응답 (기본: 사용 안 함)\n");
+    printf("  --shed-interval MS 부하 조절 판단 간격 (기본: %d)\n", DEFAULT_SHED_INTERVAL_MS);
+    printf("  --output-high-water KB Linux: 보내지 못한 응답이 KB만큼 쌓인 연결은 클라이언트가 읽을 때까지 요청을 읽지 않음 (기본: %d)\n", DEFAULT_OUTPUT_HIGH_WATER_KB);
+    printf("  --output-cap MB   Linux: 모든 연결의 보내지 못한 응답 합의 상한, 넘기려는 연결은 닫음 (기본: %d)\n", DEFAULT_OUTPUT_CAP_MB);
+    printf("  --help            이 도움말 출력\n");
+}
+
+// 양의 정수 옵션 값 해석
+static bool parse_positive_int(const char *option, const char *value, int *out)
+{
+    // 값 누락
+    if (value == NULL)
+    {
+        printf("[서버] %s 옵션에 값이 필요합니다.\n", option);
+        return false;
+    }
+    // 숫자 변환
+    char *end = NULL;
+    long n = strtol(value, &end, 10);
+    if (*value == '\0' || *end != '\0' || n <= 0 || n > 1000000)
+    {
+        printf("[서버] %s 옵션 값이 올바르지 않습니다: %s\n", option, value);
+        return false;
+    }
+    *out = (int)n;
+    return true;
+}
+
+// 요청 빈도 제한 옵션 값("초당 개수" 또는 "초당 개수:버스트") 해석
+static bool parse_rate(const char *option, const char *value, int *per_sec, int *burst)
+{
+    if (value == NULL)
+    {
+        printf("[서버] %s 옵션에 값이 필요합니다.\n", option);
+        return false;
+    }
+    char *end = NULL;
+    long n = strtol(value, &end, 10);
+    long b = n > RATE_MAX_BURST ? RATE_MAX_BURST : n; // 버스트를 생략하면 초당 개수 (최대값까지)
+    if (*end == ':')
+    {
+        const char *burst_text = end + 1;
+        b = strtol(burst_text, &end, 10);
+        if (end == burst_text)
+            b = 0;
+    }
+    if (end == value || *end != '\0' || n <= 0 || n > 1000000 || b <= 0 || b > RATE_MAX_BURST)
+    {
+        printf("[서버] %s 옵션 값이 올바르지 않습니다: %s (초당 개수 1~1000000, 버스트 1~%d)\n", option, value,
+               RATE_MAX_BURST);
+        return false;
+    }
+    *per_sec = (int)n;
+    *burst = (int)b;
+    return true;
+}
+
+// 명령행 인자 해석
+bool server_config_parse(int argc, char *argv[])
+{
+    // 기본값 설정
+    g_server_config.worker_count = ps_cpu_count();
+    g_server_config.queue_depth = DEFAULT_QUEUE_DEPTH;
+    g_server_config.bulk_limit = 1;
+    g_server_config.io_backend = IO_BACKEND_EPOLL;
+    g_server_config.shard_count = 0;
+    g_server_config.unix_socket_path = NULL;
+    g_server_config.handoff_path = NULL;
+    g_server_config.shm_name = NULL;
+    g_server_config.idle_timeout_sec = 0;
+    g_server_config.keepalive_sec = 0;
+    g_server_config.log_level = LOG_LEVEL_INFO;
+    g_server_config.shed_target_ms = 0;
+    g_server_config.shed_interval_ms = DEFAULT_SHED_INTERVAL_MS;
+    g_server_config.output_high_water_kb = DEFAULT_OUTPUT_HIGH_WATER_KB;
+    g_server_config.output_cap_mb = DEFAULT_OUTPUT_CAP_MB;
+    for (int c = 0; c < RATE_CLASS_COUNT; c++)
+    {
+        g_server_config.rate_per_sec[c] = 0;
+        g_server_config.rate_burst[c] = 0;
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        // 다음 인자 (옵션 값)
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(argv[i], "--workers") == 0)
+        {
+            if (!parse_positive_int(argv[i], value, &g_server_config.worker_count))
+                return false;
+            i++;
+        }
+        else if (strcmp(argv[i], "--queue-depth") == 0)
+        {
+            if (!parse_positive_int(argv[i], value, &g_server_config.queue_depth))
+                return false;
+            i++;
+        }
+        else if (strcmp(argv[i], "--bulk-workers") == 0)
+        {
+            if (!parse_positive_int(argv[i], value, &g_server_config.bulk_limit))
+                return false;
+            i++;
+        }
+        else if (strcmp(argv[i], "--io-backend") == 0)
+        {
+            if (value != NULL && strcmp(value, "epoll") == 0)
+                g_server_config.io_backend = IO_BACKEND_EPOLL;
+            else if (value != NULL && strcmp(value, "io_uring") == 0)
+                g_server_config.io_backend = IO_BACKEND_IO_URING;
+            else
+            {
+                printf("[서버] %s 옵션 값은 epoll 또는 io_uring이어야 합니다.\n", argv[i]);
+                return false;
+            }
+            i++;
+        }
+        else if (strcmp(argv[i], "--shards") == 0)
+        {
+            if (!parse_positive_int(argv[i], value, &g_server_config.shard_count))
+                return false;
+            if (g_server_config.shard_count > MAX_STORE_PARTITIONS)
+            {
+                printf("[서버] %s 옵션 값은 %d 이하여야 합니다.\n", argv[i], MAX_STORE_PARTITIONS);
+                return false;
+            }
+            i++;
+        }
+        else if (strcmp(argv[i], "--unix-socket") == 0)
+        {
+            if (value == NULL || *value == '\0')
+            {
+                printf("[서버] %s 옵션에 소켓 경로가 필요합니다.\n", argv[i]);
+                return false;
+            }
+            g_server_config.unix_socket_path = value;
+            i++;
+        }
+        else if (strcmp(argv[i], "--handoff") == 0)
+        {
+            if (value == NULL || *value == '\0')
+            {
+                printf("[서버] %s 옵션에 제어 소켓 경로가 필요합니다.\n", argv[i]);
+                return false;
+            }
+            g_server_config.handoff_path = value;
+            i++;
+        }
+        else if (strcmp(argv[i], "--shm") == 0)
+        {
+            // shm_open은 '/'로 시작하고 그 뒤에는 '/'가 없는 이름만 받음
+            if (value == NULL || value[0] != '/' || value[1] == '\0' || strchr(value + 1, '/') != NULL)
+            {
+                printf("[서버] %s 옵션 값은 '/'로 시작하는 이름이어야 합니다 (예: /ps_server).\n", argv[i]);
+                return false;
+            }
+            g_server_config.shm_name = value;
+            i++;
+        }
+        else if (strcmp(argv[i], "--idle-timeout") == 0)
+        {
+            if (!parse_positive_int(argv[i], value, &g_server_config.idle_timeout_sec))
+                return false;
+            i++;
+        }
+        else if (strcmp(argv[i], "--keepalive") == 0)
+        {
+            if (!parse_positive_int(argv[i], value, &g_server_config.keepalive_sec))
+                return false;
+            i++;
+        }
+        else if (strcmp(argv[i], "--log-level") == 0)
+        {
+            if (value == NULL || !logger_parse_level(value, &g_server_config.log_level))
+            {
+                printf("[서버] %s 옵션 값은 debug, info, warn, error, off 중 하나여야 합니다.\n", argv[i]);
+                return false;
+            }
+            i++;
+        }
+        else if (strcmp(argv[i], "--shed-target") == 0)
+        {
+            if (!parse_positive_int(argv[i], value, &g_server_config.shed_target_ms))
+                return false;
+            i++;
+        }
+        else if (strcmp(argv[i], "--shed-interval") == 0)
+        {
+            if (!parse_positive_int(argv[i], value, &g_server_config.shed_interval_ms))
+                return false;
+            i++;
+        }
+        else if (strcmp(argv[i], "--output-high-water") == 0)
+        {
+            if (!parse_positive_int(argv[i], value, &g_server_config.output_high_water_kb))
+                return false;
+            i++;
+        }
+        else if (strcmp(argv[i], "--output-cap") == 0)
+        {
+            if (!parse_positive_int(argv[i], value, &g_server_config.output_cap_mb))
+                return false;
+            i++;
+        }
+        else if (strncmp(argv[i], "--rate-", 7) == 0 && argv[i][7] != '\0')
+        {
+            // 옵션 이름 뒷부분이 명령 종류 이름 ("--rate-read" -> read)
+            int c = 0;
+            while (c < RATE_CLASS_COUNT && strcmp(argv[i] + 7, rate_class_name((RateClass)c)) != 0)
+                c++;
+            if (c == RATE_CLASS_COUNT)
+            {
+                printf("[서버] 알 수 없는 옵션입니다: %s\n", argv[i]);
+                print_usage(argv[0]);
+                return false;
+            }
+            if (!parse_rate(argv[i], value, &g_server_config.rate_per_sec[c], &g_server_config.rate_burst[c]))
+                return false;
+            i++;
+        }
+        else if (strcmp(argv[i], "--help") == 0)
+        {
+            print_usage(argv[0]);
+            return false;
+        }
+        else
+        {
+            printf("[서버] 알 수 없는 옵션입니다: %s\n", argv[i]);
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+
+    return server_config_check();
+}
+
+// 옵션끼리 함께 쓸 수 있는지 확인
+bool server_config_check(void)
+{
+    // 공유 메모리 채널 스레드는 디스패처의 파티션 잠금에 기대므로 샤드 모드와 함께 쓸 수 없음
+    if (g_server_config.shm_name != NULL)
+    {
+#ifdef _WIN32
+        printf("[서버] --shm 옵션은 Linux에서만 사용할 수 있습니다.\n");
+        return false;
+#else
+        if (g_server_config.shard_count > 0)
+        {
+            printf("[서버] --shm 옵션은 --shards와 함께 사용할 수 없습니다.\n");
+            return false;
+        }
+#endif
+    }
+    return true;
+}
@@ -0,0 +1,55 @@
+// src/server_config.h
+
+#ifndef SERVER_CONFIG_H
+#define SERVER_CONFIG_H
+
+#include "logger.h"
+#include "rate_limit.h"
+#include <stdbool.h>
+
+#define DEFAULT_QUEUE_DEPTH 1024 // 기본 요청 대기열 크기
+#define DEFAULT_SHED_INTERVAL_MS 100 // 기본 부하 조절 판단 간격 (CoDel 기본값)
+#define DEFAULT_OUTPUT_HIGH_WATER_KB 256 // 기본 연결별 송신 대기열 기준 (KB)
+#define DEFAULT_OUTPUT_CAP_MB 256 // 기본 서버 전체 송신 대기열 상한 (MB)
+
+// Linux 이벤트 루프의 입출력 방식
+typedef enum
+{
+    IO_BACKEND_EPOLL,   // epoll로 준비된 소켓을 찾아 recv/send 시스템 콜을 직접 호출 (기본)
+    IO_BACKEND_IO_URING // io_uring으로 accept/recv/send를 모아서 제출 (지원하지 않는 커널이면 epoll 사용)
+} IoBackend;
+
+// 서버 실행 옵션 (명령행 인자로 변경 가능)
+typedef struct
+{
+    int worker_count; // 명령어 핸들러를 실행할 워커 스레드 수 (--workers)
+    int queue_depth;  // 워커가 처리하기 전까지 대기할 수 있는 최대 요청 수 (--queue-depth, 우선순위별로 따로)
+    int bulk_limit;   // 동시에 실행할 수 있는 일괄 작업(DOWNLOAD_ALL, MEMO_SEARCH, DELETE_USER) 수 (--bulk-workers, 샤드 모드는 샤드의 한 바퀴당)
+    IoBackend io_backend; // 입출력 방식 (--io-backend, Linux 전용)
+    int shard_count;      // 코어별 샤드 수 (--shards, Linux 전용, 0이면 이벤트 루프 하나 + 워커 풀)
+    const char *unix_socket_path; // 같은 호스트의 클라이언트용 로컬(AF_UNIX) 소켓 경로 (--unix-socket, NULL이면 사용 안 함)
+    const char *shm_name;         // 공유 메모리 링 전송 계층의 세그먼트 이름 (--shm, Linux 전용, NULL이면 사용 안 함)
+    const char *handoff_path;     // 재시작 시 리스너를 주고받는 제어 소켓 경로 (--handoff, Linux 전용, NULL이면 사용 안 함)
+    int idle_timeout_sec;         // 요청이 이 시간(초) 동안 없는 연결을 닫음 (--idle-timeout, 0이면 사용 안 함)
+    int keepalive_sec;            // 이 시간(초) 동안 조용한 연결에 연결 확인 프레임을 보냄 (--keepalive, 0이면 사용 안 함)
+    LogLevel log_level;           // 기록할 최소 로그 수준 (--log-level)
+    int rate_per_sec[RATE_CLASS_COUNT]; // 명령 종류별 사용자/연결당 초당 허용 요청 수 (--rate-read/--rate-write/--rate-bulk, 0이면 제한 안 함)
+    int rate_burst[RATE_CLASS_COUNT];   // 명령 종류별 한 번에 몰아 보낼 수 있는 요청 수 (0이면 초당 허용 수와 같음)
+    int shed_target_ms;           // 요청 체류 시간 목표 (--shed-target, 넘은 상태가 계속되면 낮은 우선순위 요청부터 거절, 0이면 사용 안 함)
+    int shed_interval_ms;         // 부하 조절 판단 간격 (--shed-interval)
+    int output_high_water_kb;     // 송신 대기열이 이만큼(KB) 쌓인 연결은 요청을 더 읽지 않음 (--output-high-water, Linux 전용)
+    int output_cap_mb;            // 모든 연결의 송신 대기열 합의 상한 (--output-cap, MB, Linux 전용, 넘기려는 연결은 닫음)
+} ServerConfig;
+
+// 전역 서버 설정
+extern ServerConfig g_server_config;
+
+// 명령행 인자를 해석하여 g_server_config를 채움
+// 반환값: 서버를 계속 실행하면 true, 잘못된 인자나 --help로 종료해야 하면 false
+bool server_config_parse(int argc, char *argv[]);
+
+// 옵션끼리 함께 쓸 수 있는지 확인 (server_config_parse 끝에서 호출, 옵션을 바꾼 뒤 다시 호출)
+// 반환값: 함께 쓸 수 있으면 true (아니면 이유를 출력하고 false)
+bool server_config_check(void);
+
+#endif
@@ -0,0 +1,310 @@
+// src/session.c
+
+#define _CRT_RAND_S // Windows: stdlib.h의 rand_s 사용 (다른 헤더보다 먼저 정의해야 함)
+
+#include "session.h"
+#include "store_partition.h"
+#include "user.h"
+#include "epoch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef _WIN32
+#include <sys/random.h>
+#include <time.h>
+#endif
+
+// 토큰 값의 비트 구성
+#define PARTITION_BITS 6                               // 파티션 번호 (MAX_STORE_PARTITIONS = 64)
+#define SLOT_BITS 16                                   // 슬롯 번호
+#define NONCE_BITS (64 - PARTITION_BITS - SLOT_BITS)   // 난수
+#define SLOT_SHIFT NONCE_BITS
+#define PARTITION_SHIFT (NONCE_BITS + SLOT_BITS)
+#define NONCE_MASK ((1ULL << NONCE_BITS) - 1)
+#define SLOT_MASK ((1ULL << SLOT_BITS) - 1)
+#define INITIAL_SLOTS 16 // 세션 테이블의 처음 크기
+
+// 로그인 정보 (만든 뒤에는 고치지 않음, 세션이 끝나면 읽는 쪽이 모두 떠난 뒤 해제)
+// 사용자별 메모 항목(memo.c의 MemoUser)을 가리키는 포인터는 두지 않고 사용자 ID만 둔다.
+//  - 메모 항목은 첫 메모를 추가할 때 생기고, 메모가 모두 지워진 항목은 사용자 테이블을 다시 만들 때 해제되므로
+//    세션보다 먼저 사라졌다가 새로 생길 수 있다. 포인터를 두려면 세대 번호나 참조 수로 이를 따라가야 한다.
+//  - 메모 핸들러는 사용자 ID를 받으므로, 토큰으로 찾은 사용자 ID에서 파티션 안의 해시 테이블을 한 번 더 찾는다.
+//    (같은 파티션 안에서 사용자 ID 해시 + 탐사 몇 칸이라 요청 처리 시간에 비하면 작음)
+typedef struct
+{
+    EpochRetired retired;     // 해제 대기 (첫 멤버)
+    uint64_t token;           // 토큰 값
+    char user_id[MAX_ID_LEN]; // 로그인한 사용자 ID
+} SessionRecord;
+
+// 세션 슬롯 하나
+typedef struct
+{
+    SessionRecord *record; // 로그인 정보 (원자적으로 접근, NULL이면 빈 슬롯)
+    uint64_t last_used;    // 마지막으로 사용한 시점 (테이블의 사용 카운터 값, 원자적으로 접근)
+    int next_free;         // 다음 빈 슬롯 (빈 슬롯일 때만 사용, -1이면 끝)
+} Session;
+
+// 슬롯 배열 (늘릴 때는 새 배열로 옮겨 바꿔 끼우고, 이전 배열은 읽는 쪽이 떠난 뒤 해제)
+typedef struct
+{
+    EpochRetired retired; // 해제 대기 (첫 멤버)
+    int capacity;         // 슬롯 수
+    Session slots[];      // 슬롯
+} SessionSlots;
+
+// 파티션 하나의 세션 테이블 (슬롯 번호로 바로 찾는 배열)
+typedef struct
+{
+    SessionSlots *slots; // 슬롯 배열 (원자적으로 접근, 처음 세션을 만들 때 할당)
+    int count;           // 사용 중인 슬롯 수
+    int free_head;       // 빈 슬롯 목록의 첫 슬롯 (-1이면 없음)
+    uint64_t clock;      // 사용 카운터 (세션을 쓸 때마다 증가, 원자적으로 접근)
+} SessionTable;
+
+static SessionTable g_tables[MAX_STORE_PARTITIONS];
+
+// 토큰에 넣을 난수 (추측할 수 없도록 운영체제의 난수 생성기 사용)
+static uint64_t random_nonce(void)
+{
+    uint64_t value = 0;
+#ifdef _WIN32
+    unsigned int hi = 0, lo = 0;
+    rand_s(&hi);
+    rand_s(&lo);
+    value = ((uint64_t)hi << 32) | lo;
+#else
+    if (getrandom(&value, sizeof(value), 0) != (ssize_t)sizeof(value))
+    {
+        // 난수 생성기를 쓸 수 없는 환경: 시각과 주소를 섞어 대신 사용
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        value = ((uint64_t)ts.tv_nsec << 20) ^ (uint64_t)ts.tv_sec ^ (uint64_t)(uintptr_t)&value;
+        value *= 0x9E3779B97F4A7C15ULL;
+    }
+#endif
+    // 토큰 값 0은 빈 슬롯 표시이므로 난수가 0이 되지 않도록 함
+    value &= NONCE_MASK;
+    return value != 0 ? value : 1;
+}
+
+// 16진수 한 글자 값 (아니면 -1)
+static int hex_value(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+// 토큰 문자열을 값으로 변환 (형식이 잘못되면 false)
+static bool parse_token(const char *text, size_t len, uint64_t *value)
+{
+    if (len != SESSION_TOKEN_LEN || text[0] != SESSION_TOKEN_PREFIX)
+        return false;
+    uint64_t v = 0;
+    for (size_t i = 1; i < len; i++)
+    {
+        int digit = hex_value(text[i]);
+        if (digit < 0)
+            return false;
+        v = (v << 4) | (uint64_t)digit;
+    }
+    *value = v;
+    return true;
+}
+
+// 슬롯을 비우고 빈 슬롯 목록에 넣음 (로그인 정보는 읽는 쪽이 떠난 뒤 해제)
+static void end_slot(SessionTable *table, int slot)
+{
+    Session *session = &table->slots->slots[slot];
+    SessionRecord *record = session->record;
+    __atomic_store_n(&session->record, NULL, __ATOMIC_RELEASE);
+    epoch_retire(&record->retired, epoch_free);
+    session->next_free = table->free_head;
+    table->free_head = slot;
+    table->count--;
+}
+
+// 빈 슬롯이 없을 때 테이블 확장, 최대 크기면 가장 오래 쓰지 않은 세션을 끝내고 그 슬롯을 비움
+static bool make_free_slot(SessionTable *table)
+{
+    SessionSlots *old = table->slots;
+    int capacity = old ? old->capacity : 0;
+    if (capacity < SESSION_MAX_PER_PARTITION)
+    {
+        int new_capacity = capacity == 0 ? INITIAL_SLOTS : capacity * 2;
+        if (new_capacity > SESSION_MAX_PER_PARTITION)
+            new_capacity = SESSION_MAX_PER_PARTITION;
+        SessionSlots *slots = (SessionSlots *)malloc(sizeof(SessionSlots) + sizeof(Session) * new_capacity);
+        if (slots == NULL)
+            return false;
+        slots->capacity = new_capacity;
+        // 기존 슬롯 복사 (읽는 쪽이 사용 시점을 동시에 갱신할 수 있으므로 원자적으로 읽음)
+        for (int i = 0; i < capacity; i++)
+        {
+            slots->slots[i].record = old->slots[i].record;
+            slots->slots[i].last_used = __atomic_load_n(&old->slots[i].last_used, __ATOMIC_RELAXED);
+            slots->slots[i].next_free = old->slots[i].next_free;
+        }
+        // 처음 할당하는 테이블은 빈 슬롯 목록도 비어 있음
+        if (capacity == 0)
+            table->free_head = -1;
+        // 새 슬롯을 빈 슬롯 목록에 연결
+        for (int i = new_capacity - 1; i >= capacity; i--)
+        {
+            slots->slots[i].record = NULL;
+            slots->slots[i].last_used = 0;
+            slots->slots[i].next_free = table->free_head;
+            table->free_head = i;
+        }
+        __atomic_store_n(&table->slots, slots, __ATOMIC_RELEASE);
+        if (old)
+            epoch_retire(&old->retired, epoch_free);
+        return true;
+    }
+
+    // 가장 오래 쓰지 않은 세션 찾기 (테이블이 가득 찼을 때만 실행)
+    int oldest = 0;
+    for (int i = 1; i < capacity; i++)
+    {
+        if (__atomic_load_n(&old->slots[i].last_used, __ATOMIC_RELAXED) <
+            __atomic_load_n(&old->slots[oldest].last_used, __ATOMIC_RELAXED))
+            oldest = i;
+    }
+    end_slot(table, oldest);
+    return true;
+}
+
+// 토큰 값에 해당하는 세션 (끝난 세션이면 NULL, 잠그지 않고 읽는 쪽도 사용)
+static Session *find_session(uint64_t value, SessionRecord **record)
+{
+    int partition = session_partition_of_value(value);
+    if (partition < 0)
+        return NULL;
+    SessionSlots *slots = __atomic_load_n(&g_tables[partition].slots, __ATOMIC_ACQUIRE);
+    uint64_t slot = (value >> SLOT_SHIFT) & SLOT_MASK;
+    if (!slots || slot >= (uint64_t)slots->capacity)
+        return NULL;
+    *record = __atomic_load_n(&slots->slots[slot].record, __ATOMIC_ACQUIRE);
+    if (*record == NULL || (*record)->token != value)
+        return NULL;
+    return &slots->slots[slot];
+}
+
+// 세션 생성
+bool session_create(const char *user_id, char *token)
+{
+    int partition = store_partition_of(user_id);
+    SessionTable *table = &g_tables[partition];
+    SessionRecord *record = (SessionRecord *)malloc(sizeof(SessionRecord));
+    if (record == NULL)
+        return false;
+    if ((table->slots == NULL || table->free_head < 0) && !make_free_slot(table))
+    {
+        free(record);
+        return false;
+    }
+
+    // 빈 슬롯 하나를 꺼내 로그인 정보를 채운 뒤 발행
+    int slot = table->free_head;
+    Session *session = &table->slots->slots[slot];
+    table->free_head = session->next_free;
+    table->count++;
+    record->token = ((uint64_t)partition << PARTITION_SHIFT) | ((uint64_t)slot << SLOT_SHIFT) | random_nonce();
+    strncpy(record->user_id, user_id, MAX_ID_LEN - 1);
+    record->user_id[MAX_ID_LEN - 1] = '\0';
+    __atomic_store_n(&session->last_used, __atomic_add_fetch(&table->clock, 1, __ATOMIC_RELAXED), __ATOMIC_RELAXED);
+    __atomic_store_n(&session->record, record, __ATOMIC_RELEASE);
+
+    snprintf(token, SESSION_TOKEN_LEN + 1, "%c%016llx", SESSION_TOKEN_PREFIX, (unsigned long long)record->token);
+    return true;
+}
+
+// 사용자 ID 자리에 온 값을 사용자 ID로 변환
+const char *session_resolve(const char *key)
+{
+    // 토큰이 아니면 사용자 ID 그대로 사용
+    if (key[0] != SESSION_TOKEN_PREFIX)
+        return key;
+    uint64_t value;
+    if (!parse_token(key, strlen(key), &value))
+        return NULL;
+    return session_resolve_value(value);
+}
+
+// 8바이트 토큰 값을 사용자 ID로 변환
+const char *session_resolve_value(uint64_t value)
+{
+    SessionRecord *record;
+    Session *session = find_session(value, &record);
+    if (session == NULL)
+        return NULL;
+    // 같은 파티션의 조회 요청 여러 개가 잠그지 않고 동시에 부를 수 있음 (순서는 대략 맞으면 됨)
+    uint64_t clock = __atomic_add_fetch(&g_tables[session_partition_of_value(value)].clock, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&session->last_used, clock, __ATOMIC_RELAXED);
+    return record->user_id;
+}
+
+// 세션 종료
+bool session_end(const char *token)
+{
+    uint64_t value;
+    if (!parse_token(token, strlen(token), &value))
+        return false;
+    SessionRecord *record;
+    Session *session = find_session(value, &record);
+    if (session == NULL)
+        return false;
+    SessionTable *table = &g_tables[session_partition_of_value(value)];
+    end_slot(table, (int)(session - table->slots->slots));
+    return true;
+}
+
+// 사용자의 모든 세션 종료
+void session_end_user(const char *user_id)
+{
+    SessionTable *table = &g_tables[store_partition_of(user_id)];
+    for (int i = 0; table->slots && i < table->slots->capacity && table->count > 0; i++)
+    {
+        SessionRecord *record = table->slots->slots[i].record;
+        if (record != NULL && strcmp(record->user_id, user_id) == 0)
+            end_slot(table, i);
+    }
+}
+
+// 토큰이 가리키는 파티션 번호
+int session_partition_of_n(const char *token, size_t len)
+{
+    uint64_t value;
+    if (!parse_token(token, len, &value))
+        return -1;
+    return session_partition_of_value(value);
+}
+
+// 8바이트 토큰 값이 가리키는 파티션 번호
+int session_partition_of_value(uint64_t value)
+{
+    int partition = (int)(value >> PARTITION_SHIFT);
+    return partition < store_partition_count() ? partition : -1;
+}
+
+// 모든 세션 해제
+void session_cleanup(void)
+{
+    for (int p = 0; p < MAX_STORE_PARTITIONS; p++)
+    {
+        SessionSlots *slots = g_tables[p].slots;
+        for (int i = 0; slots && i < slots->capacity; i++)
+        {
+            free(slots->slots[i].record);
+        }
+        free(slots);
+        memset(&g_tables[p], 0, sizeof(g_tables[p]));
+    }
+    // 해제를 미뤄 둔 로그인 정보와 이전 슬롯 배열 정리
+    epoch_drain();
+}
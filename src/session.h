@@ -0,0 +1,54 @@
+// src/session.h
+
+#ifndef SESSION_H
+#define SESSION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 로그인 세션
+//
+// LOGIN에 성공하면 "@" + 16진수 16자리 형식의 세션 토큰을 응답에 붙여 준다.
+// 이후 MEMO_*, DOWNLOAD_* 명령은 사용자 ID 자리에 이 토큰을 넣어 보낼 수 있다 (사용자 ID도 그대로 사용 가능).
+// 토큰 값(64비트)은 [파티션 6비트 | 슬롯 번호 16비트 | 난수 42비트]로 이루어져 있어서,
+//  - 디스패처는 문자열 해시 없이 토큰만 보고 요청을 맡을 파티션(샤드)을 정하고,
+//  - 핸들러는 슬롯 번호로 세션 테이블을 바로 찾아 난수까지 같은지만 확인한다 (O(1)).
+// 세션 테이블은 저장소 파티션(store_partition.h)마다 따로 두며, 사용자/메모 목록과 같은 규칙으로 보호된다
+// (기본 모드는 디스패처의 파티션 잠금, 샤드 모드는 파티션을 맡은 샤드만 접근).
+// 세션을 찾는 일(session_resolve)은 잠그지 않는 조회 요청에서도 실행되므로(에포크 구간, epoch.h)
+// 로그인 정보는 만든 뒤 고치지 않고, 세션이 끝나거나 슬롯 배열을 늘리면 이전 것은 읽는 쪽이 떠난 뒤 해제한다.
+
+#define SESSION_TOKEN_PREFIX '@'      // 토큰 첫 글자 (사용자 ID는 영문/숫자로만 이루어지므로 구분됨)
+#define SESSION_TOKEN_LEN 17          // 토큰 문자열 길이 ('@' + 16진수 16자리)
+#define SESSION_MAX_PER_PARTITION 4096 // 파티션당 최대 세션 수 (넘으면 가장 오래 쓰지 않은 세션을 끝냄)
+
+// 세션 생성 (사용자 ID가 속한 파티션에서 호출)
+// token에는 SESSION_TOKEN_LEN + 1바이트 이상의 공간이 필요하다. 메모리 부족 시 false
+bool session_create(const char *user_id, char *token);
+
+// 사용자 ID 자리에 온 값을 사용자 ID로 변환
+// 세션 토큰이면 로그인한 사용자 ID(파티션 잠금이나 에포크 구간이 끝날 때까지 유효), 사용자 ID면 그대로 돌려준다.
+// 형식이 잘못되었거나 끝난 세션의 토큰이면 NULL
+const char *session_resolve(const char *key);
+
+// 세션 종료 (LOGOUT), 유효한 세션이었으면 true
+bool session_end(const char *token);
+
+// 사용자의 모든 세션 종료 (회원 탈퇴)
+void session_end_user(const char *user_id);
+
+// 토큰이 가리키는 파티션 번호 (null 문자로 끝나지 않을 수 있음)
+// 토큰 형식이 아니거나 파티션 번호가 범위를 벗어나면 -1
+int session_partition_of_n(const char *token, size_t len);
+
+// 바이너리 프로토콜의 8바이트 토큰 값이 가리키는 파티션 번호 (범위를 벗어나면 -1)
+int session_partition_of_value(uint64_t value);
+
+// 바이너리 프로토콜의 8바이트 토큰 값을 사용자 ID로 변환 (끝난 세션이면 NULL)
+const char *session_resolve_value(uint64_t value);
+
+// 모든 세션 해제 (서버 종료 시)
+void session_cleanup(void);
+
+#endif
@@ -0,0 +1,313 @@
+// src/shm_ring.c
+
+#include "shm_ring.h"
+#include "platform.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#define RING_MASK (SHM_RING_SIZE - 1)
+#define SPIN_COUNT 2000         // futex로 잠들기 전에 돌며 확인하는 횟수 (짧은 요청은 대부분 이 안에 응답이 옴)
+#define WAIT_TIMEOUT_MS 1000    // futex 대기 한 번의 최대 시간 (깨어나서 상대가 살아 있는지 확인)
+
+_Static_assert((SHM_RING_SIZE & RING_MASK) == 0, "SHM_RING_SIZE는 2의 거듭제곱이어야 합니다");
+
+// 클라이언트 연결
+struct ShmClient
+{
+    ShmSegment *segment; // 매핑한 세그먼트
+    ShmChannel *channel; // 차지한 채널
+    FrameHeader header;  // 마지막으로 받은 응답의 헤더
+};
+
+// 돌며 기다리는 동안 CPU에 알림 (하이퍼스레드 상대에게 실행 자원을 양보)
+static inline void cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// *addr가 아직 expected이면 깨울 때까지(또는 시간 초과까지) 잠듦
+// 다른 프로세스와 공유하는 메모리이므로 FUTEX_PRIVATE_FLAG를 쓰지 않는다.
+// 반환값: 시간 초과로 깨어났으면 true
+static bool futex_wait(uint32_t *addr, uint32_t expected, int timeout_ms)
+{
+    struct timespec ts = {timeout_ms / 1000, (long)(timeout_ms % 1000) * 1000000L};
+    long ret = syscall(SYS_futex, addr, FUTEX_WAIT, expected, &ts, NULL, 0);
+    return ret < 0 && errno == ETIMEDOUT;
+}
+
+// addr에서 잠든 상대를 모두 깨움
+static void futex_wake(uint32_t *addr)
+{
+    syscall(SYS_futex, addr, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+}
+
+// 잠들기 전에 돌며 확인할 횟수
+// CPU가 하나뿐이면 도는 동안 상대가 실행될 수 없어 시간만 버리므로 바로 futex로 잠든다.
+static int spin_limit(void)
+{
+    static int limit = -1; // 처음 호출할 때 계산 (여러 스레드가 동시에 계산해도 같은 값)
+    int value = __atomic_load_n(&limit, __ATOMIC_RELAXED);
+    if (value < 0)
+    {
+        value = ps_cpu_count() > 1 ? SPIN_COUNT : 0;
+        __atomic_store_n(&limit, value, __ATOMIC_RELAXED);
+    }
+    return value;
+}
+
+// *word가 seen에서 바뀌기를 기다림 (잠깐 돌다가 futex로 잠듦)
+// waiting 표시를 켠 뒤 값을 다시 확인하고, 상대는 값을 바꾼 뒤 waiting을 확인하므로 (둘 다 seq_cst)
+// 잠드는 순간과 깨우는 순간이 엇갈려 알림을 놓치는 일이 없다.
+// 반환값: 계속 진행하면 true, check가 포기하라고 하면 false
+static bool wait_for_change(uint32_t *word, uint32_t *waiting, uint32_t seen, ShmPeerCheck check, void *ctx)
+{
+    for (int i = spin_limit(); i > 0; i--)
+    {
+        if (__atomic_load_n(word, __ATOMIC_ACQUIRE) != seen)
+            return true;
+        cpu_relax();
+    }
+    __atomic_store_n(waiting, 1, __ATOMIC_SEQ_CST);
+    bool timed_out = false;
+    if (__atomic_load_n(word, __ATOMIC_SEQ_CST) == seen)
+        timed_out = futex_wait(word, seen, WAIT_TIMEOUT_MS);
+    __atomic_store_n(waiting, 0, __ATOMIC_RELAXED);
+    // 값이 바뀌었으면 바로 진행, 아니면 상대(또는 종료 요청) 확인
+    if (__atomic_load_n(word, __ATOMIC_ACQUIRE) != seen)
+        return true;
+    if (check(ctx, timed_out))
+        return true;
+    // 상대가 마지막 데이터를 공개한 직후 끊었을 수 있으므로 포기하기 전에 한 번 더 확인
+    return __atomic_load_n(word, __ATOMIC_ACQUIRE) != seen;
+}
+
+// 링에 데이터 쓰기 (parts를 차례로, 공간이 날 때까지 기다림)
+static bool ring_write(ShmRing *ring, const void *const *parts, const size_t *lengths, int count,
+                       ShmPeerCheck check, void *ctx)
+{
+    uint32_t tail = ring->tail; // 생산자만 바꾸는 값
+    for (int p = 0; p < count; p++)
+    {
+        const unsigned char *src = (const unsigned char *)parts[p];
+        size_t remaining = lengths[p];
+        while (remaining > 0)
+        {
+            uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+            uint32_t space = SHM_RING_SIZE - (tail - head);
+            if (space == 0)
+            {
+                // 소비자가 읽어 갈 때까지 대기
+                if (!wait_for_change(&ring->head, &ring->producer_waiting, head, check, ctx))
+                    return false;
+                continue;
+            }
+            // 링 끝에서 잘리면 두 번에 나눠 복사
+            size_t n = remaining < space ? remaining : space;
+            size_t offset = tail & RING_MASK;
+            size_t first = n < SHM_RING_SIZE - offset ? n : SHM_RING_SIZE - offset;
+            memcpy(ring->data + offset, src, first);
+            memcpy(ring->data, src + first, n - first);
+            src += n;
+            remaining -= n;
+            tail += (uint32_t)n;
+            // 링이 가득 찼으면 지금까지 쓴 것을 공개해야 소비자가 읽어 갈 수 있음
+            if (space == n && remaining > 0)
+            {
+                __atomic_store_n(&ring->tail, tail, __ATOMIC_SEQ_CST);
+                if (__atomic_load_n(&ring->consumer_waiting, __ATOMIC_SEQ_CST))
+                    futex_wake(&ring->tail);
+            }
+        }
+    }
+    // 프레임 전체를 한 번에 공개하고, 소비자가 잠들어 있으면 깨움
+    __atomic_store_n(&ring->tail, tail, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->consumer_waiting, __ATOMIC_SEQ_CST))
+        futex_wake(&ring->tail);
+    return true;
+}
+
+// 링에서 정확히 len바이트 읽기 (데이터가 올 때까지 기다림)
+static bool ring_read(ShmRing *ring, void *out, size_t len, ShmPeerCheck check, void *ctx)
+{
+    unsigned char *dst = (unsigned char *)out;
+    uint32_t head = ring->head; // 소비자만 바꾸는 값
+    while (len > 0)
+    {
+        uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        uint32_t avail = tail - head;
+        if (avail == 0)
+        {
+            // 생산자가 쓸 때까지 대기
+            if (!wait_for_change(&ring->tail, &ring->consumer_waiting, tail, check, ctx))
+                return false;
+            continue;
+        }
+        size_t n = len < avail ? len : avail;
+        size_t offset = head & RING_MASK;
+        size_t first = n < SHM_RING_SIZE - offset ? n : SHM_RING_SIZE - offset;
+        memcpy(dst, ring->data + offset, first);
+        memcpy(dst + first, ring->data, n - first);
+        dst += n;
+        len -= n;
+        head += (uint32_t)n;
+        // 읽은 자리를 돌려주고, 생산자가 공간을 기다리며 잠들어 있으면 깨움
+        __atomic_store_n(&ring->head, head, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&ring->producer_waiting, __ATOMIC_SEQ_CST))
+            futex_wake(&ring->head);
+    }
+    return true;
+}
+
+// 링을 빈 상태로 초기화
+void shm_ring_reset(ShmRing *ring)
+{
+    __atomic_store_n(&ring->tail, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring->head, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring->consumer_waiting, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring->producer_waiting, 0, __ATOMIC_RELEASE);
+}
+
+// 프레임 하나를 링에 씀
+bool shm_ring_write_frame(ShmRing *ring, uint8_t flags, uint32_t request_id, const char *payload, size_t len,
+                          ShmPeerCheck check, void *ctx)
+{
+    // 헤더와 요청 ID (frame_send_ex와 같은 형식)
+    unsigned char header[FRAME_HEADER_SIZE + FRAME_REQUEST_ID_SIZE];
+    size_t header_len = FRAME_HEADER_SIZE;
+    if (flags & FRAME_FLAG_REQUEST_ID)
+    {
+        frame_put_u32(header + FRAME_HEADER_SIZE, request_id);
+        header_len += FRAME_REQUEST_ID_SIZE;
+    }
+    if (len + (header_len - FRAME_HEADER_SIZE) > FRAME_MAX_PAYLOAD)
+        return false;
+    frame_encode_header(header, flags, (uint32_t)(len + header_len - FRAME_HEADER_SIZE));
+
+    const void *parts[2] = {header, payload};
+    size_t lengths[2] = {header_len, len};
+    return ring_write(ring, parts, lengths, 2, check, ctx);
+}
+
+// 프레임 하나를 링에서 읽음
+bool shm_ring_read_frame(ShmRing *ring, ReplyBuffer *payload, FrameHeader *header, size_t max_len,
+                         ShmPeerCheck check, void *ctx)
+{
+    // 헤더 읽기 및 해석
+    unsigned char raw[FRAME_HEADER_SIZE];
+    if (!ring_read(ring, raw, sizeof(raw), check, ctx) || !frame_decode_header(raw, header))
+        return false;
+
+    // 요청 ID와 제한 시간 읽기 (본문이 그보다 짧은 헤더는 frame_decode_header가 거부함)
+    uint32_t body_len = header->length;
+    size_t prefix_len = frame_prefix_size(header->flags);
+    if (prefix_len > 0)
+    {
+        unsigned char prefix[FRAME_REQUEST_ID_SIZE + FRAME_DEADLINE_SIZE];
+        if (!ring_read(ring, prefix, prefix_len, check, ctx))
+            return false;
+        frame_decode_prefix(prefix, header);
+        body_len -= (uint32_t)prefix_len;
+    }
+    if (body_len > max_len)
+        return false;
+
+    // 본문 크기만큼 버퍼 확보 후 링에서 직접 복사
+    reply_clear(payload);
+    if (!reply_reserve(payload, body_len) || !ring_read(ring, payload->data, body_len, check, ctx))
+        return false;
+    payload->len = body_len;
+    payload->data[payload->len] = '\0';
+    return true;
+}
+
+// 클라이언트: 서버가 아직 실행 중이고 채널을 끊지 않았는지 확인
+static bool server_alive(void *ctx, bool timed_out)
+{
+    ShmClient *client = (ShmClient *)ctx;
+    ShmSegment *segment = client->segment;
+    if (!__atomic_load_n(&segment->running, __ATOMIC_ACQUIRE) ||
+        __atomic_load_n(&client->channel->state, __ATOMIC_ACQUIRE) != SHM_CHANNEL_ATTACHED)
+        return false;
+    // 서버가 비정상 종료하면 running을 바꾸지 못하므로 프로세스가 남아 있는지 직접 확인
+    return !timed_out || kill(segment->server_pid, 0) == 0 || errno != ESRCH;
+}
+
+// 세그먼트에 붙어 빈 채널 하나를 차지
+ShmClient *shm_client_attach(const char *name)
+{
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0)
+        return NULL;
+    void *mem = mmap(NULL, sizeof(ShmSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED)
+        return NULL;
+    ShmSegment *segment = (ShmSegment *)mem;
+
+    // 같은 형식으로 빌드한 서버인지 확인 (세그먼트 크기가 다르면 매핑 범위 밖을 읽을 수 있음)
+    if (segment->magic != SHM_MAGIC || segment->channel_count != SHM_CHANNELS ||
+        segment->ring_size != SHM_RING_SIZE || !__atomic_load_n(&segment->running, __ATOMIC_ACQUIRE))
+    {
+        munmap(mem, sizeof(ShmSegment));
+        return NULL;
+    }
+
+    // 빈 채널을 원자적으로 차지 (다른 클라이언트와 경쟁)
+    for (int i = 0; i < SHM_CHANNELS; i++)
+    {
+        ShmChannel *channel = &segment->channels[i];
+        uint32_t expected = SHM_CHANNEL_FREE;
+        if (!__atomic_compare_exchange_n(&channel->state, &expected, SHM_CHANNEL_ATTACHED, false,
+                                         __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+            continue;
+        ShmClient *client = (ShmClient *)calloc(1, sizeof(ShmClient));
+        if (!client)
+        {
+            __atomic_store_n(&channel->state, SHM_CHANNEL_CLOSED, __ATOMIC_RELEASE);
+            futex_wake(&channel->state);
+            break;
+        }
+        __atomic_store_n(&channel->client_pid, (int32_t)getpid(), __ATOMIC_RELEASE);
+        client->segment = segment;
+        client->channel = channel;
+        // 이 채널을 맡은 서버 스레드를 깨움
+        futex_wake(&channel->state);
+        return client;
+    }
+    munmap(mem, sizeof(ShmSegment));
+    return NULL;
+}
+
+// 요청 하나를 보내고 응답 하나를 받음
+bool shm_client_call(ShmClient *client, const char *request, size_t len, ReplyBuffer *reply)
+{
+    ShmChannel *channel = client->channel;
+    return shm_ring_write_frame(&channel->request, 0, 0, request, len, server_alive, client) &&
+           shm_ring_read_frame(&channel->reply, reply, &client->header, FRAME_MAX_PAYLOAD, server_alive, client);
+}
+
+// 채널을 돌려주고 매핑 해제
+void shm_client_detach(ShmClient *client)
+{
+    if (!client)
+        return;
+    ShmChannel *channel = client->channel;
+    __atomic_store_n(&channel->state, SHM_CHANNEL_CLOSED, __ATOMIC_SEQ_CST);
+    // 서버 스레드는 채널 상태 또는 요청 링에서 잠들어 있으므로 둘 다 깨움
+    futex_wake(&channel->state);
+    futex_wake(&channel->request.tail);
+    munmap(client->segment, sizeof(ShmSegment));
+    free(client);
+}
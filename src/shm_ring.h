@@ -0,0 +1,100 @@
+// src/shm_ring.h
+
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include "frame.h"
+#include "reply_buffer.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Linux 전용: 공유 메모리 링 버퍼 전송 계층 (같은 호스트의 클라이언트용)
+//
+// 서버가 공유 메모리 세그먼트(shm_open)를 만들고, 클라이언트는 그 안의 채널 하나를 차지해서
+// 요청 링에 프레임(frame.h 형식)을 쓰고 응답 링에서 프레임을 읽는다.
+// 링은 생산자 하나/소비자 하나(SPSC)만 쓰므로 잠금 없이 head/tail 두 값만 원자적으로 갱신하고,
+// 소켓과 달리 요청마다 시스템 콜이나 커널 복사가 없다.
+// 읽을 데이터(또는 쓸 공간)가 없으면 잠깐 돌며 기다린 뒤 futex로 잠들고, 상대가 값을 바꾸며 깨운다.
+// 프레임은 링에 스트림으로 흘려 보내므로 링보다 큰 요청/응답(전체 내보내기 등)도 주고받을 수 있다.
+//
+// 세그먼트 구성: [ShmSegment 헤더 | ShmChannel x SHM_CHANNELS]
+// 채널 상태: FREE(비어 있음) -> ATTACHED(클라이언트가 차지) [-> BROKEN(서버가 끊음)] -> CLOSED(클라이언트가 떠남)
+//           -> 서버가 링을 비우고 FREE (채널을 FREE로 되돌리는 것은 클라이언트가 돌려준 뒤 서버만 한다)
+
+#define SHM_MAGIC 0x50534D31u     // 세그먼트 확인 값 ("PSM1")
+#define SHM_CHANNELS 8            // 세그먼트 하나의 채널 수 (동시에 붙을 수 있는 클라이언트 수)
+#define SHM_RING_SIZE (256 * 1024) // 링 하나의 크기 (2의 거듭제곱이어야 함)
+#define SHM_CACHE_LINE 64         // 생산자/소비자 값이 같은 캐시 라인을 두고 다투지 않도록 띄우는 간격
+
+// 채널 상태 (ShmChannel.state, futex로도 사용)
+enum
+{
+    SHM_CHANNEL_FREE = 0,     // 비어 있음
+    SHM_CHANNEL_ATTACHED = 1, // 클라이언트가 사용 중
+    SHM_CHANNEL_CLOSED = 2,   // 클라이언트가 떠남 (서버가 정리 후 FREE로 되돌림)
+    SHM_CHANNEL_BROKEN = 3    // 서버가 통신을 끝냄 (EXIT, 잘못된 프레임): 클라이언트가 CLOSED로 바꿔 돌려줘야 함
+};
+
+// 단일 생산자/단일 소비자 바이트 링
+// head/tail은 계속 증가하는 값이고 (tail - head)가 쌓인 바이트 수다 (32비트 넘침도 그대로 계산됨).
+typedef struct
+{
+    _Alignas(SHM_CACHE_LINE) uint32_t tail; // 생산자가 다음에 쓸 위치 (futex: 소비자가 여기서 잠듦)
+    uint32_t consumer_waiting;              // 소비자가 잠들었거나 잠들려는 중이면 1
+    _Alignas(SHM_CACHE_LINE) uint32_t head; // 소비자가 다음에 읽을 위치 (futex: 생산자가 여기서 잠듦)
+    uint32_t producer_waiting;              // 생산자가 잠들었거나 잠들려는 중이면 1
+    _Alignas(SHM_CACHE_LINE) unsigned char data[SHM_RING_SIZE];
+} ShmRing;
+
+// 클라이언트 하나와의 통신 채널
+typedef struct
+{
+    _Alignas(SHM_CACHE_LINE) uint32_t state; // 채널 상태 (SHM_CHANNEL_*, futex: 서버 스레드가 클라이언트를 기다림)
+    int32_t client_pid;                      // 채널을 차지한 클라이언트 프로세스 (비정상 종료 감지용)
+    ShmRing request;                         // 클라이언트 -> 서버
+    ShmRing reply;                           // 서버 -> 클라이언트
+} ShmChannel;
+
+// 공유 메모리 세그먼트 전체
+typedef struct
+{
+    uint32_t magic;         // SHM_MAGIC
+    uint32_t channel_count; // SHM_CHANNELS
+    uint32_t ring_size;     // SHM_RING_SIZE (서버/클라이언트 빌드가 맞는지 확인)
+    int32_t server_pid;     // 서버 프로세스
+    uint32_t running;       // 서버 실행 중이면 1 (종료할 때 0으로 바꿈)
+    ShmChannel channels[SHM_CHANNELS];
+} ShmSegment;
+
+// 기다리는 도중 상대가 아직 살아 있는지 확인하는 함수
+// futex에서 깨어났는데 진행할 수 없을 때 호출된다 (timed_out: 대기 시간이 지나서 깨어났는지).
+// false를 반환하면 링 읽기/쓰기를 포기한다.
+typedef bool (*ShmPeerCheck)(void *ctx, bool timed_out);
+
+// 링을 빈 상태로 초기화 (양쪽 모두 링을 쓰지 않을 때만 호출)
+void shm_ring_reset(ShmRing *ring);
+
+// 프레임 하나를 링에 씀 (공간이 날 때까지 기다림, 요청 ID 규칙은 frame_send_ex와 같음)
+bool shm_ring_write_frame(ShmRing *ring, uint8_t flags, uint32_t request_id, const char *payload, size_t len,
+                          ShmPeerCheck check, void *ctx);
+
+// 프레임 하나를 링에서 끝까지 읽어 payload에 저장 (규칙은 frame_recv_ex와 같음)
+// max_len: 받아들일 최대 본문 크기 (넘으면 false)
+bool shm_ring_read_frame(ShmRing *ring, ReplyBuffer *payload, FrameHeader *header, size_t max_len,
+                         ShmPeerCheck check, void *ctx);
+
+// 클라이언트 쪽 연결
+typedef struct ShmClient ShmClient;
+
+// 서버의 공유 메모리 세그먼트(서버의 --shm 이름)에 붙어 빈 채널 하나를 차지
+// 세그먼트가 없거나, 형식이 다르거나, 빈 채널이 없으면 NULL
+ShmClient *shm_client_attach(const char *name);
+
+// 요청 프레임 하나를 보내고 응답 프레임 하나를 reply에 받음 (서버가 종료되면 false)
+bool shm_client_call(ShmClient *client, const char *request, size_t len, ReplyBuffer *reply);
+
+// 채널을 돌려주고 세그먼트 매핑 해제
+void shm_client_detach(ShmClient *client);
+
+#endif
@@ -0,0 +1,252 @@
+// src/shm_server.c
+
+#include "shm_server.h"
+#include "shm_ring.h"
+#include "command_dispatch.h"
+#include "platform.h"
+#include "logger.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#define IDLE_TIMEOUT_MS 1000 // 빈 채널에서 클라이언트를 기다리는 한 번의 최대 시간
+
+// 채널 하나를 맡은 서버 스레드
+typedef struct
+{
+    ps_thread_t thread;  // 채널 스레드
+    ShmChannel *channel; // 맡은 채널
+    int index;           // 채널 번호 (로그용)
+} ChannelWorker;
+
+static ShmSegment *g_segment = NULL;                // 매핑한 세그먼트 (NULL이면 사용 안 함)
+static char g_segment_name[256];                    // shm_unlink할 이름
+static ChannelWorker g_workers[SHM_CHANNELS];       // 채널 스레드
+static int g_worker_count = 0;                      // 시작한 채널 스레드 수
+static int g_stop = 0;                              // 종료 요청 플래그 (원자적으로 접근)
+
+// 빈 채널에서 상태가 바뀌거나 종료 요청이 올 때까지 잠듦
+static void wait_state(ShmChannel *channel, uint32_t seen)
+{
+    struct timespec ts = {IDLE_TIMEOUT_MS / 1000, (long)(IDLE_TIMEOUT_MS % 1000) * 1000000L};
+    syscall(SYS_futex, &channel->state, FUTEX_WAIT, seen, &ts, NULL, 0);
+}
+
+// 채널을 차지한 클라이언트가 아직 통신 중인지 확인 (링 읽기/쓰기 대기 중에 호출됨)
+static bool client_alive(void *ctx, bool timed_out)
+{
+    ShmChannel *channel = (ShmChannel *)ctx;
+    if (__atomic_load_n(&g_stop, __ATOMIC_ACQUIRE) ||
+        __atomic_load_n(&channel->state, __ATOMIC_ACQUIRE) != SHM_CHANNEL_ATTACHED)
+        return false;
+    // 클라이언트가 채널을 돌려주지 못하고 비정상 종료한 경우
+    pid_t pid = __atomic_load_n(&channel->client_pid, __ATOMIC_ACQUIRE);
+    return !timed_out || pid <= 0 || kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+// 서버가 끊은(BROKEN) 채널을 클라이언트가 아직 돌려주지 않았는지 확인
+static bool client_holds(ShmChannel *channel)
+{
+    if (__atomic_load_n(&g_stop, __ATOMIC_ACQUIRE) ||
+        __atomic_load_n(&channel->state, __ATOMIC_ACQUIRE) != SHM_CHANNEL_BROKEN)
+        return false;
+    pid_t pid = __atomic_load_n(&channel->client_pid, __ATOMIC_ACQUIRE);
+    return pid > 0 && (kill(pid, 0) == 0 || errno != ESRCH);
+}
+
+// 붙은 클라이언트 하나의 요청을 차례로 처리 (serve_client와 같은 순서: HELLO 협상 -> 명령어 처리 -> 응답)
+static void serve_channel(ChannelWorker *worker)
+{
+    ShmChannel *channel = worker->channel;
+    ReplyBuffer request, reply;
+    reply_init(&request);
+    reply_init(&reply);
+    bool binary = false;
+    bool greeted = false;
+    RateLimit limit = {0}; // 채널을 차지한 클라이언트의 요청 빈도 제한 버킷 (클라이언트가 바뀌면 새로 시작)
+
+    logger_write(LOG_LEVEL_INFO, "[서버] 공유 메모리 채널 %d 연결됨 (클라이언트 프로세스 %d)", worker->index,
+                 (int)__atomic_load_n(&channel->client_pid, __ATOMIC_ACQUIRE));
+
+    while (true)
+    {
+        // 요청 하나 수신
+        FrameHeader header = {0};
+        if (!shm_ring_read_frame(&channel->request, &request, &header, FRAME_MAX_REQUEST, client_alive, channel))
+        {
+            logger_write(LOG_LEVEL_INFO, "[서버] 공유 메모리 채널 %d 연결 해제됨", worker->index);
+            break;
+        }
+        // 첫 요청이 HELLO면 프로토콜 협상
+        if (!greeted)
+        {
+            greeted = true;
+            if (dispatch_hello(reply_str(&request), &reply, &binary, NULL))
+            {
+                shm_ring_write_frame(&channel->reply, header.flags & FRAME_FLAG_REQUEST_ID, header.request_id,
+                                     reply_str(&reply), reply.len, client_alive, channel);
+                continue;
+            }
+        }
+
+        // 수신 데이터 기록 후 명령어 처리 (소켓 연결과 같은 디스패처 사용)
+        bool keep_open = true;
+        bool binary_request = binary && is_binary_request(reply_str(&request), request.len);
+        dispatch_log_request("공유 메모리 채널", worker->index, reply_str(&request), request.len, binary_request);
+        unsigned long long deadline_ms = header.timeout_ms ? ps_now_ms() + header.timeout_ms : 0;
+        if (binary_request)
+            dispatch_binary_command(reply_str(&request), request.len, &reply, &limit, deadline_ms);
+        else
+            keep_open = dispatch_command(reply_str(&request), &reply, &limit, deadline_ms);
+
+        // 응답 전송
+        if (!shm_ring_write_frame(&channel->reply, header.flags & FRAME_FLAG_REQUEST_ID, header.request_id,
+                                  reply_str(&reply), reply.len, client_alive, channel))
+        {
+            logger_write(LOG_LEVEL_INFO, "[서버] 공유 메모리 채널 %d 연결 해제됨", worker->index);
+            break;
+        }
+
+        // "EXIT" 명령어 처리
+        if (!keep_open)
+        {
+            logger_write(LOG_LEVEL_INFO, "[서버] 공유 메모리 채널 %d 정상 종료 요청", worker->index);
+            break;
+        }
+    }
+
+    reply_free(&request);
+    reply_free(&reply);
+}
+
+// 채널 스레드: 클라이언트가 붙기를 기다렸다가 처리하고, 떠나면 채널을 비워 다음 클라이언트를 받음
+static PS_THREAD_FUNC(channel_thread)
+{
+    ChannelWorker *worker = (ChannelWorker *)arg;
+    ShmChannel *channel = worker->channel;
+    while (!__atomic_load_n(&g_stop, __ATOMIC_ACQUIRE))
+    {
+        uint32_t state = __atomic_load_n(&channel->state, __ATOMIC_ACQUIRE);
+        if (state == SHM_CHANNEL_FREE)
+        {
+            wait_state(channel, state);
+            continue;
+        }
+        if (state == SHM_CHANNEL_ATTACHED)
+            serve_channel(worker);
+
+        // 클라이언트가 아직 채널을 돌려주지 않았으면(EXIT 또는 잘못된 프레임) 돌려줄 때까지 기다림
+        // (먼저 FREE로 돌리면 떠나는 클라이언트의 CLOSED 기록이 새로 붙은 클라이언트의 채널을 덮어쓸 수 있음)
+        // BROKEN으로 바꿔 응답을 기다리는 클라이언트가 더 기다리지 않고 채널을 돌려주게 한다.
+        uint32_t attached = SHM_CHANNEL_ATTACHED;
+        if (__atomic_compare_exchange_n(&channel->state, &attached, SHM_CHANNEL_BROKEN, false, __ATOMIC_ACQ_REL,
+                                        __ATOMIC_ACQUIRE))
+            syscall(SYS_futex, &channel->reply.tail, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+        while (client_holds(channel))
+        {
+            wait_state(channel, SHM_CHANNEL_BROKEN);
+        }
+        if (__atomic_load_n(&g_stop, __ATOMIC_ACQUIRE))
+            break;
+
+        // 클라이언트가 떠났거나 비정상 종료: 링을 비우고 빈 채널로 되돌림
+        shm_ring_reset(&channel->request);
+        shm_ring_reset(&channel->reply);
+        __atomic_store_n(&channel->client_pid, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&channel->state, SHM_CHANNEL_FREE, __ATOMIC_RELEASE);
+    }
+    PS_THREAD_RETURN;
+}
+
+// 세그먼트를 만들고 채널 스레드 시작
+bool shm_server_start(const char *name)
+{
+    if (strlen(name) >= sizeof(g_segment_name))
+    {
+        logger_write(LOG_LEVEL_ERROR, "[서버] 공유 메모리 이름이 너무 깁니다: %s", name);
+        return false;
+    }
+    // 이전 실행이 비정상 종료하며 남긴 세그먼트는 지우고 새로 만듦 (붙어 있던 클라이언트와 섞이지 않도록)
+    shm_unlink(name);
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0)
+    {
+        logger_write(LOG_LEVEL_ERROR, "[서버] 공유 메모리 생성 실패 (%s): %s", name, strerror(errno));
+        return false;
+    }
+    if (ftruncate(fd, sizeof(ShmSegment)) < 0)
+    {
+        logger_write(LOG_LEVEL_ERROR, "[서버] 공유 메모리 크기 설정 실패: %s", strerror(errno));
+        close(fd);
+        shm_unlink(name);
+        return false;
+    }
+    void *mem = mmap(NULL, sizeof(ShmSegment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED)
+    {
+        logger_write(LOG_LEVEL_ERROR, "[서버] 공유 메모리 매핑 실패: %s", strerror(errno));
+        shm_unlink(name);
+        return false;
+    }
+    snprintf(g_segment_name, sizeof(g_segment_name), "%s", name);
+
+    // 세그먼트 헤더 기록 (ftruncate로 만든 영역은 0으로 채워져 있으므로 채널은 모두 FREE, 링은 빈 상태)
+    g_segment = (ShmSegment *)mem;
+    g_segment->channel_count = SHM_CHANNELS;
+    g_segment->ring_size = SHM_RING_SIZE;
+    g_segment->server_pid = (int32_t)getpid();
+    __atomic_store_n(&g_segment->running, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_segment->magic, SHM_MAGIC, __ATOMIC_RELEASE); // 클라이언트는 magic부터 확인
+
+    // 채널마다 스레드 시작
+    __atomic_store_n(&g_stop, 0, __ATOMIC_RELAXED);
+    for (g_worker_count = 0; g_worker_count < SHM_CHANNELS; g_worker_count++)
+    {
+        ChannelWorker *worker = &g_workers[g_worker_count];
+        worker->channel = &g_segment->channels[g_worker_count];
+        worker->index = g_worker_count;
+        if (!ps_thread_create(&worker->thread, channel_thread, worker))
+        {
+            logger_write(LOG_LEVEL_ERROR, "[서버] 공유 메모리 채널 스레드 시작 실패");
+            shm_server_stop();
+            return false;
+        }
+    }
+    logger_write(LOG_LEVEL_INFO, "[서버] 공유 메모리 전송 대기 중: %s (채널 %d개)", name, SHM_CHANNELS);
+    return true;
+}
+
+// 채널 스레드를 멈추고 세그먼트 삭제
+void shm_server_stop(void)
+{
+    if (!g_segment)
+        return;
+    // 클라이언트에게 종료를 알리고, 잠들어 있는 채널 스레드를 모두 깨움
+    __atomic_store_n(&g_segment->running, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&g_stop, 1, __ATOMIC_RELEASE);
+    for (int i = 0; i < g_worker_count; i++)
+    {
+        ShmChannel *channel = &g_segment->channels[i];
+        syscall(SYS_futex, &channel->state, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+        syscall(SYS_futex, &channel->request.tail, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+        syscall(SYS_futex, &channel->reply.head, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+        // 응답을 기다리는 클라이언트도 깨워서 running이 꺼진 것을 보게 함
+        syscall(SYS_futex, &channel->reply.tail, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+    }
+    for (int i = 0; i < g_worker_count; i++)
+    {
+        ps_thread_join(g_workers[i].thread);
+    }
+    g_worker_count = 0;
+
+    munmap(g_segment, sizeof(ShmSegment));
+    shm_unlink(g_segment_name);
+    g_segment = NULL;
+}
@@ -0,0 +1,21 @@
+// src/shm_server.h
+
+#ifndef SHM_SERVER_H
+#define SHM_SERVER_H
+
+#include <stdbool.h>
+
+// Linux 전용: 공유 메모리 링 전송 계층의 서버 쪽 (shm_ring.h)
+// 채널마다 스레드 하나가 클라이언트를 기다리다가, 붙은 클라이언트의 요청 프레임을 읽어
+// 소켓 연결과 같은 디스패처(command_dispatch.h)로 처리하고 응답 프레임을 쓴다.
+// 디스패처가 파티션 잠금으로 저장소를 보호하는 기본 모드에서만 사용할 수 있다 (샤드 모드와 함께 쓸 수 없음).
+
+// 공유 메모리 세그먼트(/dev/shm/<name>)를 만들고 채널 스레드 시작
+// name은 '/'로 시작하는 이름 (예: /ps_server). 같은 이름의 이전 세그먼트가 남아 있으면 지우고 새로 만든다.
+// 반환값: 성공 시 true
+bool shm_server_start(const char *name);
+
+// 채널 스레드를 멈추고 세그먼트 삭제 (시작하지 않았으면 아무것도 하지 않음)
+void shm_server_stop(void);
+
+#endif
@@ -0,0 +1,332 @@
+// src/store_bench.c
+
+// Linux 전용: 저장소 잠금 부하 측정 도구
+// 서버 없이 디스패처(dispatch_command)를 한 프로세스의 여러 스레드에서 직접 호출해,
+// 스레드 수를 늘릴 때 처리량이 얼마나 늘어나는지 잰다. 네트워크와 이벤트 루프 비용이 빠지므로 저장소 잠금의 경합이 그대로 드러난다.
+// 임시 디렉터리에 사용자 N명과 사용자마다 메모 M개를 만든 뒤, 스레드마다 무작위 사용자에게
+// MEMO_VIEW / MEMO_LIST_BY_MONTH / MEMO_SEARCH를 돌아가며 보내고, --write-percent 비율만큼 MEMO_UPDATE를 섞는다.
+// --serialize를 주면 모든 요청을 이 도구의 뮤텍스 하나로 감싸서 예전의 전역 잠금(요청 하나씩 처리)과 같은 조건을 만든다.
+// 코어가 여러 개인 장비에서 실행해야 스레드 수에 따른 차이를 볼 수 있다.
+
+#include "command_dispatch.h"
+#include "store_partition.h"
+#include "reply_buffer.h"
+#include "platform.h"
+#include "user.h"
+#include "memo.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#define DEFAULT_THREADS "1,2,4,8" // 기본 스레드 수 목록
+#define DEFAULT_SECONDS 2         // 기본 스레드 수마다 측정 시간 (초)
+#define DEFAULT_USERS 64          // 기본 사용자 수
+#define DEFAULT_MEMOS 50          // 기본 사용자당 메모 수
+#define MAX_THREAD_STEPS 16       // 스레드 수 목록의 최대 항목 수
+#define REQUEST_SIZE 256          // 요청 문자열 버퍼 크기
+
+// 측정 옵션
+typedef struct
+{
+    int threads[MAX_THREAD_STEPS]; // 차례로 측정할 스레드 수
+    int thread_steps;              // 스레드 수 목록의 항목 수
+    int seconds;                   // 스레드 수마다 측정 시간 (초)
+    int users;                     // 사용자 수
+    int memos;                     // 사용자당 메모 수
+    int write_percent;             // 변경 요청 비율 (0~100)
+    int stripes;                   // 저장소 파티션(잠금) 수
+    bool serialize;                // 모든 요청을 뮤텍스 하나로 감쌈 (예전 전역 잠금 흉내)
+} StoreBenchConfig;
+
+// 스레드 하나의 측정 결과
+typedef struct
+{
+    ps_thread_t thread;       // 측정 스레드
+    uint64_t seed;            // 난수 상태
+    unsigned long long reads; // 처리한 조회 요청 수
+    unsigned long long writes; // 처리한 변경 요청 수
+} StoreBenchWorker;
+
+static StoreBenchConfig g_config = {{0}, 0, DEFAULT_SECONDS, DEFAULT_USERS, DEFAULT_MEMOS, 0, STORE_LOCK_STRIPES, false};
+static volatile int g_stop = 0;                             // 측정 종료 신호 (원자적으로 접근)
+static ps_mutex_t g_serial_lock = PS_MUTEX_INITIALIZER;     // --serialize에서 모든 요청을 감싸는 잠금
+static int g_year = 0;                                      // 메모를 만든 연도 (월별 조회에 사용)
+static int g_month = 0;                                     // 메모를 만든 달
+
+// 난수 (xorshift64, 스레드마다 상태를 따로 둠)
+static uint64_t next_random(uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+// 요청 하나 처리 (--serialize면 뮤텍스 안에서)
+static void run_request(const char *request, ReplyBuffer *reply)
+{
+    if (g_config.serialize)
+        ps_mutex_lock(&g_serial_lock);
+    dispatch_command(request, reply, NULL, 0);
+    if (g_config.serialize)
+        ps_mutex_unlock(&g_serial_lock);
+}
+
+// 측정 스레드: 멈추라는 신호가 올 때까지 무작위 사용자에게 요청을 보냄
+static PS_THREAD_FUNC(bench_thread)
+{
+    StoreBenchWorker *worker = (StoreBenchWorker *)arg;
+    ReplyBuffer reply;
+    reply_init(&reply);
+    char request[REQUEST_SIZE];
+    unsigned long long step = 0;
+    while (!__atomic_load_n(&g_stop, __ATOMIC_RELAXED))
+    {
+        uint64_t r = next_random(&worker->seed);
+        int user = (int)(r % (uint64_t)g_config.users);
+        int memo = (int)((r >> 32) % (uint64_t)g_config.memos);
+        // 메모 ID는 준비 단계에서 사용자 순서대로 1부터 발급됨
+        int memo_id = user * g_config.memos + memo + 1;
+        if ((int)((r >> 16) % 100) < g_config.write_percent)
+        {
+            snprintf(request, sizeof(request), "MEMO_UPDATE:sbuser%d:%d:updated %llu", user, memo_id, step);
+            run_request(request, &reply);
+            worker->writes++;
+        }
+        else
+        {
+            switch (step % 3)
+            {
+            case 0:
+                snprintf(request, sizeof(request), "MEMO_VIEW:sbuser%d:%d", user, memo_id);
+                break;
+            case 1:
+                snprintf(request, sizeof(request), "MEMO_LIST_BY_MONTH:sbuser%d:%d:%d", user, g_year, g_month);
+                break;
+            default:
+                snprintf(request, sizeof(request), "MEMO_SEARCH:sbuser%d:title:title%d", user, memo);
+                break;
+            }
+            run_request(request, &reply);
+            worker->reads++;
+        }
+        step++;
+    }
+    reply_free(&reply);
+    return 0;
+}
+
+// 스레드 수 하나로 측정 (반환값: 초당 처리한 요청 수, 실패하면 음수)
+static double run_step(int thread_count, unsigned long long *reads, unsigned long long *writes)
+{
+    StoreBenchWorker *workers = (StoreBenchWorker *)calloc(thread_count, sizeof(StoreBenchWorker));
+    if (!workers)
+        return -1.0;
+    __atomic_store_n(&g_stop, 0, __ATOMIC_RELAXED);
+    unsigned long long start = ps_now_us();
+    int started = 0;
+    for (; started < thread_count; started++)
+    {
+        workers[started].seed = 0x9E3779B97F4A7C15ULL * (uint64_t)(started + 1);
+        if (!ps_thread_create(&workers[started].thread, bench_thread, &workers[started]))
+            break;
+    }
+    ps_sleep_ms((unsigned)g_config.seconds * 1000u);
+    __atomic_store_n(&g_stop, 1, __ATOMIC_RELAXED);
+    for (int i = 0; i < started; i++)
+        ps_thread_join(workers[i].thread);
+    double elapsed = (double)(ps_now_us() - start) / 1e6;
+
+    *reads = 0;
+    *writes = 0;
+    for (int i = 0; i < started; i++)
+    {
+        *reads += workers[i].reads;
+        *writes += workers[i].writes;
+    }
+    free(workers);
+    if (started < thread_count)
+        return -1.0;
+    return (double)(*reads + *writes) / elapsed;
+}
+
+// 임시 디렉터리에 사용자와 메모 만들기 (저장소 파일은 현재 디렉터리 기준 data/ 아래에 생김)
+static bool prepare_store(char *dir)
+{
+    if (!mkdtemp(dir) || chdir(dir) != 0 || mkdir("data", 0755) != 0 || mkdir("data/memo", 0755) != 0)
+        return false;
+    store_set_partition_count(g_config.stripes);
+    user_init();
+    memo_init();
+
+    time_t now = time(NULL);
+    struct tm t;
+    ps_localtime(&now, &t);
+    g_year = t.tm_year + 1900;
+    g_month = t.tm_mon + 1;
+
+    ReplyBuffer reply;
+    reply_init(&reply);
+    char request[REQUEST_SIZE];
+    bool ok = true;
+    for (int u = 0; u < g_config.users && ok; u++)
+    {
+        snprintf(request, sizeof(request), "REGISTER:sbuser%d:password1", u);
+        dispatch_command(request, &reply, NULL, 0);
+        for (int m = 0; m < g_config.memos && ok; m++)
+        {
+            snprintf(request, sizeof(request), "MEMO_ADD:sbuser%d:title%d:content of memo %d for user %d", u, m, m, u);
+            dispatch_command(request, &reply, NULL, 0);
+            ok = reply_total_len(&reply) >= 2 && strncmp(reply.data, "OK", 2) == 0;
+        }
+    }
+    reply_free(&reply);
+    return ok;
+}
+
+// 임시 디렉터리 지우기
+static void remove_store(const char *dir)
+{
+    DIR *memo_dir = opendir("data/memo");
+    if (memo_dir)
+    {
+        struct dirent *entry;
+        char path[512];
+        while ((entry = readdir(memo_dir)) != NULL)
+        {
+            if (entry->d_name[0] == '.')
+                continue;
+            snprintf(path, sizeof(path), "data/memo/%s", entry->d_name);
+            unlink(path);
+        }
+        closedir(memo_dir);
+    }
+    rmdir("data/memo");
+    unlink("data/users.txt");
+    rmdir("data");
+    if (chdir("/") == 0)
+        rmdir(dir);
+}
+
+// 사용법 출력
+static void print_usage(const char *program)
+{
+    printf("사용법: %s [옵션]\n", program);
+    printf("  --threads LIST       차례로 측정할 스레드 수, 쉼표 구분 (기본: %s)\n", DEFAULT_THREADS);
+    printf("  --seconds N          스레드 수마다 측정 시간 (기본: %d초)\n", DEFAULT_SECONDS);
+    printf("  --users N            사용자 수 (기본: %d)\n", DEFAULT_USERS);
+    printf("  --memos N            사용자당 메모 수 (기본: %d)\n", DEFAULT_MEMOS);
+    printf("  --write-percent P    MEMO_UPDATE 요청 비율 %% (기본: 0)\n");
+    printf("  --stripes N          저장소 파티션(잠금) 수 (기본: %d, 최대 %d)\n", STORE_LOCK_STRIPES, MAX_STORE_PARTITIONS);
+    printf("  --serialize          모든 요청을 잠금 하나로 감싸 예전 전역 잠금과 비교\n");
+}
+
+// 쉼표로 구분한 스레드 수 목록 해석
+static bool parse_threads(const char *value)
+{
+    g_config.thread_steps = 0;
+    while (*value)
+    {
+        if (g_config.thread_steps == MAX_THREAD_STEPS)
+            return false;
+        int n = atoi(value);
+        if (n <= 0)
+            return false;
+        g_config.threads[g_config.thread_steps++] = n;
+        value += strcspn(value, ",");
+        if (*value == ',')
+            value++;
+    }
+    return g_config.thread_steps > 0;
+}
+
+// 명령행 인자 해석
+static bool parse_args(int argc, char *argv[])
+{
+    parse_threads(DEFAULT_THREADS);
+    for (int i = 1; i < argc; i++)
+    {
+        // 값이 없는 옵션
+        if (strcmp(argv[i], "--serialize") == 0)
+        {
+            g_config.serialize = true;
+            continue;
+        }
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (value == NULL)
+        {
+            print_usage(argv[0]);
+            return false;
+        }
+        bool ok = true;
+        if (strcmp(argv[i], "--threads") == 0)
+            ok = parse_threads(value);
+        else if (strcmp(argv[i], "--seconds") == 0)
+            g_config.seconds = atoi(value);
+        else if (strcmp(argv[i], "--users") == 0)
+            g_config.users = atoi(value);
+        else if (strcmp(argv[i], "--memos") == 0)
+            g_config.memos = atoi(value);
+        else if (strcmp(argv[i], "--write-percent") == 0)
+            g_config.write_percent = atoi(value);
+        else if (strcmp(argv[i], "--stripes") == 0)
+            g_config.stripes = atoi(value);
+        else
+            ok = false;
+        if (!ok)
+        {
+            print_usage(argv[0]);
+            return false;
+        }
+        i++;
+    }
+    if (g_config.seconds <= 0 || g_config.users <= 0 || g_config.memos <= 0 || g_config.write_percent < 0 ||
+        g_config.write_percent > 100 || g_config.stripes <= 0 || g_config.stripes > MAX_STORE_PARTITIONS)
+    {
+        print_usage(argv[0]);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    if (!parse_args(argc, argv))
+        return 1;
+
+    char dir[] = "/tmp/store_bench.XXXXXX";
+    printf("[저장소 벤치] 사용자 %d명 x 메모 %d개, 변경 %d%%, 파티션 %d개%s, CPU %d개\n", g_config.users, g_config.memos,
+           g_config.write_percent, g_config.stripes, g_config.serialize ? ", 전역 잠금" : "", ps_cpu_count());
+    bool prepared = prepare_store(dir);
+    if (!prepared)
+        printf("[저장소 벤치] 임시 저장소를 준비하지 못했습니다. (%s)\n", dir);
+
+    int status = prepared ? 0 : 1;
+    double base = 0.0;
+    for (int i = 0; i < g_config.thread_steps && prepared; i++)
+    {
+        unsigned long long reads, writes;
+        double rate = run_step(g_config.threads[i], &reads, &writes);
+        if (rate < 0)
+        {
+            printf("[저장소 벤치] 스레드를 만들지 못했습니다.\n");
+            status = 1;
+            break;
+        }
+        if (i == 0)
+            base = rate;
+        printf("[저장소 벤치] 스레드 %3d개: 초당 %10.0f건 (조회 %llu, 변경 %llu), 첫 항목 대비 %.2f배\n", g_config.threads[i], rate,
+               reads, writes, base > 0 ? rate / base : 0.0);
+    }
+
+    memo_cleanup();
+    user_cleanup();
+    remove_store(dir);
+    return status;
+}
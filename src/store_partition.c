@@ -0,0 +1,72 @@
+// src/store_partition.c
+
+// 읽기/쓰기 잠금을 쓰기 우선으로 설정하는 pthread_rwlockattr_setkind_np 사용 (platform.h의 ps_rwlock_init)
+#define _GNU_SOURCE
+#include "store_partition.h"
+#include "platform.h"
+#include <string.h>
+#include <stdint.h>
+
+static int g_partition_count = 1;                           // 파티션 수
+static ps_rwlock_t g_partition_locks[MAX_STORE_PARTITIONS]; // 파티션별 읽기/쓰기 잠금
+
+// 파티션 수 설정 (잠금 초기화도 함께 하므로 스레드를 만들기 전에 한 번만 호출)
+void store_set_partition_count(int count)
+{
+    if (count < 1)
+        count = 1;
+    if (count > MAX_STORE_PARTITIONS)
+        count = MAX_STORE_PARTITIONS;
+    g_partition_count = count;
+    for (int i = 0; i < count; i++)
+        ps_rwlock_init(&g_partition_locks[i]);
+}
+
+// 현재 파티션 수
+int store_partition_count(void)
+{
+    return g_partition_count;
+}
+
+// 사용자 ID가 속한 파티션 번호
+int store_partition_of(const char *user_id)
+{
+    return store_partition_of_n(user_id, strlen(user_id));
+}
+
+// 길이가 주어진 사용자 ID가 속한 파티션 번호 (FNV-1a 해시)
+int store_partition_of_n(const char *user_id, size_t len)
+{
+    if (g_partition_count == 1)
+        return 0;
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; i++)
+    {
+        hash ^= (unsigned char)user_id[i];
+        hash *= 16777619u;
+    }
+    // 홀수를 곱하는 FNV-1a의 아래 비트는 각 바이트의 아래 비트로만 정해지므로(맨 아래 비트는 홀수 바이트 수의 홀짝)
+    // 2의 거듭제곱 개로 나누기 전에 위 비트를 섞는다.
+    hash ^= hash >> 16;
+    return (int)(hash % (uint32_t)g_partition_count);
+}
+
+// 파티션 잠금
+void store_lock_partition(int partition, bool write)
+{
+    ps_rwlock_t *lock = &g_partition_locks[partition < 0 ? 0 : partition];
+    if (write)
+        ps_rwlock_write_lock(lock);
+    else
+        ps_rwlock_read_lock(lock);
+}
+
+// 파티션 잠금 해제
+void store_unlock_partition(int partition, bool write)
+{
+    ps_rwlock_t *lock = &g_partition_locks[partition < 0 ? 0 : partition];
+    if (write)
+        ps_rwlock_write_unlock(lock);
+    else
+        ps_rwlock_read_unlock(lock);
+}
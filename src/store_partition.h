@@ -0,0 +1,39 @@
+// src/store_partition.h
+
+#ifndef STORE_PARTITION_H
+#define STORE_PARTITION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// 사용자/메모 저장소 파티션
+// 사용자 ID의 해시로 파티션을 정하고, 사용자 목록(user.c)과 메모 목록(memo.c)을 파티션마다 따로 둔다.
+// 샤드 모드(--shards N)에서는 파티션 i를 샤드 i만 접근하므로, 샤드끼리 잠금 없이 서로 다른 사용자를 처리할 수 있다.
+// 기본 모드는 파티션 STORE_LOCK_STRIPES개를 두고 파티션마다 읽기/쓰기 잠금을 하나씩 건다. (command_dispatch.c)
+//  - 메모 ID로 찾는 조회는 읽기 잠금이라 같은 파티션이라도 여러 스레드가 동시에 처리한다.
+//  - 목록/검색/내보내기는 잠그지 않고 메모 판을 읽는다. (에포크 구간, epoch.h)
+//  - 변경 명령은 쓰기 잠금이라 그 파티션의 다른 요청만 기다리고, 다른 파티션의 사용자는 막지 않는다.
+// 요청 하나는 자기 사용자의 파티션만 건드리므로 (샤드 모드가 이미 이 성질에 기댐) 잠금 하나로 충분하다.
+
+#define MAX_STORE_PARTITIONS 64 // 최대 파티션 수 (= 최대 샤드 수)
+#define STORE_LOCK_STRIPES 16   // 샤드 모드가 아닐 때의 파티션 수 (= 잠금 수)
+
+// 파티션 수 설정 (user_init/memo_init 전에 호출)
+void store_set_partition_count(int count);
+
+// 현재 파티션 수
+int store_partition_count(void);
+
+// 사용자 ID가 속한 파티션 번호
+int store_partition_of(const char *user_id);
+
+// 길이가 주어진(null 문자로 끝나지 않을 수 있는) 사용자 ID가 속한 파티션 번호
+int store_partition_of_n(const char *user_id, size_t len);
+
+// 파티션 잠금 (샤드 모드가 아닐 때 디스패처가 핸들러 실행 전후로 호출)
+// - partition: 잠글 파티션 (-1이면 사용자가 없는 요청이므로 파티션 0을 잠금)
+// - write: 저장소를 바꾸는 요청이면 true (쓰기 잠금), 조회만 하면 false (읽기 잠금)
+void store_lock_partition(int partition, bool write);
+void store_unlock_partition(int partition, bool write);
+
+#endif
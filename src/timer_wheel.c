@@ -0,0 +1,189 @@
+// src/timer_wheel.c
+
+#include "timer_wheel.h"
+#include <limits.h>
+
+#define SLOT_MASK (TIMER_WHEEL_SLOTS - 1)
+
+// 단계 level의 칸 번호 (틱 값에서 그 단계에 해당하는 6비트)
+static unsigned slot_of(uint64_t tick, int level)
+{
+    return (unsigned)(tick >> (level * TIMER_WHEEL_BITS)) & SLOT_MASK;
+}
+
+// 칸이 비어 있는지 여부
+static bool slot_empty(const TimerNode *head)
+{
+    return head->next == head;
+}
+
+// 칸 리스트 끝에 추가
+static void list_append(TimerNode *head, TimerNode *timer)
+{
+    timer->prev = head->prev;
+    timer->next = head;
+    head->prev->next = timer;
+    head->prev = timer;
+}
+
+// 리스트에서 제거
+static void list_remove(TimerNode *timer)
+{
+    timer->prev->next = timer->next;
+    timer->next->prev = timer->prev;
+    timer->prev = timer->next = NULL;
+}
+
+// 만료 틱에 맞는 칸에 넣음 (expire_tick >= current_tick이어야 함)
+// 현재 틱과 만료 틱이 처음으로 달라지는 6비트 묶음이 단계가 된다. 그 단계보다 위의 비트는 같으므로
+// 칸은 항상 현재 위치보다 앞에 있고, 현재 틱이 그 칸의 구간에 들어설 때 아래 단계로 옮겨진다.
+// 맨 윗단계보다 멀리 있으면 맨 윗단계에 넣어 두고, 옮길 때 다시 자리를 찾는다.
+static void place(TimerWheel *wheel, TimerNode *timer)
+{
+    uint64_t diff = timer->expire_tick ^ wheel->current_tick;
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 && (diff >> ((level + 1) * TIMER_WHEEL_BITS)) != 0)
+    {
+        level++;
+    }
+    unsigned slot = slot_of(timer->expire_tick, level);
+    list_append(&wheel->slots[level][slot], timer);
+    wheel->occupied[level] |= 1ULL << slot;
+}
+
+// 휠 초기화
+void timer_wheel_init(TimerWheel *wheel, uint64_t now_ms, unsigned tick_ms)
+{
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++)
+    {
+        for (int slot = 0; slot < TIMER_WHEEL_SLOTS; slot++)
+        {
+            TimerNode *head = &wheel->slots[level][slot];
+            head->prev = head->next = head;
+        }
+        wheel->occupied[level] = 0;
+    }
+    wheel->current_tick = 0;
+    wheel->start_ms = now_ms;
+    wheel->tick_ms = tick_ms > 0 ? tick_ms : 1;
+    wheel->count = 0;
+}
+
+// 타이머 노드 초기화
+void timer_init(TimerNode *timer, TimerCallback callback)
+{
+    timer->prev = timer->next = NULL;
+    timer->expire_tick = 0;
+    timer->callback = callback;
+}
+
+// 등록 여부
+bool timer_pending(const TimerNode *timer)
+{
+    return timer->next != NULL;
+}
+
+// 만료 시각 등록
+void timer_wheel_schedule(TimerWheel *wheel, TimerNode *timer, uint64_t expire_ms)
+{
+    if (timer_pending(timer))
+    {
+        list_remove(timer);
+        wheel->count--;
+    }
+    // 만료 시각이 들어 있는 틱이 끝날 때 만료 (틱 경계에 걸치면 늦게 만료될 뿐 일찍 만료되지는 않음)
+    uint64_t tick = expire_ms > wheel->start_ms ? (expire_ms - wheel->start_ms + wheel->tick_ms - 1) / wheel->tick_ms : 0;
+    if (tick <= wheel->current_tick)
+        tick = wheel->current_tick + 1;
+    timer->expire_tick = tick;
+    place(wheel, timer);
+    wheel->count++;
+}
+
+// 등록 취소 (칸의 occupied 비트는 그 칸을 처리할 때 지움)
+void timer_wheel_cancel(TimerWheel *wheel, TimerNode *timer)
+{
+    if (!timer_pending(timer))
+        return;
+    list_remove(timer);
+    wheel->count--;
+}
+
+// 윗단계 칸 하나의 타이머들을 현재 틱 기준으로 다시 배치
+static void cascade(TimerWheel *wheel, int level, unsigned slot)
+{
+    TimerNode *head = &wheel->slots[level][slot];
+    wheel->occupied[level] &= ~(1ULL << slot);
+    // 리스트를 떼어 낸 뒤 하나씩 다시 넣음 (같은 칸으로 돌아올 수 있으므로)
+    if (slot_empty(head))
+        return;
+    TimerNode *first = head->next;
+    TimerNode *last = head->prev;
+    head->prev = head->next = head;
+    last->next = NULL;
+    while (first)
+    {
+        TimerNode *timer = first;
+        first = first->next;
+        place(wheel, timer);
+    }
+}
+
+// 지난 틱들을 처리하며 만료된 타이머의 콜백 호출
+int timer_wheel_advance(TimerWheel *wheel, uint64_t now_ms)
+{
+    uint64_t target = now_ms > wheel->start_ms ? (now_ms - wheel->start_ms) / wheel->tick_ms : 0;
+    int fired = 0;
+    while (wheel->current_tick < target)
+    {
+        // 등록된 타이머가 없으면 남은 틱은 건너뜀
+        if (wheel->count == 0)
+        {
+            wheel->current_tick = target;
+            break;
+        }
+        uint64_t tick = ++wheel->current_tick;
+
+        // 이 틱에서 구간이 시작되는 윗단계 칸들을 위에서부터 아래 단계로 옮김
+        int top = 0;
+        while (top < TIMER_WHEEL_LEVELS - 1 && slot_of(tick, top) == 0)
+        {
+            top++;
+        }
+        for (int level = top; level > 0; level--)
+        {
+            cascade(wheel, level, slot_of(tick, level));
+        }
+
+        // 이 틱에 만료되는 타이머 (콜백이 다른 타이머를 등록/취소할 수 있으므로 하나씩 꺼냄)
+        unsigned slot = slot_of(tick, 0);
+        TimerNode *head = &wheel->slots[0][slot];
+        while (!slot_empty(head))
+        {
+            TimerNode *timer = head->next;
+            list_remove(timer);
+            wheel->count--;
+            fired++;
+            timer->callback(timer);
+        }
+        wheel->occupied[0] &= ~(1ULL << slot);
+    }
+    return fired;
+}
+
+// 다음 처리 시점까지 남은 시간
+int timer_wheel_next_timeout(TimerWheel *wheel, uint64_t now_ms)
+{
+    if (wheel->count == 0)
+        return -1;
+    // 단계 0의 남은 칸 중 타이머가 있는 첫 칸, 없으면 다음 64틱 구간이 시작되는 틱(윗단계 칸을 옮겨야 함)
+    uint64_t current = wheel->current_tick;
+    unsigned index = slot_of(current, 0);
+    uint64_t ahead = index == SLOT_MASK ? 0 : wheel->occupied[0] & (~0ULL << (index + 1));
+    uint64_t next_tick = ahead ? (current & ~(uint64_t)SLOT_MASK) + (uint64_t)__builtin_ctzll(ahead)
+                               : (current | SLOT_MASK) + 1;
+    uint64_t due_ms = wheel->start_ms + next_tick * wheel->tick_ms;
+    if (due_ms <= now_ms)
+        return 0;
+    return due_ms - now_ms > INT_MAX ? INT_MAX : (int)(due_ms - now_ms);
+}
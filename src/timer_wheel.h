@@ -0,0 +1,76 @@
+// src/timer_wheel.h
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// 계층형 타이머 휠
+//
+// 시간을 tick_ms 단위 틱으로 나누고, 만료 시각까지 남은 틱 수에 따라 타이머를 4단계 휠 중 하나의 칸(슬롯)에 넣는다.
+//   단계 0: 64틱 안에 만료 (칸 하나 = 1틱)
+//   단계 1: 64^2틱 안에 만료 (칸 하나 = 64틱), 단계 2, 3도 같은 방식으로 64배씩
+// 등록/취소는 칸의 연결 리스트에 넣고 빼기만 하므로 타이머 수와 상관없이 O(1)이고,
+// 윗단계 칸은 그 칸의 시간이 되었을 때 한 번만 아래 단계로 옮겨진다(cascade).
+// 타이머 노드는 사용하는 쪽 구조체에 멤버로 두므로(침입형) 등록할 때 메모리를 할당하지 않는다.
+//
+// 가장 먼 단계(64^4틱, 틱 100ms 기준 약 19일)를 넘는 타이머는 맨 윗단계에 두었다가 옮길 때마다 다시 자리를 찾으므로
+// 일찍 만료되지 않는다.
+// 스레드 안전하지 않다. 휠 하나는 한 스레드(예: 샤드의 이벤트 루프)에서만 사용하거나 호출하는 쪽이 잠가야 한다.
+
+#define TIMER_WHEEL_LEVELS 4 // 휠 단계 수
+#define TIMER_WHEEL_BITS 6   // 단계별 칸 수의 비트 수
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+
+typedef struct TimerNode TimerNode;
+
+// 만료 시 호출되는 함수 (휠에서 빠진 뒤에 호출되므로 안에서 다시 등록하거나 다른 타이머를 취소해도 됨)
+typedef void (*TimerCallback)(TimerNode *timer);
+
+// 타이머 (사용하는 쪽 구조체에 멤버로 둠)
+struct TimerNode
+{
+    TimerNode *prev;        // 칸 안의 이전 타이머 (등록되지 않았으면 NULL)
+    TimerNode *next;        // 칸 안의 다음 타이머
+    uint64_t expire_tick;   // 만료 틱
+    TimerCallback callback; // 만료 시 호출할 함수
+};
+
+// 타이머 휠
+typedef struct
+{
+    TimerNode slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS]; // 칸마다 원형 연결 리스트의 머리 노드
+    uint64_t occupied[TIMER_WHEEL_LEVELS];                  // 타이머가 있을 수 있는 칸 (비트 i = 칸 i)
+    uint64_t current_tick;                                  // 처리를 마친 마지막 틱
+    uint64_t start_ms;                                      // 틱 0의 시각
+    unsigned tick_ms;                                       // 틱 하나의 길이 (밀리초)
+    size_t count;                                           // 등록된 타이머 수
+} TimerWheel;
+
+// 휠 초기화 (now_ms: 현재 시각, tick_ms: 틱 길이)
+void timer_wheel_init(TimerWheel *wheel, uint64_t now_ms, unsigned tick_ms);
+
+// 타이머 노드 초기화 (등록하기 전에 한 번 호출)
+void timer_init(TimerNode *timer, TimerCallback callback);
+
+// 타이머가 휠에 등록되어 있는지 여부
+bool timer_pending(const TimerNode *timer);
+
+// expire_ms(절대 시각)에 만료되도록 등록 (이미 등록되어 있으면 옮김)
+// 이미 지난 시각이면 다음 틱에 만료된다.
+void timer_wheel_schedule(TimerWheel *wheel, TimerNode *timer, uint64_t expire_ms);
+
+// 등록 취소 (등록되어 있지 않으면 아무것도 하지 않음)
+void timer_wheel_cancel(TimerWheel *wheel, TimerNode *timer);
+
+// now_ms까지 지난 틱들을 처리하며 만료된 타이머의 콜백 호출
+// 반환값: 만료된 타이머 수
+int timer_wheel_advance(TimerWheel *wheel, uint64_t now_ms);
+
+// 다음에 timer_wheel_advance를 호출해야 할 때까지 남은 시간 (밀리초)
+// 등록된 타이머가 없으면 -1 (epoll_wait 등의 대기 시간으로 그대로 사용할 수 있음)
+int timer_wheel_next_timeout(TimerWheel *wheel, uint64_t now_ms);
+
+#endif
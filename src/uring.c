@@ -0,0 +1,251 @@
+// src/uring.c
+
+#include "uring.h"
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+// 커널과 공유하는 인덱스 읽기/쓰기 (커널이 항목 내용을 본 뒤에 인덱스가 바뀌도록 순서 보장)
+#define LOAD_ACQUIRE(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+// 시스템 콜 래퍼 (glibc가 io_uring 함수를 제공하지 않음)
+static int sys_io_uring_setup(unsigned entries, struct io_uring_params *params)
+{
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+{
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+// 대기 시간을 지정한 io_uring_enter (IORING_ENTER_EXT_ARG, 커널 5.11 이상)
+static int sys_io_uring_enter_ext(int fd, unsigned to_submit, unsigned min_complete, unsigned flags,
+                                  struct io_uring_getevents_arg *arg)
+{
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags | IORING_ENTER_EXT_ARG, arg, sizeof(*arg));
+}
+
+static int sys_io_uring_register(int fd, unsigned opcode, void *arg, unsigned nr_args)
+{
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+// io_uring 생성
+bool uring_init(Uring *ring, unsigned entries)
+{
+    memset(ring, 0, sizeof(*ring));
+    ring->fd = -1;
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    // 제출은 이벤트 루프 스레드 하나만 하므로 커널이 잠금/인터럽트를 줄일 수 있게 알려 줌
+    params.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_COOP_TASKRUN;
+    int fd = sys_io_uring_setup(entries, &params);
+    // 오래된 커널은 위 플래그를 모름 (EINVAL) → 플래그 없이 다시 시도
+    if (fd < 0 && errno == EINVAL)
+    {
+        memset(&params, 0, sizeof(params));
+        fd = sys_io_uring_setup(entries, &params);
+    }
+    if (fd < 0)
+        return false;
+    // 완료 큐 넘침 시 항목을 버리지 않는 커널만 사용 (5.5 이상)
+    if (!(params.features & IORING_FEAT_NODROP) || !(params.features & IORING_FEAT_SINGLE_MMAP))
+    {
+        close(fd);
+        errno = ENOSYS;
+        return false;
+    }
+    ring->fd = fd;
+
+    // 제출/완료 큐 링 매핑 (SINGLE_MMAP: 두 링이 한 영역을 공유)
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (ring->cq_ring_size > ring->sq_ring_size)
+        ring->sq_ring_size = ring->cq_ring_size;
+    ring->cq_ring_size = ring->sq_ring_size;
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ring == MAP_FAILED)
+    {
+        ring->sq_ring = NULL;
+        uring_exit(ring);
+        return false;
+    }
+    ring->cq_ring = ring->sq_ring;
+
+    // 제출 항목 배열 매핑
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = (struct io_uring_sqe *)mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED)
+    {
+        ring->sqes = NULL;
+        uring_exit(ring);
+        return false;
+    }
+
+    char *sq = (char *)ring->sq_ring;
+    ring->sq_head = (unsigned *)(sq + params.sq_off.head);
+    ring->sq_tail = (unsigned *)(sq + params.sq_off.tail);
+    ring->sq_mask = *(unsigned *)(sq + params.sq_off.ring_mask);
+    ring->sq_entries = params.sq_entries;
+    ring->sqe_tail = *ring->sq_tail;
+    // 제출 큐 인덱스 배열은 항목 배열과 1:1로 고정
+    unsigned *array = (unsigned *)(sq + params.sq_off.array);
+    for (unsigned i = 0; i < params.sq_entries; i++)
+    {
+        array[i] = i;
+    }
+
+    char *cq = (char *)ring->cq_ring;
+    ring->cq_head = (unsigned *)(cq + params.cq_off.head);
+    ring->cq_tail = (unsigned *)(cq + params.cq_off.tail);
+    ring->cq_mask = *(unsigned *)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+    return true;
+}
+
+// io_uring 해제
+void uring_exit(Uring *ring)
+{
+    if (ring->buf_ring)
+        munmap(ring->buf_ring, ring->buf_ring_size);
+    if (ring->buf_base)
+        munmap(ring->buf_base, (size_t)ring->buf_count * ring->buf_size);
+    if (ring->sqes)
+        munmap(ring->sqes, ring->sqes_size);
+    if (ring->sq_ring)
+        munmap(ring->sq_ring, ring->sq_ring_size);
+    if (ring->fd >= 0)
+        close(ring->fd);
+    memset(ring, 0, sizeof(*ring));
+    ring->fd = -1;
+}
+
+// 수신용 버퍼 링 등록
+bool uring_setup_buffers(Uring *ring, uint16_t group, unsigned count, unsigned size)
+{
+    // 버퍼 목록은 페이지 정렬된 메모리여야 함
+    size_t ring_size = count * sizeof(struct io_uring_buf);
+    void *br = mmap(NULL, ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (br == MAP_FAILED)
+        return false;
+    void *base = mmap(NULL, (size_t)count * size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED)
+    {
+        munmap(br, ring_size);
+        return false;
+    }
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)br;
+    reg.ring_entries = count;
+    reg.bgid = group;
+    if (sys_io_uring_register(ring->fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0)
+    {
+        munmap(base, (size_t)count * size);
+        munmap(br, ring_size);
+        return false;
+    }
+    ring->buf_ring = (struct io_uring_buf_ring *)br;
+    ring->buf_ring_size = ring_size;
+    ring->buf_base = (char *)base;
+    ring->buf_count = count;
+    ring->buf_size = size;
+    ring->buf_group = group;
+
+    // 모든 버퍼를 커널에 넘김
+    for (unsigned i = 0; i < count; i++)
+    {
+        struct io_uring_buf *buf = &ring->buf_ring->bufs[i];
+        buf->addr = (uint64_t)(uintptr_t)(ring->buf_base + (size_t)i * size);
+        buf->len = size;
+        buf->bid = (uint16_t)i;
+    }
+    STORE_RELEASE(&ring->buf_ring->tail, (uint16_t)count);
+    return true;
+}
+
+// 버퍼 ID → 버퍼 주소
+char *uring_buffer(Uring *ring, uint16_t bid)
+{
+    return ring->buf_base + (size_t)bid * ring->buf_size;
+}
+
+// 다 쓴 버퍼를 버퍼 링 끝에 다시 추가
+void uring_recycle_buffer(Uring *ring, uint16_t bid)
+{
+    uint16_t tail = ring->buf_ring->tail;
+    struct io_uring_buf *buf = &ring->buf_ring->bufs[tail & (ring->buf_count - 1)];
+    buf->addr = (uint64_t)(uintptr_t)uring_buffer(ring, bid);
+    buf->len = ring->buf_size;
+    buf->bid = bid;
+    STORE_RELEASE(&ring->buf_ring->tail, (uint16_t)(tail + 1));
+}
+
+// 비어 있는 제출 항목 얻기
+struct io_uring_sqe *uring_get_sqe(Uring *ring)
+{
+    // 제출 큐가 가득 차면 대기 없이 먼저 제출
+    if (ring->sqe_tail - LOAD_ACQUIRE(ring->sq_head) >= ring->sq_entries)
+    {
+        if (uring_submit_and_wait(ring, 0) < 0 || ring->sqe_tail - LOAD_ACQUIRE(ring->sq_head) >= ring->sq_entries)
+            return NULL;
+    }
+    struct io_uring_sqe *sqe = &ring->sqes[ring->sqe_tail & ring->sq_mask];
+    memset(sqe, 0, sizeof(*sqe));
+    ring->sqe_tail++;
+    return sqe;
+}
+
+// 쌓인 요청 제출 및 완료 대기
+int uring_submit_and_wait(Uring *ring, unsigned wait_nr)
+{
+    // 새로 채운 항목을 커널에 공개 (지난번에 다 가져가지 못한 항목도 다시 제출)
+    STORE_RELEASE(ring->sq_tail, ring->sqe_tail);
+    unsigned to_submit = ring->sqe_tail - LOAD_ACQUIRE(ring->sq_head);
+    if (to_submit == 0 && wait_nr == 0)
+        return 0;
+
+    ring->enter_calls++;
+    int ret = sys_io_uring_enter(ring->fd, to_submit, wait_nr, wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0);
+    return ret < 0 ? -errno : ret;
+}
+
+// 쌓인 요청 제출 및 최대 timeout_ms 동안 완료 대기
+int uring_submit_and_wait_timeout(Uring *ring, unsigned wait_nr, int timeout_ms)
+{
+    if (timeout_ms < 0 || wait_nr == 0)
+        return uring_submit_and_wait(ring, wait_nr);
+
+    STORE_RELEASE(ring->sq_tail, ring->sqe_tail);
+    unsigned to_submit = ring->sqe_tail - LOAD_ACQUIRE(ring->sq_head);
+
+    struct __kernel_timespec ts = {timeout_ms / 1000, (long long)(timeout_ms % 1000) * 1000000LL};
+    struct io_uring_getevents_arg arg = {0};
+    arg.ts = (uint64_t)(uintptr_t)&ts;
+    ring->enter_calls++;
+    int ret = sys_io_uring_enter_ext(ring->fd, to_submit, wait_nr, IORING_ENTER_GETEVENTS, &arg);
+    if (ret < 0)
+        return errno == ETIME ? 0 : -errno; // 시간이 지난 것은 정상 (완료 항목 없이 돌아옴)
+    return ret;
+}
+
+// 처리하지 않은 완료 항목
+struct io_uring_cqe *uring_peek_cqe(Uring *ring)
+{
+    unsigned head = *ring->cq_head;
+    if (head == LOAD_ACQUIRE(ring->cq_tail))
+        return NULL;
+    return &ring->cqes[head & ring->cq_mask];
+}
+
+// 완료 항목 처리 완료
+void uring_cqe_seen(Uring *ring)
+{
+    STORE_RELEASE(ring->cq_head, *ring->cq_head + 1);
+}
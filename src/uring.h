@@ -0,0 +1,88 @@
+// src/uring.h
+
+#ifndef URING_H
+#define URING_H
+
+// Linux 전용: io_uring 시스템 콜을 직접 사용하는 얇은 래퍼 (liburing 없이 커널 헤더만 사용)
+// 이벤트 루프(event_loop.c)의 io_uring 입출력 방식에서 사용한다.
+//  - 제출 큐(SQ)에 요청을 쌓아 두었다가 io_uring_enter 한 번으로 제출하고 완료를 기다린다.
+//  - 수신은 미리 등록해 둔 버퍼 링(provided buffers)에서 커널이 버퍼를 골라 채운다.
+
+#include <linux/io_uring.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// io_uring 인스턴스
+typedef struct
+{
+    int fd; // io_uring 파일 디스크립터 (-1이면 미사용)
+
+    // 제출 큐 (커널과 공유하는 메모리)
+    unsigned *sq_head;         // 커널이 가져간 위치
+    unsigned *sq_tail;         // 제출한 위치
+    unsigned sq_mask;          // 인덱스 마스크
+    unsigned sq_entries;       // 크기
+    struct io_uring_sqe *sqes; // 요청 항목 배열
+    unsigned sqe_tail;         // 채운 위치 (제출할 때 sq_tail에 반영)
+
+    // 완료 큐 (커널과 공유하는 메모리)
+    unsigned *cq_head;         // 읽은 위치
+    unsigned *cq_tail;         // 커널이 채운 위치
+    unsigned cq_mask;          // 인덱스 마스크
+    struct io_uring_cqe *cqes; // 완료 항목 배열
+
+    // mmap 영역
+    void *sq_ring;
+    size_t sq_ring_size;
+    void *cq_ring;
+    size_t cq_ring_size;
+    size_t sqes_size;
+
+    // 수신용 버퍼 링
+    struct io_uring_buf_ring *buf_ring; // 커널과 공유하는 버퍼 목록
+    size_t buf_ring_size;               // 버퍼 목록 mmap 크기
+    char *buf_base;                     // 버퍼 메모리 시작
+    unsigned buf_count;                 // 버퍼 수 (2의 거듭제곱)
+    unsigned buf_size;                  // 버퍼 하나의 크기
+    uint16_t buf_group;                 // 버퍼 그룹 ID
+
+    unsigned long long enter_calls; // io_uring_enter 호출 횟수 (벤치마크용)
+} Uring;
+
+// io_uring 생성 (entries: 제출 큐 크기, 2의 거듭제곱)
+// 커널이 지원하지 않거나(ENOSYS) 보안 정책으로 막혀 있으면(EPERM) false
+bool uring_init(Uring *ring, unsigned entries);
+
+// io_uring과 버퍼 링 해제 (진행 중인 요청은 커널이 취소함)
+void uring_exit(Uring *ring);
+
+// 수신용 버퍼 링 등록 (count: 버퍼 수, 2의 거듭제곱 / size: 버퍼 하나의 크기)
+// 커널 5.19 미만이면 false
+bool uring_setup_buffers(Uring *ring, uint16_t group, unsigned count, unsigned size);
+
+// 커널이 완료 항목에 담아 준 버퍼 ID로 버퍼 주소 계산
+char *uring_buffer(Uring *ring, uint16_t bid);
+
+// 다 쓴 버퍼를 버퍼 링에 되돌림
+void uring_recycle_buffer(Uring *ring, uint16_t bid);
+
+// 비어 있는 제출 항목 하나를 0으로 초기화하여 돌려줌
+// 제출 큐가 가득 차면 쌓인 요청을 먼저 제출한 뒤 다시 시도한다.
+struct io_uring_sqe *uring_get_sqe(Uring *ring);
+
+// 쌓인 요청을 제출하고 완료 항목이 wait_nr개 이상 생길 때까지 대기
+// 반환값: 제출한 요청 수, 실패 시 -errno (시그널로 중단되면 -EINTR)
+int uring_submit_and_wait(Uring *ring, unsigned wait_nr);
+
+// uring_submit_and_wait와 같지만 최대 timeout_ms 동안만 대기 (음수면 무한 대기, 시간이 지나도 오류가 아님)
+// 이벤트 루프가 타이머 휠의 다음 만료 시각까지만 잠들 때 사용한다. (커널 5.11 이상)
+int uring_submit_and_wait_timeout(Uring *ring, unsigned wait_nr, int timeout_ms);
+
+// 처리하지 않은 완료 항목 (없으면 NULL)
+struct io_uring_cqe *uring_peek_cqe(Uring *ring);
+
+// 완료 항목 하나를 처리했음을 커널에 알림
+void uring_cqe_seen(Uring *ring);
+
+#endif
@@ -1,6 +1,8 @@
 // src/user.c
 
 #include "user.h"
+#include "platform.h"
+#include "store_partition.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -8,8 +10,17 @@
 
 #define USERS_FILE "data/users.txt"
 
-// 연결 리스트의 헤드 포인터
-static UserNode *user_list_head = NULL;
+// 연결 리스트의 헤드 포인터 (사용자 ID의 파티션마다 하나, store_partition.h)
+// 파티션의 목록은 그 파티션을 맡은 샤드만 읽고 고치지만, 파일 저장은 모든 파티션을 읽으므로
+// 목록을 고칠 때와 파일에 저장할 때는 g_user_file_lock을 잡는다. (조회는 잠금 없음)
+static UserNode *user_list_heads[MAX_STORE_PARTITIONS];
+static ps_mutex_t g_user_file_lock = PS_MUTEX_INITIALIZER;
+
+// 사용자가 속한 목록의 헤드
+static UserNode **user_head_of(const char *id)
+{
+    return &user_list_heads[store_partition_of(id)];
+}
 
 // 새로운 UserNode를 생성하고 초기화
 UserNode *create_user_node(const char *id, const char *pw)
@@ -63,21 +74,24 @@ void user_init()
 // 연결 리스트의 모든 노드 메모리를 해제
 void user_cleanup()
 {
-    // 현재 노드 포인터
-    UserNode *current = user_list_head;
-    // 다음 노드 포인터
-    UserNode *next_node;
-    // 모든 노드 메모리 해제
-    while (current != NULL)
+    // 모든 파티션의 노드 메모리 해제
+    for (int p = 0; p < MAX_STORE_PARTITIONS; p++)
     {
-        // 다음 노드 포인터 저장
-        next_node = current->next;
-        // 현재 노드 메모리 해제
-        free(current);
-        //
-        current = next_node;
-    }
-    user_list_head = NULL;
+        // 현재 노드 포인터
+        UserNode *current = user_list_heads[p];
+        // 다음 노드 포인터
+        UserNode *next_node;
+        while (current != NULL)
+        {
+            // 다음 노드 포인터 저장
+            next_node = current->next;
+            // 현재 노드 메모리 해제
+            free(current);
+            //
+            current = next_node;
+        }
+        user_list_heads[p] = NULL;
+    }
     printf("[정보] 모든 사용자 정보 메모리를 해제했습니다.\n");
 }
 
@@ -85,7 +99,7 @@ void user_cleanup()
 User *user_find_by_id(const char *id)
 {
     // 현재 노드 포인터
-    UserNode *current = user_list_head;
+    UserNode *current = *user_head_of(id);
     // 모든 노드 탐색
     while (current != NULL)
     {
@@ -118,14 +132,16 @@ bool user_add(const char *id, const char *pw)
     }
 
     // 리스트의 끝에 추가
-    if (user_list_head == NULL)
+    UserNode **head = user_head_of(id);
+    ps_mutex_lock(&g_user_file_lock);
+    if (*head == NULL)
     {
-        user_list_head = newNode;
+        *head = newNode;
     }
     else
     {
         // 마지막 노드 찾기
-        UserNode *current = user_list_head;
+        UserNode *current = *head;
         while (current->next != NULL)
         {
             // 다음 노드 포인터 이동
@@ -134,6 +150,7 @@ bool user_add(const char *id, const char *pw)
         // 마지막 노드의 다음 노드 포인터 설정
         current->next = newNode;
     }
+    ps_mutex_unlock(&g_user_file_lock);
 
     // 변경사항은 서버 종료 시점에 일괄 저장
     return true;
@@ -143,7 +160,8 @@ bool user_add(const char *id, const char *pw)
 bool user_delete_by_id(const char *id)
 {
     // 현재 노드 포인터
-    UserNode *current = user_list_head;
+    UserNode **head = user_head_of(id);
+    UserNode *current = *head;
     // 이전 노드 포인터
     UserNode *prev = NULL;
 
@@ -162,15 +180,17 @@ bool user_delete_by_id(const char *id)
     }
 
     // 찾은 노드를 리스트에서 제거
+    ps_mutex_lock(&g_user_file_lock);
     if (prev == NULL)
     { // 첫 번째 노드인 경우
-        user_list_head = current->next;
+        *head = current->next;
     }
     else
     {
         // 이전 노드의 다음 노드 포인터 설정
         prev->next = current->next;
     }
+    ps_mutex_unlock(&g_user_file_lock);
     // 현재 노드 메모리 해제
     free(current);
 
@@ -188,8 +208,10 @@ bool user_update_password(const char *id, const char *new_pw)
     {
         return false;
     }
+    ps_mutex_lock(&g_user_file_lock);
     strncpy(user->pw, new_pw, MAX_PW_LEN - 1);
     user->pw[MAX_PW_LEN - 1] = '\0';
+    ps_mutex_unlock(&g_user_file_lock);
 
     // 변경사항은 서버 종료 시점에 일괄 저장
     return true;
@@ -198,23 +220,25 @@ bool user_update_password(const char *id, const char *new_pw)
 // 현재 연결 리스트의 모든 사용자 정보를 파일에 저장
 void user_save_to_file()
 {
+    ps_mutex_lock(&g_user_file_lock);
     FILE *file = fopen(USERS_FILE, "w");
     if (file == NULL)
     {
+        ps_mutex_unlock(&g_user_file_lock);
         perror("[에러] 사용자 파일 저장 실패");
         return;
     }
 
-    // 현재 노드 포인터
-    UserNode *current = user_list_head;
-    // 모든 노드 탐색
-    while (current != NULL)
+    // 모든 파티션의 노드 탐색
+    for (int p = 0; p < MAX_STORE_PARTITIONS; p++)
     {
-        // 파일에 사용자 정보 쓰기
-        fprintf(file, "%s:%s\n", current->user.id, current->user.pw);
-        // 다음 노드 포인터 이동
-        current = current->next;
+        for (UserNode *current = user_list_heads[p]; current != NULL; current = current->next)
+        {
+            // 파일에 사용자 정보 쓰기
+            fprintf(file, "%s:%s\n", current->user.id, current->user.pw);
+        }
     }
 
     fclose(file);
+    ps_mutex_unlock(&g_user_file_lock);
 }
@@ -3,6 +3,8 @@
 #include "user_command.h"
 #include "user.h"
 #include "memo.h"
+#include "session.h"
+#include "platform.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdbool.h>
@@ -54,22 +56,23 @@ static bool is_valid_password(const char *pw)
 }
 
 // 사용자 명령 처리
-void handle_user_command(const char *request, char *reply, int reply_size)
+void handle_user_command(const char *request, ReplyBuffer *reply)
 {
     // 요청 복사
     char *request_copy = strdup(request);
     // 복사 실패 시
     if (request_copy == NULL)
     {
-        snprintf(reply, reply_size, "FAIL:서버 메모리 할당 오류");
+        reply_set(reply, "FAIL:서버 메모리 할당 오류");
         return;
     }
-    // 명령어 파싱
-    char *command = strtok(request_copy, DELIMITER);
+    // 명령어 파싱 (여러 샤드에서 동시에 실행될 수 있으므로 재진입 가능한 분리 함수 사용)
+    char *save_ptr = NULL;
+    char *command = ps_strtok_r(request_copy, DELIMITER, &save_ptr);
     // 명령어 없음
     if (command == NULL)
     {
-        snprintf(reply, reply_size, "FAIL:잘못된 요청 형식입니다.");
+        reply_set(reply, "FAIL:잘못된 요청 형식입니다.");
         free(request_copy);
         return;
     }
@@ -78,13 +81,13 @@ void handle_user_command(const char *request, char *reply, int reply_size)
     if (strcmp(command, "LOGIN") == 0)
     {
         // 아이디 파싱
-        char *id = strtok(NULL, DELIMITER);
+        char *id = ps_strtok_r(NULL, DELIMITER, &save_ptr);
         // 비밀번호 파싱
-        char *pw = strtok(NULL, DELIMITER);
+        char *pw = ps_strtok_r(NULL, DELIMITER, &save_ptr);
         // 아이디 또는 비밀번호 없음
         if (id == NULL || pw == NULL)
         {
-            snprintf(reply, reply_size, "FAIL:아이디 또는 비밀번호가 누락되었습니다.");
+            reply_set(reply, "FAIL:아이디 또는 비밀번호가 누락되었습니다.");
         }
         else
         {
@@ -93,49 +96,63 @@ void handle_user_command(const char *request, char *reply, int reply_size)
             // 사용자 존재 및 비밀번호 일치 시
             if (user && strcmp(user->pw, pw) == 0)
             {
-                // 로그인 성공
-                snprintf(reply, reply_size, "OK:로그인 성공");
+                // 로그인 성공: 이후 요청에 사용자 ID 대신 쓸 세션 토큰을 응답 끝에 붙임
+                char token[SESSION_TOKEN_LEN + 1];
+                if (session_create(user->id, token))
+                    reply_set(reply, "OK:로그인 성공:%s", token);
+                else
+                    reply_set(reply, "OK:로그인 성공");
             }
             else
             {
-                snprintf(reply, reply_size, "FAIL:아이디 또는 비밀번호가 틀렸습니다.");
+                reply_set(reply, "FAIL:아이디 또는 비밀번호가 틀렸습니다.");
             }
         }
     }
+    // 로그아웃 (세션 종료)
+    else if (strcmp(command, "LOGOUT") == 0)
+    {
+        // 세션 토큰 파싱
+        char *token = ps_strtok_r(NULL, DELIMITER, &save_ptr);
+        if (token && session_end(token))
+            reply_set(reply, "OK:로그아웃 성공");
+        else
+            reply_set(reply, "FAIL:유효하지 않은 세션입니다.");
+    }
     // 회원가입
     else if (strcmp(command, "REGISTER") == 0)
     {
         // 아이디 파싱
-        char *id = strtok(NULL, DELIMITER);
+        char *id = ps_strtok_r(NULL, DELIMITER, &save_ptr);
         // 비밀번호 파싱
-        char *pw = strtok(NULL, DELIMITER);
+        char *pw = ps_strtok_r(NULL, DELIMITER, &save_ptr);
         // 아이디 또는 비밀번호 없음
         if (id == NULL || pw == NULL)
         {
-            snprintf(reply, reply_size, "FAIL:아이디 또는 비밀번호가 누락되었습니다.");
+            reply_set(reply, "FAIL:아이디 또는 비밀번호가 누락되었습니다.");
         }
         else
         {
             // 아이디 유효성 검사
             if (!is_valid_id(id))
             {
-                snprintf(reply, reply_size, "FAIL:아이디는 영문/숫자 조합으로 %d~%d자여야 합니다.", MIN_ID_LEN, MAX_ID_LEN);
+                reply_set(reply, "FAIL:아이디는 영문/숫자 조합으로 %d~%d자여야 합니다.", MIN_ID_LEN, MAX_ID_LEN);
             }
             // 비밀번호 유효성 검사
             else if (!is_valid_password(pw))
             {
-                snprintf(reply, reply_size, "FAIL:비밀번호는 공백 없이 %d~%d자여야 합니다.", MIN_PW_LEN, MAX_PW_LEN);
+                reply_set(reply, "FAIL:비밀번호는 공백 없이 %d~%d자여야 합니다.", MIN_PW_LEN, MAX_PW_LEN);
             }
             // 사용자 추가
             else if (user_add(id, pw))
             {
                 // 사용자 목록 파일 저장
                 user_save_to_file();
-                snprintf(reply, reply_size, "OK:회원가입 성공");
+                reply_set(reply, "OK:회원가입 성공");
             }
             else
             {
-                snprintf(reply, reply_size, "FAIL:이미 존재하는 아이디이거나 오류가 발생했습니다.");
+                reply_set(reply, "FAIL:이미 존재하는 아이디이거나 오류가 발생했습니다.");
             }
         }
     }
@@ -143,13 +160,13 @@ void handle_user_command(const char *request, char *reply, int reply_size)
     else if (strcmp(command, "DELETE_USER") == 0)
     {
         // 아이디 파싱
-        char *id = strtok(NULL, DELIMITER);
+        char *id = ps_strtok_r(NULL, DELIMITER, &save_ptr);
         // 비밀번호 파싱
-        char *pw = strtok(NULL, DELIMITER);
+        char *pw = ps_strtok_r(NULL, DELIMITER, &save_ptr);
         // 아이디 또는 비밀번호 없음
         if (id == NULL || pw == NULL)
         {
-            snprintf(reply, reply_size, "FAIL:아이디 또는 비밀번호가 누락되었습니다.");
+            reply_set(reply, "FAIL:아이디 또는 비밀번호가 누락되었습니다.");
         }
         else
         {
@@ -171,16 +188,18 @@ void handle_user_command(const char *request, char *reply, int reply_size)
                     user_save_to_file();
                     // 사용자의 메모도 함께 삭제
                     memo_delete_by_user_id(user_id_copy);
-                    snprintf(reply, reply_size, "OK:회원 탈퇴 성공");
+                    // 사용자의 세션도 모두 종료
+                    session_end_user(user_id_copy);
+                    reply_set(reply, "OK:회원 탈퇴 성공");
                 }
                 else
                 {
-                    snprintf(reply, reply_size, "FAIL:회원 탈퇴 중 오류 발생");
+                    reply_set(reply, "FAIL:회원 탈퇴 중 오류 발생");
                 }
             }
             else
             {
-                snprintf(reply, reply_size, "FAIL:아이디 또는 비밀번호가 틀렸습니다.");
+                reply_set(reply, "FAIL:아이디 또는 비밀번호가 틀렸습니다.");
             }
         }
     }
@@ -188,15 +207,15 @@ void handle_user_command(const char *request, char *reply, int reply_size)
     else if (strcmp(command, "UPDATE_PW") == 0)
     {
         // 아이디 파싱
-        char *id = strtok(NULL, DELIMITER);
+        char *id = ps_strtok_r(NULL, DELIMITER, &save_ptr);
         // 기존 비밀번호 파싱
-        char *old_pw = strtok(NULL, DELIMITER);
+        char *old_pw = ps_strtok_r(NULL, DELIMITER, &save_ptr);
         // 새 비밀번호 파싱
-        char *new_pw = strtok(NULL, DELIMITER);
+        char *new_pw = ps_strtok_r(NULL, DELIMITER, &save_ptr);
         // 아이디 또는 기존 비밀번호 또는 새 비밀번호 없음
         if (id == NULL || old_pw == NULL || new_pw == NULL)
         {
-            snprintf(reply, reply_size, "FAIL:필수 정보가 누락되었습니다.");
+            reply_set(reply, "FAIL:필수 정보가 누락되었습니다.");
         }
         else
         {
@@ -208,29 +227,29 @@ void handle_user_command(const char *request, char *reply, int reply_size)
                 // 새 비밀번호 유효성 검사
                 if (!is_valid_password(new_pw))
                 {
-                    snprintf(reply, reply_size, "FAIL:비밀번호는 공백 없이 %d~%d자여야 합니다.", MIN_PW_LEN, MAX_PW_LEN);
+                    reply_set(reply, "FAIL:비밀번호는 공백 없이 %d~%d자여야 합니다.", MIN_PW_LEN, MAX_PW_LEN);
                 }
                 else if (user_update_password(id, new_pw))
                 {
                     // 변경사항을 즉시 파일에 저장
                     user_save_to_file();
-                    snprintf(reply, reply_size, "OK:비밀번호 변경 성공");
+                    reply_set(reply, "OK:비밀번호 변경 성공");
                 }
                 else
                 {
-                    snprintf(reply, reply_size, "FAIL:비밀번호 변경 중 오류 발생");
+                    reply_set(reply, "FAIL:비밀번호 변경 중 오류 발생");
                 }
             }
             else
             {
-                snprintf(reply, reply_size, "FAIL:기존 비밀번호가 틀렸거나 사용자가 존재하지 않습니다.");
+                reply_set(reply, "FAIL:기존 비밀번호가 틀렸거나 사용자가 존재하지 않습니다.");
             }
         }
     }
     // 예외처리
     else
     {
-        snprintf(reply, reply_size, "FAIL:알 수 없는 USER 명령입니다: %s", command);
+        reply_set(reply, "FAIL:알 수 없는 USER 명령입니다: %s", command);
     }
     free(request_copy);
 }
@@ -4,6 +4,7 @@
 #include "common_input.h"
 #include "user.h"
 #include "main_menu.h"
+#include "client_net.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -14,26 +15,6 @@
 
 #define BUF_SIZE 2048
 
-// 서버에 요청을 보내고 응답을 받아 출력하는 헬퍼 함수
-static bool communicate_with_server(SOCKET sock, const char *request, char *reply)
-{
-    // 요청 전송
-    if (send(sock, request, strlen(request), 0) < 0)
-    {
-        printf("[클라이언트] 서버에 요청 전송 실패\n");
-        return false;
-    }
-    // 응답 수신
-    int bytes = recv(sock, reply, BUF_SIZE - 1, 0);
-    if (bytes <= 0)
-    {
-        printf("[클라이언트] 서버로부터 응답 수신 실패\n");
-        return false;
-    }
-    reply[bytes] = '\0';
-    return true;
-}
-
 // 로그인 이전 메뉴 (로그인, 회원가입, 종료)
 void user_menu_loop(SOCKET sock)
 {
@@ -42,7 +23,7 @@ void user_menu_loop(SOCKET sock)
     // 아이디, 비밀번호, 비밀번호 확인 변수
     char id[MAX_ID_LEN], pw[MAX_PW_LEN], pw2[MAX_PW_LEN];
     // 요청, 응답 버퍼
-    char request[BUF_SIZE], reply[BUF_SIZE];
+    char request[BUF_SIZE], *reply;
 
     while (true)
     {
@@ -80,12 +61,16 @@ void user_menu_loop(SOCKET sock)
             // 로그인 요청 전송
             snprintf(request, sizeof(request), "LOGIN:%s:%s", id, pw);
             // 로그인 응답 처리
-            if (communicate_with_server(sock, request, reply) && strncmp(reply, "OK", 2) == 0)
+            if (communicate_with_server(sock, request, &reply) && strncmp(reply, "OK", 2) == 0)
             {
+                // 세션 토큰 저장 (이후 메모 요청은 사용자 ID 대신 토큰을 사용)
+                client_set_session(reply);
                 printf("[클라이언트] %s\n", reply + 3);
                 // 메인 메뉴 루프 진입
                 Sleep(500);
                 main_menu_loop(sock, id);
+                // 로그아웃 또는 회원 탈퇴 후 세션 종료
+                client_end_session(sock);
             }
             else
             {
@@ -148,7 +133,7 @@ void user_menu_loop(SOCKET sock)
             // 회원가입 요청 전송
             snprintf(request, sizeof(request), "REGISTER:%s:%s", id, pw);
             // 회원가입 응답 처리
-            communicate_with_server(sock, request, reply);
+            communicate_with_server(sock, request, &reply);
             // 회원가입 응답 처리
             if (strncmp(reply, "OK", 2) == 0)
             {
@@ -173,30 +158,18 @@ void user_menu_loop(SOCKET sock)
 // 프로그램 종료
 void exit_program(SOCKET sock)
 {
-    char request[BUF_SIZE] = "EXIT";
-    char reply[BUF_SIZE];
+    char *reply;
 
     printf("\n[클라이언트] 서버에 종료 요청을 보냅니다...\n");
 
-    // 서버에 종료 요청 전송
+    // 서버에 종료 요청 전송 후 응답 대기
     if (sock != INVALID_SOCKET)
     {
-        if (send(sock, request, strlen(request), 0) < 0)
-        {
-            printf("[클라이언트] 서버에 종료 요청 전송 실패\n");
-        }
-        else
+        if (communicate_with_server(sock, "EXIT", &reply))
         {
-            // 서버의 응답 대기
-            int bytes = recv(sock, reply, BUF_SIZE - 1, 0);
-            if (bytes > 0)
-            {
-                reply[bytes] = '\0';
-                printf("[클라이언트] %s\n", reply + 3); // "OK:" 이후 메시지 출력
-            }
-
-            closesocket(sock);
+            printf("[클라이언트] %s\n", reply + 3); // "OK:" 이후 메시지 출력
         }
+        closesocket(sock);
     }
 
     WSACleanup();
@@ -0,0 +1,193 @@
+// src/worker_pool.c
+
+#include "worker_pool.h"
+#include "platform.h"
+#include "logger.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// 워커 풀 상태
+// 대기열은 우선순위마다 하나씩인 고정 크기 원형 버퍼이며, 여러 생산자(I/O 스레드)와 여러 소비자(워커)가 하나의 뮤텍스로 공유한다.
+typedef struct
+{
+    WorkerTask **tasks; // 작업 (원형 버퍼)
+    int head;           // 다음에 꺼낼 위치
+    int count;          // 대기 중인 작업 수
+} TaskQueue;
+
+static ps_thread_t *g_workers = NULL;         // 워커 스레드 배열
+static int g_worker_count = 0;                // 워커 스레드 수
+static TaskQueue g_lanes[WORKER_LANE_COUNT];  // 우선순위별 대기열
+static int g_queue_capacity = 0;              // 대기열 하나의 크기
+static int g_bulk_limit = 1;                  // 동시에 실행할 수 있는 일괄 작업 수
+static int g_bulk_running = 0;                // 실행 중인 일괄 작업 수
+static bool g_stopping = false;               // 종료 요청 여부
+static ps_mutex_t g_queue_lock;               // 대기열 보호용 뮤텍스
+static ps_cond_t g_queue_not_empty;           // 작업 도착(또는 일괄 작업 자리가 빔) 알림
+
+// 대기열에서 작업 하나 꺼냄 (잠근 상태에서 호출)
+static WorkerTask *queue_pop(TaskQueue *queue)
+{
+    WorkerTask *task = queue->tasks[queue->head];
+    queue->head = (queue->head + 1) % g_queue_capacity;
+    queue->count--;
+    return task;
+}
+
+// 지금 실행할 작업 선택 (잠근 상태에서 호출, 없으면 NULL)
+// 대화형 작업이 있으면 항상 먼저 꺼내고, 일괄 작업은 실행 중인 수가 제한보다 적을 때만 꺼낸다.
+static WorkerTask *take_next(void)
+{
+    if (g_lanes[WORKER_LANE_INTERACTIVE].count > 0)
+        return queue_pop(&g_lanes[WORKER_LANE_INTERACTIVE]);
+    if (g_lanes[WORKER_LANE_BULK].count > 0 && g_bulk_running < g_bulk_limit)
+    {
+        g_bulk_running++;
+        return queue_pop(&g_lanes[WORKER_LANE_BULK]);
+    }
+    return NULL;
+}
+
+// 워커 스레드: 대기열에서 작업을 꺼내 실행
+static PS_THREAD_FUNC(worker_main)
+{
+    (void)arg;
+    while (true)
+    {
+        ps_mutex_lock(&g_queue_lock);
+        // 실행할 수 있는 작업이 생길 때까지 대기
+        WorkerTask *task;
+        while ((task = take_next()) == NULL)
+        {
+            // 종료 요청 후 대기열이 모두 비었으면 종료
+            if (g_stopping && g_lanes[WORKER_LANE_INTERACTIVE].count == 0 && g_lanes[WORKER_LANE_BULK].count == 0)
+                break;
+            ps_cond_wait(&g_queue_not_empty, &g_queue_lock);
+        }
+        ps_mutex_unlock(&g_queue_lock);
+        if (!task)
+            break;
+
+        // 잠금 밖에서 작업 실행 (실행 후에는 작업 구조체가 해제될 수 있으므로 우선순위를 먼저 읽어 둠)
+        WorkerLane lane = task->lane;
+        task->run(task);
+
+        // 일괄 작업 자리가 비었으면 기다리던 일괄 작업을 다른 워커가 꺼낼 수 있게 알림
+        // (종료 중에는 남은 작업을 기다리며 잠든 워커들이 모두 끝날 수 있도록 전부 깨움)
+        if (lane == WORKER_LANE_BULK)
+        {
+            ps_mutex_lock(&g_queue_lock);
+            g_bulk_running--;
+            if (g_stopping)
+                ps_cond_broadcast(&g_queue_not_empty);
+            else if (g_lanes[WORKER_LANE_BULK].count > 0)
+                ps_cond_signal(&g_queue_not_empty);
+            ps_mutex_unlock(&g_queue_lock);
+        }
+    }
+    PS_THREAD_RETURN;
+}
+
+// 워커 풀 시작
+bool worker_pool_start(int worker_count, int queue_depth, int bulk_limit)
+{
+    // 대기열과 스레드 배열 할당
+    bool allocated = true;
+    for (int i = 0; i < WORKER_LANE_COUNT; i++)
+    {
+        g_lanes[i].tasks = (WorkerTask **)calloc(queue_depth, sizeof(WorkerTask *));
+        g_lanes[i].head = g_lanes[i].count = 0;
+        allocated = allocated && g_lanes[i].tasks;
+    }
+    g_workers = (ps_thread_t *)calloc(worker_count, sizeof(ps_thread_t));
+    if (!allocated || !g_workers)
+    {
+        for (int i = 0; i < WORKER_LANE_COUNT; i++)
+        {
+            free(g_lanes[i].tasks);
+            g_lanes[i].tasks = NULL;
+        }
+        free(g_workers);
+        g_workers = NULL;
+        return false;
+    }
+    g_queue_capacity = queue_depth;
+    // 워커가 둘 이상이면 적어도 하나는 대화형 작업만 처리하도록 남김
+    if (bulk_limit < 1)
+        bulk_limit = 1;
+    if (worker_count > 1 && bulk_limit > worker_count - 1)
+        bulk_limit = worker_count - 1;
+    g_bulk_limit = bulk_limit;
+    g_bulk_running = 0;
+    g_stopping = false;
+    ps_mutex_init(&g_queue_lock);
+    ps_cond_init(&g_queue_not_empty);
+
+    // 워커 스레드 생성
+    for (g_worker_count = 0; g_worker_count < worker_count; g_worker_count++)
+    {
+        if (!ps_thread_create(&g_workers[g_worker_count], worker_main, NULL))
+        {
+            logger_write(LOG_LEVEL_ERROR, "[서버] 워커 스레드 생성 실패");
+            break;
+        }
+    }
+    // 워커를 하나도 만들지 못한 경우
+    if (g_worker_count == 0)
+    {
+        worker_pool_stop();
+        return false;
+    }
+    logger_write(LOG_LEVEL_INFO, "[서버] 워커 스레드 %d개 시작 (대기열 크기: %d, 동시 일괄 작업: %d)", g_worker_count,
+                 g_queue_capacity, g_bulk_limit);
+    return true;
+}
+
+// 작업을 대기열에 추가
+bool worker_pool_submit(WorkerTask *task, WorkerLane lane)
+{
+    TaskQueue *queue = &g_lanes[lane];
+    ps_mutex_lock(&g_queue_lock);
+    // 대기열이 가득 찼거나 종료 중이면 거절
+    if (queue->count == g_queue_capacity || g_stopping)
+    {
+        ps_mutex_unlock(&g_queue_lock);
+        return false;
+    }
+    // 원형 버퍼 끝에 추가
+    task->lane = lane;
+    queue->tasks[(queue->head + queue->count) % g_queue_capacity] = task;
+    queue->count++;
+    ps_cond_signal(&g_queue_not_empty);
+    ps_mutex_unlock(&g_queue_lock);
+    return true;
+}
+
+// 워커 풀 종료
+void worker_pool_stop(void)
+{
+    if (!g_lanes[WORKER_LANE_INTERACTIVE].tasks)
+        return;
+    // 종료 요청 후 모든 워커 깨우기 (남은 작업은 처리하고 종료)
+    ps_mutex_lock(&g_queue_lock);
+    g_stopping = true;
+    ps_cond_broadcast(&g_queue_not_empty);
+    ps_mutex_unlock(&g_queue_lock);
+
+    // 워커 종료 대기
+    for (int i = 0; i < g_worker_count; i++)
+    {
+        ps_thread_join(g_workers[i]);
+    }
+    // 자원 해제
+    ps_cond_destroy(&g_queue_not_empty);
+    ps_mutex_destroy(&g_queue_lock);
+    free(g_workers);
+    g_workers = NULL;
+    for (int i = 0; i < WORKER_LANE_COUNT; i++)
+    {
+        free(g_lanes[i].tasks);
+        g_lanes[i].tasks = NULL;
+    }
+    g_worker_count = 0;
+}
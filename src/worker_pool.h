@@ -0,0 +1,39 @@
+// src/worker_pool.h
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <stdbool.h>
+
+// 작업 우선순위 (대기열이 따로 있음)
+// 워커는 대화형 대기열부터 꺼내고, 일괄 작업은 대화형 작업이 없을 때만 동시에 bulk_limit개까지 실행한다.
+// 따라서 일괄 작업이 아무리 많이 쌓여도 최소 (워커 수 - bulk_limit)개의 워커는 대화형 작업을 위해 남는다.
+typedef enum
+{
+    WORKER_LANE_INTERACTIVE, // 조회/변경 등 짧은 요청
+    WORKER_LANE_BULK,        // 내보내기, 검색, 회원 탈퇴 등 오래 걸리는 요청
+    WORKER_LANE_COUNT
+} WorkerLane;
+
+// 워커 스레드에서 실행할 작업
+// 호출자는 이 구조체를 자신의 작업 구조체 첫 멤버로 두고, run에서 원래 구조체로 캐스팅하여 사용한다.
+typedef struct WorkerTask
+{
+    void (*run)(struct WorkerTask *task); // 워커 스레드에서 호출되는 함수
+    WorkerLane lane;                      // 넣은 대기열 (worker_pool_submit이 기록)
+} WorkerTask;
+
+// 고정 크기 워커 풀 시작
+// - worker_count: 워커 스레드 수
+// - queue_depth: 대기열마다 쌓일 수 있는 최대 작업 수
+// - bulk_limit: 동시에 실행할 수 있는 일괄 작업 수 (워커가 둘 이상이면 워커 수 - 1 이하로 줄임)
+bool worker_pool_start(int worker_count, int queue_depth, int bulk_limit);
+
+// 작업을 우선순위에 맞는 대기열에 추가 (여러 I/O 스레드에서 동시에 호출 가능)
+// 반환값: 추가되었으면 true, 대기열이 가득 찼으면 false (호출자가 과부하 응답을 보내야 함)
+bool worker_pool_submit(WorkerTask *task, WorkerLane lane);
+
+// 대기열에 남은 작업을 모두 처리한 뒤 워커 스레드를 종료
+void worker_pool_stop(void);
+
+#endif